@@ -45,6 +45,7 @@
 #include <stdbool.h>
 #include "ad7124.h"
 #include "no-os/delay.h"
+#include "no-os/error.h"
 
 /* Error codes */
 #define INVALID_VAL -1 /* Invalid argument */
@@ -201,6 +202,9 @@ int32_t ad7124_read_register(struct ad7124_dev *dev,
 {
 	int32_t ret;
 
+	if (dev->cont_read)
+		return -EBUSY;
+
 	if (p_reg->addr != AD7124_ERR_REG && dev->check_ready) {
 		ret = ad7124_wait_for_spi_ready(dev,
 						dev->spi_rdy_poll_cnt);
@@ -250,6 +254,9 @@ int32_t ad7124_write_register(struct ad7124_dev *dev,
 {
 	int32_t ret;
 
+	if (dev->cont_read)
+		return -EBUSY;
+
 	if (dev->check_ready) {
 		ret = ad7124_wait_for_spi_ready(dev,
 						dev->spi_rdy_poll_cnt);
@@ -472,24 +479,7 @@ int32_t ad7124_get_read_chan_id(struct ad7124_dev *dev, uint32_t *status)
 *******************************************************************************/
 uint8_t ad7124_compute_crc8(uint8_t * p_buf, uint8_t buf_size)
 {
-	uint8_t i = 0;
-	uint8_t crc = 0;
-
-	while(buf_size) {
-		for(i = 0x80; i != 0; i >>= 1) {
-			bool cmp1 = (crc & 0x80) != 0;
-			bool cmp2 = (*p_buf & i) != 0;
-			if(cmp1 != cmp2) { /* MSB of CRC register XOR input Bit from Data */
-				crc <<= 1;
-				crc ^= AD7124_CRC8_POLYNOMIAL_REPRESENTATION;
-			} else {
-				crc <<= 1;
-			}
-		}
-		p_buf++;
-		buf_size--;
-	}
-	return crc;
+	return crc8(crc8_table_07, p_buf, buf_size, 0);
 }
 
 /***************************************************************************//**
@@ -539,6 +529,174 @@ void ad7124_update_dev_spi_settings(struct ad7124_dev *dev)
 	}
 }
 
+/***************************************************************************//**
+ * @brief Reads one result in continuous read mode. Must be called after the
+ *        DOUT/RDY falling edge. No command is sent, the result, the status
+ *        and the CRC are clocked out in a single transaction, except when
+ *        leaving the mode, when the data register read command is sent first.
+ *
+ * @param dev  - The handler of the instance of the driver.
+ * @param data - Pointer to a struct ad7124_sample to store the result.
+ *
+ * @return Returns 0 for success or negative error code.
+*******************************************************************************/
+static int32_t ad7124_cont_read_sample(void *dev, uint8_t *data)
+{
+	struct ad7124_dev *desc = dev;
+	struct ad7124_sample *sample = (struct ad7124_sample *)data;
+	uint8_t buf[6] = {0, 0, 0, 0, 0, 0};
+	uint8_t *tx = &buf[1];
+	uint8_t len = 4;
+	bool exit = desc->cont_read_exit;
+	int32_t ret;
+
+	/* DOUT/RDY also toggles as MISO outside of continuous read mode */
+	if (!desc->cont_read)
+		return INVALID_VAL;
+
+	if (desc->use_crc != AD7124_DISABLE_CRC)
+		len++;
+
+	if (exit) {
+		buf[0] = AD7124_COMM_REG_WEN | AD7124_COMM_REG_RD |
+			 AD7124_COMM_REG_RA(AD7124_DATA_REG);
+		tx = buf;
+		len++;
+	}
+
+	sample->timestamp = 0;
+	if (desc->timer) {
+		ret = timer_counter_get(desc->timer, &sample->timestamp);
+		if (ret < 0)
+			return ret;
+	}
+
+	ret = spi_write_and_read(desc->spi_desc, tx, len);
+	if (ret < 0)
+		return ret;
+
+	if (exit) {
+		desc->regs[AD7124_ADC_Control].value &=
+			~AD7124_ADC_CTRL_REG_CONT_READ;
+		desc->cont_read_exit = false;
+		desc->cont_read = false;
+	}
+
+	/* The CRC covers the data register read command, sent or not */
+	if (desc->use_crc != AD7124_DISABLE_CRC &&
+	    crc8(crc8_table_07, &buf[1], 5, desc->data_crc_seed))
+		return COMM_ERR;
+
+	/* A result already read or not yet available */
+	if (buf[4] & AD7124_STATUS_REG_RDY)
+		return COMM_ERR;
+
+	sample->code = ((uint32_t)buf[1] << 16) | ((uint32_t)buf[2] << 8) |
+		       buf[3];
+	sample->channel = AD7124_STATUS_REG_CH_ACTIVE(buf[4]);
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Enters continuous read mode, with the status appended to the data,
+ *        and starts buffering the results on the DOUT/RDY falling edge.
+ *        Register accesses are not possible until ad7124_cont_read_stop().
+ *
+ * @param dev - The handler of the instance of the driver.
+ *
+ * @return Returns 0 for success or negative error code.
+*******************************************************************************/
+int32_t ad7124_cont_read_start(struct ad7124_dev *dev)
+{
+	uint32_t adc_ctrl;
+	int32_t ret;
+
+	if (!dev || !dev->acq || dev->cont_read)
+		return INVALID_VAL;
+
+	dev->cont_read_adc_ctrl = dev->regs[AD7124_ADC_Control].value;
+	adc_ctrl = dev->cont_read_adc_ctrl | AD7124_ADC_CTRL_REG_CONT_READ |
+		   AD7124_ADC_CTRL_REG_DATA_STATUS;
+
+	ret = ad7124_write_register2(dev, AD7124_ADC_Control, adc_ctrl);
+	if (ret < 0) {
+		dev->regs[AD7124_ADC_Control].value = dev->cont_read_adc_ctrl;
+		return ret;
+	}
+
+	/*
+	 * The results are read from the interrupt, so it is only enabled once
+	 * the SPI is no longer used from here.
+	 */
+	dev->cont_read_exit = false;
+	dev->cont_read = true;
+
+	return drdy_acq_start(dev->acq);
+}
+
+/***************************************************************************//**
+ * @brief Gets the oldest buffered continuous read result.
+ *
+ * @param dev    - The handler of the instance of the driver.
+ * @param sample - Pointer to store the result.
+ *
+ * @return Returns 0 for success or negative error code.
+*******************************************************************************/
+int32_t ad7124_cont_read_get(struct ad7124_dev *dev,
+			     struct ad7124_sample *sample)
+{
+	uint32_t timeout = AD7124_CONT_READ_TIMEOUT_MS;
+	int32_t ret;
+
+	if (!dev || !dev->acq || !sample)
+		return INVALID_VAL;
+
+	while (true) {
+		ret = drdy_acq_read(dev->acq, sample, 1);
+		if (ret != -EAGAIN)
+			return ret;
+		if (!dev->cont_read || !timeout--)
+			return TIMEOUT;
+		mdelay(1);
+	}
+}
+
+/***************************************************************************//**
+ * @brief Leaves continuous read mode on the next result and restores the
+ *        ADC_Control register.
+ *
+ * @param dev - The handler of the instance of the driver.
+ *
+ * @return Returns 0 for success or negative error code.
+*******************************************************************************/
+int32_t ad7124_cont_read_stop(struct ad7124_dev *dev)
+{
+	uint32_t timeout = AD7124_CONT_READ_TIMEOUT_MS;
+	int32_t ret;
+
+	if (!dev || !dev->acq)
+		return INVALID_VAL;
+
+	if (!dev->cont_read)
+		return 0;
+
+	dev->cont_read_exit = true;
+	while (dev->cont_read && timeout--)
+		mdelay(1);
+
+	ret = drdy_acq_stop(dev->acq);
+	if (dev->cont_read) {
+		dev->cont_read = false;
+		return TIMEOUT;
+	}
+	if (ret < 0)
+		return ret;
+
+	return ad7124_write_register2(dev, AD7124_ADC_Control,
+				      dev->cont_read_adc_ctrl);
+}
+
 /***************************************************************************//**
  * @brief Initializes the AD7124.
  *
@@ -551,11 +709,17 @@ void ad7124_update_dev_spi_settings(struct ad7124_dev *dev)
 int32_t ad7124_setup(struct ad7124_dev **device,
 		     struct ad7124_init_param *init_param)
 {
+	struct drdy_acq_init_param acq_param = {
+		.trig = IRQ_EDGE_FALLING,
+		.sample_size = sizeof(struct ad7124_sample),
+		.read_sample = ad7124_cont_read_sample,
+	};
 	int32_t ret;
 	enum ad7124_registers reg_nr;
 	struct ad7124_dev *dev;
+	uint8_t cmd;
 
-	dev = (struct ad7124_dev *)malloc(sizeof(*dev));
+	dev = (struct ad7124_dev *)calloc(1, sizeof(*dev));
 	if (!dev)
 		return INVALID_VAL;
 
@@ -565,16 +729,21 @@ int32_t ad7124_setup(struct ad7124_dev **device,
 	/* Initialize the SPI communication. */
 	ret = spi_init(&dev->spi_desc, init_param->spi_init);
 	if (ret < 0)
-		return ret;
+		goto error_dev;
+	acq_param.dev = dev;
 
 	/*  Reset the device interface.*/
 	ret = ad7124_reset(dev);
 	if (ret < 0)
-		return ret;
+		goto error_spi;
 
 	/* Update the device structure with power-on/reset settings */
 	dev->check_ready = 1;
 
+	cmd = AD7124_COMM_REG_WEN | AD7124_COMM_REG_RD |
+	      AD7124_COMM_REG_RA(AD7124_DATA_REG);
+	dev->data_crc_seed = crc8(crc8_table_07, &cmd, 1, 0);
+
 	/* Initialize registers AD7124_ADC_Control through AD7124_Filter_7. */
 	for(reg_nr = AD7124_Status; (reg_nr < AD7124_Offset_0) && !(ret < 0);
 	    reg_nr++) {
@@ -590,9 +759,45 @@ int32_t ad7124_setup(struct ad7124_dev **device,
 			ad7124_update_dev_spi_settings(dev);
 		}
 	}
+	if (ret < 0)
+		goto error_spi;
+
+	if (init_param->rdy_irq_ctrl_optional) {
+		if (init_param->timer_param_optional) {
+			ret = timer_init(&dev->timer,
+					 init_param->timer_param_optional);
+			if (ret < 0)
+				goto error_spi;
+
+			ret = timer_start(dev->timer);
+			if (ret < 0)
+				goto error_timer;
+		}
+
+		acq_param.irq_ctrl = init_param->rdy_irq_ctrl_optional;
+		acq_param.irq_id = init_param->rdy_irq_id;
+		acq_param.nb_samples = init_param->cont_read_nb_samples ?
+				       init_param->cont_read_nb_samples :
+				       AD7124_CONT_READ_DEFAULT_SAMPLES;
+		ret = drdy_acq_init(&dev->acq, &acq_param);
+		if (ret < 0)
+			goto error_timer;
+	}
 
 	*device = dev;
 
+	return ret;
+
+error_timer:
+	if (dev->timer) {
+		timer_stop(dev->timer);
+		timer_remove(dev->timer);
+	}
+error_spi:
+	spi_remove(dev->spi_desc);
+error_dev:
+	free(dev);
+
 	return ret;
 }
 
@@ -786,6 +991,16 @@ int32_t ad7124_remove(struct ad7124_dev *dev)
 {
 	int32_t ret;
 
+	if (dev->acq) {
+		if (dev->cont_read)
+			ad7124_cont_read_stop(dev);
+		drdy_acq_remove(dev->acq);
+	}
+	if (dev->timer) {
+		timer_stop(dev->timer);
+		timer_remove(dev->timer);
+	}
+
 	ret = spi_remove(dev->spi_desc);
 
 	free(dev);
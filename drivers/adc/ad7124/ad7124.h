@@ -45,8 +45,13 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdint.h>
+#include <stdbool.h>
 #include "no-os/spi.h"
 #include "no-os/delay.h"
+#include "no-os/crc8.h"
+#include "no-os/irq.h"
+#include "no-os/timer.h"
+#include "no-os/drdy_acq.h"
 
 /******************************************************************************/
 /******************* Register map and register definitions ********************/
@@ -331,6 +336,18 @@ enum ad7124_registers {
 	AD7124_REG_NO
 };
 
+/*
+ * Conversion result read in continuous read mode.
+ * @timestamp: Timer count when the result was read, 0 without a timer.
+ * @code: Raw conversion result.
+ * @channel: Sequencer channel that produced the result.
+ */
+struct ad7124_sample {
+	uint32_t timestamp;
+	uint32_t code;
+	uint8_t channel;
+};
+
 /*
  * The structure describes the device and is used with the ad7124 driver.
  * @spi_desc: A reference to the SPI configuration of the device.
@@ -342,6 +359,15 @@ enum ad7124_registers {
  * @spi_rdy_poll_cnt: Number of times the driver should read the Error register
  *                    to check if the device is ready to accept user requests,
  *                    before a timeout error will be issued.
+ * @data_crc_seed: CRC of the data register read command, which is part of the
+ *                 CRC of each continuous read result.
+ * @acq: Acquisition reading the results on the DOUT/RDY falling edge. Only
+ *       present if the DOUT/RDY interrupt was provided at setup.
+ * @timer: Optional timer used to timestamp the results.
+ * @cont_read: Whether the device is in continuous read mode.
+ * @cont_read_exit: Set to leave continuous read mode on the next result.
+ * @cont_read_adc_ctrl: ADC_Control value to restore when leaving continuous
+ *                      read mode.
  */
 struct ad7124_dev {
 	/* SPI */
@@ -351,6 +377,13 @@ struct ad7124_dev {
 	int16_t use_crc;
 	int16_t check_ready;
 	int16_t spi_rdy_poll_cnt;
+	/* Continuous read */
+	uint8_t data_crc_seed;
+	struct drdy_acq_desc	*acq;
+	struct timer_desc	*timer;
+	volatile bool cont_read;
+	volatile bool cont_read_exit;
+	uint32_t cont_read_adc_ctrl;
 };
 
 struct ad7124_init_param {
@@ -359,6 +392,16 @@ struct ad7124_init_param {
 	/* Device Settings */
 	struct ad7124_st_reg	*regs;
 	int16_t spi_rdy_poll_cnt;
+	/* Optional, interrupt controller of the DOUT/RDY pin. Needed by the
+	 * continuous read mode. */
+	struct irq_ctrl_desc	*rdy_irq_ctrl_optional;
+	/* Interrupt ID of the DOUT/RDY pin */
+	uint32_t rdy_irq_id;
+	/* Number of results buffered in continuous read mode. 0 for
+	 * AD7124_CONT_READ_DEFAULT_SAMPLES */
+	uint32_t cont_read_nb_samples;
+	/* Optional, timer used to timestamp continuous read results */
+	struct timer_init_param	*timer_param_optional;
 };
 
 /******************************************************************************/
@@ -367,6 +410,8 @@ struct ad7124_init_param {
 #define AD7124_CRC8_POLYNOMIAL_REPRESENTATION 0x07 /* x8 + x2 + x + 1 */
 #define AD7124_DISABLE_CRC 0
 #define AD7124_USE_CRC 1
+#define AD7124_CONT_READ_DEFAULT_SAMPLES 256
+#define AD7124_CONT_READ_TIMEOUT_MS 2000
 
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
@@ -442,6 +487,16 @@ float ad7124_get_odr(struct ad7124_dev *dev, int16_t ch_no);
 int32_t ad7124_set_odr(struct ad7124_dev *dev, float odr,
 		       int16_t ch_no);
 
+/*! Enter continuous read mode and start buffering results. */
+int32_t ad7124_cont_read_start(struct ad7124_dev *dev);
+
+/*! Get the oldest buffered continuous read result. */
+int32_t ad7124_cont_read_get(struct ad7124_dev *dev,
+			     struct ad7124_sample *sample);
+
+/*! Leave continuous read mode. */
+int32_t ad7124_cont_read_stop(struct ad7124_dev *dev);
+
 /*! Initializes the AD7124. */
 int32_t ad7124_setup(struct ad7124_dev **device,
 		     struct ad7124_init_param *init_param);
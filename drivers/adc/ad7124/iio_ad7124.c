@@ -598,6 +598,9 @@ static int32_t iio_ad7124_update_active_channels(void *dev, uint32_t mask)
 			return ret;
 	}
 
+	if (desc->acq)
+		return ad7124_cont_read_start(desc);
+
 	return SUCCESS;
 }
 
@@ -613,6 +616,12 @@ static int32_t iio_ad7124_close_channels(void *dev)
 	int32_t ret;
 	uint32_t reg_temp;
 
+	if (desc->cont_read) {
+		ret = ad7124_cont_read_stop(desc);
+		if (ret != SUCCESS)
+			return ret;
+	}
+
 	for (ch_idx = 0; ch_idx < 16; ch_idx++) {
 		ret = ad7124_read_register2(desc,
 					    (AD7124_CH0_MAP_REG + ch_idx),
@@ -656,6 +665,55 @@ static int32_t iio_ad7124_get_active_channels(struct ad7124_dev * desc,
 	return SUCCESS;
 }
 
+/**
+ * @brief Get a number of samples from the continuous read results. Each
+ * result is tagged with its channel, so a scan is only output once all the
+ * active channels were converted in sequence, and no resynchronization is
+ * needed.
+ * @param [in] desc - Device descriptor.
+ * @param [out] buff - Sample buffer.
+ * @param [in] mask - Active channels.
+ * @param [in] nb_samples - Number of samples to get.
+ * @return Number of samples read.
+ */
+static int32_t iio_ad7124_read_cont_samples(struct ad7124_dev *desc,
+		int32_t *buff, uint32_t mask, uint32_t nb_samples)
+{
+	struct ad7124_sample sample;
+	int32_t scan[16];
+	uint32_t filled = 0, last, k = 0, ch, i;
+	int32_t ret;
+
+	if (!mask)
+		return -EINVAL;
+
+	last = find_last_set_bit(mask);
+	while (k < nb_samples) {
+		ret = ad7124_cont_read_get(desc, &sample);
+		if (ret != SUCCESS)
+			return ret;
+
+		if (!(mask & (1 << sample.channel)))
+			continue;
+		scan[sample.channel] = sample.code;
+		filled |= 1 << sample.channel;
+		if (sample.channel != last)
+			continue;
+
+		/* Drop the scans with a missing result */
+		if (filled == mask) {
+			for (ch = 0, i = 0; ch <= last; ch++)
+				if (mask & (1 << ch))
+					buff[i++] = scan[ch];
+			buff += i;
+			k++;
+		}
+		filled = 0;
+	}
+
+	return nb_samples;
+}
+
 /**
  * @brief Get a number of samples from all the active channels.
  * @param [in] dev - Device descriptor.
@@ -672,6 +730,18 @@ static int32_t iio_ad7124_read_samples(void *dev, int32_t *buff,
 	uint32_t ch_id = -1, test;
 	uint32_t mask;
 
+	if (desc->cont_read) {
+		/* Registers can't be read in continuous read mode */
+		mask = 0;
+		for (k = 0; k < 16; k++)
+			if (desc->regs[AD7124_Channel_0 + k].value &
+			    AD7124_CH_MAP_REG_CH_ENABLE)
+				mask |= 1 << k;
+
+		return iio_ad7124_read_cont_samples(desc, buff, mask,
+						    nb_samples);
+	}
+
 	ret = iio_ad7124_get_active_channels(desc, &mask);
 	if (ret != SUCCESS)
 		return ret;
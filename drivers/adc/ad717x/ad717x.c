@@ -46,6 +46,7 @@
 /******************************************************************************/
 #include <stdlib.h>
 #include "ad717x.h"
+#include "no-os/crc8.h"
 #include "no-os/error.h"
 
 /* Error codes */
@@ -668,23 +669,7 @@ int32_t AD717X_ComputeDataregSize(ad717x_dev *device)
 uint8_t AD717X_ComputeCRC8(uint8_t * pBuf,
 			   uint8_t bufSize)
 {
-	uint8_t i   = 0;
-	uint8_t crc = 0;
-
-	while(bufSize) {
-		for(i = 0x80; i != 0; i >>= 1) {
-			if(((crc & 0x80) != 0) != ((*pBuf & i) !=
-						   0)) { /* MSB of CRC register XOR input Bit from Data */
-				crc <<= 1;
-				crc ^= AD717X_CRC8_POLYNOMIAL_REPRESENTATION;
-			} else {
-				crc <<= 1;
-			}
-		}
-		pBuf++;
-		bufSize--;
-	}
-	return crc;
+	return crc8(crc8_table_07, pBuf, bufSize, 0);
 }
 
 /***************************************************************************//**
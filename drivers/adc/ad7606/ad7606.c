@@ -50,6 +50,7 @@
 #include "no-os/error.h"
 #include "no-os/util.h"
 #include "no-os/crc.h"
+#include "no-os/interleave.h"
 
 struct ad7606_chip_info {
 	uint8_t num_channels;
@@ -64,7 +65,6 @@ struct ad7606_chip_info {
 	uint32_t sw_range_table_sz;
 };
 
-DECLARE_CRC8_TABLE(ad7606_crc8);
 DECLARE_CRC16_TABLE(ad7606_crc16);
 
 static const struct ad7606_range ad7606_range_table[] = {
@@ -241,7 +241,7 @@ int32_t ad7606_spi_reg_read(struct ad7606_dev *dev,
 	buf[0] = AD7606_RD_FLAG_MSK(reg_addr);
 	buf[1] = 0x00;
 	if (dev->digital_diag_enable.int_crc_err_en) {
-		crc = crc8(ad7606_crc8, buf, 2, 0);
+		crc = crc8(crc8_table_07, buf, 2, 0);
 		buf[2] = crc;
 		sz += 1;
 	}
@@ -254,7 +254,7 @@ int32_t ad7606_spi_reg_read(struct ad7606_dev *dev,
 	buf[0] = AD7606_RD_FLAG_MSK(reg_addr);
 	buf[1] = 0x00;
 	if (dev->digital_diag_enable.int_crc_err_en) {
-		crc = crc8(ad7606_crc8, buf, 2, 0);
+		crc = crc8(crc8_table_07, buf, 2, 0);
 		buf[2] = crc;
 	}
 	ret = spi_write_and_read(dev->spi_desc, buf, sz);
@@ -262,7 +262,7 @@ int32_t ad7606_spi_reg_read(struct ad7606_dev *dev,
 		return ret;
 
 	if (dev->digital_diag_enable.int_crc_err_en) {
-		crc = crc8(ad7606_crc8, buf, 2, 0);
+		crc = crc8(crc8_table_07, buf, 2, 0);
 		if (crc != buf[2])
 			return -EBADMSG;
 	}
@@ -310,7 +310,7 @@ int32_t ad7606_spi_reg_write(struct ad7606_dev *dev,
 	buf[0] = AD7606_WR_FLAG_MSK(reg_addr);
 	buf[1] = reg_data;
 	if (dev->digital_diag_enable.int_crc_err_en) {
-		crc = crc8(ad7606_crc8, buf, 2, 0);
+		crc = crc8(crc8_table_07, buf, 2, 0);
 		buf[2] = crc;
 		sz += 1;
 	}
@@ -459,7 +459,7 @@ int32_t ad7606_convst(struct ad7606_dev *dev)
 int32_t ad7606_spi_data_read(struct ad7606_dev *dev, uint32_t *data)
 {
 	uint32_t sz;
-	int32_t ret, i;
+	int32_t ret;
 	uint16_t crc, icrc;
 	uint8_t bits = ad7606_chip_info_tbl[dev->device_id].bits;
 	uint8_t sbits = dev->config.status_header ? 8 : 0;
@@ -505,16 +505,10 @@ int32_t ad7606_spi_data_read(struct ad7606_dev *dev, uint32_t *data)
 			return ret;
 		break;
 	case 16:
-		for(i = 0; i < nchannels; i++) {
-			if (dev->config.status_header) {
-				data[i] = (uint32_t)dev->data[i*3] << 16;
-				data[i] |= (uint32_t)dev->data[i*3+1] << 8;
-				data[i] |= (uint32_t)dev->data[i*3+2];
-			} else {
-				data[i] = (uint32_t)dev->data[i*2] << 8;
-				data[i] |= (uint32_t)dev->data[i*2+1];
-			}
-		}
+		if (dev->config.status_header)
+			sample_be24_to_u32(data, dev->data, nchannels);
+		else
+			sample_be16_to_u32(data, dev->data, nchannels);
 		break;
 	default:
 		ret = -ENOTSUP;
@@ -573,6 +567,35 @@ int32_t ad7606_read(struct ad7606_dev *dev, uint32_t * data)
 	return ad7606_spi_data_read(dev, data);
 }
 
+/***************************************************************************//**
+ * @brief Data read callback for the data-ready acquisition helper.
+ *
+ * To be used as drdy_acq_init_param.read_sample with the BUSY pin falling
+ * edge as interrupt source and ad7606_drdy_trigger() as trigger callback.
+ * A sample is num_channels * sizeof(uint32_t) bytes.
+ *
+ * @param dev        - The device structure.
+ * @param data       - Pointer to location of buffer where to store the data.
+ *
+ * @return ret - return code of ad7606_spi_data_read().
+*******************************************************************************/
+int32_t ad7606_drdy_read_sample(void *dev, uint8_t *data)
+{
+	return ad7606_spi_data_read(dev, (uint32_t *)data);
+}
+
+/***************************************************************************//**
+ * @brief Conversion start callback for the data-ready acquisition helper.
+ *
+ * @param dev        - The device structure.
+ *
+ * @return ret - return code of ad7606_convst().
+*******************************************************************************/
+int32_t ad7606_drdy_trigger(void *dev)
+{
+	return ad7606_convst(dev);
+}
+
 /* Internal function to reset device settings to default state after chip reset. */
 static inline void ad7606_reset_settings(struct ad7606_dev *dev)
 {
@@ -1109,7 +1132,6 @@ int32_t ad7606_init(struct ad7606_dev **device,
 	uint8_t reg, id;
 	int32_t i, ret;
 
-	crc8_populate_msb(ad7606_crc8, 0x7);
 	crc16_populate_msb(ad7606_crc16, 0x755b);
 
 	dev = (struct ad7606_dev *)calloc(1, sizeof(*dev));
@@ -377,6 +377,8 @@ int32_t ad7606_spi_data_read(struct ad7606_dev *dev,
 int32_t ad7606_read(struct ad7606_dev *dev,
 		    uint32_t *data);
 int32_t ad7606_convst(struct ad7606_dev *dev);
+int32_t ad7606_drdy_read_sample(void *dev, uint8_t *data);
+int32_t ad7606_drdy_trigger(void *dev);
 int32_t ad7606_reset(struct ad7606_dev *dev);
 int32_t ad7606_set_oversampling(struct ad7606_dev *dev,
 				struct ad7606_oversampling oversampling);
@@ -47,6 +47,7 @@
 #include "ad77681.h"
 #include "no-os/error.h"
 #include "no-os/delay.h"
+#include "no-os/util.h"
 
 /******************************************************************************/
 /************************** Functions Implementation **************************/
@@ -62,21 +63,7 @@ uint8_t ad77681_compute_crc8(uint8_t *data,
 			     uint8_t data_size,
 			     uint8_t init_val)
 {
-	uint8_t i;
-	uint8_t crc = init_val;
-
-	while (data_size) {
-		for (i = 0x80; i != 0; i >>= 1) {
-			if (((crc & 0x80) != 0) != ((*data & i) != 0)) {
-				crc <<= 1;
-				crc ^= AD77681_CRC8_POLY;
-			} else
-				crc <<= 1;
-		}
-		data++;
-		data_size--;
-	}
-	return crc;
+	return crc8(crc8_table_07, data, data_size, init_val);
 }
 
 /**
@@ -310,7 +297,7 @@ int32_t ad77681_spi_read_adc_data(struct ad77681_dev *dev,
 						      INITIAL_CRC_XOR);
 
 		if (crc_xor != buf[dev->data_frame_byte - (1 - add_buff)]) {
-			printf("%s: CRC Error.\n", __func__);
+			dev->crc_errors++;
 			ret = FAILURE;
 		}
 #ifdef CRC_DEBUG
@@ -321,7 +308,7 @@ int32_t ad77681_spi_read_adc_data(struct ad77681_dev *dev,
 	}
 
 	/* Fill the adc_data buffer */
-	memcpy(adc_data, buf, ARRAY_SIZE(buf));
+	memcpy(adc_data, buf, dev->data_frame_byte + add_buff);
 
 	return ret;
 }
@@ -337,11 +324,13 @@ int32_t ad77681_CRC_status_handling(struct ad77681_dev *dev,
 				    uint16_t *data_buffer)
 {
 	int32_t ret = 0;
-	uint8_t status_byte = 0, checksum = 0, checksum_byte = 0, checksum_buf[5],
+	uint8_t checksum = 0, checksum_byte = 0, checksum_buf[5],
 		checksum_length = 0, i;
+#ifdef CRC_DEBUG
+	uint8_t status_byte = 0;
 	char print_buf[50];
 
-	/* Status bit handling */
+	/* Status bit handling, the status is only printed */
 	if (dev->status_bit) {
 		/* 24bit ADC data + 8bit of status = 2 16bit frames */
 		if (dev->conv_len == AD77681_CONV_24BIT)
@@ -350,6 +339,7 @@ int32_t ad77681_CRC_status_handling(struct ad77681_dev *dev,
 		else
 			status_byte = data_buffer[1] >> 8;
 	}
+#endif /* CRC_DEBUG */
 
 	/* Checksum bit handling */
 	if (dev->crc_sel != AD77681_NO_CRC) {
@@ -1756,7 +1746,7 @@ int32_t ad77681_setup(struct ad77681_dev **device,
 	int32_t ret;
 	uint8_t scratchpad_check = 0xAD;
 
-	dev = (struct ad77681_dev *)malloc(sizeof(*dev));
+	dev = (struct ad77681_dev *)calloc(1, sizeof(*dev));
 	if (!dev) {
 		return -1;
 	}
@@ -1838,3 +1828,346 @@ int32_t ad77681_setup(struct ad77681_dev **device,
 	return ret;
 }
 
+
+/**
+ * Allocate the block capture buffers.
+ * @param dev - The device structure.
+ * @param param - Burst and ring sizes.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad77681_capture_init(struct ad77681_dev *dev,
+			     const struct ad77681_capture_init_param *param)
+{
+	struct ad77681_capture *cap;
+	int32_t ret;
+
+	if (!dev || !param || !param->burst_len ||
+	    param->ring_len < param->burst_len)
+		return -EINVAL;
+
+	if (dev->capture)
+		return -EBUSY;
+
+	cap = (struct ad77681_capture *)calloc(1, sizeof(*cap));
+	if (!cap)
+		return -ENOMEM;
+
+	cap->raw = (uint8_t *)malloc(param->burst_len *
+				     AD77681_CAPTURE_MAX_FRAME);
+	cap->samples = (int32_t *)malloc(param->burst_len * sizeof(int32_t));
+	if (!cap->raw || !cap->samples) {
+		ret = -ENOMEM;
+		goto error;
+	}
+
+	ret = cb_init(&cap->ring, param->ring_len * sizeof(int32_t));
+	if (ret < 0)
+		goto error;
+
+	cap->burst_len = param->burst_len;
+	dev->capture = cap;
+
+	return 0;
+error:
+	free(cap->samples);
+	free(cap->raw);
+	free(cap);
+
+	return ret;
+}
+
+/**
+ * Free the block capture buffers.
+ * @param dev - The device structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad77681_capture_remove(struct ad77681_dev *dev)
+{
+	struct ad77681_capture *cap;
+
+	if (!dev || !dev->capture)
+		return -EINVAL;
+
+	cap = dev->capture;
+	if (cap->running)
+		ad77681_capture_stop(dev);
+
+	dev->capture = NULL;
+	cb_remove(cap->ring);
+	free(cap->samples);
+	free(cap->raw);
+	free(cap);
+
+	return 0;
+}
+
+/**
+ * Enter continuous read mode and start the capture. From now on, only
+ * ad77681_capture_drdy_handler() may access the SPI.
+ * @param dev - The device structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad77681_capture_start(struct ad77681_dev *dev)
+{
+	struct ad77681_capture *cap;
+	int32_t ret;
+
+	if (!dev || !dev->capture)
+		return -EINVAL;
+
+	cap = dev->capture;
+	if (cap->running)
+		return -EBUSY;
+
+	cap->frame_len = ad77681_get_frame_byte(dev);
+	cap->fill = 0;
+
+	ret = ad77681_set_continuos_read(dev, AD77681_CONTINUOUS_READ_ENABLE);
+	if (ret < 0)
+		return ret;
+
+	cap->running = true;
+
+	return 0;
+}
+
+/**
+ * Stop the capture and exit continuous read mode. The frames of an
+ * incomplete burst are buffered.
+ * @param dev - The device structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad77681_capture_stop(struct ad77681_dev *dev)
+{
+	struct ad77681_capture *cap;
+
+	if (!dev || !dev->capture)
+		return -EINVAL;
+
+	cap = dev->capture;
+	if (!cap->running)
+		return 0;
+
+	cap->running = false;
+	if (cap->fill) {
+		ad77681_capture_push(dev, cap->raw, cap->fill,
+				     AD77681_FRAME_PACKED);
+		cap->fill = 0;
+	}
+
+	return ad77681_set_continuos_read(dev, AD77681_CONTINUOUS_READ_DISABLE);
+}
+
+/**
+ * DRDY interrupt handler, to be registered with the device as context.
+ * Reads one frame, and validates and buffers the frames once a burst is
+ * complete, so the checksums and the unpacking run in one pass per burst.
+ * @param ctx - The device structure.
+ * @param event - Unused.
+ * @param extra - Unused.
+ */
+void ad77681_capture_drdy_handler(void *ctx, uint32_t event, void *extra)
+{
+	struct ad77681_dev *dev = ctx;
+	struct ad77681_capture *cap = dev->capture;
+	uint8_t *frame;
+
+	if (!cap || !cap->running)
+		return;
+
+	/* Keep SDI low, the exit key must not be sent by accident */
+	frame = cap->raw + cap->fill * cap->frame_len;
+	memset(frame, 0, cap->frame_len);
+	if (spi_write_and_read(dev->spi_desc, frame, cap->frame_len) < 0) {
+		cap->spi_errors++;
+		return;
+	}
+
+	if (++cap->fill < cap->burst_len)
+		return;
+
+	cap->fill = 0;
+	ad77681_capture_push(dev, cap->raw, cap->burst_len,
+			     AD77681_FRAME_PACKED);
+}
+
+/**
+ * Validate and unpack frames, dropping the ones with a wrong checksum.
+ * @param dev - The device structure.
+ * @param frames - Frames, in the given layout.
+ * @param nb_frames - Number of frames.
+ * @param layout - Frame layout.
+ * @param samples - Unpacked samples.
+ * @return Number of valid samples.
+ */
+static uint32_t ad77681_capture_unpack(struct ad77681_dev *dev,
+				       const uint8_t *frames,
+				       uint32_t nb_frames,
+				       enum ad77681_frame_layout layout,
+				       int32_t *samples)
+{
+	struct ad77681_capture *cap = dev->capture;
+	uint8_t len = cap->frame_len, word[AD77681_CAPTURE_MAX_FRAME];
+	const uint8_t *frame;
+	uint32_t i, n = 0;
+	uint8_t j, check;
+	uint64_t w;
+
+	for (i = 0; i < nb_frames; i++) {
+		if (layout == AD77681_FRAME_PACKED) {
+			frame = frames + i * len;
+		} else {
+			/* Move the frame to the top of a 64-bit word */
+			if (layout == AD77681_FRAME_WORD64)
+				w = ((const uint64_t *)frames)[i];
+			else
+				w = (uint64_t)((const uint32_t *)frames)[i] << 32;
+			for (j = 0; j < len; j++)
+				word[j] = w >> (56 - 8 * j);
+			frame = word;
+		}
+
+		if (dev->crc_sel == AD77681_CRC) {
+			check = crc8(crc8_table_07, frame, len - 1,
+				     INITIAL_CRC_CRC8);
+			if (check != frame[len - 1]) {
+				cap->crc_errors++;
+				continue;
+			}
+		} else if (dev->crc_sel == AD77681_XOR) {
+			check = INITIAL_CRC_XOR;
+			for (j = 0; j < len - 1; j++)
+				check ^= frame[j];
+			if (check != frame[len - 1]) {
+				cap->crc_errors++;
+				continue;
+			}
+		}
+
+		if (dev->conv_len == AD77681_CONV_24BIT)
+			samples[n++] = (int32_t)(((uint32_t)frame[0] << 24) |
+						 (frame[1] << 16) |
+						 (frame[2] << 8)) >> 8;
+		else
+			samples[n++] = (int16_t)((frame[0] << 8) | frame[1]);
+	}
+
+	return n;
+}
+
+/**
+ * Validate continuous read frames and buffer their samples. Used by the
+ * DRDY handler, or directly with the buffer filled by the SPI Engine offload.
+ * The offload itself is not set up by the driver.
+ * @param dev - The device structure.
+ * @param frames - Frames, in the given layout.
+ * @param nb_frames - Number of frames.
+ * @param layout - Frame layout.
+ * @return 0 in case of success, -EINVAL if the frames do not fit the
+ *         layout, negative error code otherwise.
+ */
+int32_t ad77681_capture_push(struct ad77681_dev *dev,
+			     const void *frames,
+			     uint32_t nb_frames,
+			     enum ad77681_frame_layout layout)
+{
+	struct ad77681_capture *cap;
+	const uint8_t *src = frames;
+	uint32_t n, nb, used, room, stride;
+	int32_t ret;
+
+	if (!dev || !dev->capture || !frames)
+		return -EINVAL;
+
+	cap = dev->capture;
+	if (!cap->frame_len)
+		cap->frame_len = ad77681_get_frame_byte(dev);
+
+	switch (layout) {
+	case AD77681_FRAME_PACKED:
+		stride = cap->frame_len;
+		break;
+	case AD77681_FRAME_WORD32:
+		stride = sizeof(uint32_t);
+		break;
+	case AD77681_FRAME_WORD64:
+		stride = sizeof(uint64_t);
+		break;
+	default:
+		return -EINVAL;
+	}
+	if (cap->frame_len > stride)
+		return -EINVAL;
+
+	while (nb_frames) {
+		n = min(nb_frames, cap->burst_len);
+		nb = ad77681_capture_unpack(dev, src, n, layout, cap->samples);
+		src += n * stride;
+		nb_frames -= n;
+
+		ret = cb_size(cap->ring, &used);
+		if (ret < 0)
+			return ret;
+
+		/* Drop the newest samples instead of overwriting unread ones */
+		room = (cap->ring->size - used) / sizeof(int32_t);
+		if (nb > room) {
+			cap->overruns += nb - room;
+			nb = room;
+		}
+		if (!nb)
+			continue;
+
+		ret = cb_write(cap->ring, cap->samples, nb * sizeof(int32_t));
+		if (ret < 0)
+			return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * Get the number of captured samples.
+ * @param dev - The device structure.
+ * @param nb_samples - Number of samples available.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad77681_capture_available(struct ad77681_dev *dev,
+				  uint32_t *nb_samples)
+{
+	uint32_t size;
+	int32_t ret;
+
+	if (!dev || !dev->capture || !nb_samples)
+		return -EINVAL;
+
+	ret = cb_size(dev->capture->ring, &size);
+	*nb_samples = size / sizeof(int32_t);
+
+	return ret;
+}
+
+/**
+ * Copy captured samples.
+ * @param dev - The device structure.
+ * @param data - Destination buffer.
+ * @param nb_samples - Number of samples to copy.
+ * @return 0 in case of success, -EAGAIN if not enough samples are
+ *         available, negative error code otherwise.
+ */
+int32_t ad77681_capture_read(struct ad77681_dev *dev,
+			     int32_t *data,
+			     uint32_t nb_samples)
+{
+	uint32_t available;
+	int32_t ret;
+
+	ret = ad77681_capture_available(dev, &available);
+	if (ret < 0)
+		return ret;
+
+	if (available < nb_samples)
+		return -EAGAIN;
+
+	return cb_read(dev->capture->ring, data, nb_samples * sizeof(int32_t));
+}
@@ -40,7 +40,10 @@
 #ifndef SRC_AD77681_H_
 #define SRC_AD77681_H_
 
+#include <stdbool.h>
 #include "no-os/spi.h"
+#include "no-os/crc8.h"
+#include "no-os/circular_buffer.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -330,11 +333,13 @@
 #define INITIAL_CRC_XOR							0x6C
 #define INITIAL_CRC								0x00
 
-#define CRC_DEBUG
+/* Define CRC_DEBUG to print the CRC/XOR check of every read */
 
 /* AD7768-1 */
 /* A special key for exit the contiuous read mode, taken from the AD7768-1 datasheet */
 #define EXIT_CONT_READ							0x6C
+/* Longest continuous read frame: 24bit data + status + CRC */
+#define AD77681_CAPTURE_MAX_FRAME					5
 /* Bit resolution of the AD7768-1 */
 #define AD7768_N_BITS							24
 /* Full scale of the AD7768-1 = 2^24 = 16777216 */
@@ -527,6 +532,50 @@ struct ad77681_status_registers {
 	bool							fuse_crc_error;
 };
 
+/* Layout of the frames given to ad77681_capture_push(). The driver does not
+ * set up the SPI Engine offload, the project does (see ad7768-1fmcz) and
+ * passes the DMA buffer to ad77681_capture_push(). */
+enum ad77681_frame_layout {
+	/* Frames back to back, as read over SPI. Any frame length */
+	AD77681_FRAME_PACKED,
+	/* One frame per 32-bit word, MSB aligned, as written by the SPI Engine
+	 * offload with a 32-bit data width. Frames of up to 4 bytes */
+	AD77681_FRAME_WORD32,
+	/* One frame per 64-bit word, MSB aligned, as written by the SPI Engine
+	 * offload with a 64-bit data width. Needed for 5 byte frames (24-bit
+	 * data, status and CRC) */
+	AD77681_FRAME_WORD64,
+};
+
+struct ad77681_capture_init_param {
+	/* Samples read on DRDY before they are validated and buffered */
+	uint32_t	burst_len;
+	/* Number of samples the ring can hold */
+	uint32_t	ring_len;
+};
+
+/* Block capture in continuous read mode */
+struct ad77681_capture {
+	/* Validated samples, sign extended to int32 */
+	struct circular_buffer	*ring;
+	/* Frames read from the DRDY interrupt */
+	uint8_t			*raw;
+	/* Samples of one burst, before they are pushed in the ring */
+	int32_t			*samples;
+	uint32_t		burst_len;
+	/* Number of frames in raw */
+	uint32_t		fill;
+	/* Bytes per frame */
+	uint8_t			frame_len;
+	volatile bool		running;
+	/* Frames dropped because of a CRC/XOR mismatch */
+	volatile uint32_t	crc_errors;
+	/* Samples dropped because the ring was full */
+	volatile uint32_t	overruns;
+	/* Failed SPI reads */
+	volatile uint32_t	spi_errors;
+};
+
 struct ad77681_dev {
 	/* SPI */
 	spi_desc			*spi_desc;
@@ -551,6 +600,8 @@ struct ad77681_dev {
 	uint16_t                        mclk;               /* Mater clock*/
 	uint32_t                        sample_rate;        /* Sample rate*/
 	uint8_t                         data_frame_byte;    /* SPI 8bit frames*/
+	uint32_t                        crc_errors;         /* Data read CRC errors*/
+	struct ad77681_capture          *capture;           /* Block capture*/
 };
 
 struct ad77681_init_param {
@@ -680,4 +731,19 @@ int32_t ad77681_SINC3_ODR(struct ad77681_dev *dev,
 			  float sinc3_odr);
 int32_t ad77681_status(struct ad77681_dev *dev,
 		       struct ad77681_status_registers *status);
+int32_t ad77681_capture_init(struct ad77681_dev *dev,
+			     const struct ad77681_capture_init_param *param);
+int32_t ad77681_capture_remove(struct ad77681_dev *dev);
+int32_t ad77681_capture_start(struct ad77681_dev *dev);
+int32_t ad77681_capture_stop(struct ad77681_dev *dev);
+void ad77681_capture_drdy_handler(void *ctx, uint32_t event, void *extra);
+int32_t ad77681_capture_push(struct ad77681_dev *dev,
+			     const void *frames,
+			     uint32_t nb_frames,
+			     enum ad77681_frame_layout layout);
+int32_t ad77681_capture_available(struct ad77681_dev *dev,
+				  uint32_t *nb_samples);
+int32_t ad77681_capture_read(struct ad77681_dev *dev,
+			     int32_t *data,
+			     uint32_t nb_samples);
 #endif /* SRC_AD77681_H_ */
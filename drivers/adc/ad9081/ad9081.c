@@ -45,6 +45,7 @@
 #include "adi_cms_api_common.h"
 #include "no-os/util.h"
 #include "no-os/delay.h"
+#include "no-os/trace.h"
 #include "adi_ad9081_hal.h"
 #include "ad9081.h"
 
@@ -1090,7 +1091,9 @@ int32_t ad9081_init(struct ad9081_phy **dev,
 	if (ret < 0)
 		goto error_3;
 
+	TRACE_BEGIN(TRACE_EV_AD9081_RESET, 0);
 	ret = adi_ad9081_device_reset(&phy->ad9081, AD9081_HARD_RESET_AND_INIT);
+	TRACE_END(TRACE_EV_AD9081_RESET, ret);
 	if (ret < 0) {
 		printf("%s: reset/init failed (%"PRId32")\n", __func__, ret);
 		goto error_3;
@@ -1109,7 +1112,9 @@ int32_t ad9081_init(struct ad9081_phy **dev,
 		goto error_3;
 	}
 
+	TRACE_BEGIN(TRACE_EV_AD9081_SETUP, 0);
 	ret = ad9081_setup(phy);
+	TRACE_END(TRACE_EV_AD9081_SETUP, ret);
 	if (ret < 0) {
 		printf("%s: ad9081_setup failed (%"PRId32")\n", __func__, ret);
 		goto error_3;
@@ -45,6 +45,8 @@
 #include <string.h>
 #include <stdlib.h>
 #include "adc_demo.h"
+#include "iio.h"
+#include "no-os/delay.h"
 #include "no-os/error.h"
 #include "no-os/util.h"
 
@@ -68,6 +70,49 @@ const uint16_t sine_lut[128] = {
 	0xCF0, 0xD4E, 0xDAD, 0xE0E, 0xE70, 0xED3, 0xF37, 0xF9B
 };
 
+/* One period of a full scale sine, used by the sine pattern */
+static const int16_t adc_demo_sine[256] = {
+	0, 804, 1608, 2410, 3212, 4011, 4808, 5602,
+	6393, 7179, 7962, 8739, 9512, 10278, 11039, 11793,
+	12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+	18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+	23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+	27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+	30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+	32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+	32767, 32757, 32728, 32678, 32609, 32521, 32412, 32285,
+	32137, 31971, 31785, 31580, 31356, 31113, 30852, 30571,
+	30273, 29956, 29621, 29268, 28898, 28510, 28105, 27683,
+	27245, 26790, 26319, 25832, 25329, 24811, 24279, 23731,
+	23170, 22594, 22005, 21403, 20787, 20159, 19519, 18868,
+	18204, 17530, 16846, 16151, 15446, 14732, 14010, 13279,
+	12539, 11793, 11039, 10278, 9512, 8739, 7962, 7179,
+	6393, 5602, 4808, 4011, 3212, 2410, 1608, 804,
+	0, -804, -1608, -2410, -3212, -4011, -4808, -5602,
+	-6393, -7179, -7962, -8739, -9512, -10278, -11039, -11793,
+	-12539, -13279, -14010, -14732, -15446, -16151, -16846, -17530,
+	-18204, -18868, -19519, -20159, -20787, -21403, -22005, -22594,
+	-23170, -23731, -24279, -24811, -25329, -25832, -26319, -26790,
+	-27245, -27683, -28105, -28510, -28898, -29268, -29621, -29956,
+	-30273, -30571, -30852, -31113, -31356, -31580, -31785, -31971,
+	-32137, -32285, -32412, -32521, -32609, -32678, -32728, -32757,
+	-32767, -32757, -32728, -32678, -32609, -32521, -32412, -32285,
+	-32137, -31971, -31785, -31580, -31356, -31113, -30852, -30571,
+	-30273, -29956, -29621, -29268, -28898, -28510, -28105, -27683,
+	-27245, -26790, -26319, -25832, -25329, -24811, -24279, -23731,
+	-23170, -22594, -22005, -21403, -20787, -20159, -19519, -18868,
+	-18204, -17530, -16846, -16151, -15446, -14732, -14010, -13279,
+	-12539, -11793, -11039, -10278, -9512, -8739, -7962, -7179,
+	-6393, -5602, -4808, -4011, -3212, -2410, -1608, -804,
+};
+
+const char * const adc_demo_pattern_names[] = {
+	[ADC_DEMO_PATTERN_TABLE] = "table",
+	[ADC_DEMO_PATTERN_RAMP] = "ramp",
+	[ADC_DEMO_PATTERN_PRBS] = "prbs",
+	[ADC_DEMO_PATTERN_SINE] = "sine",
+};
+
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
@@ -82,6 +127,8 @@ int32_t adc_demo_init(struct adc_demo_desc **desc,
 		      struct adc_demo_init_param *param)
 {
 	struct adc_demo_desc *adesc;
+	int32_t ret;
+
 	adesc = (struct adc_demo_desc*)calloc(1, sizeof(*adesc));
 
 	if(!adesc)
@@ -92,9 +139,40 @@ int32_t adc_demo_init(struct adc_demo_desc **desc,
 	for(int i = 0; i < TOTAL_ADC_CHANNELS; i++)
 		adesc->adc_ch_attr[i] = param->dev_ch_attr[i];
 	adesc->adc_global_attr = param->dev_global_attr;
+	adesc->nco_step = param->nco_step ? param->nco_step :
+			  ADC_DEMO_NCO_STEP(1, 128);
+	adesc->overrun_period = param->overrun_period;
+	interleave_plan_init(&adesc->plan, 0, sizeof(adc_demo_sample_t));
+
+	ret = adc_demo_set_pattern(adesc, param->pattern);
+	if (IS_ERR_VALUE(ret))
+		goto error;
+
+	if (param->timer_param_optional) {
+		ret = timer_init(&adesc->timer, param->timer_param_optional);
+		if (IS_ERR_VALUE(ret))
+			goto error;
+
+		ret = timer_start(adesc->timer);
+		if (IS_ERR_VALUE(ret))
+			goto error_timer;
+	}
+
+	ret = adc_demo_set_sample_rate(adesc, param->sample_rate);
+	if (IS_ERR_VALUE(ret))
+		goto error_timer;
+
 	*desc = adesc;
 
 	return SUCCESS;
+
+error_timer:
+	if (adesc->timer)
+		timer_remove(adesc->timer);
+error:
+	free(adesc);
+
+	return ret;
 }
 
 /**
@@ -107,11 +185,84 @@ int32_t adc_demo_remove(struct adc_demo_desc *desc)
 	if(!desc)
 		return -EINVAL;
 
+	if (desc->timer) {
+		timer_stop(desc->timer);
+		timer_remove(desc->timer);
+	}
+
 	free(desc);
 
 	return SUCCESS;
 }
 
+/**
+ * @brief Restart the generators of the active channels.
+ * @param desc - descriptor for the adc
+ */
+static void adc_demo_gen_reset(struct adc_demo_desc *desc)
+{
+	uint32_t j, ch;
+
+	desc->table_pos = 0;
+	for (j = 0; j < desc->plan.nb_ch; j++) {
+		ch = desc->plan.ch[j];
+		switch (desc->pattern) {
+		case ADC_DEMO_PATTERN_RAMP:
+			desc->gen[j] = ch;
+			break;
+		case ADC_DEMO_PATTERN_PRBS:
+			/* Different non zero seeds */
+			desc->gen[j] = 0x7FFFFFFF - ch * 0x01000193;
+			break;
+		case ADC_DEMO_PATTERN_SINE:
+			desc->gen[j] = ((uint64_t)ch << 32) / TOTAL_ADC_CHANNELS;
+			break;
+		default:
+			desc->gen[j] = 0;
+			break;
+		}
+	}
+}
+
+/**
+ * @brief Select the generated data. The generators restart.
+ * @param desc - descriptor for the adc
+ * @param pattern - new pattern
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t adc_demo_set_pattern(struct adc_demo_desc *desc,
+			     enum adc_demo_pattern pattern)
+{
+	if (!desc || pattern > ADC_DEMO_PATTERN_SINE)
+		return -EINVAL;
+
+	desc->pattern = pattern;
+	adc_demo_gen_reset(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Set the rate at which the buffers are filled.
+ * @param desc - descriptor for the adc
+ * @param rate - samples per second of each channel, 0 for no pacing
+ * @return SUCCESS in case of success, -ENODEV if pacing is requested without
+ *         a timer.
+ */
+int32_t adc_demo_set_sample_rate(struct adc_demo_desc *desc, uint32_t rate)
+{
+	if (!desc)
+		return -EINVAL;
+
+	if (rate && !desc->timer)
+		return -ENODEV;
+
+	desc->sample_rate = rate;
+	desc->streaming = false;
+
+	return SUCCESS;
+}
+
 /**
  * @brief active adc channels
  * @param dev - descriptor for the adc
@@ -121,6 +272,7 @@ int32_t adc_demo_remove(struct adc_demo_desc *desc)
 int32_t update_adc_channels(void *dev, uint32_t mask)
 {
 	struct adc_demo_desc *desc;
+	int32_t ret;
 
 	if(!dev)
 		return -ENODEV;
@@ -130,6 +282,15 @@ int32_t update_adc_channels(void *dev, uint32_t mask)
 	desc->active_ch = mask;
 	/* If a real device. Here needs to be selected the channels to be read*/
 
+	ret = interleave_plan_init(&desc->plan, mask,
+				   sizeof(adc_demo_sample_t));
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	adc_demo_gen_reset(desc);
+	desc->streaming = false;
+	desc->nb_blocks = 0;
+
 	return SUCCESS;
 }
 
@@ -149,32 +310,139 @@ int32_t close_adc_channels(void* dev)
 
 	desc->active_ch = 0;
 
-	return SUCCESS;
+	return interleave_plan_init(&desc->plan, 0, sizeof(adc_demo_sample_t));
 }
 
 /**
- * @brief utility function for computing next upcoming channel
- * @param ch_mask - active channels .
- * @param last_idx -  previous index.
- * @param new_idx - upcoming channel index, return param.
- * @return 1 if there are more channels, 0 if done.
+ * @brief copy samples of the active channels from circular sources
+ * @param desc - descriptor for the adc
+ * @param buff - buffer of 16-bit frames to fill
+ * @param samples - number of samples of each channel
+ * @param base - source of channel 0
+ * @param stride - distance between the sources of consecutive channels
+ * @param phase - start offset between consecutive channels
+ * @param len - number of samples of a source, after which it wraps
  */
-static bool get_next_ch_idx(uint32_t ch_mask, uint32_t last_idx,
-			    uint32_t *new_idx)
+static void adc_demo_copy(struct adc_demo_desc *desc, uint16_t *buff,
+			  uint32_t samples, const uint16_t *base,
+			  uint32_t stride, uint32_t phase, uint32_t len)
 {
-	last_idx++;
-	ch_mask >>= last_idx;
-	if (!ch_mask) {
-		*new_idx = -1;
-		return 0;
+	const void *src[INTERLEAVE_MAX_CH];
+	uint32_t i, j, n, pos;
+
+	/* Interleave the longest run for which no source wraps */
+	for (i = 0; i < samples; i += n) {
+		n = samples - i;
+		for (j = 0; j < desc->plan.nb_ch; j++) {
+			pos = (desc->table_pos + i + desc->plan.ch[j] * phase) %
+			      len;
+			n = min(n, len - pos);
+			src[j] = base + desc->plan.ch[j] * stride + pos;
+		}
+		interleave_frames(&desc->plan, buff + i * desc->plan.nb_ch,
+				  src, n);
 	}
-	while (!(ch_mask & 1)) {
-		last_idx++;
-		ch_mask >>= 1;
+}
+
+/**
+ * @brief Sign extend a generated value to a sample.
+ * @param val - value, in its bits lsbs
+ * @param bits - number of bits of the value
+ * @return the sample.
+ */
+static inline adc_demo_sample_t adc_demo_sample(uint32_t val, uint32_t bits)
+{
+	return (int32_t)(val << (32 - bits)) >> (32 - bits);
+}
+
+/**
+ * @brief replay ext_buff or sine_lut
+ * @param desc - descriptor for the adc
+ * @param buff - buffer of frames to fill
+ * @param samples - number of samples of each channel
+ */
+static void adc_demo_fill_table(struct adc_demo_desc *desc,
+				adc_demo_sample_t *buff, uint32_t samples)
+{
+	const uint16_t *base;
+	uint32_t stride, phase, len;
+	uint32_t i, j, ch, pos;
+
+	if (desc->ext_buff == NULL || !desc->ext_buff_len) {
+		//default sine lookup table
+		base = sine_lut;
+		stride = 0;
+		phase = ARRAY_SIZE(sine_lut) / TOTAL_ADC_CHANNELS;
+		len = ARRAY_SIZE(sine_lut);
+	} else {
+		base = (const uint16_t *)desc->ext_buff;
+		stride = desc->ext_buff_len;
+		phase = 0;
+		len = desc->ext_buff_len;
 	}
-	*new_idx = last_idx;
 
-	return 1;
+	if (sizeof(*buff) == sizeof(uint16_t)) {
+		adc_demo_copy(desc, (uint16_t *)buff, samples, base, stride,
+			      phase, len);
+	} else {
+		/* The 12-bit values a 16-bit build sends, sign extended */
+		for (i = 0; i < samples; i++) {
+			for (j = 0; j < desc->plan.nb_ch; j++) {
+				ch = desc->plan.ch[j];
+				pos = (desc->table_pos + i + ch * phase) % len;
+				*buff++ = adc_demo_sample(base[ch * stride + pos], 12);
+			}
+		}
+	}
+
+	desc->table_pos = (desc->table_pos + samples) % len;
+}
+
+/**
+ * @brief generate samples of the active channels
+ * @param desc - descriptor for the adc
+ * @param buff - buffer of frames to fill
+ * @param samples - number of samples of each channel
+ */
+static void adc_demo_fill(struct adc_demo_desc *desc, adc_demo_sample_t *buff,
+			  uint32_t samples)
+{
+	const uint32_t bits = ADC_DEMO_REAL_BITS;
+	uint32_t nb_ch = desc->plan.nb_ch;
+	uint32_t *gen = desc->gen;
+	uint32_t i, j, s;
+
+	switch (desc->pattern) {
+	case ADC_DEMO_PATTERN_RAMP:
+		for (i = 0; i < samples; i++)
+			for (j = 0; j < nb_ch; j++)
+				*buff++ = adc_demo_sample(gen[j]++, bits);
+		break;
+	case ADC_DEMO_PATTERN_PRBS:
+		/* bits steps of the x^31 + x^28 + 1 LFSR at once */
+		for (i = 0; i < samples; i++) {
+			for (j = 0; j < nb_ch; j++) {
+				s = gen[j];
+				s = ((s >> (31 - bits)) ^ (s >> (28 - bits))) &
+				    (BIT(bits) - 1);
+				gen[j] = ((gen[j] << bits) | s) & 0x7FFFFFFF;
+				*buff++ = adc_demo_sample(s, bits);
+			}
+		}
+		break;
+	case ADC_DEMO_PATTERN_SINE:
+		for (i = 0; i < samples; i++) {
+			for (j = 0; j < nb_ch; j++) {
+				s = (uint32_t)adc_demo_sine[gen[j] >> 24] << 16;
+				gen[j] += desc->nco_step;
+				*buff++ = adc_demo_sample(s >> (32 - bits), bits);
+			}
+		}
+		break;
+	default:
+		adc_demo_fill_table(desc, buff, samples);
+		break;
+	}
 }
 
 /**
@@ -184,34 +452,137 @@ static bool get_next_ch_idx(uint32_t ch_mask, uint32_t last_idx,
  * @param samples - number of samples to receive
  * @return the number of samples.
  */
-int32_t adc_read_samples(void* dev, uint16_t* buff, uint32_t samples)
+int32_t adc_read_samples(void* dev, void* buff, uint32_t samples)
 {
-	struct adc_demo_desc *desc;
-	uint32_t k = 0;
-	uint32_t ch = -1;
-
 	if(!dev)
 		return -ENODEV;
 
-	desc = dev;
+	adc_demo_fill(dev, buff, samples);
 
-	if(desc->ext_buff == NULL) {
-		//default sine lookup table
-		int offset_per_ch = ARRAY_SIZE(sine_lut) / TOTAL_ADC_CHANNELS;
-		for(uint32_t i = 0; i < samples; i++) {
-			while(get_next_ch_idx(desc->active_ch, ch, &ch))
-				buff[k++] = sine_lut[(i + ch * offset_per_ch ) % ARRAY_SIZE(sine_lut)];
-		}
+	return samples;
+}
+
+/**
+ * @brief read the pacing timer
+ * @param desc - descriptor for the adc
+ * @param ticks - timer counts, extended to 64 bits
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t adc_demo_ticks(struct adc_demo_desc *desc, uint64_t *ticks)
+{
+	uint32_t counter;
+	int32_t ret;
+
+	ret = timer_counter_get(desc->timer, &counter);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	/* The counter must not wrap twice between two reads */
+	desc->ticks += counter - desc->last_counter;
+	desc->last_counter = counter;
+	*ticks = desc->ticks;
+
+	return SUCCESS;
+}
 
-		return samples;
+/**
+ * @brief time at which the last sample of the stream is captured
+ * @param desc - descriptor for the adc
+ * @return time in timer counts.
+ */
+static uint64_t adc_demo_due(struct adc_demo_desc *desc)
+{
+	uint64_t samples = desc->stream_samples;
+	uint32_t rate = desc->sample_rate;
+	uint32_t freq = desc->timer->freq_hz;
+
+	return desc->stream_start + samples / rate * freq +
+	       samples % rate * freq / rate;
+}
+
+/**
+ * @brief wait until a DMA capturing at sample_rate would have filled the
+ * buffer. If it would have been filled before this call, its data was
+ * overwritten while the host was away: this counts as an overrun and the
+ * stream restarts.
+ * @param desc - descriptor for the adc
+ * @param samples - number of samples of each channel in the buffer
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t adc_demo_pace(struct adc_demo_desc *desc, uint32_t samples)
+{
+	uint64_t now, due;
+	int32_t ret;
+
+	if (!desc->sample_rate)
+		return SUCCESS;
+
+	ret = adc_demo_ticks(desc, &now);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	desc->stream_samples += samples;
+	due = adc_demo_due(desc);
+	if (!desc->streaming || now > due) {
+		if (desc->streaming)
+			desc->overruns++;
+		desc->streaming = true;
+		desc->stream_start = now;
+		desc->stream_samples = samples;
+		due = adc_demo_due(desc);
 	}
 
-	for(uint32_t i = 0; i < samples; i++) {
-		while(get_next_ch_idx(desc->active_ch, ch, &ch))
-			buff[k++] = ((uint16_t (*)[desc->ext_buff_len])(desc->ext_buff))[ch]
-				    [i % desc->ext_buff_len];
+	while (now < due) {
+		udelay((due - now) * 1000000 / desc->timer->freq_hz);
+		ret = adc_demo_ticks(desc, &now);
+		if (IS_ERR_VALUE(ret))
+			return ret;
 	}
-	return samples;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief fill the iio buffer like a DMA would
+ * @param dev_data - device instance and iio buffer
+ * @return SUCCESS in case of success, -EOVERFLOW for an injected overrun,
+ *         negative error code otherwise.
+ */
+int32_t adc_submit_samples(struct iio_device_data *dev_data)
+{
+	struct adc_demo_desc *desc;
+	struct iio_buffer *buffer;
+	uint32_t samples;
+	void *buff;
+	int32_t ret;
+
+	if (!dev_data || !dev_data->dev)
+		return -ENODEV;
+
+	desc = dev_data->dev;
+	buffer = dev_data->buffer;
+
+	desc->nb_blocks++;
+	if (desc->overrun_period &&
+	    !(desc->nb_blocks % desc->overrun_period)) {
+		/* The buffer is lost and the stream restarts */
+		desc->overruns++;
+		desc->streaming = false;
+		return -EOVERFLOW;
+	}
+
+	ret = iio_buffer_get_block(buffer, &buff);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	samples = buffer->size / buffer->bytes_per_scan;
+	adc_demo_fill(desc, buff, samples);
+
+	ret = iio_buffer_block_done(buffer);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	return adc_demo_pace(desc, samples);
 }
 
 /**
@@ -44,19 +44,64 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 
+#include <stdbool.h>
 #include <stdint.h>
 #include "iio_types.h"
+#include "no-os/interleave.h"
+#include "no-os/timer.h"
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
 
 #define MAX_ADC_ADDR		16
-/* For testing a maximum of 16 channels can be enabled */
+/* Channels of the iio descriptor */
+#define ADC_DEMO_MAX_CHANNELS	32
+/* For testing a maximum of 32 channels can be enabled */
 #ifndef TOTAL_ADC_CHANNELS
 #define TOTAL_ADC_CHANNELS 2
 #endif
 
+#if TOTAL_ADC_CHANNELS > ADC_DEMO_MAX_CHANNELS
+#error "TOTAL_ADC_CHANNELS is larger than ADC_DEMO_MAX_CHANNELS"
+#endif
+
+/* Sample storage size, 16 or 32 bits */
+#ifndef ADC_DEMO_STORAGE_BITS
+#define ADC_DEMO_STORAGE_BITS	16
+#endif
+
+#if ADC_DEMO_STORAGE_BITS == 32
+#define ADC_DEMO_REAL_BITS	24
+typedef int32_t adc_demo_sample_t;
+#elif ADC_DEMO_STORAGE_BITS == 16
+#define ADC_DEMO_REAL_BITS	12
+typedef int16_t adc_demo_sample_t;
+#else
+#error "ADC_DEMO_STORAGE_BITS must be 16 or 32"
+#endif
+
+/* NCO phase increment for a tone of _tone_hz sampled at _rate_hz */
+#define ADC_DEMO_NCO_STEP(_tone_hz, _rate_hz) \
+	((uint32_t)(((uint64_t)(_tone_hz) << 32) / (_rate_hz)))
+
+/**
+ * @enum adc_demo_pattern
+ * @brief Data generated by the adc demo.
+ */
+enum adc_demo_pattern {
+	/** Replay ext_buff, or sine_lut if there is no ext_buff */
+	ADC_DEMO_PATTERN_TABLE,
+	/** Incremented with each sample, channel n starts from n */
+	ADC_DEMO_PATTERN_RAMP,
+	/** PRBS31 (x^31 + x^28 + 1), ADC_DEMO_REAL_BITS bits per sample, msb
+	 *  first. Each channel has its own seed. */
+	ADC_DEMO_PATTERN_PRBS,
+	/** Sine from a phase accumulator. Channel n is delayed by n periods /
+	 *  TOTAL_ADC_CHANNELS. */
+	ADC_DEMO_PATTERN_SINE,
+};
+
 /**
  * @struct iio_demo_adc_desc
  * @brief Desciptor.
@@ -67,13 +112,43 @@ struct adc_demo_desc {
 	/** Demo global device attribute */
 	uint32_t adc_global_attr;
 	/** Demo device channel attribute */
-	uint32_t adc_ch_attr[MAX_ADC_ADDR];
+	uint32_t adc_ch_attr[ADC_DEMO_MAX_CHANNELS];
 	/** Active channel**/
 	uint32_t active_ch;
+	/** Kernels for the active channels */
+	struct interleave_plan plan;
 	/** Number of samples in each buffer */
 	uint32_t ext_buff_len;
 	/** Array of buffers for each channel*/
 	uint16_t **ext_buff;
+	/** Generated data */
+	enum adc_demo_pattern pattern;
+	/** Generator state of each active channel: counter, LFSR or phase */
+	uint32_t gen[ADC_DEMO_MAX_CHANNELS];
+	/** Position in ext_buff or sine_lut */
+	uint32_t table_pos;
+	/** NCO phase increment of the sine pattern */
+	uint32_t nco_step;
+	/** Samples per second of each channel. 0 fills buffers at once. */
+	uint32_t sample_rate;
+	/** Timer used to pace the buffers */
+	struct timer_desc *timer;
+	/** Timer counts, extended to 64 bits */
+	uint64_t ticks;
+	/** Last timer counter value */
+	uint32_t last_counter;
+	/** Set when the pacing time reference is valid */
+	bool streaming;
+	/** Time (timer counts) when the stream started */
+	uint64_t stream_start;
+	/** Samples of each channel captured since stream_start */
+	uint64_t stream_samples;
+	/** One buffer refill in overrun_period fails. 0 never fails. */
+	uint32_t overrun_period;
+	/** Buffer refills since the buffer was enabled */
+	uint32_t nb_blocks;
+	/** Lost buffers, injected or not refilled in time */
+	uint32_t overruns;
 };
 
 /**
@@ -84,18 +159,38 @@ struct adc_demo_init_param {
 	/** Demo global dac attribute */
 	uint32_t dev_global_attr;
 	/** Demo dac channel attribute */
-	uint32_t dev_ch_attr[MAX_ADC_ADDR];
+	uint32_t dev_ch_attr[ADC_DEMO_MAX_CHANNELS];
 	/** Number of samples in each buffer */
 	uint32_t ext_buff_len;
 	/**Array of buffers for each channel*/
 	uint16_t **ext_buff;
+	/** Generated data */
+	enum adc_demo_pattern pattern;
+	/** NCO phase increment of the sine pattern, see ADC_DEMO_NCO_STEP().
+	 *  0 selects a period of 128 samples. */
+	uint32_t nco_step;
+	/** Samples per second of each channel, 0 for no pacing */
+	uint32_t sample_rate;
+	/** Up counting timer pacing the buffers. Needed for sample_rate. */
+	struct timer_init_param *timer_param_optional;
+	/** One buffer refill in overrun_period fails with -EOVERFLOW. 0 never
+	 *  fails. */
+	uint32_t overrun_period;
 };
 
 enum iio_adc_demo_attributes {
 	ADC_CHANNEL_ATTR,
 	ADC_GLOBAL_ATTR,
+	ADC_SAMPLING_FREQUENCY,
+	ADC_PATTERN,
+	ADC_PATTERN_AVAILABLE,
+	ADC_NCO_STEP,
+	ADC_OVERRUN_PERIOD,
+	ADC_OVERRUNS,
 };
 
+extern const char * const adc_demo_pattern_names[];
+
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
@@ -109,7 +204,14 @@ int32_t update_adc_channels(void *dev, uint32_t mask);
 
 int32_t close_adc_channels(void* dev);
 
-int32_t adc_read_samples(void* dev, uint16_t* buff, uint32_t samples);
+int32_t adc_read_samples(void* dev, void* buff, uint32_t samples);
+
+int32_t adc_submit_samples(struct iio_device_data *dev_data);
+
+int32_t adc_demo_set_pattern(struct adc_demo_desc *desc,
+			     enum adc_demo_pattern pattern);
+
+int32_t adc_demo_set_sample_rate(struct adc_demo_desc *desc, uint32_t rate);
 
 int32_t adc_demo_reg_read(struct adc_demo_desc *desc, uint8_t reg_index,
 			  uint8_t *readval);
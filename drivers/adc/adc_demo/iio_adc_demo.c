@@ -40,6 +40,7 @@
 #include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "no-os/error.h"
 #include "no-os/util.h"
 #include "iio_adc_demo.h"
@@ -57,6 +58,7 @@ int get_adc_demo_attr(void *device, char *buf, uint32_t len,
 		      const struct iio_ch_info *channel, intptr_t attr_id)
 {
 	struct adc_demo_desc *desc;
+	uint32_t i;
 
 	if(!device)
 		return -ENODEV;
@@ -68,6 +70,23 @@ int get_adc_demo_attr(void *device, char *buf, uint32_t len,
 		return snprintf(buf,len,"%"PRIu32"",desc->adc_global_attr);
 	case ADC_CHANNEL_ATTR:
 		return snprintf(buf,len,"%"PRIu32"",desc->adc_ch_attr[channel->ch_num]);
+	case ADC_SAMPLING_FREQUENCY:
+		return snprintf(buf,len,"%"PRIu32"",desc->sample_rate);
+	case ADC_PATTERN:
+		return snprintf(buf,len,"%s",adc_demo_pattern_names[desc->pattern]);
+	case ADC_PATTERN_AVAILABLE:
+		strcpy(buf, "");
+		for (i = 0; i <= ADC_DEMO_PATTERN_SINE; i++) {
+			strcat(buf, adc_demo_pattern_names[i]);
+			strcat(buf, " ");
+		}
+		return strlen(buf);
+	case ADC_NCO_STEP:
+		return snprintf(buf,len,"%"PRIu32"",desc->nco_step);
+	case ADC_OVERRUN_PERIOD:
+		return snprintf(buf,len,"%"PRIu32"",desc->overrun_period);
+	case ADC_OVERRUNS:
+		return snprintf(buf,len,"%"PRIu32"",desc->overruns);
 	default:
 		return -EINVAL;
 	}
@@ -89,6 +108,8 @@ int set_adc_demo_attr(void *device, char *buf, uint32_t len,
 {
 	struct adc_demo_desc *desc;
 	uint32_t value = srt_to_uint32(buf);
+	int32_t ret;
+	uint32_t i;
 
 	if(!device)
 		return -ENODEV;
@@ -102,6 +123,29 @@ int set_adc_demo_attr(void *device, char *buf, uint32_t len,
 	case ADC_CHANNEL_ATTR:
 		desc->adc_ch_attr[channel->ch_num] = value;
 		return len;
+	case ADC_SAMPLING_FREQUENCY:
+		ret = adc_demo_set_sample_rate(desc, value);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+		return len;
+	case ADC_PATTERN:
+		for (i = 0; i <= ADC_DEMO_PATTERN_SINE; i++)
+			if (!strncmp(buf, adc_demo_pattern_names[i],
+				     strlen(adc_demo_pattern_names[i])))
+				break;
+		ret = adc_demo_set_pattern(desc, i);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+		return len;
+	case ADC_NCO_STEP:
+		desc->nco_step = value;
+		return len;
+	case ADC_OVERRUN_PERIOD:
+		desc->overrun_period = value;
+		return len;
+	case ADC_OVERRUNS:
+		desc->overruns = 0;
+		return len;
 	default:
 		return -EINVAL;
 	}
@@ -118,8 +162,8 @@ int set_adc_demo_attr(void *device, char *buf, uint32_t len,
 
 struct scan_type adc_scan_type = {
 	.sign = 's',
-	.realbits = 12,
-	.storagebits = 16,
+	.realbits = ADC_DEMO_REAL_BITS,
+	.storagebits = ADC_DEMO_STORAGE_BITS,
 	.shift = 0,
 	.is_big_endian = false
 };
@@ -131,6 +175,12 @@ struct iio_attribute adc_channel_attributes[] = {
 
 struct iio_attribute iio_adc_global_attributes[] = {
 	ADC_DEMO_ATTR("adc_global_attr", ADC_GLOBAL_ATTR),
+	ADC_DEMO_ATTR("sampling_frequency", ADC_SAMPLING_FREQUENCY),
+	ADC_DEMO_ATTR("pattern", ADC_PATTERN),
+	ADC_DEMO_ATTR("pattern_available", ADC_PATTERN_AVAILABLE),
+	ADC_DEMO_ATTR("nco_step", ADC_NCO_STEP),
+	ADC_DEMO_ATTR("overrun_period", ADC_OVERRUN_PERIOD),
+	ADC_DEMO_ATTR("overruns", ADC_OVERRUNS),
 	END_ATTRIBUTES_ARRAY,
 };
 
@@ -162,6 +212,22 @@ static struct iio_channel iio_adc_channels[] = {
 	IIO_DEMO_ADC_CHANNEL(13),
 	IIO_DEMO_ADC_CHANNEL(14),
 	IIO_DEMO_ADC_CHANNEL(15),
+	IIO_DEMO_ADC_CHANNEL(16),
+	IIO_DEMO_ADC_CHANNEL(17),
+	IIO_DEMO_ADC_CHANNEL(18),
+	IIO_DEMO_ADC_CHANNEL(19),
+	IIO_DEMO_ADC_CHANNEL(20),
+	IIO_DEMO_ADC_CHANNEL(21),
+	IIO_DEMO_ADC_CHANNEL(22),
+	IIO_DEMO_ADC_CHANNEL(23),
+	IIO_DEMO_ADC_CHANNEL(24),
+	IIO_DEMO_ADC_CHANNEL(25),
+	IIO_DEMO_ADC_CHANNEL(26),
+	IIO_DEMO_ADC_CHANNEL(27),
+	IIO_DEMO_ADC_CHANNEL(28),
+	IIO_DEMO_ADC_CHANNEL(29),
+	IIO_DEMO_ADC_CHANNEL(30),
+	IIO_DEMO_ADC_CHANNEL(31),
 };
 
 struct iio_device const adc_demo_iio_descriptor = {
@@ -172,7 +238,7 @@ struct iio_device const adc_demo_iio_descriptor = {
 	.buffer_attributes = NULL,
 	.pre_enable = update_adc_channels,
 	.post_disable = close_adc_channels,
-	.read_dev = (int32_t (*)())adc_read_samples,
+	.submit = adc_submit_samples,
 	.debug_reg_read = (int32_t (*)()) adc_demo_reg_read,
 	.debug_reg_write = (int32_t (*)()) adc_demo_reg_write
 };
@@ -45,6 +45,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "ad4110.h"
+#include "no-os/crc8.h"
 #include "no-os/error.h"
 #include "no-os/irq.h"
 #include "no-os/print_log.h"
@@ -63,21 +64,7 @@
 uint8_t ad4110_compute_crc8(uint8_t *data,
 			    uint8_t data_size)
 {
-	uint8_t i;
-	uint8_t crc = 0;
-
-	while (data_size) {
-		for (i = 0x80; i != 0; i >>= 1) {
-			if (((crc & 0x80) != 0) != ((*data & i) != 0)) {
-				crc <<= 1;
-				crc ^= AD4110_CRC8_POLY;
-			} else
-				crc <<= 1;
-		}
-		data++;
-		data_size--;
-	}
-	return crc;
+	return crc8(crc8_table_07, data, data_size, 0);
 }
 
 /***************************************************************************//**
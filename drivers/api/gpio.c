@@ -40,6 +40,7 @@
 #include <inttypes.h>
 #include "no-os/gpio.h"
 #include <stdlib.h>
+#include <stdbool.h>
 #include "no-os/error.h"
 
 /******************************************************************************/
@@ -182,3 +183,98 @@ int32_t gpio_get_value(struct gpio_desc *desc,
 	else
 		return SUCCESS;
 }
+
+/**
+ * @brief Check if the values of several GPIOs can be accessed with a single
+ * call to the platform.
+ * @param desc - Array of GPIO descriptors.
+ * @param num - Number of descriptors.
+ * @param set - true for gpio_ops_set_values, false for gpio_ops_get_values.
+ * @return true if all the descriptors are valid, use the same platform ops and
+ *         these implement the batch access.
+ */
+static bool gpio_batch_supported(struct gpio_desc **desc, uint8_t num,
+				 bool set)
+{
+	const struct gpio_platform_ops *ops;
+	uint8_t i;
+
+	if (!num || !desc[0])
+		return false;
+
+	ops = desc[0]->platform_ops;
+	if (set ? !ops->gpio_ops_set_values : !ops->gpio_ops_get_values)
+		return false;
+
+	for (i = 1; i < num; i++)
+		if (!desc[i] || desc[i]->platform_ops != ops)
+			return false;
+
+	return true;
+}
+
+/**
+ * @brief Set the values of several GPIOs. Platforms that implement
+ * gpio_ops_set_values can set lines of the same port or chip at once,
+ * otherwise the GPIOs are set one by one.
+ * @param desc - Array of GPIO descriptors. NULL entries are skipped.
+ * @param num - Number of descriptors.
+ * @param values - The values, values[i] for desc[i].
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t gpio_set_values(struct gpio_desc **desc, uint8_t num,
+			const uint8_t *values)
+{
+	int32_t ret;
+	uint8_t i;
+
+	if (!desc || !values)
+		return FAILURE;
+
+	if (gpio_batch_supported(desc, num, true))
+		return desc[0]->platform_ops->gpio_ops_set_values(desc, num,
+				values);
+
+	for (i = 0; i < num; i++) {
+		ret = gpio_set_value(desc[i], values[i]);
+		if (ret != SUCCESS)
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the values of several GPIOs. Platforms that implement
+ * gpio_ops_get_values can read lines of the same port or chip at once,
+ * otherwise the GPIOs are read one by one.
+ * @param desc - Array of GPIO descriptors. NULL entries read as 0.
+ * @param num - Number of descriptors.
+ * @param values - The values, values[i] for desc[i].
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t gpio_get_values(struct gpio_desc **desc, uint8_t num,
+			uint8_t *values)
+{
+	int32_t ret;
+	uint8_t i;
+
+	if (!desc || !values)
+		return FAILURE;
+
+	if (gpio_batch_supported(desc, num, false))
+		return desc[0]->platform_ops->gpio_ops_get_values(desc, num,
+				values);
+
+	for (i = 0; i < num; i++) {
+		if (!desc[i]) {
+			values[i] = 0;
+			continue;
+		}
+		ret = gpio_get_value(desc[i], &values[i]);
+		if (ret != SUCCESS)
+			return ret;
+	}
+
+	return SUCCESS;
+}
@@ -109,3 +109,53 @@ int32_t i2c_read(struct i2c_desc *desc,
 	return desc->platform_ops->i2c_ops_read(desc, data, bytes_number,
 						stop_bit);
 }
+
+/**
+ * @brief Queue an array of reads/writes and return without waiting for them
+ * to finish. Platforms without native support perform the transfer
+ * synchronously and call the callback before returning.
+ * @param desc - The I2C descriptor.
+ * @param xfers - Array of reads/writes. The array and the buffers it
+ *                references must stay valid until the callback is called.
+ * @param len - Number of elements in the array.
+ * @param callback - Called with the transfer status when all the elements are
+ *                   transferred. May be called from interrupt or thread
+ *                   context.
+ * @param ctx - Parameter passed to the callback.
+ * @return SUCCESS if the transfer was queued, -EBUSY if the platform queue is
+ *         full, negative error code otherwise.
+ */
+int32_t i2c_transfer_async(struct i2c_desc *desc,
+			   struct i2c_xfer *xfers,
+			   uint32_t len,
+			   void (*callback)(void *ctx, int32_t status),
+			   void *ctx)
+{
+	int32_t ret = SUCCESS;
+	uint32_t i;
+
+	if (!desc || !desc->platform_ops)
+		return -EINVAL;
+
+	if (desc->platform_ops->i2c_ops_transfer_async)
+		return desc->platform_ops->i2c_ops_transfer_async(desc, xfers,
+				len, callback, ctx);
+
+	for (i = 0; i < len; i++) {
+		if (xfers[i].read)
+			ret = i2c_read(desc, xfers[i].data,
+				       xfers[i].bytes_number,
+				       xfers[i].stop_bit);
+		else
+			ret = i2c_write(desc, xfers[i].data,
+					xfers[i].bytes_number,
+					xfers[i].stop_bit);
+		if (ret != SUCCESS)
+			break;
+	}
+
+	if (callback)
+		callback(ctx, ret);
+
+	return SUCCESS;
+}
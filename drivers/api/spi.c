@@ -41,6 +41,7 @@
 #include "no-os/spi.h"
 #include <stdlib.h>
 #include "no-os/error.h"
+#include "no-os/trace.h"
 
 /**
  * @brief Initialize the SPI communication peripheral.
@@ -83,7 +84,13 @@ int32_t spi_write_and_read(struct spi_desc *desc,
 			   uint8_t *data,
 			   uint16_t bytes_number)
 {
-	return desc->platform_ops->write_and_read(desc, data, bytes_number);
+	int32_t ret;
+
+	TRACE_BEGIN(TRACE_EV_SPI, (desc->chip_select << 16) | bytes_number);
+	ret = desc->platform_ops->write_and_read(desc, data, bytes_number);
+	TRACE_END(TRACE_EV_SPI, ret);
+
+	return ret;
 }
 
 /**
@@ -115,3 +122,38 @@ int32_t spi_transfer(struct spi_desc *desc, struct spi_msg *msgs, uint32_t len)
 
 	return SUCCESS;
 }
+
+/**
+ * @brief Queue an array of spi messages and return without waiting for the
+ * transfer to finish. Platforms without native support perform the transfer
+ * synchronously and call the callback before returning.
+ * @param desc - The SPI descriptor.
+ * @param msgs - Array of messages. The array and the buffers it references
+ *               must stay valid until the callback is called.
+ * @param len - Number of messages in the array.
+ * @param callback - Called with the transfer status when all messages are
+ *                   sent. May be called from interrupt or thread context.
+ * @param ctx - Parameter passed to the callback.
+ * @return SUCCESS if the transfer was queued, -EBUSY if the platform queue is
+ *         full, negative error code otherwise.
+ */
+int32_t spi_transfer_async(struct spi_desc *desc, struct spi_msg *msgs,
+			   uint32_t len,
+			   void (*callback)(void *ctx, int32_t status),
+			   void *ctx)
+{
+	int32_t ret;
+
+	if (!desc || !desc->platform_ops)
+		return -EINVAL;
+
+	if (desc->platform_ops->transfer_async)
+		return desc->platform_ops->transfer_async(desc, msgs, len,
+				callback, ctx);
+
+	ret = spi_transfer(desc, msgs, len);
+	if (callback)
+		callback(ctx, ret);
+
+	return SUCCESS;
+}
@@ -86,6 +86,11 @@
 
 #define ADXCVR_BROADCAST				0xff
 
+/* Status reads done back to back before starting to sleep between them */
+#define ADXCVR_DRP_SPIN_COUNT		16
+#define ADXCVR_DRP_BACKOFF_MAX_US	128
+#define ADXCVR_DRP_TIMEOUT_US		20000
+
 /**
  * @brief adxcvr_write
  */
@@ -112,28 +117,103 @@ int32_t adxcvr_read(struct adxcvr *xcvr,
 
 /**
  * @brief adxcvr_drp_wait_idle
+ *
+ * A DRP access usually completes within a few AXI reads, so the status is
+ * polled back to back first and only then with an exponentially growing
+ * delay, up to ADXCVR_DRP_TIMEOUT_US.
  */
 int32_t adxcvr_drp_wait_idle(struct adxcvr *xcvr,
 			     uint32_t drp_addr)
 {
 	uint32_t val;
-	int32_t timeout = 20;
+	int32_t ret;
 
-	do {
-		adxcvr_read(xcvr, ADXCVR_REG_DRP_STATUS(drp_addr), &val);
-		if (!(val & ADXCVR_DRP_STATUS_BUSY))
-			return ADXCVR_DRP_STATUS_RDATA(val);
+	ret = poll_timeout_spin_us((adxcvr_read(xcvr,
+						ADXCVR_REG_DRP_STATUS(drp_addr),
+						&val),
+				    !(val & ADXCVR_DRP_STATUS_BUSY)),
+				   ADXCVR_DRP_SPIN_COUNT,
+				   ADXCVR_DRP_BACKOFF_MAX_US,
+				   ADXCVR_DRP_TIMEOUT_US);
+	if (ret) {
+		printf("%s: %s: Timeout!", xcvr->name, __func__);
+		return FAILURE;
+	}
 
-		mdelay(1);
-	} while (timeout--);
+	return ADXCVR_DRP_STATUS_RDATA(val);
+}
 
-	printf("%s: %s: Timeout!", xcvr->name, __func__);
+/**
+ * @brief adxcvr_drp_shadow_get
+ *
+ * Shadows are kept for the channel ports and for the common port of each
+ * quad (ADXCVR_DRP_PORT_COMMON(4 * n)).
+ */
+static struct adxcvr_drp_shadow *adxcvr_drp_shadow_get(struct adxcvr *xcvr,
+		uint32_t drp_port)
+{
+	uint32_t idx;
 
-	return FAILURE;
+	if (!xcvr->drp_shadow)
+		return NULL;
+
+	if (drp_port >= ADXCVR_DRP_PORT_CHANNEL(0)) {
+		idx = drp_port - ADXCVR_DRP_PORT_CHANNEL(0);
+		if (idx >= xcvr->num_lanes)
+			return NULL;
+
+		return &xcvr->drp_shadow[idx];
+	}
+
+	if (drp_port % 4)
+		return NULL;
+
+	idx = drp_port / 4;
+	if (idx >= DIV_ROUND_UP(xcvr->num_lanes, 4))
+		return NULL;
+
+	return &xcvr->drp_shadow[xcvr->num_lanes + idx];
+}
+
+/**
+ * @brief adxcvr_drp_shadow_store
+ */
+static void adxcvr_drp_shadow_store(struct adxcvr_drp_shadow *shadow,
+				    uint32_t reg, uint32_t val)
+{
+	uint32_t slot = reg % ADXCVR_DRP_SHADOW_SIZE;
+
+	if (!shadow)
+		return;
+
+	shadow->reg[slot] = reg;
+	shadow->val[slot] = val;
+	shadow->valid |= (1u << slot);
+}
+
+/**
+ * @brief adxcvr_drp_shadow_invalidate
+ *
+ * Drop all the shadowed DRP values, the next adxcvr_drp_update() reads the
+ * hardware again. Must be called after the transceiver is reset and after
+ * any DRP access that bypasses adxcvr_drp_write().
+ */
+void adxcvr_drp_shadow_invalidate(struct adxcvr *xcvr)
+{
+	uint32_t i;
+
+	if (!xcvr->drp_shadow)
+		return;
+
+	for (i = 0; i < xcvr->num_lanes + DIV_ROUND_UP(xcvr->num_lanes, 4); i++)
+		xcvr->drp_shadow[i].valid = 0;
 }
 
 /**
  * @brief adxcvr_drp_read
+ *
+ * Always accesses the hardware and refreshes the shadow. Reading the
+ * broadcast channel port returns the value of the first lane.
  */
 int32_t adxcvr_drp_read(struct adxcvr *xcvr,
 			uint32_t drp_port,
@@ -143,6 +223,9 @@ int32_t adxcvr_drp_read(struct adxcvr *xcvr,
 	uint32_t drp_sel, drp_addr;
 	int32_t ret;
 
+	if (drp_port == ADXCVR_DRP_PORT_CHANNEL(ADXCVR_BROADCAST))
+		drp_port = ADXCVR_DRP_PORT_CHANNEL(0);
+
 	if (drp_port < ADXCVR_DRP_PORT_CHANNEL(0))
 		drp_addr = ADXCVR_DRP_PORT_ADDR_COMMON;
 	else
@@ -158,12 +241,36 @@ int32_t adxcvr_drp_read(struct adxcvr *xcvr,
 		return ret;
 
 	*val = ret & 0xffff;
+	adxcvr_drp_shadow_store(adxcvr_drp_shadow_get(xcvr, drp_port), reg, *val);
 
 	return SUCCESS;
 }
 
+/**
+ * @brief adxcvr_drp_read_cached
+ */
+static int32_t adxcvr_drp_read_cached(struct adxcvr *xcvr,
+				      uint32_t drp_port,
+				      uint32_t reg,
+				      uint32_t *val)
+{
+	struct adxcvr_drp_shadow *shadow = adxcvr_drp_shadow_get(xcvr, drp_port);
+	uint32_t slot = reg % ADXCVR_DRP_SHADOW_SIZE;
+
+	if (shadow && (shadow->valid & (1u << slot)) && shadow->reg[slot] == reg) {
+		*val = shadow->val[slot];
+
+		return SUCCESS;
+	}
+
+	return adxcvr_drp_read(xcvr, drp_port, reg, val);
+}
+
 /**
  * @brief adxcvr_drp_write
+ *
+ * Writing the broadcast channel port updates all the lanes with a single
+ * DRP transaction.
  */
 int32_t adxcvr_drp_write(struct adxcvr *xcvr,
 			 uint32_t drp_port,
@@ -171,6 +278,7 @@ int32_t adxcvr_drp_write(struct adxcvr *xcvr,
 			 uint32_t val)
 {
 	uint32_t drp_sel, drp_addr;
+	uint32_t i;
 	int32_t ret;
 
 	if (drp_port < ADXCVR_DRP_PORT_CHANNEL(0))
@@ -185,12 +293,100 @@ int32_t adxcvr_drp_write(struct adxcvr *xcvr,
 			ADXCVR_DRP_CTRL_ADDR(reg) | ADXCVR_DRP_CTRL_WDATA(val)));
 
 	ret = adxcvr_drp_wait_idle(xcvr, drp_addr);
-	if (ret < 0)
+	if (ret < 0) {
+		/* The write may or may not have landed, stop trusting the shadow. */
+		adxcvr_drp_shadow_invalidate(xcvr);
 		return ret;
+	}
+
+	if (drp_port == ADXCVR_DRP_PORT_CHANNEL(ADXCVR_BROADCAST)) {
+		for (i = 0; i < xcvr->num_lanes; i++)
+			adxcvr_drp_shadow_store(adxcvr_drp_shadow_get(xcvr,
+						ADXCVR_DRP_PORT_CHANNEL(i)), reg, val & 0xffff);
+	} else {
+		adxcvr_drp_shadow_store(adxcvr_drp_shadow_get(xcvr, drp_port),
+					reg, val & 0xffff);
+	}
 
 	return SUCCESS;
 }
 
+/**
+ * @brief adxcvr_drp_update
+ *
+ * Read-modify-write of a DRP register, the read is served from the shadow
+ * when possible and the write is skipped if the value does not change. On
+ * the broadcast channel port a single write is issued if all the lanes hold
+ * the same value in the bits outside the mask, otherwise the lanes are
+ * updated one by one.
+ *
+ * @return The number of DRP writes issued or a negative error code.
+ */
+int32_t adxcvr_drp_update(struct adxcvr *xcvr,
+			  uint32_t drp_port,
+			  uint32_t reg,
+			  uint32_t mask,
+			  uint32_t val)
+{
+	uint32_t read_val, keep = 0;
+	bool changed = false;
+	int32_t writes = 0;
+	uint32_t i;
+	int32_t ret;
+
+	if (drp_port != ADXCVR_DRP_PORT_CHANNEL(ADXCVR_BROADCAST)) {
+		ret = adxcvr_drp_read_cached(xcvr, drp_port, reg, &read_val);
+		if (ret < 0)
+			return ret;
+
+		if ((val | (read_val & ~mask)) == read_val)
+			return 0;
+
+		ret = adxcvr_drp_write(xcvr, drp_port, reg, val | (read_val & ~mask));
+		if (ret < 0)
+			return ret;
+
+		return 1;
+	}
+
+	for (i = 0; i < xcvr->num_lanes; i++) {
+		ret = adxcvr_drp_read_cached(xcvr, ADXCVR_DRP_PORT_CHANNEL(i), reg,
+					     &read_val);
+		if (ret < 0)
+			return ret;
+
+		if ((val | (read_val & ~mask)) != read_val)
+			changed = true;
+
+		if (i == 0)
+			keep = read_val & ~mask;
+		else if ((read_val & ~mask) != keep)
+			break;
+	}
+
+	if (i == xcvr->num_lanes) {
+		if (!changed)
+			return 0;
+
+		ret = adxcvr_drp_write(xcvr, drp_port, reg, val | keep);
+		if (ret < 0)
+			return ret;
+
+		return 1;
+	}
+
+	for (i = 0; i < xcvr->num_lanes; i++) {
+		ret = adxcvr_drp_update(xcvr, ADXCVR_DRP_PORT_CHANNEL(i), reg, mask,
+					val);
+		if (ret < 0)
+			return ret;
+
+		writes += ret;
+	}
+
+	return writes;
+}
+
 /**
  * @brief adxcvr_clk_set_rate
  */
@@ -219,47 +415,48 @@ int32_t adxcvr_clk_set_rate(struct adxcvr *xcvr,
 	if (ret < 0)
 		return ret;
 
-	for (i = 0; i < xcvr->num_lanes; i++) {
-
-		if (xcvr->cpll_enable)
-			ret = xilinx_xcvr_cpll_write_config(&xcvr->xlx_xcvr,
-							    ADXCVR_DRP_PORT_CHANNEL(i),
-							    &cpll_conf);
-		else if (i % 4 == 0)
+	/* The channel settings are the same for all the lanes, broadcast them. */
+	if (xcvr->cpll_enable) {
+		ret = xilinx_xcvr_cpll_write_config(&xcvr->xlx_xcvr,
+						    ADXCVR_DRP_PORT_CHANNEL(ADXCVR_BROADCAST),
+						    &cpll_conf);
+		if (ret < 0)
+			return ret;
+	} else {
+		for (i = 0; i < xcvr->num_lanes; i += 4) {
 			ret = xilinx_xcvr_qpll_write_config(&xcvr->xlx_xcvr,
 							    ADXCVR_DRP_PORT_COMMON(i),
 							    &qpll_conf);
-		if (ret < 0)
-			return ret;
-
-		ret = xilinx_xcvr_write_out_div(&xcvr->xlx_xcvr,
-						ADXCVR_DRP_PORT_CHANNEL(i),
-						xcvr->tx_enable ? -1 : (int32_t)out_div,
-						xcvr->tx_enable ? (int32_t)out_div : -1);
-		if (ret < 0)
-			return ret;
-
-		if (!xcvr->tx_enable) {
-			ret = xilinx_xcvr_configure_cdr(&xcvr->xlx_xcvr,
-							ADXCVR_DRP_PORT_CHANNEL(i),
-							rate, out_div,
-							xcvr->lpm_enable);
 			if (ret < 0)
 				return ret;
-
-			ret = xilinx_xcvr_write_rx_clk25_div(&xcvr->xlx_xcvr,
-							     ADXCVR_DRP_PORT_CHANNEL(i),
-							     clk25_div);
-		} else {
-			ret = xilinx_xcvr_write_tx_clk25_div(&xcvr->xlx_xcvr,
-							     ADXCVR_DRP_PORT_CHANNEL(i),
-							     clk25_div);
 		}
+	}
 
+	ret = xilinx_xcvr_write_out_div(&xcvr->xlx_xcvr,
+					ADXCVR_DRP_PORT_CHANNEL(ADXCVR_BROADCAST),
+					xcvr->tx_enable ? -1 : (int32_t)out_div,
+					xcvr->tx_enable ? (int32_t)out_div : -1);
+	if (ret < 0)
+		return ret;
+
+	if (!xcvr->tx_enable) {
+		ret = xilinx_xcvr_configure_cdr(&xcvr->xlx_xcvr,
+						ADXCVR_DRP_PORT_CHANNEL(ADXCVR_BROADCAST),
+						rate, out_div,
+						xcvr->lpm_enable);
 		if (ret < 0)
 			return ret;
-	}
 
+		ret = xilinx_xcvr_write_rx_clk25_div(&xcvr->xlx_xcvr,
+						     ADXCVR_DRP_PORT_CHANNEL(ADXCVR_BROADCAST),
+						     clk25_div);
+	} else {
+		ret = xilinx_xcvr_write_tx_clk25_div(&xcvr->xlx_xcvr,
+						     ADXCVR_DRP_PORT_CHANNEL(ADXCVR_BROADCAST),
+						     clk25_div);
+	}
+	if (ret < 0)
+		return ret;
 
 	xcvr->lane_rate_khz = rate;
 
@@ -292,18 +489,45 @@ int32_t adxcvr_status_error(struct adxcvr *xcvr)
  */
 int32_t adxcvr_clk_enable(struct adxcvr *xcvr)
 {
+	adxcvr_drp_shadow_invalidate(xcvr);
 	adxcvr_write(xcvr, ADXCVR_REG_RESETN, ADXCVR_RESETN);
 	mdelay(100);
 
 	return adxcvr_status_error(xcvr);
 }
 
+/**
+ * @brief adxcvr_clk_enable_nowait
+ *
+ * Release the transceiver reset without waiting for it to come up, poll
+ * adxcvr_status_ready() afterwards.
+ */
+int32_t adxcvr_clk_enable_nowait(struct adxcvr *xcvr)
+{
+	adxcvr_drp_shadow_invalidate(xcvr);
+
+	return adxcvr_write(xcvr, ADXCVR_REG_RESETN, ADXCVR_RESETN);
+}
+
+/**
+ * @brief adxcvr_status_ready
+ */
+bool adxcvr_status_ready(struct adxcvr *xcvr)
+{
+	uint32_t status;
+
+	adxcvr_read(xcvr, ADXCVR_REG_STATUS, &status);
+
+	return status != 0;
+}
+
 /**
  * @brief adxcvr_clk_disable
  */
 int32_t adxcvr_clk_disable(struct adxcvr *xcvr)
 {
 	adxcvr_write(xcvr, ADXCVR_REG_RESETN, 0);
+	adxcvr_drp_shadow_invalidate(xcvr);
 
 	return SUCCESS;
 }
@@ -333,7 +557,6 @@ int32_t adxcvr_init(struct adxcvr **ad_xcvr,
 {
 	struct adxcvr *xcvr;
 	uint32_t synth_conf, xcvr_type;
-	uint32_t i;
 	int32_t ret;
 
 	xcvr = (struct adxcvr *)malloc(sizeof(*xcvr));
@@ -354,6 +577,11 @@ int32_t adxcvr_init(struct adxcvr **ad_xcvr,
 	xcvr->tx_enable = (synth_conf >> 8) & 1;
 	xcvr->num_lanes = synth_conf & 0xff;
 
+	xcvr->drp_shadow = (struct adxcvr_drp_shadow *)calloc(xcvr->num_lanes +
+			   DIV_ROUND_UP(xcvr->num_lanes, 4), sizeof(*xcvr->drp_shadow));
+	if (!xcvr->drp_shadow)
+		goto err;
+
 	xcvr_type = (synth_conf >> 16) & 0xf;
 
 	adxcvr_read(xcvr, AXI_REG_VERSION, &xcvr->xlx_xcvr.version);
@@ -396,6 +624,7 @@ int32_t adxcvr_init(struct adxcvr **ad_xcvr,
 	xcvr->xlx_xcvr.refclk_ppm = PM_200; /* TODO use clock accuracy */
 
 	adxcvr_write(xcvr, ADXCVR_REG_RESETN, 0);
+	adxcvr_drp_shadow_invalidate(xcvr);
 
 	adxcvr_write(xcvr, ADXCVR_REG_CONTROL,
 		     ((xcvr->lpm_enable ? ADXCVR_LPM_DFE_N : 0) |
@@ -404,13 +633,10 @@ int32_t adxcvr_init(struct adxcvr **ad_xcvr,
 
 	xcvr->xlx_xcvr.ad_xcvr = xcvr;
 
-	if (!xcvr->tx_enable) {
-		for (i = 0; i < xcvr->num_lanes; i++) {
-			xilinx_xcvr_configure_lpm_dfe_mode(&xcvr->xlx_xcvr,
-							   ADXCVR_DRP_PORT_CHANNEL(i),
-							   xcvr->lpm_enable);
-		}
-	}
+	if (!xcvr->tx_enable)
+		xilinx_xcvr_configure_lpm_dfe_mode(&xcvr->xlx_xcvr,
+						   ADXCVR_DRP_PORT_CHANNEL(ADXCVR_BROADCAST),
+						   xcvr->lpm_enable);
 
 	if (xcvr->lane_rate_khz && xcvr->ref_rate_khz) {
 		ret = adxcvr_clk_set_rate(xcvr, xcvr->lane_rate_khz, xcvr->ref_rate_khz);
@@ -423,6 +649,7 @@ int32_t adxcvr_init(struct adxcvr **ad_xcvr,
 	return SUCCESS;
 
 err:
+	free(xcvr->drp_shadow);
 	free(xcvr);
 
 	return FAILURE;
@@ -433,6 +660,7 @@ err:
  */
 int32_t adxcvr_remove(struct adxcvr *xcvr)
 {
+	free(xcvr->drp_shadow);
 	free(xcvr);
 
 	return SUCCESS;
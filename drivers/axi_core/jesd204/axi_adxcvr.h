@@ -46,9 +46,21 @@
 #include <stdbool.h>
 #include "xilinx_transceiver.h"
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+#define ADXCVR_DRP_SHADOW_SIZE	32
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
+/* Direct mapped cache of the last values read from/written to a DRP port */
+struct adxcvr_drp_shadow {
+	uint16_t reg[ADXCVR_DRP_SHADOW_SIZE];
+	uint16_t val[ADXCVR_DRP_SHADOW_SIZE];
+	uint32_t valid;
+};
+
 struct adxcvr {
 	const char *name;
 	uint32_t base;
@@ -61,6 +73,8 @@ struct adxcvr {
 	uint32_t sys_clk_sel;
 	uint32_t out_clk_sel;
 	struct xilinx_xcvr xlx_xcvr;
+	/* num_lanes channel shadows followed by one shadow per quad common */
+	struct adxcvr_drp_shadow *drp_shadow;
 };
 
 struct adxcvr_init {
@@ -85,8 +99,16 @@ int32_t adxcvr_drp_write(struct adxcvr *xcvr,
 			 uint32_t drp_port,
 			 uint32_t reg,
 			 uint32_t val);
+int32_t adxcvr_drp_update(struct adxcvr *xcvr,
+			  uint32_t drp_port,
+			  uint32_t reg,
+			  uint32_t mask,
+			  uint32_t val);
+void adxcvr_drp_shadow_invalidate(struct adxcvr *xcvr);
 int32_t adxcvr_status_error(struct adxcvr *xcvr);
 int32_t adxcvr_clk_enable(struct adxcvr *xcvr);
+int32_t adxcvr_clk_enable_nowait(struct adxcvr *xcvr);
+bool adxcvr_status_ready(struct adxcvr *xcvr);
 int32_t adxcvr_clk_disable(struct adxcvr *xcvr);
 int32_t adxcvr_init(struct adxcvr **ad_xcvr,
 		    const struct adxcvr_init *init);
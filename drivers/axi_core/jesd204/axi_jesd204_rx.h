@@ -91,6 +91,8 @@ struct jesd204_rx_init {
 int32_t axi_jesd204_rx_lane_clk_enable(struct axi_jesd204_rx *jesd);
 int32_t axi_jesd204_rx_lane_clk_disable(struct axi_jesd204_rx *jesd);
 uint32_t axi_jesd204_rx_status_read(struct axi_jesd204_rx *jesd);
+int32_t axi_jesd204_rx_link_poll(struct axi_jesd204_rx *jesd,
+				  bool *enabled, bool *sysref_captured, bool *data);
 int32_t axi_jesd204_rx_laneinfo_read(struct axi_jesd204_rx *jesd,
 				     uint32_t lane);
 int32_t axi_jesd204_rx_watchdog(struct axi_jesd204_rx *jesd);
@@ -145,6 +145,36 @@ int32_t axi_jesd204_tx_lane_clk_disable(struct axi_jesd204_tx *jesd)
 	return axi_jesd204_tx_write(jesd, JESD204_TX_REG_LINK_DISABLE, 0x1);
 }
 
+/**
+ * @brief axi_jesd204_tx_link_poll
+ *
+ * Non-blocking view of the link state, for bring-up state machines.
+ * sysref_captured is also set when SYSREF is disabled (subclass 0).
+ */
+int32_t axi_jesd204_tx_link_poll(struct axi_jesd204_tx *jesd,
+				  bool *enabled, bool *sysref_captured, bool *data)
+{
+	uint32_t link_state;
+	uint32_t link_status;
+	uint32_t sysref_status;
+	uint32_t sysref_config;
+
+	axi_jesd204_tx_read(jesd, JESD204_TX_REG_LINK_STATE, &link_state);
+	axi_jesd204_tx_read(jesd, JESD204_TX_REG_LINK_STATUS, &link_status);
+	axi_jesd204_tx_read(jesd, JESD204_TX_REG_SYSREF_STATUS, &sysref_status);
+	axi_jesd204_tx_read(jesd, JESD204_TX_REG_SYSREF_CONF, &sysref_config);
+
+	if (enabled)
+		*enabled = !(link_state & 0x3);
+	if (sysref_captured)
+		*sysref_captured = (sysref_config & JESD204_TX_REG_SYSREF_CONF_SYSREF_DISABLE) ||
+				   (sysref_status & 0x1);
+	if (data)
+		*data = (link_status & 0x3) == 0x3;
+
+	return SUCCESS;
+}
+
 /**
  * @brief axi_jesd204_tx_status_read
  */
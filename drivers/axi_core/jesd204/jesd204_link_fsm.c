@@ -0,0 +1,373 @@
+/***************************************************************************//**
+ *   @file   jesd204_link_fsm.c
+ *   @brief  Non-blocking JESD204 link bring-up state machine.
+ *           Brings many links up in parallel, clocks -> PHY -> link ->
+ *           SYSREF -> data, timing every stage.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include "no-os/error.h"
+#include "no-os/delay.h"
+#include "no-os/trace.h"
+#include "jesd204_link_fsm.h"
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+static const char *jesd204_link_fsm_stage_name[] = {
+	[JESD204_LINK_FSM_CLOCKS] = "clocks",
+	[JESD204_LINK_FSM_PHY] = "phy",
+	[JESD204_LINK_FSM_LINK] = "link",
+	[JESD204_LINK_FSM_SYSREF] = "sysref",
+	[JESD204_LINK_FSM_DATA] = "data",
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Update the current time of the state machine.
+ * @param fsm - The state machine descriptor.
+ */
+static void jesd204_link_fsm_update_time(struct jesd204_link_fsm *fsm)
+{
+	uint64_t ns;
+
+	/* Without a timer the time is advanced by jesd204_link_fsm_run(). */
+	if (fsm->timer && !timer_get_elapsed_time_nsec(fsm->timer, &ns))
+		fsm->now_us = ns / 1000;
+}
+
+/**
+ * @brief Mark a link as failed.
+ * @param fsm - The state machine descriptor.
+ * @param idx - Index of the link.
+ * @param error - Error code.
+ */
+static void jesd204_link_fsm_fail(struct jesd204_link_fsm *fsm, uint32_t idx,
+				  int32_t error)
+{
+	struct jesd204_link_fsm_link *link = &fsm->links[idx];
+
+	printf("%s: %s stage failed (%"PRId32")\n", link->name,
+	       jesd204_link_fsm_stage_name[link->state], error);
+
+	link->stage_us[link->state] = fsm->now_us - fsm->stage_start_us[idx];
+	link->error = error;
+	link->state = JESD204_LINK_FSM_FAILED;
+	TRACE_INSTANT(TRACE_EV_JESD204_LINK_STATE, (idx << 8) | link->state);
+}
+
+/**
+ * @brief Close the current stage of a link and run the entry action of the
+ * next one.
+ * @param fsm - The state machine descriptor.
+ * @param idx - Index of the link.
+ */
+static void jesd204_link_fsm_next(struct jesd204_link_fsm *fsm, uint32_t idx)
+{
+	struct jesd204_link_fsm_link *link = &fsm->links[idx];
+	int32_t ret = SUCCESS;
+
+	link->stage_us[link->state] = fsm->now_us - fsm->stage_start_us[idx];
+	fsm->stage_start_us[idx] = fsm->now_us;
+	link->state++;
+	TRACE_INSTANT(TRACE_EV_JESD204_LINK_STATE, (idx << 8) | link->state);
+
+	switch (link->state) {
+	case JESD204_LINK_FSM_PHY:
+		if (link->xcvr)
+			ret = adxcvr_clk_enable_nowait(link->xcvr);
+		break;
+	case JESD204_LINK_FSM_LINK:
+		if (link->rx)
+			ret = axi_jesd204_rx_lane_clk_enable(link->rx);
+		else
+			ret = axi_jesd204_tx_lane_clk_enable(link->tx);
+		break;
+	default:
+		break;
+	}
+
+	if (ret)
+		jesd204_link_fsm_fail(fsm, idx, ret);
+}
+
+/**
+ * @brief Put a link in reset and set up its lane rate (CLOCKS entry action).
+ * @param fsm - The state machine descriptor.
+ * @param idx - Index of the link.
+ */
+static void jesd204_link_fsm_start(struct jesd204_link_fsm *fsm, uint32_t idx)
+{
+	struct jesd204_link_fsm_link *link = &fsm->links[idx];
+	int32_t ret;
+
+	link->state = JESD204_LINK_FSM_CLOCKS;
+	link->error = SUCCESS;
+	fsm->stage_start_us[idx] = fsm->now_us;
+	TRACE_INSTANT(TRACE_EV_JESD204_LINK_STATE, (idx << 8) | link->state);
+
+	if (link->rx)
+		axi_jesd204_rx_lane_clk_disable(link->rx);
+	else
+		axi_jesd204_tx_lane_clk_disable(link->tx);
+
+	if (!link->xcvr)
+		return;
+
+	adxcvr_clk_disable(link->xcvr);
+
+	if (link->lane_rate_khz) {
+		ret = adxcvr_clk_set_rate(link->xcvr, link->lane_rate_khz,
+					  link->xcvr->ref_rate_khz);
+		if (ret)
+			jesd204_link_fsm_fail(fsm, idx, ret);
+	}
+}
+
+/**
+ * @brief Advance one link as far as possible without blocking.
+ * @param fsm - The state machine descriptor.
+ * @param idx - Index of the link.
+ */
+static void jesd204_link_fsm_advance(struct jesd204_link_fsm *fsm, uint32_t idx)
+{
+	struct jesd204_link_fsm_link *link = &fsm->links[idx];
+	enum jesd204_link_fsm_state state;
+	bool enabled, sysref, data;
+	int32_t ret;
+
+	do {
+		state = link->state;
+
+		switch (state) {
+		case JESD204_LINK_FSM_CLOCKS:
+			ret = link->setup_clocks ? link->setup_clocks(link->ctx) : SUCCESS;
+			if (ret == SUCCESS)
+				jesd204_link_fsm_next(fsm, idx);
+			else if (ret != -EAGAIN)
+				jesd204_link_fsm_fail(fsm, idx, ret);
+			break;
+		case JESD204_LINK_FSM_PHY:
+			if (!link->xcvr || adxcvr_status_ready(link->xcvr))
+				jesd204_link_fsm_next(fsm, idx);
+			break;
+		case JESD204_LINK_FSM_LINK:
+		case JESD204_LINK_FSM_SYSREF:
+		case JESD204_LINK_FSM_DATA:
+			if (link->rx)
+				axi_jesd204_rx_link_poll(link->rx, &enabled, &sysref, &data);
+			else
+				axi_jesd204_tx_link_poll(link->tx, &enabled, &sysref, &data);
+
+			if ((state == JESD204_LINK_FSM_LINK && enabled) ||
+			    (state == JESD204_LINK_FSM_SYSREF && sysref) ||
+			    (state == JESD204_LINK_FSM_DATA && data))
+				jesd204_link_fsm_next(fsm, idx);
+			break;
+		default:
+			return;
+		}
+
+		if (link->state == state &&
+		    fsm->now_us - fsm->stage_start_us[idx] > fsm->stage_timeout_us)
+			jesd204_link_fsm_fail(fsm, idx, -ETIMEDOUT);
+	} while (link->state != state);
+}
+
+/**
+ * @brief Allocate the state machine and put all the links in the CLOCKS
+ * stage. No hardware is touched until the first step.
+ * @param fsm - The state machine descriptor.
+ * @param param - The initialization parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t jesd204_link_fsm_init(struct jesd204_link_fsm **fsm,
+			      const struct jesd204_link_fsm_init_param *param)
+{
+	struct jesd204_link_fsm *dev;
+	uint32_t i;
+
+	if (!fsm || !param || !param->links || !param->num_links)
+		return -EINVAL;
+
+	for (i = 0; i < param->num_links; i++)
+		if (!param->links[i].rx == !param->links[i].tx)
+			return -EINVAL;
+
+	dev = (struct jesd204_link_fsm *)calloc(1, sizeof(*dev));
+	if (!dev)
+		return -ENOMEM;
+
+	dev->stage_start_us = (uint64_t *)calloc(param->num_links,
+			      sizeof(*dev->stage_start_us));
+	if (!dev->stage_start_us) {
+		free(dev);
+		return -ENOMEM;
+	}
+
+	dev->links = param->links;
+	dev->num_links = param->num_links;
+	dev->sysref = param->sysref;
+	dev->sysref_ctx = param->sysref_ctx;
+	dev->timer = param->timer;
+	dev->poll_us = param->poll_us ? param->poll_us : JESD204_LINK_FSM_POLL_US;
+	dev->stage_timeout_us = param->stage_timeout_us ? param->stage_timeout_us :
+				JESD204_LINK_FSM_STAGE_TIMEOUT_US;
+
+	for (i = 0; i < dev->num_links; i++) {
+		dev->links[i].state = JESD204_LINK_FSM_CLOCKS;
+		dev->links[i].error = SUCCESS;
+	}
+
+	*fsm = dev;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Advance every link as far as possible without blocking. SYSREF is
+ * requested once, when every link waits for it.
+ * @param fsm - The state machine descriptor.
+ * @return SUCCESS when all the links are up, -EAGAIN while in progress,
+ * the error of the first failed link otherwise.
+ */
+int32_t jesd204_link_fsm_step(struct jesd204_link_fsm *fsm)
+{
+	bool all_done = true;
+	bool all_sysref = true;
+	uint32_t i;
+	int32_t ret;
+
+	jesd204_link_fsm_update_time(fsm);
+
+	if (!fsm->started) {
+		fsm->started = true;
+		fsm->start_us = fsm->now_us;
+		for (i = 0; i < fsm->num_links; i++)
+			jesd204_link_fsm_start(fsm, i);
+	}
+
+	for (i = 0; i < fsm->num_links; i++)
+		jesd204_link_fsm_advance(fsm, i);
+
+	for (i = 0; i < fsm->num_links; i++) {
+		if (fsm->links[i].state == JESD204_LINK_FSM_FAILED)
+			return fsm->links[i].error;
+		if (fsm->links[i].state != JESD204_LINK_FSM_DONE)
+			all_done = false;
+		if (fsm->links[i].state < JESD204_LINK_FSM_SYSREF)
+			all_sysref = false;
+	}
+
+	if (all_done) {
+		fsm->total_us = fsm->now_us - fsm->start_us;
+		return SUCCESS;
+	}
+
+	if (all_sysref && fsm->sysref && !fsm->sysref_sent) {
+		ret = fsm->sysref(fsm->sysref_ctx);
+		if (ret)
+			return ret;
+		fsm->sysref_sent = true;
+	}
+
+	return -EAGAIN;
+}
+
+/**
+ * @brief Step until all the links are up or one of them failed.
+ * @param fsm - The state machine descriptor.
+ * @return SUCCESS when all the links are up, negative error code otherwise.
+ */
+int32_t jesd204_link_fsm_run(struct jesd204_link_fsm *fsm)
+{
+	int32_t ret;
+
+	while ((ret = jesd204_link_fsm_step(fsm)) == -EAGAIN) {
+		udelay(fsm->poll_us);
+		if (!fsm->timer)
+			fsm->now_us += fsm->poll_us;
+	}
+
+	return ret;
+}
+
+/**
+ * @brief Print the per stage timing of every link.
+ * @param fsm - The state machine descriptor.
+ */
+void jesd204_link_fsm_print_timing(struct jesd204_link_fsm *fsm)
+{
+	struct jesd204_link_fsm_link *link;
+	uint32_t i, s;
+
+	for (i = 0; i < fsm->num_links; i++) {
+		link = &fsm->links[i];
+		printf("%s:", link->name);
+		for (s = 0; s < JESD204_LINK_FSM_NUM_STAGES; s++)
+			printf(" %s %"PRIu32" us", jesd204_link_fsm_stage_name[s],
+			       link->stage_us[s]);
+		printf(" (%s)\n", link->state == JESD204_LINK_FSM_DONE ? "up" :
+		       link->state == JESD204_LINK_FSM_FAILED ? "failed" : "pending");
+	}
+
+	printf("%"PRIu32" links up in %"PRIu32" us\n", fsm->num_links,
+	       fsm->total_us);
+}
+
+/**
+ * @brief Free the resources allocated by jesd204_link_fsm_init().
+ * @param fsm - The state machine descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t jesd204_link_fsm_remove(struct jesd204_link_fsm *fsm)
+{
+	if (!fsm)
+		return -EINVAL;
+
+	free(fsm->stage_start_us);
+	free(fsm);
+
+	return SUCCESS;
+}
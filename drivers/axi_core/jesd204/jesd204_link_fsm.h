@@ -0,0 +1,166 @@
+/***************************************************************************//**
+ *   @file   jesd204_link_fsm.h
+ *   @brief  Non-blocking JESD204 link bring-up state machine.
+ *           Brings many links up in parallel, clocks -> PHY -> link ->
+ *           SYSREF -> data, timing every stage.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef JESD204_LINK_FSM_H_
+#define JESD204_LINK_FSM_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "axi_adxcvr.h"
+#include "axi_jesd204_rx.h"
+#include "axi_jesd204_tx.h"
+#include "no-os/timer.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+#define JESD204_LINK_FSM_POLL_US		100
+#define JESD204_LINK_FSM_STAGE_TIMEOUT_US	1000000
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+/**
+ * @enum jesd204_link_fsm_state
+ * @brief Bring-up stages, in order. A link in a given state is working on
+ * that stage.
+ */
+enum jesd204_link_fsm_state {
+	/** Link and PHY held in reset, lane rate and clocks set up */
+	JESD204_LINK_FSM_CLOCKS,
+	/** PHY reset released, waiting for the PLLs to lock */
+	JESD204_LINK_FSM_PHY,
+	/** Link enabled, waiting for it to leave reset */
+	JESD204_LINK_FSM_LINK,
+	/** Waiting for SYSREF to be captured (skipped for subclass 0) */
+	JESD204_LINK_FSM_SYSREF,
+	/** Waiting for the link to reach the DATA state */
+	JESD204_LINK_FSM_DATA,
+	JESD204_LINK_FSM_NUM_STAGES,
+	/** Link is up */
+	JESD204_LINK_FSM_DONE = JESD204_LINK_FSM_NUM_STAGES,
+	/** A stage failed or timed out, see error */
+	JESD204_LINK_FSM_FAILED,
+};
+
+/**
+ * @struct jesd204_link_fsm_link
+ * @brief One link handled by the state machine. Exactly one of rx/tx is set.
+ */
+struct jesd204_link_fsm_link {
+	const char *name;
+	/** Transceiver of the link, NULL if it is brought up elsewhere */
+	struct adxcvr *xcvr;
+	struct axi_jesd204_rx *rx;
+	struct axi_jesd204_tx *tx;
+	/** Lane rate to program during the CLOCKS stage, 0 to keep it */
+	uint32_t lane_rate_khz;
+	/** Optional clock setup (device clocks, link clock). Must not block:
+	 *  return 0 when done, -EAGAIN to be called again, error otherwise. */
+	int32_t (*setup_clocks)(void *ctx);
+	void *ctx;
+	/** Current stage (managed by the state machine) */
+	enum jesd204_link_fsm_state state;
+	/** Error code of the failed stage */
+	int32_t error;
+	/** Time spent in each stage, in microseconds */
+	uint32_t stage_us[JESD204_LINK_FSM_NUM_STAGES];
+};
+
+/**
+ * @struct jesd204_link_fsm_init_param
+ * @brief State machine initialization parameters.
+ */
+struct jesd204_link_fsm_init_param {
+	struct jesd204_link_fsm_link *links;
+	uint32_t num_links;
+	/** Issue SYSREF pulses. Called once all the links wait for SYSREF.
+	 *  Optional for continuous SYSREF. */
+	int32_t (*sysref)(void *ctx);
+	void *sysref_ctx;
+	/** Running timer used for the timing, NULL to count poll periods */
+	struct timer_desc *timer;
+	/** Delay between polls in jesd204_link_fsm_run(), 0 for default */
+	uint32_t poll_us;
+	/** Per stage timeout, 0 for default */
+	uint32_t stage_timeout_us;
+};
+
+/**
+ * @struct jesd204_link_fsm
+ * @brief State machine descriptor.
+ */
+struct jesd204_link_fsm {
+	struct jesd204_link_fsm_link *links;
+	uint32_t num_links;
+	int32_t (*sysref)(void *ctx);
+	void *sysref_ctx;
+	bool started;
+	bool sysref_sent;
+	struct timer_desc *timer;
+	uint32_t poll_us;
+	uint32_t stage_timeout_us;
+	/** Time of the current step and of the start, in microseconds */
+	uint64_t now_us;
+	uint64_t start_us;
+	/** Start of the current stage of each link */
+	uint64_t *stage_start_us;
+	/** Total bring-up time, in microseconds */
+	uint32_t total_us;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+/* Allocate the state machine and put all the links in the CLOCKS stage. */
+int32_t jesd204_link_fsm_init(struct jesd204_link_fsm **fsm,
+			      const struct jesd204_link_fsm_init_param *param);
+/* Advance every link as far as possible without blocking. */
+int32_t jesd204_link_fsm_step(struct jesd204_link_fsm *fsm);
+/* Step until all the links are up or one of them failed. */
+int32_t jesd204_link_fsm_run(struct jesd204_link_fsm *fsm);
+/* Print the per stage timing of every link. */
+void jesd204_link_fsm_print_timing(struct jesd204_link_fsm *fsm);
+/* Free the resources allocated by jesd204_link_fsm_init(). */
+int32_t jesd204_link_fsm_remove(struct jesd204_link_fsm *fsm);
+
+#endif
@@ -48,6 +48,7 @@
 #include "no-os/error.h"
 #include "axi_adxcvr.h"
 #include "xilinx_transceiver.h"
+#include "xilinx_transceiver_pll_table.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -106,6 +107,36 @@
 #define TX_CLK25_DIV			0x6a
 #define TX_CLK25_DIV_MASK		0x1f
 
+#define XILINX_XCVR_PLL_CACHE_SIZE	8
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+struct xilinx_xcvr_pll_cache_entry {
+	bool valid;
+	bool qpll;
+	enum xilinx_xcvr_type type;
+	uint32_t version;
+	uint32_t voltage;
+	enum axi_fpga_speed_grade speed_grade;
+	uint32_t refclk_khz;
+	uint32_t lane_rate_khz;
+	int32_t ret;
+	struct xilinx_xcvr_pll_solution sol;
+};
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+/* Solutions computed at run time, shared by all the transceiver instances */
+static struct xilinx_xcvr_pll_cache_entry
+	xilinx_xcvr_pll_cache[XILINX_XCVR_PLL_CACHE_SIZE];
+static uint32_t xilinx_xcvr_pll_cache_next;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
 /**
  * @brief xilinx_xcvr_write
  */
@@ -124,6 +155,15 @@ int32_t xilinx_xcvr_read(struct xilinx_xcvr *xcvr, uint32_t drp_port,
 	return adxcvr_drp_read(xcvr->ad_xcvr, drp_port, reg_addr, reg_val);
 }
 
+/**
+ * @brief xilinx_xcvr_update
+ */
+int32_t xilinx_xcvr_update(struct xilinx_xcvr *xcvr, uint32_t drp_port,
+			   uint32_t reg_addr, uint32_t mask, uint32_t reg_val)
+{
+	return adxcvr_drp_update(xcvr->ad_xcvr, drp_port, reg_addr, mask, reg_val);
+}
+
 /**
  * @brief xilinx_xcvr_drp_read
  */
@@ -178,13 +218,24 @@ int32_t xilinx_xcvr_drp_update(struct xilinx_xcvr *xcvr, uint32_t drp_port,
 	uint32_t read_val;
 	int32_t ret;
 
-	ret = xilinx_xcvr_drp_read(xcvr, drp_port, reg, &read_val);
-	if (ret < 0)
+	ret = xilinx_xcvr_update(xcvr, drp_port, reg, mask, val);
+	if (ret < 0) {
+		printf("%s: Failed to update reg %"PRIu32"-0x%"PRIX32": %"PRId32"\n",
+		       __func__, drp_port, reg, ret);
 		return ret;
+	}
 
-	val |= read_val & ~mask;
+	/* Nothing was written, the register already holds the value. */
+	if (ret == 0)
+		return SUCCESS;
 
-	return xilinx_xcvr_drp_write(xcvr, drp_port, reg, val);
+	xilinx_xcvr_drp_read(xcvr, drp_port, reg, &read_val);
+	if ((read_val & mask) != (val & mask))
+		printf("%s: read-write mismatch: reg 0x%"PRIX32","
+		       "val 0x%4"PRIX32", expected val 0x%4"PRIX32"\n",
+		       __func__, reg, val, read_val);
+
+	return SUCCESS;
 }
 
 /**
@@ -290,10 +341,14 @@ int32_t xilinx_xcvr_gtx2_configure_cdr(struct xilinx_xcvr *xcvr,
 		}
 	}
 
-	xilinx_xcvr_drp_write(xcvr, drp_port, RXCDR_CFG0_ADDR, cfg0);
-	xilinx_xcvr_drp_write(xcvr, drp_port, RXCDR_CFG1_ADDR, cfg1);
-	xilinx_xcvr_drp_write(xcvr, drp_port, RXCDR_CFG2_ADDR, cfg2);
-	xilinx_xcvr_drp_write(xcvr, drp_port, RXCDR_CFG3_ADDR, cfg3);
+	xilinx_xcvr_drp_update(xcvr, drp_port, RXCDR_CFG0_ADDR, RXCDR_CFG0_MASK,
+			       cfg0);
+	xilinx_xcvr_drp_update(xcvr, drp_port, RXCDR_CFG1_ADDR, RXCDR_CFG1_MASK,
+			       cfg1);
+	xilinx_xcvr_drp_update(xcvr, drp_port, RXCDR_CFG2_ADDR, RXCDR_CFG2_MASK,
+			       cfg2);
+	xilinx_xcvr_drp_update(xcvr, drp_port, RXCDR_CFG3_ADDR, RXCDR_CFG3_MASK,
+			       cfg3);
 	xilinx_xcvr_drp_update(xcvr, drp_port, RXCDR_CFG4_ADDR,
 			       RXCDR_CFG4_MASK, cfg4);
 
@@ -439,17 +494,143 @@ int32_t xilinx_xcvr_configure_lpm_dfe_mode(struct xilinx_xcvr *xcvr,
 	return SUCCESS;
 }
 
+/**
+ * @brief xilinx_xcvr_pll_cache_find
+ */
+static struct xilinx_xcvr_pll_cache_entry *xilinx_xcvr_pll_cache_find(
+	struct xilinx_xcvr *xcvr, bool qpll, uint32_t refclk_khz,
+	uint32_t lane_rate_khz)
+{
+	struct xilinx_xcvr_pll_cache_entry *entry;
+	uint32_t i;
+
+	for (i = 0; i < XILINX_XCVR_PLL_CACHE_SIZE; i++) {
+		entry = &xilinx_xcvr_pll_cache[i];
+		if (entry->valid && entry->qpll == qpll &&
+		    entry->refclk_khz == refclk_khz &&
+		    entry->lane_rate_khz == lane_rate_khz &&
+		    entry->type == xcvr->type &&
+		    entry->version == xcvr->version &&
+		    entry->voltage == xcvr->voltage &&
+		    entry->speed_grade == xcvr->speed_grade)
+			return entry;
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief xilinx_xcvr_pll_cache_add
+ */
+static void xilinx_xcvr_pll_cache_add(struct xilinx_xcvr *xcvr, bool qpll,
+				      uint32_t refclk_khz, uint32_t lane_rate_khz, int32_t ret,
+				      const struct xilinx_xcvr_pll_solution *sol)
+{
+	struct xilinx_xcvr_pll_cache_entry *entry;
+
+	entry = &xilinx_xcvr_pll_cache[xilinx_xcvr_pll_cache_next];
+	xilinx_xcvr_pll_cache_next = (xilinx_xcvr_pll_cache_next + 1) %
+				     XILINX_XCVR_PLL_CACHE_SIZE;
+
+	entry->valid = true;
+	entry->qpll = qpll;
+	entry->type = xcvr->type;
+	entry->version = xcvr->version;
+	entry->voltage = xcvr->voltage;
+	entry->speed_grade = xcvr->speed_grade;
+	entry->refclk_khz = refclk_khz;
+	entry->lane_rate_khz = lane_rate_khz;
+	entry->ret = ret;
+	entry->sol = *sol;
+}
+
+/**
+ * @brief xilinx_xcvr_pll_table_find
+ *
+ * The table is sorted by reference clock and lane rate.
+ */
+static const struct xilinx_xcvr_pll_solution *xilinx_xcvr_pll_table_find(
+	bool gtx2, bool qpll, uint32_t vco_max, uint32_t refclk_khz,
+	uint32_t lane_rate_khz)
+{
+	const struct xilinx_xcvr_pll_solution *sol;
+	uint32_t lo = 0;
+	uint32_t hi = ARRAY_SIZE(xilinx_xcvr_pll_table);
+	uint32_t mid;
+
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		sol = &xilinx_xcvr_pll_table[mid];
+		if (sol->refclk_khz < refclk_khz ||
+		    (sol->refclk_khz == refclk_khz && sol->lane_rate_khz < lane_rate_khz))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	for (; lo < ARRAY_SIZE(xilinx_xcvr_pll_table); lo++) {
+		sol = &xilinx_xcvr_pll_table[lo];
+		if (sol->refclk_khz != refclk_khz || sol->lane_rate_khz != lane_rate_khz)
+			break;
+
+		if (sol->gtx2 == gtx2 && sol->qpll == qpll && sol->vco_max == vco_max)
+			return sol;
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief xilinx_xcvr_solve_cpll_config
+ */
+static int32_t xilinx_xcvr_solve_cpll_config(uint32_t refclk_khz,
+		uint32_t lane_rate_khz, uint32_t vco_min, uint32_t vco_max,
+		struct xilinx_xcvr_pll_solution *sol)
+{
+	uint32_t n1, n2, d, m;
+	uint32_t vco_freq;
+
+	for (m = 1; m <= 2; m++) {
+		for (d = 1; d <= 8; d <<= 1) {
+			for (n1 = 5; n1 >= 4; n1--) {
+				for (n2 = 5; n2 >= 1; n2--) {
+					vco_freq = refclk_khz * n1 * n2 / m;
+
+					if (vco_freq > vco_max || vco_freq < vco_min)
+						continue;
+
+					if (refclk_khz / m / d == lane_rate_khz / (2 * n1 * n2)) {
+						sol->refclk_div = m;
+						sol->fb_div_N1 = n1;
+						sol->fb_div_N2 = n2;
+						sol->out_div = d;
+
+						return SUCCESS;
+					}
+				}
+			}
+		}
+	}
+
+	return FAILURE;
+}
+
 /**
  * @brief xilinx_xcvr_calc_cpll_config
+ *
+ * Recently used solutions are cached, common ones come from a precomputed
+ * table, the rest are searched for.
  */
 int32_t xilinx_xcvr_calc_cpll_config(struct xilinx_xcvr *xcvr,
 				     uint32_t refclk_khz, uint32_t lane_rate_khz,
 				     struct xilinx_xcvr_cpll_config *conf, uint32_t *out_div)
 {
-	uint32_t n1, n2, d, m;
-	uint32_t vco_freq;
+	struct xilinx_xcvr_pll_cache_entry *entry;
+	const struct xilinx_xcvr_pll_solution *table_sol;
+	struct xilinx_xcvr_pll_solution sol = {0};
 	uint32_t vco_min;
 	uint32_t vco_max;
+	int32_t ret;
 
 	/*
 	 * For PLL limits see:
@@ -482,27 +663,74 @@ int32_t xilinx_xcvr_calc_cpll_config(struct xilinx_xcvr *xcvr,
 		return FAILURE;
 	}
 
-	for (m = 1; m <= 2; m++) {
-		for (d = 1; d <= 8; d <<= 1) {
-			for (n1 = 5; n1 >= 4; n1--) {
-				for (n2 = 5; n2 >= 1; n2--) {
-					vco_freq = refclk_khz * n1 * n2 / m;
+	entry = xilinx_xcvr_pll_cache_find(xcvr, false, refclk_khz, lane_rate_khz);
+	if (entry) {
+		ret = entry->ret;
+		sol = entry->sol;
+	} else {
+		table_sol = xilinx_xcvr_pll_table_find(xcvr->type == XILINX_XCVR_TYPE_S7_GTX2,
+						       false, vco_max, refclk_khz, lane_rate_khz);
+		if (table_sol) {
+			ret = SUCCESS;
+			sol = *table_sol;
+		} else {
+			ret = xilinx_xcvr_solve_cpll_config(refclk_khz, lane_rate_khz,
+							    vco_min, vco_max, &sol);
+		}
+		xilinx_xcvr_pll_cache_add(xcvr, false, refclk_khz, lane_rate_khz, ret,
+					  &sol);
+	}
+	if (ret < 0)
+		return ret;
 
-					if (vco_freq > vco_max || vco_freq < vco_min)
-						continue;
+	if (conf) {
+		conf->refclk_div = sol.refclk_div;
+		conf->fb_div_N1 = sol.fb_div_N1;
+		conf->fb_div_N2 = sol.fb_div_N2;
+	}
 
-					if (refclk_khz / m / d == lane_rate_khz / (2 * n1 * n2)) {
-						if (conf) {
-							conf->refclk_div = m;
-							conf->fb_div_N1 = n1;
-							conf->fb_div_N2 = n2;
-						}
+	if (out_div)
+		*out_div = sol.out_div;
 
-						if (out_div)
-							*out_div = d;
+	return SUCCESS;
+}
 
-						return SUCCESS;
-					}
+/**
+ * @brief xilinx_xcvr_solve_qpll_config
+ */
+static int32_t xilinx_xcvr_solve_qpll_config(uint32_t refclk_khz,
+		uint32_t lane_rate_khz, const uint8_t *N,
+		uint32_t vco0_min, uint32_t vco0_max,
+		uint32_t vco1_min, uint32_t vco1_max,
+		struct xilinx_xcvr_pll_solution *sol)
+{
+	uint32_t n, d, m;
+	uint32_t vco_freq;
+	uint32_t band;
+
+	for (m = 1; m <= 4; m++) {
+		for (d = 1; d <= 16; d <<= 1) {
+			for (n = 0; N[n] != 0; n++) {
+				vco_freq = refclk_khz * N[n] / m;
+
+				/*
+				 * high band = 9.8G to 12.5GHz VCO
+				 * low band = 5.93G to 8.0GHz VCO
+				 */
+				if (vco_freq >= vco1_min && vco_freq <= vco1_max)
+					band = 1;
+				else if (vco_freq >= vco0_min && vco_freq <= vco0_max)
+					band = 0;
+				else
+					continue;
+
+				if (refclk_khz / m / d == lane_rate_khz / N[n]) {
+					sol->refclk_div = m;
+					sol->fb_div = N[n];
+					sol->band = band;
+					sol->out_div = d;
+
+					return SUCCESS;
 				}
 			}
 		}
@@ -513,19 +741,23 @@ int32_t xilinx_xcvr_calc_cpll_config(struct xilinx_xcvr *xcvr,
 
 /**
  * @brief xilinx_xcvr_calc_qpll_config
+ *
+ * Recently used solutions are cached, common ones come from a precomputed
+ * table, the rest are searched for.
  */
 int32_t xilinx_xcvr_calc_qpll_config(struct xilinx_xcvr *xcvr,
 				     uint32_t refclk_khz, uint32_t lane_rate_khz,
 				     struct xilinx_xcvr_qpll_config *conf, uint32_t *out_div)
 {
-	uint32_t n, d, m;
-	uint32_t vco_freq;
-	uint32_t band;
+	struct xilinx_xcvr_pll_cache_entry *entry;
+	const struct xilinx_xcvr_pll_solution *table_sol;
+	struct xilinx_xcvr_pll_solution sol = {0};
 	uint32_t vco0_min;
 	uint32_t vco0_max;
 	uint32_t vco1_min;
 	uint32_t vco1_max;
 	const uint8_t *N;
+	int32_t ret;
 
 	static const uint8_t N_gtx2[] = {16, 20, 32, 40, 64, 66, 80, 100, 0};
 	static const uint8_t N_gth34[] = {16, 20, 32, 40, 64, 66, 75, 80, 100,
@@ -554,40 +786,37 @@ int32_t xilinx_xcvr_calc_qpll_config(struct xilinx_xcvr *xcvr,
 		return FAILURE;
 	}
 
-	for (m = 1; m <= 4; m++) {
-		for (d = 1; d <= 16; d <<= 1) {
-			for (n = 0; N[n] != 0; n++) {
-				vco_freq = refclk_khz * N[n] / m;
-
-				/*
-				 * high band = 9.8G to 12.5GHz VCO
-				 * low band = 5.93G to 8.0GHz VCO
-				 */
-				if (vco_freq >= vco1_min && vco_freq <= vco1_max)
-					band = 1;
-				else if (vco_freq >= vco0_min && vco_freq <= vco0_max)
-					band = 0;
-				else
-					continue;
-
-				if (refclk_khz / m / d == lane_rate_khz / N[n]) {
-
-					if (conf) {
-						conf->refclk_div = m;
-						conf->fb_div = N[n];
-						conf->band = band;
-					}
-
-					if (out_div)
-						*out_div = d;
-
-					return SUCCESS;
-				}
-			}
+	entry = xilinx_xcvr_pll_cache_find(xcvr, true, refclk_khz, lane_rate_khz);
+	if (entry) {
+		ret = entry->ret;
+		sol = entry->sol;
+	} else {
+		table_sol = xilinx_xcvr_pll_table_find(xcvr->type == XILINX_XCVR_TYPE_S7_GTX2,
+						       true, 0, refclk_khz, lane_rate_khz);
+		if (table_sol) {
+			ret = SUCCESS;
+			sol = *table_sol;
+		} else {
+			ret = xilinx_xcvr_solve_qpll_config(refclk_khz, lane_rate_khz, N,
+							    vco0_min, vco0_max,
+							    vco1_min, vco1_max, &sol);
 		}
+		xilinx_xcvr_pll_cache_add(xcvr, true, refclk_khz, lane_rate_khz, ret,
+					  &sol);
+	}
+	if (ret < 0)
+		return ret;
+
+	if (conf) {
+		conf->refclk_div = sol.refclk_div;
+		conf->fb_div = sol.fb_div;
+		conf->band = sol.band;
 	}
 
-	return FAILURE;
+	if (out_div)
+		*out_div = sol.out_div;
+
+	return SUCCESS;
 }
 
 /**
@@ -162,6 +162,23 @@ struct xilinx_xcvr_qpll_config {
 	uint32_t band;
 };
 
+/* Precomputed PLL solution, see tools/scripts/xcvr_pll_table.py */
+struct xilinx_xcvr_pll_solution {
+	uint32_t refclk_khz;
+	uint32_t lane_rate_khz;
+	/* CPLL: VCO upper limit the solution was computed for, 0 for QPLL */
+	uint32_t vco_max;
+	/* 1 for 7 series GTX2, 0 for UltraScale GTH3/GTH4/GTY4 */
+	uint8_t gtx2;
+	uint8_t qpll;
+	uint8_t refclk_div;
+	uint8_t fb_div;
+	uint8_t fb_div_N1;
+	uint8_t fb_div_N2;
+	uint8_t band;
+	uint8_t out_div;
+};
+
 #define ENC_8B10B		810
 
 /******************************************************************************/
@@ -0,0 +1,314 @@
+/* Generated by tools/scripts/xcvr_pll_table.py, do not edit. */
+#ifndef XILINX_TRANSCEIVER_PLL_TABLE_H_
+#define XILINX_TRANSCEIVER_PLL_TABLE_H_
+
+#include "xilinx_transceiver.h"
+
+/* refclk_khz, lane_rate_khz, vco_max, gtx2, qpll, refclk_div, fb_div, fb_div_N1, fb_div_N2, band, out_div */
+static const struct xilinx_xcvr_pll_solution xilinx_xcvr_pll_table[] = {
+	{122880, 1228800, 3300000, 1, 0, 1, 0, 5, 4, 0, 4},
+	{122880, 1228800, 6250000, 0, 0, 1, 0, 5, 4, 0, 4},
+	{122880, 1228800, 4250000, 0, 0, 1, 0, 5, 4, 0, 4},
+	{122880, 1228800, 0, 1, 1, 1, 80, 0, 0, 1, 8},
+	{122880, 1228800, 0, 0, 1, 1, 80, 0, 0, 1, 8},
+	{122880, 2457600, 3300000, 1, 0, 1, 0, 5, 4, 0, 2},
+	{122880, 2457600, 6250000, 0, 0, 1, 0, 5, 4, 0, 2},
+	{122880, 2457600, 4250000, 0, 0, 1, 0, 5, 4, 0, 2},
+	{122880, 2457600, 0, 1, 1, 1, 80, 0, 0, 1, 4},
+	{122880, 2457600, 0, 0, 1, 1, 80, 0, 0, 1, 4},
+	{122880, 3072000, 3300000, 1, 0, 1, 0, 5, 5, 0, 2},
+	{122880, 3072000, 6250000, 0, 0, 1, 0, 5, 5, 0, 2},
+	{122880, 3072000, 4250000, 0, 0, 1, 0, 5, 5, 0, 2},
+	{122880, 3072000, 0, 1, 1, 1, 100, 0, 0, 1, 4},
+	{122880, 3072000, 0, 0, 1, 1, 100, 0, 0, 1, 4},
+	{122880, 4915200, 3300000, 1, 0, 1, 0, 5, 4, 0, 1},
+	{122880, 4915200, 6250000, 0, 0, 1, 0, 5, 4, 0, 1},
+	{122880, 4915200, 4250000, 0, 0, 1, 0, 5, 4, 0, 1},
+	{122880, 4915200, 0, 1, 1, 1, 80, 0, 0, 1, 2},
+	{122880, 4915200, 0, 0, 1, 1, 80, 0, 0, 1, 2},
+	{122880, 6144000, 3300000, 1, 0, 1, 0, 5, 5, 0, 1},
+	{122880, 6144000, 6250000, 0, 0, 1, 0, 5, 5, 0, 1},
+	{122880, 6144000, 4250000, 0, 0, 1, 0, 5, 5, 0, 1},
+	{122880, 6144000, 0, 1, 1, 1, 100, 0, 0, 1, 2},
+	{122880, 6144000, 0, 0, 1, 1, 100, 0, 0, 1, 2},
+	{122880, 7372800, 0, 0, 1, 1, 120, 0, 0, 0, 2},
+	{122880, 9830400, 0, 1, 1, 1, 80, 0, 0, 1, 1},
+	{122880, 9830400, 0, 0, 1, 1, 80, 0, 0, 1, 1},
+	{122880, 12288000, 0, 1, 1, 1, 100, 0, 0, 1, 1},
+	{122880, 12288000, 0, 0, 1, 1, 100, 0, 0, 1, 1},
+	{125000, 2500000, 3300000, 1, 0, 1, 0, 5, 4, 0, 2},
+	{125000, 2500000, 6250000, 0, 0, 1, 0, 5, 4, 0, 2},
+	{125000, 2500000, 4250000, 0, 0, 1, 0, 5, 4, 0, 2},
+	{125000, 2500000, 0, 1, 1, 1, 80, 0, 0, 1, 4},
+	{125000, 2500000, 0, 0, 1, 1, 80, 0, 0, 1, 4},
+	{125000, 4000000, 3300000, 1, 0, 1, 0, 4, 4, 0, 1},
+	{125000, 4000000, 6250000, 0, 0, 1, 0, 4, 4, 0, 1},
+	{125000, 4000000, 4250000, 0, 0, 1, 0, 4, 4, 0, 1},
+	{125000, 4000000, 0, 1, 1, 1, 64, 0, 0, 0, 2},
+	{125000, 4000000, 0, 0, 1, 1, 64, 0, 0, 1, 2},
+	{125000, 5000000, 3300000, 1, 0, 1, 0, 5, 4, 0, 1},
+	{125000, 5000000, 6250000, 0, 0, 1, 0, 5, 4, 0, 1},
+	{125000, 5000000, 4250000, 0, 0, 1, 0, 5, 4, 0, 1},
+	{125000, 5000000, 0, 1, 1, 1, 80, 0, 0, 1, 2},
+	{125000, 5000000, 0, 0, 1, 1, 80, 0, 0, 1, 2},
+	{125000, 6250000, 3300000, 1, 0, 1, 0, 5, 5, 0, 1},
+	{125000, 6250000, 6250000, 0, 0, 1, 0, 5, 5, 0, 1},
+	{125000, 6250000, 4250000, 0, 0, 1, 0, 5, 5, 0, 1},
+	{125000, 6250000, 0, 1, 1, 1, 100, 0, 0, 1, 2},
+	{125000, 6250000, 0, 0, 1, 1, 100, 0, 0, 1, 2},
+	{125000, 10000000, 0, 1, 1, 1, 80, 0, 0, 1, 1},
+	{125000, 10000000, 0, 0, 1, 1, 80, 0, 0, 1, 1},
+	{125000, 15000000, 0, 0, 1, 1, 120, 0, 0, 0, 1},
+	{153600, 1228800, 3300000, 1, 0, 1, 0, 4, 4, 0, 4},
+	{153600, 1228800, 6250000, 0, 0, 1, 0, 4, 4, 0, 4},
+	{153600, 1228800, 4250000, 0, 0, 1, 0, 4, 4, 0, 4},
+	{153600, 1228800, 0, 1, 1, 1, 64, 0, 0, 1, 8},
+	{153600, 1228800, 0, 0, 1, 1, 64, 0, 0, 1, 8},
+	{153600, 2457600, 3300000, 1, 0, 1, 0, 4, 4, 0, 2},
+	{153600, 2457600, 6250000, 0, 0, 1, 0, 4, 4, 0, 2},
+	{153600, 2457600, 4250000, 0, 0, 1, 0, 4, 4, 0, 2},
+	{153600, 2457600, 0, 1, 1, 1, 64, 0, 0, 1, 4},
+	{153600, 2457600, 0, 0, 1, 1, 64, 0, 0, 1, 4},
+	{153600, 3072000, 3300000, 1, 0, 1, 0, 5, 4, 0, 2},
+	{153600, 3072000, 6250000, 0, 0, 1, 0, 5, 4, 0, 2},
+	{153600, 3072000, 4250000, 0, 0, 1, 0, 5, 4, 0, 2},
+	{153600, 3072000, 0, 1, 1, 1, 40, 0, 0, 0, 2},
+	{153600, 3072000, 0, 0, 1, 1, 80, 0, 0, 1, 4},
+	{153600, 4915200, 3300000, 1, 0, 1, 0, 4, 4, 0, 1},
+	{153600, 4915200, 6250000, 0, 0, 1, 0, 4, 4, 0, 1},
+	{153600, 4915200, 4250000, 0, 0, 1, 0, 4, 4, 0, 1},
+	{153600, 4915200, 0, 1, 1, 1, 64, 0, 0, 1, 2},
+	{153600, 4915200, 0, 0, 1, 1, 64, 0, 0, 1, 2},
+	{153600, 6144000, 3300000, 1, 0, 1, 0, 5, 4, 0, 1},
+	{153600, 6144000, 6250000, 0, 0, 1, 0, 5, 4, 0, 1},
+	{153600, 6144000, 4250000, 0, 0, 1, 0, 5, 4, 0, 1},
+	{153600, 6144000, 0, 1, 1, 1, 40, 0, 0, 0, 1},
+	{153600, 6144000, 0, 0, 1, 1, 80, 0, 0, 1, 2},
+	{153600, 9830400, 0, 1, 1, 1, 64, 0, 0, 1, 1},
+	{153600, 9830400, 0, 0, 1, 1, 64, 0, 0, 1, 1},
+	{153600, 12288000, 0, 1, 1, 1, 80, 0, 0, 1, 1},
+	{153600, 12288000, 0, 0, 1, 1, 80, 0, 0, 1, 1},
+	{184320, 1228800, 0, 0, 1, 3, 160, 0, 0, 1, 8},
+	{184320, 2457600, 0, 0, 1, 3, 160, 0, 0, 1, 4},
+	{184320, 3072000, 0, 1, 1, 3, 100, 0, 0, 0, 2},
+	{184320, 4915200, 0, 0, 1, 3, 160, 0, 0, 1, 2},
+	{184320, 6144000, 0, 1, 1, 3, 100, 0, 0, 0, 1},
+	{184320, 7372800, 6250000, 0, 0, 1, 0, 5, 4, 0, 1},
+	{184320, 7372800, 4250000, 0, 0, 1, 0, 5, 4, 0, 1},
+	{184320, 7372800, 0, 1, 1, 1, 40, 0, 0, 0, 1},
+	{184320, 7372800, 0, 0, 1, 1, 80, 0, 0, 0, 2},
+	{184320, 9830400, 0, 0, 1, 3, 160, 0, 0, 1, 1},
+	{200000, 2500000, 3300000, 1, 0, 2, 0, 5, 5, 0, 2},
+	{200000, 2500000, 6250000, 0, 0, 1, 0, 5, 5, 0, 4},
+	{200000, 2500000, 4250000, 0, 0, 2, 0, 5, 5, 0, 2},
+	{200000, 2500000, 0, 1, 1, 2, 100, 0, 0, 1, 4},
+	{200000, 2500000, 0, 0, 1, 2, 100, 0, 0, 1, 4},
+	{200000, 4000000, 3300000, 1, 0, 1, 0, 5, 2, 0, 1},
+	{200000, 4000000, 6250000, 0, 0, 1, 0, 5, 2, 0, 1},
+	{200000, 4000000, 4250000, 0, 0, 1, 0, 5, 2, 0, 1},
+	{200000, 4000000, 0, 1, 1, 1, 40, 0, 0, 0, 2},
+	{200000, 4000000, 0, 0, 1, 1, 40, 0, 0, 1, 2},
+	{200000, 5000000, 3300000, 1, 0, 2, 0, 5, 5, 0, 1},
+	{200000, 5000000, 6250000, 0, 0, 1, 0, 5, 5, 0, 2},
+	{200000, 5000000, 4250000, 0, 0, 2, 0, 5, 5, 0, 1},
+	{200000, 5000000, 0, 1, 1, 2, 100, 0, 0, 1, 2},
+	{200000, 5000000, 0, 0, 1, 2, 100, 0, 0, 1, 2},
+	{200000, 6250000, 0, 0, 1, 2, 125, 0, 0, 1, 2},
+	{200000, 10000000, 6250000, 0, 0, 1, 0, 5, 5, 0, 1},
+	{200000, 10000000, 0, 1, 1, 2, 100, 0, 0, 1, 1},
+	{200000, 10000000, 0, 0, 1, 2, 100, 0, 0, 1, 1},
+	{200000, 15000000, 0, 0, 1, 1, 75, 0, 0, 0, 1},
+	{245760, 1228800, 3300000, 1, 0, 1, 0, 5, 2, 0, 4},
+	{245760, 1228800, 6250000, 0, 0, 1, 0, 5, 2, 0, 4},
+	{245760, 1228800, 4250000, 0, 0, 1, 0, 5, 2, 0, 4},
+	{245760, 1228800, 0, 1, 1, 1, 40, 0, 0, 1, 8},
+	{245760, 1228800, 0, 0, 1, 1, 40, 0, 0, 1, 8},
+	{245760, 2457600, 3300000, 1, 0, 1, 0, 5, 2, 0, 2},
+	{245760, 2457600, 6250000, 0, 0, 1, 0, 5, 2, 0, 2},
+	{245760, 2457600, 4250000, 0, 0, 1, 0, 5, 2, 0, 2},
+	{245760, 2457600, 0, 1, 1, 1, 40, 0, 0, 1, 4},
+	{245760, 2457600, 0, 0, 1, 1, 40, 0, 0, 1, 4},
+	{245760, 3072000, 3300000, 1, 0, 2, 0, 5, 5, 0, 2},
+	{245760, 3072000, 6250000, 0, 0, 1, 0, 5, 5, 0, 4},
+	{245760, 3072000, 4250000, 0, 0, 2, 0, 5, 5, 0, 2},
+	{245760, 3072000, 0, 1, 1, 2, 100, 0, 0, 1, 4},
+	{245760, 3072000, 0, 0, 1, 2, 100, 0, 0, 1, 4},
+	{245760, 4915200, 3300000, 1, 0, 1, 0, 5, 2, 0, 1},
+	{245760, 4915200, 6250000, 0, 0, 1, 0, 5, 2, 0, 1},
+	{245760, 4915200, 4250000, 0, 0, 1, 0, 5, 2, 0, 1},
+	{245760, 4915200, 0, 1, 1, 1, 40, 0, 0, 1, 2},
+	{245760, 4915200, 0, 0, 1, 1, 40, 0, 0, 1, 2},
+	{245760, 6144000, 3300000, 1, 0, 2, 0, 5, 5, 0, 1},
+	{245760, 6144000, 6250000, 0, 0, 1, 0, 5, 5, 0, 2},
+	{245760, 6144000, 4250000, 0, 0, 2, 0, 5, 5, 0, 1},
+	{245760, 6144000, 0, 1, 1, 2, 100, 0, 0, 1, 2},
+	{245760, 6144000, 0, 0, 1, 2, 100, 0, 0, 1, 2},
+	{245760, 7372800, 6250000, 0, 0, 1, 0, 5, 3, 0, 1},
+	{245760, 7372800, 4250000, 0, 0, 1, 0, 5, 3, 0, 1},
+	{245760, 7372800, 0, 0, 1, 2, 120, 0, 0, 0, 2},
+	{245760, 9830400, 6250000, 0, 0, 1, 0, 5, 4, 0, 1},
+	{245760, 9830400, 0, 1, 1, 1, 40, 0, 0, 1, 1},
+	{245760, 9830400, 0, 0, 1, 1, 40, 0, 0, 1, 1},
+	{245760, 12288000, 6250000, 0, 0, 1, 0, 5, 5, 0, 1},
+	{245760, 12288000, 0, 1, 1, 2, 100, 0, 0, 1, 1},
+	{245760, 12288000, 0, 0, 1, 2, 100, 0, 0, 1, 1},
+	{250000, 2500000, 3300000, 1, 0, 1, 0, 5, 2, 0, 2},
+	{250000, 2500000, 6250000, 0, 0, 1, 0, 5, 2, 0, 2},
+	{250000, 2500000, 4250000, 0, 0, 1, 0, 5, 2, 0, 2},
+	{250000, 2500000, 0, 1, 1, 1, 40, 0, 0, 1, 4},
+	{250000, 2500000, 0, 0, 1, 1, 40, 0, 0, 1, 4},
+	{250000, 4000000, 3300000, 1, 0, 1, 0, 4, 2, 0, 1},
+	{250000, 4000000, 6250000, 0, 0, 1, 0, 4, 2, 0, 1},
+	{250000, 4000000, 4250000, 0, 0, 1, 0, 4, 2, 0, 1},
+	{250000, 4000000, 0, 1, 1, 1, 32, 0, 0, 0, 2},
+	{250000, 4000000, 0, 0, 1, 1, 32, 0, 0, 1, 2},
+	{250000, 5000000, 3300000, 1, 0, 1, 0, 5, 2, 0, 1},
+	{250000, 5000000, 6250000, 0, 0, 1, 0, 5, 2, 0, 1},
+	{250000, 5000000, 4250000, 0, 0, 1, 0, 5, 2, 0, 1},
+	{250000, 5000000, 0, 1, 1, 1, 40, 0, 0, 1, 2},
+	{250000, 5000000, 0, 0, 1, 1, 40, 0, 0, 1, 2},
+	{250000, 6250000, 3300000, 1, 0, 2, 0, 5, 5, 0, 1},
+	{250000, 6250000, 6250000, 0, 0, 1, 0, 5, 5, 0, 2},
+	{250000, 6250000, 4250000, 0, 0, 2, 0, 5, 5, 0, 1},
+	{250000, 6250000, 0, 1, 1, 2, 100, 0, 0, 1, 2},
+	{250000, 6250000, 0, 0, 1, 2, 100, 0, 0, 1, 2},
+	{250000, 10000000, 6250000, 0, 0, 1, 0, 5, 4, 0, 1},
+	{250000, 10000000, 0, 1, 1, 1, 40, 0, 0, 1, 1},
+	{250000, 10000000, 0, 0, 1, 1, 40, 0, 0, 1, 1},
+	{250000, 15000000, 0, 0, 1, 2, 120, 0, 0, 0, 1},
+	{307200, 1228800, 3300000, 1, 0, 1, 0, 4, 2, 0, 4},
+	{307200, 1228800, 6250000, 0, 0, 1, 0, 4, 2, 0, 4},
+	{307200, 1228800, 4250000, 0, 0, 1, 0, 4, 2, 0, 4},
+	{307200, 1228800, 0, 1, 1, 1, 32, 0, 0, 1, 8},
+	{307200, 1228800, 0, 0, 1, 1, 32, 0, 0, 1, 8},
+	{307200, 2457600, 3300000, 1, 0, 1, 0, 4, 2, 0, 2},
+	{307200, 2457600, 6250000, 0, 0, 1, 0, 4, 2, 0, 2},
+	{307200, 2457600, 4250000, 0, 0, 1, 0, 4, 2, 0, 2},
+	{307200, 2457600, 0, 1, 1, 1, 32, 0, 0, 1, 4},
+	{307200, 2457600, 0, 0, 1, 1, 32, 0, 0, 1, 4},
+	{307200, 3072000, 3300000, 1, 0, 1, 0, 5, 2, 0, 2},
+	{307200, 3072000, 6250000, 0, 0, 1, 0, 5, 2, 0, 2},
+	{307200, 3072000, 4250000, 0, 0, 1, 0, 5, 2, 0, 2},
+	{307200, 3072000, 0, 1, 1, 1, 20, 0, 0, 0, 2},
+	{307200, 3072000, 0, 0, 1, 1, 40, 0, 0, 1, 4},
+	{307200, 4915200, 3300000, 1, 0, 1, 0, 4, 2, 0, 1},
+	{307200, 4915200, 6250000, 0, 0, 1, 0, 4, 2, 0, 1},
+	{307200, 4915200, 4250000, 0, 0, 1, 0, 4, 2, 0, 1},
+	{307200, 4915200, 0, 1, 1, 1, 32, 0, 0, 1, 2},
+	{307200, 4915200, 0, 0, 1, 1, 32, 0, 0, 1, 2},
+	{307200, 6144000, 3300000, 1, 0, 1, 0, 5, 2, 0, 1},
+	{307200, 6144000, 6250000, 0, 0, 1, 0, 5, 2, 0, 1},
+	{307200, 6144000, 4250000, 0, 0, 1, 0, 5, 2, 0, 1},
+	{307200, 6144000, 0, 1, 1, 1, 20, 0, 0, 0, 1},
+	{307200, 6144000, 0, 0, 1, 1, 40, 0, 0, 1, 2},
+	{307200, 7372800, 6250000, 0, 0, 1, 0, 4, 3, 0, 1},
+	{307200, 7372800, 4250000, 0, 0, 1, 0, 4, 3, 0, 1},
+	{307200, 9830400, 6250000, 0, 0, 1, 0, 4, 4, 0, 1},
+	{307200, 9830400, 0, 1, 1, 1, 32, 0, 0, 1, 1},
+	{307200, 9830400, 0, 0, 1, 1, 32, 0, 0, 1, 1},
+	{307200, 12288000, 6250000, 0, 0, 1, 0, 5, 4, 0, 1},
+	{307200, 12288000, 0, 1, 1, 1, 40, 0, 0, 1, 1},
+	{307200, 12288000, 0, 0, 1, 1, 40, 0, 0, 1, 1},
+	{368640, 1228800, 0, 1, 1, 3, 80, 0, 0, 1, 8},
+	{368640, 1228800, 0, 0, 1, 3, 80, 0, 0, 1, 8},
+	{368640, 2457600, 0, 1, 1, 3, 80, 0, 0, 1, 4},
+	{368640, 2457600, 0, 0, 1, 3, 80, 0, 0, 1, 4},
+	{368640, 3072000, 0, 1, 1, 3, 100, 0, 0, 1, 4},
+	{368640, 3072000, 0, 0, 1, 3, 100, 0, 0, 1, 4},
+	{368640, 4915200, 0, 1, 1, 3, 80, 0, 0, 1, 2},
+	{368640, 4915200, 0, 0, 1, 3, 80, 0, 0, 1, 2},
+	{368640, 6144000, 0, 1, 1, 3, 100, 0, 0, 1, 2},
+	{368640, 6144000, 0, 0, 1, 3, 100, 0, 0, 1, 2},
+	{368640, 7372800, 6250000, 0, 0, 1, 0, 5, 2, 0, 1},
+	{368640, 7372800, 4250000, 0, 0, 1, 0, 5, 2, 0, 1},
+	{368640, 7372800, 0, 1, 1, 1, 20, 0, 0, 0, 1},
+	{368640, 7372800, 0, 0, 1, 1, 40, 0, 0, 0, 2},
+	{368640, 9830400, 0, 1, 1, 3, 80, 0, 0, 1, 1},
+	{368640, 9830400, 0, 0, 1, 3, 80, 0, 0, 1, 1},
+	{368640, 12288000, 0, 1, 1, 3, 100, 0, 0, 1, 1},
+	{368640, 12288000, 0, 0, 1, 3, 100, 0, 0, 1, 1},
+	{491520, 1228800, 3300000, 1, 0, 1, 0, 5, 1, 0, 4},
+	{491520, 1228800, 6250000, 0, 0, 1, 0, 5, 1, 0, 4},
+	{491520, 1228800, 4250000, 0, 0, 1, 0, 5, 1, 0, 4},
+	{491520, 1228800, 0, 1, 1, 1, 20, 0, 0, 1, 8},
+	{491520, 1228800, 0, 0, 1, 1, 20, 0, 0, 1, 8},
+	{491520, 2457600, 3300000, 1, 0, 1, 0, 5, 1, 0, 2},
+	{491520, 2457600, 6250000, 0, 0, 1, 0, 5, 1, 0, 2},
+	{491520, 2457600, 4250000, 0, 0, 1, 0, 5, 1, 0, 2},
+	{491520, 2457600, 0, 1, 1, 1, 20, 0, 0, 1, 4},
+	{491520, 2457600, 0, 0, 1, 1, 20, 0, 0, 1, 4},
+	{491520, 3072000, 6250000, 0, 0, 2, 0, 5, 5, 0, 4},
+	{491520, 3072000, 0, 1, 1, 4, 100, 0, 0, 1, 4},
+	{491520, 3072000, 0, 0, 1, 3, 75, 0, 0, 1, 4},
+	{491520, 4915200, 3300000, 1, 0, 1, 0, 5, 1, 0, 1},
+	{491520, 4915200, 6250000, 0, 0, 1, 0, 5, 1, 0, 1},
+	{491520, 4915200, 4250000, 0, 0, 1, 0, 5, 1, 0, 1},
+	{491520, 4915200, 0, 1, 1, 1, 20, 0, 0, 1, 2},
+	{491520, 4915200, 0, 0, 1, 1, 20, 0, 0, 1, 2},
+	{491520, 6144000, 6250000, 0, 0, 2, 0, 5, 5, 0, 2},
+	{491520, 6144000, 0, 1, 1, 4, 100, 0, 0, 1, 2},
+	{491520, 6144000, 0, 0, 1, 3, 75, 0, 0, 1, 2},
+	{491520, 7372800, 6250000, 0, 0, 2, 0, 5, 3, 0, 1},
+	{491520, 7372800, 4250000, 0, 0, 2, 0, 5, 3, 0, 1},
+	{491520, 7372800, 0, 0, 1, 4, 120, 0, 0, 0, 2},
+	{491520, 9830400, 6250000, 0, 0, 1, 0, 5, 2, 0, 1},
+	{491520, 9830400, 0, 1, 1, 1, 20, 0, 0, 1, 1},
+	{491520, 9830400, 0, 0, 1, 1, 20, 0, 0, 1, 1},
+	{491520, 12288000, 6250000, 0, 0, 2, 0, 5, 5, 0, 1},
+	{491520, 12288000, 0, 1, 1, 4, 100, 0, 0, 1, 1},
+	{491520, 12288000, 0, 0, 1, 3, 75, 0, 0, 1, 1},
+	{500000, 2500000, 3300000, 1, 0, 1, 0, 5, 1, 0, 2},
+	{500000, 2500000, 6250000, 0, 0, 1, 0, 5, 1, 0, 2},
+	{500000, 2500000, 4250000, 0, 0, 1, 0, 5, 1, 0, 2},
+	{500000, 2500000, 0, 1, 1, 1, 20, 0, 0, 1, 4},
+	{500000, 2500000, 0, 0, 1, 1, 20, 0, 0, 1, 4},
+	{500000, 4000000, 3300000, 1, 0, 1, 0, 4, 1, 0, 1},
+	{500000, 4000000, 6250000, 0, 0, 1, 0, 4, 1, 0, 1},
+	{500000, 4000000, 4250000, 0, 0, 1, 0, 4, 1, 0, 1},
+	{500000, 4000000, 0, 1, 1, 1, 16, 0, 0, 0, 2},
+	{500000, 4000000, 0, 0, 1, 1, 16, 0, 0, 1, 2},
+	{500000, 5000000, 3300000, 1, 0, 1, 0, 5, 1, 0, 1},
+	{500000, 5000000, 6250000, 0, 0, 1, 0, 5, 1, 0, 1},
+	{500000, 5000000, 4250000, 0, 0, 1, 0, 5, 1, 0, 1},
+	{500000, 5000000, 0, 1, 1, 1, 20, 0, 0, 1, 2},
+	{500000, 5000000, 0, 0, 1, 1, 20, 0, 0, 1, 2},
+	{500000, 6250000, 6250000, 0, 0, 2, 0, 5, 5, 0, 2},
+	{500000, 6250000, 0, 1, 1, 4, 100, 0, 0, 1, 2},
+	{500000, 6250000, 0, 0, 1, 3, 75, 0, 0, 1, 2},
+	{500000, 10000000, 6250000, 0, 0, 1, 0, 5, 2, 0, 1},
+	{500000, 10000000, 0, 1, 1, 1, 20, 0, 0, 1, 1},
+	{500000, 10000000, 0, 0, 1, 1, 20, 0, 0, 1, 1},
+	{500000, 15000000, 0, 0, 1, 4, 120, 0, 0, 0, 1},
+	{616500, 12330000, 6250000, 0, 0, 1, 0, 5, 2, 0, 1},
+	{616500, 12330000, 0, 1, 1, 1, 20, 0, 0, 1, 1},
+	{616500, 12330000, 0, 0, 1, 1, 20, 0, 0, 1, 1},
+	{625000, 2500000, 3300000, 1, 0, 1, 0, 4, 1, 0, 2},
+	{625000, 2500000, 6250000, 0, 0, 1, 0, 4, 1, 0, 2},
+	{625000, 2500000, 4250000, 0, 0, 1, 0, 4, 1, 0, 2},
+	{625000, 2500000, 0, 1, 1, 1, 16, 0, 0, 1, 4},
+	{625000, 2500000, 0, 0, 1, 1, 16, 0, 0, 1, 4},
+	{625000, 5000000, 3300000, 1, 0, 1, 0, 4, 1, 0, 1},
+	{625000, 5000000, 6250000, 0, 0, 1, 0, 4, 1, 0, 1},
+	{625000, 5000000, 4250000, 0, 0, 1, 0, 4, 1, 0, 1},
+	{625000, 5000000, 0, 1, 1, 1, 16, 0, 0, 1, 2},
+	{625000, 5000000, 0, 0, 1, 1, 16, 0, 0, 1, 2},
+	{625000, 6250000, 3300000, 1, 0, 1, 0, 5, 1, 0, 1},
+	{625000, 6250000, 6250000, 0, 0, 1, 0, 5, 1, 0, 1},
+	{625000, 6250000, 4250000, 0, 0, 1, 0, 5, 1, 0, 1},
+	{625000, 6250000, 0, 1, 1, 1, 20, 0, 0, 1, 2},
+	{625000, 6250000, 0, 0, 1, 1, 20, 0, 0, 1, 2},
+	{625000, 10000000, 6250000, 0, 0, 1, 0, 4, 2, 0, 1},
+	{625000, 10000000, 0, 1, 1, 1, 16, 0, 0, 1, 1},
+	{625000, 10000000, 0, 0, 1, 1, 16, 0, 0, 1, 1},
+	{750000, 2500000, 0, 1, 1, 3, 40, 0, 0, 1, 4},
+	{750000, 2500000, 0, 0, 1, 3, 40, 0, 0, 1, 4},
+	{750000, 4000000, 0, 1, 1, 3, 32, 0, 0, 0, 2},
+	{750000, 4000000, 0, 0, 1, 3, 32, 0, 0, 1, 2},
+	{750000, 5000000, 0, 1, 1, 3, 40, 0, 0, 1, 2},
+	{750000, 5000000, 0, 0, 1, 3, 40, 0, 0, 1, 2},
+	{750000, 10000000, 0, 1, 1, 3, 40, 0, 0, 1, 1},
+	{750000, 10000000, 0, 0, 1, 3, 40, 0, 0, 1, 1},
+	{750000, 15000000, 0, 0, 1, 1, 20, 0, 0, 0, 1},
+};
+
+#endif
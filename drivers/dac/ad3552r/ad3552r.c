@@ -48,6 +48,7 @@
 #include "no-os/error.h"
 #include "no-os/gpio.h"
 #include "no-os/print_log.h"
+#include "no-os/pwm.h"
 #include "no-os/spi.h"
 #include "no-os/timer.h"
 #include "no-os/util.h"
@@ -81,7 +82,6 @@ enum ad3552r_spi_attributes {
 #define AD3552R_CRC_ENABLE_VALUE			(BIT(6) | BIT(1))
 #define AD3552R_CRC_DISABLE_VALUE			(BIT(1) | BIT(0))
 #define AD3552R_EXTERNAL_VREF_MASK			BIT(1)
-#define AD3552R_CRC_POLY				0x07
 #define AD3552R_CRC_SEED				0xA5
 #define AD3552R_SECONDARY_REGION_ADDR			0x28
 #define AD3552R_DEFAULT_CONFIG_B_VALUE			0x8
@@ -354,7 +354,7 @@ static int32_t _ad3552r_transfer_with_crc(struct ad3552r_desc *desc,
 			       + (inc % desc->spi_cfg.stream_mode_length);
 		else
 			addr = data->addr + inc;
-		addr %= AD3552R_REG_ADDR_MAX;
+		addr %= AD3552R_REG_ADDR_MAX + 1;
 		reg_len = _ad3552r_reg_len(addr);
 
 		/* Prepare CRC to send */
@@ -362,7 +362,7 @@ static int32_t _ad3552r_transfer_with_crc(struct ad3552r_desc *desc,
 		if (i > 0)
 			crc_init = addr;
 		else
-			crc_init = crc8(desc->crc_table, &instr, 1,
+			crc_init = crc8(crc8_table_07, &instr, 1,
 					AD3552R_CRC_SEED);
 
 		if (data->is_read && i > 0) {
@@ -377,7 +377,7 @@ static int32_t _ad3552r_transfer_with_crc(struct ad3552r_desc *desc,
 				++msg.bytes_number;
 			}
 			memcpy(pbuf, data->data + i, reg_len);
-			pbuf[reg_len] = crc8(desc->crc_table, pbuf, reg_len,
+			pbuf[reg_len] = crc8(crc8_table_07, pbuf, reg_len,
 					     crc_init);
 		}
 
@@ -395,7 +395,7 @@ static int32_t _ad3552r_transfer_with_crc(struct ad3552r_desc *desc,
 			/* Save received data */
 			memcpy(data->data + i, pbuf, reg_len);
 			if (pbuf[reg_len] !=
-			    crc8(desc->crc_table, pbuf, reg_len, crc_init))
+			    crc8(crc8_table_07, pbuf, reg_len, crc_init))
 				return -EBADMSG;
 		} else {
 			if (in[reg_len + (i == 0)] != out[reg_len + (i == 0)])
@@ -1060,7 +1060,37 @@ static int32_t ad3552r_configure_device(struct ad3552r_desc *desc,
 			return err;
 		}
 	}
+
+	if (param->ldac_pwm_param_optional) {
+		err = pwm_init(&desc->ldac_pwm, param->ldac_pwm_param_optional);
+		if (IS_ERR_VALUE(err))
+			goto err_ldac;
+	}
+
+	if (param->timer_param_optional) {
+		err = timer_init(&desc->timer, param->timer_param_optional);
+		if (IS_ERR_VALUE(err))
+			goto err_pwm;
+
+		err = timer_start(desc->timer);
+		if (IS_ERR_VALUE(err))
+			goto err_timer;
+	}
+
 	return SUCCESS;
+err_timer:
+	timer_remove(desc->timer);
+	desc->timer = NULL;
+err_pwm:
+	if (desc->ldac_pwm)
+		pwm_remove(desc->ldac_pwm);
+	desc->ldac_pwm = NULL;
+err_ldac:
+	if (desc->ldac)
+		gpio_remove(desc->ldac);
+	desc->ldac = NULL;
+
+	return err;
 }
 
 int32_t ad3552r_init(struct ad3552r_desc **desc,
@@ -1081,8 +1111,6 @@ int32_t ad3552r_init(struct ad3552r_desc **desc,
 	if (IS_ERR_VALUE(err))
 		goto err;
 
-	crc8_populate_msb(ldesc->crc_table, AD3552R_CRC_POLY);
-
 	err = gpio_get_optional(&ldesc->reset,
 				param->reset_gpio_param_optional);
 	if (IS_ERR_VALUE(err))
@@ -1155,6 +1183,14 @@ err:
 
 int32_t ad3552r_remove(struct ad3552r_desc *desc)
 {
+	if (desc->stream)
+		ad3552r_stream_stop(desc);
+	if (desc->timer) {
+		timer_stop(desc->timer);
+		timer_remove(desc->timer);
+	}
+	if (desc->ldac_pwm)
+		pwm_remove(desc->ldac_pwm);
 	if (desc->ldac)
 		gpio_remove(desc->ldac);
 	if (desc->reset)
@@ -1310,6 +1346,394 @@ int32_t ad3552r_write_samples(struct ad3552r_desc *desc, uint16_t *data,
 	return SUCCESS;
 }
 
+/* Streaming playback state */
+struct ad3552r_stream {
+	struct ad3552r_stream_config cfg;
+	/* Interface configuration to restore on stop */
+	struct ad3552_transfer_config old_spi_cfg;
+	/* Instruction starting each transfer and its CRC */
+	uint8_t instr;
+	uint8_t instr_crc;
+	/* Registers of a frame, in the order they are written */
+	uint8_t nb_regs;
+	uint8_t reg_addr[AD3552R_NUM_CH + 1];
+	uint8_t reg_len[AD3552R_NUM_CH + 1];
+	/* Index of the sample written to a register. -1 for software LDAC */
+	int8_t reg_src[AD3552R_NUM_CH + 1];
+	uint8_t nb_ch;
+	uint8_t is_fast;
+	/* Bytes of a frame on the wire, CRC bytes included */
+	uint32_t frame_len;
+	uint8_t *tx;
+	uint8_t *rx;
+	/* Time at which the next frame is due, for timer pacing */
+	uint64_t next_ns;
+};
+
+/* Add the register of a frame, right below the previous one */
+static void _ad3552r_stream_add_reg(struct ad3552r_stream *st, uint8_t addr,
+				    int8_t src)
+{
+	st->reg_addr[st->nb_regs] = addr;
+	st->reg_len[st->nb_regs] = _ad3552r_reg_len(addr);
+	st->reg_src[st->nb_regs] = src;
+	st->nb_regs++;
+}
+
+/*
+ * A frame is one update of the active channels, written from the highest
+ * register down. In stream mode, with the loop length set to the frame
+ * size, the address wraps back to the first register after each frame, so
+ * any number of frames can follow a single instruction.
+ */
+static int32_t _ad3552r_stream_layout(struct ad3552r_desc *desc,
+				      struct ad3552r_stream *st)
+{
+	uint32_t mask = st->cfg.ch_mask;
+	uint8_t is_dac, ldac, ch, addr;
+
+	if (!mask || (mask & ~AD3552R_MASK_ALL_CH))
+		return -EINVAL;
+
+	if (mask == AD3552R_MASK_ALL_CH &&
+	    desc->ch_data[0].fast_en != desc->ch_data[1].fast_en)
+		return -EINVAL;
+
+	ch = find_first_set_bit(mask);
+	st->nb_ch = hweight8(mask);
+	st->is_fast = desc->ch_data[ch].fast_en;
+	is_dac = st->cfg.mode == AD3552R_WRITE_DAC_REGS;
+	ldac = st->cfg.mode == AD3552R_WRITE_INPUT_REGS_AND_TRIGGER_LDAC;
+	if (st->cfg.pacing == AD3552R_STREAM_LDAC_PWM) {
+		if (!desc->ldac_pwm || is_dac)
+			return -EINVAL;
+		ldac = 0;
+	}
+	/*
+	 * The software LDAC register follows channel 0. Updating channel 1
+	 * alone through its DAC register has the same effect.
+	 */
+	if (ldac && mask == AD3552R_MASK_CH(1)) {
+		is_dac = 1;
+		ldac = 0;
+	}
+
+	if (mask == AD3552R_MASK_ALL_CH) {
+		_ad3552r_stream_add_reg(st, _get_code_reg_addr(1, is_dac,
+					st->is_fast), 1);
+		_ad3552r_stream_add_reg(st, _get_code_reg_addr(0, is_dac,
+					st->is_fast), 0);
+	} else {
+		_ad3552r_stream_add_reg(st, _get_code_reg_addr(ch, is_dac,
+					st->is_fast), 0);
+	}
+	if (ldac) {
+		addr = st->reg_addr[st->nb_regs - 1] -
+		       st->reg_len[st->nb_regs - 1];
+		_ad3552r_stream_add_reg(st, addr, -1);
+	}
+
+	st->frame_len = 0;
+	for (ch = 0; ch < st->nb_regs; ch++)
+		st->frame_len += st->reg_len[ch] + (desc->crc_en ? 1 : 0);
+
+	return SUCCESS;
+}
+
+/*
+ * Pack frames in the transfer buffer and compute all their CRCs. The first
+ * register after an instruction has the instruction in its CRC, the others
+ * are seeded with their address.
+ */
+static uint32_t _ad3552r_stream_pack(struct ad3552r_desc *desc,
+				     const uint16_t *data, uint32_t samples,
+				     bool instr_per_frame)
+{
+	struct ad3552r_stream *st = desc->stream;
+	uint8_t *p = st->tx, *reg;
+	uint32_t i, j;
+	uint16_t val;
+	uint8_t seed;
+
+	for (i = 0; i < samples; i++, data += st->nb_ch) {
+		if (i == 0 || instr_per_frame)
+			*p++ = st->instr;
+		for (j = 0; j < st->nb_regs; j++) {
+			reg = p;
+			if (st->reg_src[j] < 0) {
+				*p++ = st->cfg.ch_mask;
+			} else {
+				val = data[st->reg_src[j]];
+				if (st->is_fast)
+					val &= AD3552R_MASK_DAC_12B;
+				put_unaligned_be16(val, p);
+				p += 2;
+				if (st->reg_len[j] == 3)
+					*p++ = 0;
+			}
+			if (!desc->crc_en)
+				continue;
+
+			if (j == 0 && (i == 0 || instr_per_frame))
+				seed = st->instr_crc;
+			else
+				seed = st->reg_addr[j];
+			*p = crc8(crc8_table_07, reg, st->reg_len[j], seed);
+			p++;
+		}
+	}
+
+	return p - st->tx;
+}
+
+/* Send packed frames and check the CRC bytes echoed by the device */
+static int32_t _ad3552r_stream_send(struct ad3552r_desc *desc, uint8_t *tx,
+				    uint8_t *rx, uint32_t len)
+{
+	struct ad3552r_stream *st = desc->stream;
+	struct spi_msg msg = {
+		.tx_buff = tx,
+		.rx_buff = rx,
+		.bytes_number = len,
+	};
+	uint32_t i, j;
+	int32_t err;
+
+	err = spi_transfer(desc->spi, &msg, 1);
+	if (IS_ERR_VALUE(err) || !desc->crc_en)
+		return err;
+
+	/* A transfer is one instruction followed by frames */
+	i = 1;
+	while (i < len) {
+		for (j = 0; j < st->nb_regs; j++) {
+			i += st->reg_len[j];
+			if (rx[i] != tx[i])
+				return -EBADMSG;
+			i++;
+		}
+	}
+
+	return SUCCESS;
+}
+
+/* Wait until the next frame is due */
+static int32_t _ad3552r_stream_wait(struct ad3552r_desc *desc)
+{
+	struct ad3552r_stream *st = desc->stream;
+	uint64_t now;
+	int32_t err;
+
+	do {
+		err = timer_get_elapsed_time_nsec(desc->timer, &now);
+		if (IS_ERR_VALUE(err))
+			return err;
+	} while (now < st->next_ns);
+
+	st->next_ns += st->cfg.period_ns;
+	/* Drop the missed deadlines instead of bursting to catch up */
+	if (st->next_ns < now)
+		st->next_ns = now + st->cfg.period_ns;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Configure the device for stream mode playback.
+ *
+ * The interface is put in stream mode with a loop length of one frame, so
+ * ad3552r_stream_write() can send up to cfg->batch frames after a single
+ * instruction, in one chip select assertion.
+ *
+ * @param desc - The device structure.
+ * @param cfg - Channels, registers and pacing of the playback.
+ *
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad3552r_stream_start(struct ad3552r_desc *desc,
+			     const struct ad3552r_stream_config *cfg)
+{
+	struct ad3552_transfer_config spi_cfg = { 0 };
+	struct ad3552r_stream *st;
+	uint32_t per_frame;
+	int32_t err;
+
+	if (!desc || !cfg)
+		return -EINVAL;
+
+	if (desc->stream)
+		return -EBUSY;
+
+	if (cfg->pacing != AD3552R_STREAM_FREE_RUN && !cfg->period_ns)
+		return -EINVAL;
+
+	if (cfg->pacing == AD3552R_STREAM_TIMER && !desc->timer)
+		return -EINVAL;
+
+	st = (struct ad3552r_stream *)calloc(1, sizeof(*st));
+	if (!st)
+		return -ENOMEM;
+
+	st->cfg = *cfg;
+	if (!st->cfg.batch)
+		st->cfg.batch = AD3552R_STREAM_DEFAULT_BATCH;
+
+	err = _ad3552r_stream_layout(desc, st);
+	if (IS_ERR_VALUE(err))
+		goto err_free;
+
+	/* Room for an instruction before each frame, for timer pacing */
+	per_frame = st->frame_len + 1;
+	st->tx = (uint8_t *)malloc(st->cfg.batch * per_frame);
+	if (!st->tx) {
+		err = -ENOMEM;
+		goto err_free;
+	}
+	if (desc->crc_en) {
+		st->rx = (uint8_t *)malloc(st->cfg.batch * per_frame);
+		if (!st->rx) {
+			err = -ENOMEM;
+			goto err_free;
+		}
+	}
+
+	st->instr = st->reg_addr[0] & AD3552R_ADDR_MASK;
+	st->instr_crc = crc8(crc8_table_07, &st->instr, 1, AD3552R_CRC_SEED);
+	st->old_spi_cfg = desc->spi_cfg;
+
+	spi_cfg = desc->spi_cfg;
+	spi_cfg.addr_asc = 0;
+	spi_cfg.single_instr = 0;
+	spi_cfg.stream_length_keep_value = 1;
+	spi_cfg.stream_mode_length = st->frame_len -
+				     (desc->crc_en ? st->nb_regs : 0);
+	err = _update_spi_cfg(desc, &spi_cfg);
+	if (IS_ERR_VALUE(err))
+		goto err_cfg;
+
+	if (cfg->pacing == AD3552R_STREAM_LDAC_PWM) {
+		/* A frame sent faster than the LDAC period would be lost */
+		if (!desc->spi->max_speed_hz ||
+		    (uint64_t)st->frame_len * 8 * 1000000000 <
+		    (uint64_t)cfg->period_ns * desc->spi->max_speed_hz) {
+			err = -EINVAL;
+			goto err_cfg;
+		}
+		err = pwm_set_period(desc->ldac_pwm, cfg->period_ns);
+		if (IS_ERR_VALUE(err))
+			goto err_cfg;
+		err = pwm_set_duty_cycle(desc->ldac_pwm,
+					 AD3552R_LDAC_PULSE_US * 1000);
+		if (IS_ERR_VALUE(err))
+			goto err_cfg;
+		err = pwm_set_polarity(desc->ldac_pwm, PWM_POLARITY_LOW);
+		if (IS_ERR_VALUE(err))
+			goto err_cfg;
+		err = pwm_enable(desc->ldac_pwm);
+		if (IS_ERR_VALUE(err))
+			goto err_cfg;
+	}
+
+	if (cfg->pacing == AD3552R_STREAM_TIMER) {
+		err = timer_get_elapsed_time_nsec(desc->timer, &st->next_ns);
+		if (IS_ERR_VALUE(err))
+			goto err_cfg;
+	}
+
+	desc->stream = st;
+
+	return SUCCESS;
+err_cfg:
+	_update_spi_cfg(desc, &st->old_spi_cfg);
+err_free:
+	free(st->rx);
+	free(st->tx);
+	free(st);
+
+	return err;
+}
+
+/**
+ * @brief Play samples with the configuration set by ad3552r_stream_start().
+ *
+ * Samples are packed, with their CRCs, cfg.batch frames at a time. With
+ * free run and LDAC PWM pacing a batch is one SPI transfer. With timer
+ * pacing each frame is sent in its own transfer when it is due.
+ *
+ * @param desc - The device structure.
+ * @param data - One sample of each active channel, in increasing channel
+ *               order, for each update.
+ * @param samples - Number of samples per channel.
+ *
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad3552r_stream_write(struct ad3552r_desc *desc, const uint16_t *data,
+			     uint32_t samples)
+{
+	struct ad3552r_stream *st;
+	uint32_t n, i, len;
+	int32_t err;
+	bool paced;
+
+	if (!desc || !desc->stream || !data)
+		return -EINVAL;
+
+	st = desc->stream;
+	paced = st->cfg.pacing == AD3552R_STREAM_TIMER;
+	while (samples) {
+		n = min(samples, st->cfg.batch);
+		len = _ad3552r_stream_pack(desc, data, n, paced);
+		if (!paced) {
+			err = _ad3552r_stream_send(desc, st->tx, st->rx, len);
+			if (IS_ERR_VALUE(err))
+				return err;
+		} else {
+			len = st->frame_len + 1;
+			for (i = 0; i < n; i++) {
+				err = _ad3552r_stream_wait(desc);
+				if (IS_ERR_VALUE(err))
+					return err;
+				err = _ad3552r_stream_send(desc, st->tx + i * len,
+							   st->rx ? st->rx + i * len : NULL,
+							   len);
+				if (IS_ERR_VALUE(err))
+					return err;
+			}
+		}
+		data += n * st->nb_ch;
+		samples -= n;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Stop the playback and restore the interface configuration.
+ * @param desc - The device structure.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad3552r_stream_stop(struct ad3552r_desc *desc)
+{
+	struct ad3552r_stream *st;
+	int32_t err;
+
+	if (!desc || !desc->stream)
+		return -EINVAL;
+
+	st = desc->stream;
+	if (st->cfg.pacing == AD3552R_STREAM_LDAC_PWM)
+		pwm_disable(desc->ldac_pwm);
+
+	err = _update_spi_cfg(desc, &st->old_spi_cfg);
+
+	desc->stream = NULL;
+	free(st->rx);
+	free(st->tx);
+	free(st);
+
+	return err;
+}
+
 #ifdef AD3552R_DEBUG
 
 int32_t ad3552r_get_status(struct ad3552r_desc *desc, uint32_t *status,
@@ -51,6 +51,8 @@
 #include <stdbool.h>
 #include "no-os/spi.h"
 #include "no-os/gpio.h"
+#include "no-os/pwm.h"
+#include "no-os/timer.h"
 #include "no-os/crc8.h"
 
 /*****************************************************************************/
@@ -171,6 +173,7 @@
 #define AD3552R_STORAGE_BITS_FAST_MODE			16
 #define AD3552R_MAX_OFFSET				511
 #define AD3552R_LDAC_PULSE_US				1
+#define AD3552R_STREAM_DEFAULT_BATCH			256
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -319,6 +322,35 @@ enum ad3552r_write_mode {
 	AD3552R_WRITE_INPUT_REGS_AND_TRIGGER_LDAC
 };
 
+enum ad3552r_stream_pacing {
+	/* Frames are sent back to back. The SPI clock sets the update rate */
+	AD3552R_STREAM_FREE_RUN,
+	/* One frame is sent every period_ns, measured with the timer */
+	AD3552R_STREAM_TIMER,
+	/*
+	 * Frames are sent back to back to the input registers and the LDAC
+	 * PWM latches them every period_ns. The SPI max_speed_hz must be set
+	 * so that a frame lasts at least one period, otherwise frames would
+	 * be overwritten before they are latched.
+	 */
+	AD3552R_STREAM_LDAC_PWM
+};
+
+struct ad3552r_stream_config {
+	/* Mask of channels to update. Ex. 0b11 (Both channels) */
+	uint32_t ch_mask;
+	/* Registers to write and how the update is triggered */
+	enum ad3552r_write_mode mode;
+	/* Source of the update rate */
+	enum ad3552r_stream_pacing pacing;
+	/* Update period for timer and LDAC PWM pacing */
+	uint32_t period_ns;
+	/* Max samples per SPI transfer. 0 for AD3552R_STREAM_DEFAULT_BATCH */
+	uint32_t batch;
+};
+
+struct ad3552r_stream;
+
 /* By default all values are set to 0 */
 struct ad3552_transfer_config {
 	/* Defines the length of the loop when streaming data */
@@ -382,8 +414,10 @@ struct ad3552r_desc {
 	struct spi_desc *spi;
 	struct gpio_desc *ldac;
 	struct gpio_desc *reset;
+	struct pwm_desc *ldac_pwm;
+	struct timer_desc *timer;
+	struct ad3552r_stream *stream;
 	struct ad3552r_ch_data ch_data[AD3552R_NUM_CH];
-	uint8_t crc_table[CRC8_TABLE_SIZE];
 	uint8_t chip_id;
 	uint8_t crc_en : 1;
 };
@@ -420,6 +454,10 @@ struct ad3552r_init_param {
 	struct gpio_init_param	*reset_gpio_param_optional;
 	/* If set, input register are used and LDAC pulse is sent */
 	struct gpio_init_param	*ldac_gpio_param_optional;
+	/* If set, LDAC can be driven by a PWM to pace streamed samples */
+	struct pwm_init_param	*ldac_pwm_param_optional;
+	/* If set, streamed samples can be paced by this timer */
+	struct timer_init_param	*timer_param_optional;
 	/* If set, use external Vref */
 	bool use_external_vref;
 	/* If set, output internal Vref on Vref pin */
@@ -487,4 +525,15 @@ int32_t ad3552r_write_samples(struct ad3552r_desc *desc, uint16_t *data,
 			      uint32_t samples, uint32_t ch_mask,
 			      enum ad3552r_write_mode mode);
 
+/* Configure the device for stream mode playback. */
+int32_t ad3552r_stream_start(struct ad3552r_desc *desc,
+			     const struct ad3552r_stream_config *cfg);
+
+/* Play samples of the active channels, interleaved in increasing order. */
+int32_t ad3552r_stream_write(struct ad3552r_desc *desc, const uint16_t *data,
+			     uint32_t samples);
+
+/* Stop the playback and restore the previous interface configuration. */
+int32_t ad3552r_stream_stop(struct ad3552r_desc *desc);
+
 #endif /* _AD3552R_H_ */
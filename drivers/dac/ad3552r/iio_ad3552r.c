@@ -76,6 +76,7 @@ enum ad3552r_iio_attrs {
 	AD3552R_IIO_ATTR_OFFSET,
 	AD3552R_IIO_ATTR_RAW,
 	AD3552R_IIO_ATTR_SCALE,
+	AD3552R_IIO_ATTR_SAMPLING_FREQUENCY,
 };
 
 struct iio_ad3552r_desc {
@@ -83,6 +84,8 @@ struct iio_ad3552r_desc {
 	struct iio_device iio_desc;
 	struct ad3552r_desc *dac;
 	uint32_t mask;
+	/* Buffer update rate in Hz. 0 to stream as fast as the SPI allows */
+	uint32_t sampling_freq;
 };
 
 /*****************************************************************************/
@@ -134,6 +137,10 @@ static ssize_t iio_ad3552r_attr_get(void *device, char *buf, size_t len,
 
 		return iio_format_value(buf, len, IIO_VAL_INT_PLUS_MICRO, 2,
 					vals);
+	case AD3552R_IIO_ATTR_SAMPLING_FREQUENCY:
+		vals[0] = iio_dac->sampling_freq;
+
+		return iio_format_value(buf, len, IIO_VAL_INT, 1, vals);
 	default:
 		return -EINVAL;
 	}
@@ -148,6 +155,15 @@ static ssize_t iio_ad3552r_attr_set(void *device, char *buf, size_t len,
 
 	val = srt_to_uint32(buf);
 	switch (priv) {
+	case AD3552R_IIO_ATTR_SAMPLING_FREQUENCY:
+		/* Without a timer the updates can't be paced */
+		if (val && !iio_dac->dac->timer)
+			return -ENOSYS;
+
+		/* Used when the next buffer is enabled */
+		iio_dac->sampling_freq = val;
+
+		return len;
 	case AD3552R_IIO_ATTR_EN:
 		err = ad3552r_set_ch_value(iio_dac->dac,
 					   AD3552R_CH_DAC_POWERDOWN,
@@ -186,6 +202,11 @@ static struct iio_attribute iio_ad3552r_ch_attributes[] = {
 	END_ATTRIBUTES_ARRAY,
 };
 
+static struct iio_attribute iio_ad3552r_dev_attributes[] = {
+	AD3552R_ATTR("sampling_frequency", AD3552R_IIO_ATTR_SAMPLING_FREQUENCY),
+	END_ATTRIBUTES_ARRAY,
+};
+
 static int32_t iio_ad3552r_write_reg(struct iio_ad3552r_desc *iio_dac,
 				     uint32_t addr, uint32_t val)
 {
@@ -205,28 +226,49 @@ static int32_t iio_ad3552r_read_reg(struct iio_ad3552r_desc *iio_dac,
 	return err;
 }
 
+/*
+ * Samples are streamed in stream mode. With a sampling frequency set, each
+ * update is sent when the timer says it is due. The LDAC PWM is not used:
+ * it latches at a fixed rate while frames go out at the SPI rate, so most
+ * of them would be overwritten before being latched.
+ */
 static int32_t iio_ad3552r_prep_wr(struct iio_ad3552r_desc *iio_dac,
 				   uint32_t mask)
 {
+	struct ad3552r_stream_config cfg = {
+		.ch_mask = mask,
+		.mode = AD3552R_WRITE_INPUT_REGS_AND_TRIGGER_LDAC,
+		.pacing = AD3552R_STREAM_FREE_RUN,
+	};
+
 	iio_dac->mask = mask;
+	if (iio_dac->sampling_freq) {
+		cfg.period_ns = 1000000000 / iio_dac->sampling_freq;
+		cfg.pacing = AD3552R_STREAM_TIMER;
+	}
 
-	return SUCCESS;
+	return ad3552r_stream_start(iio_dac->dac, &cfg);
+}
+
+static int32_t iio_ad3552r_post_disable(struct iio_ad3552r_desc *iio_dac)
+{
+	return ad3552r_stream_stop(iio_dac->dac);
 }
 
 static int32_t iio_ad3552r_wr_dev(struct iio_ad3552r_desc *iio_dac,
 				  uint16_t *buff, uint32_t nb_samples)
 {
-	int32_t i;
-
-	static int c = 0;
-	c++;
+	uint32_t i;
+	int32_t err;
 
 	for (i = 0; i < nb_samples * hweight8(iio_dac->mask); ++i)
 		buff[i] = get_unaligned_be16((uint8_t *)&buff[i]);
 
-	return ad3552r_write_samples(iio_dac->dac, buff, nb_samples,
-				     iio_dac->mask,
-				     AD3552R_WRITE_INPUT_REGS_AND_TRIGGER_LDAC);
+	err = ad3552r_stream_write(iio_dac->dac, buff, nb_samples);
+	if (IS_ERR_VALUE(err))
+		return err;
+
+	return nb_samples;
 }
 
 
@@ -258,7 +300,9 @@ int32_t iio_ad3552r_init(struct iio_ad3552r_desc **iio_dac,
 	liio_dac->iio_desc.num_ch = j;
 	liio_dac->iio_desc.channels = liio_dac->channels;
 	liio_dac->iio_desc.write_dev = (int32_t (*)())iio_ad3552r_wr_dev;
+	liio_dac->iio_desc.attributes = iio_ad3552r_dev_attributes;
 	liio_dac->iio_desc.pre_enable = (int32_t (*)())iio_ad3552r_prep_wr;
+	liio_dac->iio_desc.post_disable = (int32_t (*)())iio_ad3552r_post_disable;
 	liio_dac->iio_desc.debug_reg_read = (int32_t (*)())iio_ad3552r_read_reg;
 	liio_dac->iio_desc.debug_reg_write = (int32_t (*)())iio_ad3552r_write_reg;
 
@@ -43,6 +43,7 @@
 #include <stdlib.h>
 #include "ad5755.h"         // AD5755 definitions.
 #include "ad5755_cfg.h"     // AD5755_cfg definitions.
+#include "no-os/crc8.h"
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
@@ -406,23 +407,7 @@ void ad5755_set_control_registers(struct ad5755_dev *dev,
 uint8_t ad5755_check_crc(uint8_t* data,
 			 uint8_t bytes_number)
 {
-	uint8_t crc = 0x00;
-	uint8_t byte = 0;
-	uint8_t bit = 0;
-
-	/* Calculates 8-Bit checksum with given polynomial. */
-	for(byte = 0; byte < bytes_number; byte++) {
-		crc ^= (data[byte]);
-		for(bit = 8; bit > 0; bit--) {
-			if (crc & 0x80) {
-				crc = (crc << 1) ^ AD5755_CRC_POLYNOMIAL;
-			} else {
-				crc = (crc << 1);
-			}
-		}
-	}
-
-	return crc;
+	return crc8(crc8_table_07, data, bytes_number, 0);
 }
 
 /***************************************************************************//**
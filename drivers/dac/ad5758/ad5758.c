@@ -42,6 +42,7 @@
 /******************************************************************************/
 
 #include "ad5758.h"
+#include "no-os/crc8.h"
 #include "no-os/delay.h"
 #include "no-os/error.h"
 #include "no-os/gpio.h"
@@ -61,23 +62,7 @@
 static uint8_t ad5758_compute_crc8(uint8_t *data,
 				   uint8_t data_size)
 {
-	uint8_t i;
-	uint8_t crc = 0;
-
-	while (data_size) {
-		for (i = 0x80; i != 0; i >>= 1) {
-			if (((crc & 0x80) != 0) != ((*data & i) != 0)) {
-				crc <<= 1;
-				crc ^= AD5758_CRC8_POLY;
-			} else {
-				crc <<= 1;
-			}
-		}
-		data++;
-		data_size--;
-	}
-
-	return crc;
+	return crc8(crc8_table_07, data, data_size, 0);
 }
 
 /**
@@ -42,8 +42,11 @@
 /******************************************************************************/
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "dac_demo.h"
+#include "iio.h"
+#include "no-os/delay.h"
 #include "no-os/error.h"
 #include "no-os/util.h"
 
@@ -61,17 +64,45 @@ int32_t dac_demo_init(struct dac_demo_desc **desc,
 		      struct dac_demo_init_param *param)
 {
 	struct dac_demo_desc *adesc;
+	int32_t ret;
+
 	adesc = (struct dac_demo_desc*)calloc(1, sizeof(*adesc));
 
 	if(!adesc)
 		return -ENOMEM;
 
 	adesc->loopback_buffers = param->loopback_buffers;
+	adesc->loopback_buffer_len = param->loopback_buffer_len;
 	for(int i = 0; i < TOTAL_DAC_CHANNELS; i++)
 		adesc->dac_ch_attr[i] = param->dev_ch_attr[i];
 	adesc->dac_global_attr = param->dev_global_attr;
+	adesc->underrun_period = param->underrun_period;
+	interleave_plan_init(&adesc->plan, 0, sizeof(uint16_t));
+
+	if (param->timer_param_optional) {
+		ret = timer_init(&adesc->timer, param->timer_param_optional);
+		if (IS_ERR_VALUE(ret))
+			goto error;
+
+		ret = timer_start(adesc->timer);
+		if (IS_ERR_VALUE(ret))
+			goto error_timer;
+	}
+
+	ret = dac_demo_set_sample_rate(adesc, param->sample_rate);
+	if (IS_ERR_VALUE(ret))
+		goto error_timer;
+
 	*desc = adesc;
 	return SUCCESS;
+
+error_timer:
+	if (adesc->timer)
+		timer_remove(adesc->timer);
+error:
+	free(adesc);
+
+	return ret;
 }
 
 /****************************************************************************//**
@@ -84,11 +115,37 @@ int32_t dac_demo_remove(struct dac_demo_desc *desc)
 	if(!desc)
 		return -EINVAL;
 
+	if (desc->timer) {
+		timer_stop(desc->timer);
+		timer_remove(desc->timer);
+	}
+
 	free(desc);
 
 	return SUCCESS;
 }
 
+/***************************************************************************//**
+ * @brief Set the rate at which the buffers are consumed.
+ * @param desc - descriptor for the dac
+ * @param rate - samples per second of each channel, 0 for no pacing
+ * @return SUCCESS in case of success, -ENODEV if pacing is requested without
+ *         a timer.
+*******************************************************************************/
+int32_t dac_demo_set_sample_rate(struct dac_demo_desc *desc, uint32_t rate)
+{
+	if (!desc)
+		return -EINVAL;
+
+	if (rate && !desc->timer)
+		return -ENODEV;
+
+	desc->sample_rate = rate;
+	desc->streaming = false;
+
+	return SUCCESS;
+}
+
 /***************************************************************************//**
  * @brief update number of active channels
  * @param dev - physical instance of a dac device
@@ -104,8 +161,10 @@ int32_t update_dac_channels(void *dev, int32_t mask)
 	desc = dev;
 
 	desc->active_ch = mask;
+	desc->streaming = false;
+	desc->nb_blocks = 0;
 
-	return SUCCESS;
+	return interleave_plan_init(&desc->plan, mask, sizeof(uint16_t));
 }
 
 /**********************************************************************//**
@@ -123,32 +182,7 @@ int32_t close_dac_channels(void* dev)
 
 	desc->active_ch = 0;
 
-	return SUCCESS;
-}
-
-/*********************************************************************//**
- * @brief utility function for computing next upcoming channel
- * @param ch_mask - active channels .
- * @param last_idx -  previous index.
- * @param new_idx - upcoming channel index, return param.
- * @return 1 if there are more channels, 0 if done.
-**************************************************************************/
-static bool get_next_ch_idx(uint32_t ch_mask, uint32_t last_idx,
-			    uint32_t *new_idx)
-{
-	last_idx++;
-	ch_mask >>= last_idx;
-	if (!ch_mask) {
-		*new_idx = -1;
-		return 0;
-	}
-	while (!(ch_mask & 1)) {
-		last_idx++;
-		ch_mask >>= 1;
-	}
-	*new_idx = last_idx;
-
-	return 1;
+	return interleave_plan_init(&desc->plan, 0, sizeof(uint16_t));
 }
 
 /**********************************************************************//**
@@ -161,25 +195,158 @@ static bool get_next_ch_idx(uint32_t ch_mask, uint32_t last_idx,
 int32_t dac_write_samples(void* dev, uint16_t* buff, uint32_t samples)
 {
 	struct dac_demo_desc *desc;
-	uint32_t k = 0;
-	uint32_t ch = -1;
+	void *dst[INTERLEAVE_MAX_CH];
+	uint16_t *base;
+	uint32_t i, j, n, pos;
 
 	if(!dev)
 		return -ENODEV;
 
 	desc = dev;
 
-	if (!desc->loopback_buffers)
-		return -EINVAL;
+	/* Without a loopback buffer the samples are consumed and dropped */
+	if (!desc->loopback_buffers || !desc->loopback_buffer_len)
+		return samples;
 
-	for(uint32_t i = 0; i < samples; i++)
-		while (get_next_ch_idx(desc->active_ch, ch, &ch))
-			desc->loopback_buffers[ch]
-			[i % desc->loopback_buffer_len] = buff[k++];
+	/* The channel buffers are the rows of a [channel][len] array */
+	base = (uint16_t *)desc->loopback_buffers;
+	for (i = 0; i < samples; i += n) {
+		pos = i % desc->loopback_buffer_len;
+		n = min(samples - i, desc->loopback_buffer_len - pos);
+		for (j = 0; j < desc->plan.nb_ch; j++)
+			dst[j] = base + desc->plan.ch[j] *
+				 desc->loopback_buffer_len + pos;
+		deinterleave_frames(&desc->plan, dst,
+				    buff + i * desc->plan.nb_ch, n);
+	}
 
 	return samples;
 }
 
+/***************************************************************************//**
+ * @brief read the pacing timer
+ * @param desc - descriptor for the dac
+ * @param ticks - timer counts, extended to 64 bits
+ * @return SUCCESS in case of success, negative error code otherwise.
+*******************************************************************************/
+static int32_t dac_demo_ticks(struct dac_demo_desc *desc, uint64_t *ticks)
+{
+	uint32_t counter;
+	int32_t ret;
+
+	ret = timer_counter_get(desc->timer, &counter);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	/* The counter must not wrap twice between two reads */
+	desc->ticks += counter - desc->last_counter;
+	desc->last_counter = counter;
+	*ticks = desc->ticks;
+
+	return SUCCESS;
+}
+
+/***************************************************************************//**
+ * @brief time at which the last sample of the stream is output
+ * @param desc - descriptor for the dac
+ * @return time in timer counts.
+*******************************************************************************/
+static uint64_t dac_demo_due(struct dac_demo_desc *desc)
+{
+	uint64_t samples = desc->stream_samples;
+	uint32_t rate = desc->sample_rate;
+	uint32_t freq = desc->timer->freq_hz;
+
+	return desc->stream_start + samples / rate * freq +
+	       samples % rate * freq / rate;
+}
+
+/***************************************************************************//**
+ * @brief queue a buffer behind the one a DMA outputting at sample_rate is
+ * playing, waiting for the latter to run out first. If it already ran out
+ * before this one was pushed, the output starved: this counts as an underrun
+ * and the stream restarts.
+ * @param desc - descriptor for the dac
+ * @param samples - number of samples of each channel in the buffer
+ * @return SUCCESS in case of success, negative error code otherwise.
+*******************************************************************************/
+static int32_t dac_demo_pace(struct dac_demo_desc *desc, uint32_t samples)
+{
+	uint64_t now, due;
+	int32_t ret;
+
+	if (!desc->sample_rate)
+		return SUCCESS;
+
+	ret = dac_demo_ticks(desc, &now);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	due = dac_demo_due(desc);
+	if (!desc->streaming || now > due) {
+		if (desc->streaming)
+			desc->underruns++;
+		desc->streaming = true;
+		desc->stream_start = now;
+		desc->stream_samples = 0;
+	}
+
+	/* Keep one block queued: wait for the previous one to play out */
+	while (now < due) {
+		udelay((due - now) * 1000000 / desc->timer->freq_hz);
+		ret = dac_demo_ticks(desc, &now);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+	desc->stream_samples += samples;
+
+	return SUCCESS;
+}
+
+/***************************************************************************//**
+ * @brief consume the iio buffer like a DMA would
+ * @param dev_data - device instance and iio buffer
+ * @return SUCCESS in case of success, -EPIPE for an injected underrun,
+ *         negative error code otherwise.
+*******************************************************************************/
+int32_t dac_submit_samples(struct iio_device_data *dev_data)
+{
+	struct dac_demo_desc *desc;
+	struct iio_buffer *buffer;
+	uint32_t samples;
+	void *buff;
+	int32_t ret;
+
+	if (!dev_data || !dev_data->dev)
+		return -ENODEV;
+
+	desc = dev_data->dev;
+	buffer = dev_data->buffer;
+
+	ret = iio_buffer_get_block(buffer, &buff);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	desc->nb_blocks++;
+	if (desc->underrun_period &&
+	    !(desc->nb_blocks % desc->underrun_period)) {
+		/* The buffer is dropped and the stream restarts */
+		desc->underruns++;
+		desc->streaming = false;
+		iio_buffer_block_done(buffer);
+		return -EPIPE;
+	}
+
+	samples = buffer->size / buffer->bytes_per_scan;
+	dac_write_samples(desc, buff, samples);
+
+	ret = iio_buffer_block_done(buffer);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	return dac_demo_pace(desc, samples);
+}
+
 /**********************************************************************//**
  * @brief read function for the dac demo driver
  * @param desc - descriptor for the dac
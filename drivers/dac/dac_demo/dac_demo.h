@@ -44,19 +44,28 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 
+#include <stdbool.h>
 #include <stdint.h>
 #include "iio_types.h"
+#include "no-os/interleave.h"
+#include "no-os/timer.h"
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
 
 #define MAX_DAC_ADDR		16
-/* For testing a maximum of 16 channels can be enabled */
+/* Channels of the iio descriptor */
+#define DAC_DEMO_MAX_CHANNELS	32
+/* For testing a maximum of 32 channels can be enabled */
 #ifndef TOTAL_DAC_CHANNELS
 #define TOTAL_DAC_CHANNELS 2
 #endif
 
+#if TOTAL_DAC_CHANNELS > DAC_DEMO_MAX_CHANNELS
+#error "TOTAL_DAC_CHANNELS is larger than DAC_DEMO_MAX_CHANNELS"
+#endif
+
 /**
  * @struct iio_demo_dac_desc
  * @brief Desciptor.
@@ -67,13 +76,35 @@ struct dac_demo_desc {
 	/** Demo global device attribute */
 	uint32_t dac_global_attr;
 	/** Demo device channel attribute */
-	uint32_t dac_ch_attr[MAX_DAC_ADDR];
+	uint32_t dac_ch_attr[DAC_DEMO_MAX_CHANNELS];
 	/** Active channel**/
 	uint32_t active_ch;
+	/** Kernels for the active channels */
+	struct interleave_plan plan;
 	/** Number of samples in each buffer */
 	uint32_t loopback_buffer_len;
 	/** Array of buffers for each channel*/
 	uint16_t **loopback_buffers;
+	/** Samples per second of each channel. 0 consumes buffers at once. */
+	uint32_t sample_rate;
+	/** Timer used to pace the buffers */
+	struct timer_desc *timer;
+	/** Timer counts, extended to 64 bits */
+	uint64_t ticks;
+	/** Last timer counter value */
+	uint32_t last_counter;
+	/** Set when the pacing time reference is valid */
+	bool streaming;
+	/** Time (timer counts) when the stream started */
+	uint64_t stream_start;
+	/** Samples of each channel output since stream_start */
+	uint64_t stream_samples;
+	/** One buffer push in underrun_period fails. 0 never fails. */
+	uint32_t underrun_period;
+	/** Buffer pushes since the buffer was enabled */
+	uint32_t nb_blocks;
+	/** Dropped buffers and buffers not pushed in time */
+	uint32_t underruns;
 };
 
 /**
@@ -84,16 +115,26 @@ struct dac_demo_init_param {
 	/** Demo global dac attribute */
 	uint32_t dev_global_attr;
 	/** Demo dac channel attribute */
-	uint32_t dev_ch_attr[MAX_DAC_ADDR];
+	uint32_t dev_ch_attr[DAC_DEMO_MAX_CHANNELS];
 	/** Number of samples in each buffer */
 	uint32_t loopback_buffer_len;
 	/** Buffer for adc/dac communication*/
 	uint16_t **loopback_buffers;
+	/** Samples per second of each channel, 0 for no pacing */
+	uint32_t sample_rate;
+	/** Up counting timer pacing the buffers. Needed for sample_rate. */
+	struct timer_init_param *timer_param_optional;
+	/** One buffer push in underrun_period is dropped and fails with -EPIPE.
+	 *  0 never fails. */
+	uint32_t underrun_period;
 };
 
 enum iio_dac_demo_attributes {
 	DAC_CHANNEL_ATTR,
 	DAC_GLOBAL_ATTR,
+	DAC_SAMPLING_FREQUENCY,
+	DAC_UNDERRUN_PERIOD,
+	DAC_UNDERRUNS,
 };
 
 /******************************************************************************/
@@ -111,6 +152,10 @@ int32_t close_dac_channels(void* dev);
 
 int32_t dac_write_samples(void* dev, uint16_t* buff, uint32_t samples);
 
+int32_t dac_submit_samples(struct iio_device_data *dev_data);
+
+int32_t dac_demo_set_sample_rate(struct dac_demo_desc *desc, uint32_t rate);
+
 int get_dac_demo_attr(void *device, char *buf, uint32_t len,
 		      const struct iio_ch_info *channel, intptr_t priv);
 
@@ -68,6 +68,12 @@ int get_dac_demo_attr(void *device, char *buf, uint32_t len,
 		return snprintf(buf,len,"%"PRIu32"",desc->dac_global_attr);
 	case DAC_CHANNEL_ATTR:
 		return snprintf(buf,len,"%"PRIu32"",desc->dac_ch_attr[channel->ch_num]);
+	case DAC_SAMPLING_FREQUENCY:
+		return snprintf(buf,len,"%"PRIu32"",desc->sample_rate);
+	case DAC_UNDERRUN_PERIOD:
+		return snprintf(buf,len,"%"PRIu32"",desc->underrun_period);
+	case DAC_UNDERRUNS:
+		return snprintf(buf,len,"%"PRIu32"",desc->underruns);
 	default:
 		return -EINVAL;
 	}
@@ -89,6 +95,7 @@ int set_dac_demo_attr(void *device, char *buf, uint32_t len,
 {
 	struct dac_demo_desc *desc;
 	uint32_t value = srt_to_uint32(buf);
+	int32_t ret;
 
 	if(!device)
 		return -ENODEV;
@@ -102,6 +109,17 @@ int set_dac_demo_attr(void *device, char *buf, uint32_t len,
 	case DAC_CHANNEL_ATTR:
 		desc->dac_ch_attr[channel->ch_num] = value;
 		return len;
+	case DAC_SAMPLING_FREQUENCY:
+		ret = dac_demo_set_sample_rate(desc, value);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+		return len;
+	case DAC_UNDERRUN_PERIOD:
+		desc->underrun_period = value;
+		return len;
+	case DAC_UNDERRUNS:
+		desc->underruns = 0;
+		return len;
 	default:
 		return -EINVAL;
 	}
@@ -142,6 +160,9 @@ struct iio_attribute dac_channel_attributes[] = {
 
 struct iio_attribute dac_global_attributes[] = {
 	DAC_DEMO_ATTR("dac_global_attr", DAC_GLOBAL_ATTR),
+	DAC_DEMO_ATTR("sampling_frequency", DAC_SAMPLING_FREQUENCY),
+	DAC_DEMO_ATTR("underrun_period", DAC_UNDERRUN_PERIOD),
+	DAC_DEMO_ATTR("underruns", DAC_UNDERRUNS),
 	END_ATTRIBUTES_ARRAY,
 };
 
@@ -161,7 +182,23 @@ static struct iio_channel iio_dac_channels[] = {
 	IIO_DEMO_DAC_CHANNEL(12),
 	IIO_DEMO_DAC_CHANNEL(13),
 	IIO_DEMO_DAC_CHANNEL(14),
-	IIO_DEMO_DAC_CHANNEL(15)
+	IIO_DEMO_DAC_CHANNEL(15),
+	IIO_DEMO_DAC_CHANNEL(16),
+	IIO_DEMO_DAC_CHANNEL(17),
+	IIO_DEMO_DAC_CHANNEL(18),
+	IIO_DEMO_DAC_CHANNEL(19),
+	IIO_DEMO_DAC_CHANNEL(20),
+	IIO_DEMO_DAC_CHANNEL(21),
+	IIO_DEMO_DAC_CHANNEL(22),
+	IIO_DEMO_DAC_CHANNEL(23),
+	IIO_DEMO_DAC_CHANNEL(24),
+	IIO_DEMO_DAC_CHANNEL(25),
+	IIO_DEMO_DAC_CHANNEL(26),
+	IIO_DEMO_DAC_CHANNEL(27),
+	IIO_DEMO_DAC_CHANNEL(28),
+	IIO_DEMO_DAC_CHANNEL(29),
+	IIO_DEMO_DAC_CHANNEL(30),
+	IIO_DEMO_DAC_CHANNEL(31)
 };
 
 struct iio_device const dac_demo_iio_descriptor = {
@@ -172,7 +209,7 @@ struct iio_device const dac_demo_iio_descriptor = {
 	.buffer_attributes = NULL,
 	.pre_enable = (int32_t (*)())update_dac_channels,
 	.post_disable = close_dac_channels,
-	.read_dev = (int32_t (*)())dac_write_samples,
+	.submit = dac_submit_samples,
 	.debug_reg_read = (int32_t (*)()) dac_demo_reg_read,
 	.debug_reg_write = (int32_t (*)()) dac_demo_reg_write
 };
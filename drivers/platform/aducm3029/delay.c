@@ -44,6 +44,11 @@
 #include "no-os/delay.h"
 #include "no-os/timer.h"
 #include "no-os/error.h"
+#include "no-os/trace.h"
+
+/* The delay accounting wrappers of delay.h do not apply here */
+#undef udelay
+#undef mdelay
 
 /******************************************************************************/
 /****************************** Global Variables*******************************/
@@ -119,7 +124,9 @@ void udelay(uint32_t usecs)
 	if (!us_timer)
 		if (!initialize_timer(&us_timer, 1))
 			return ;
+	TRACE_BEGIN(TRACE_EV_DELAY, usecs);
 	start_and_wait(us_timer, usecs);
+	TRACE_END(TRACE_EV_DELAY, 0);
 }
 
 /**
@@ -131,5 +138,7 @@ void mdelay(uint32_t msecs)
 	if (!ms_timer)
 		if (!initialize_timer(&ms_timer, 0))
 			return ;
+	TRACE_BEGIN(TRACE_EV_DELAY, msecs * 1000);
 	start_and_wait(ms_timer, msecs);
+	TRACE_END(TRACE_EV_DELAY, 0);
 }
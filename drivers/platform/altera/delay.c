@@ -42,6 +42,11 @@
 /******************************************************************************/
 
 #include "no-os/delay.h"
+#include "no-os/trace.h"
+
+/* The delay accounting wrappers of delay.h do not apply here */
+#undef udelay
+#undef mdelay
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
@@ -54,7 +59,9 @@
  */
 void udelay(uint32_t usecs)
 {
+	TRACE_BEGIN(TRACE_EV_DELAY, usecs);
 	usleep(usecs);
+	TRACE_END(TRACE_EV_DELAY, 0);
 }
 
 /**
@@ -64,5 +71,7 @@ void udelay(uint32_t usecs)
  */
 void mdelay(uint32_t msecs)
 {
+	TRACE_BEGIN(TRACE_EV_DELAY, msecs * 1000);
 	usleep(msecs * 1000);
+	TRACE_END(TRACE_EV_DELAY, 0);
 }
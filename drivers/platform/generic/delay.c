@@ -43,6 +43,10 @@
 
 #include "no-os/delay.h"
 
+/* The delay accounting wrappers of delay.h do not apply here */
+#undef udelay
+#undef mdelay
+
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
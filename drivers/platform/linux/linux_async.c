@@ -0,0 +1,244 @@
+/***************************************************************************//**
+ *   @file   linux/linux_async.c
+ *   @brief  Worker thread used by the Linux platform drivers to implement
+ *           asynchronous transfers.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "no-os/error.h"
+#include "linux_async.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct linux_async_queue
+ * @brief Fixed size request queue served by a worker thread.
+ */
+struct linux_async_queue {
+	/** Worker thread */
+	pthread_t thread;
+	/** Protects the queue fields */
+	pthread_mutex_t lock;
+	/** Signaled when a request is queued or when the worker must stop */
+	pthread_cond_t cond;
+	/** Held while a request is executed, see linux_async_lock() */
+	pthread_mutex_t exec_lock;
+	/** Requests */
+	struct linux_async_job *jobs;
+	/** Size of jobs */
+	uint32_t depth;
+	/** Index of the oldest request */
+	uint32_t head;
+	/** Number of queued requests */
+	uint32_t count;
+	/** Set to stop the worker thread */
+	bool stop;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Worker thread. Executes the requests in submission order.
+ * @param arg - The queue.
+ * @return NULL.
+ */
+static void *linux_async_worker(void *arg)
+{
+	struct linux_async_queue *queue = arg;
+	struct linux_async_job job;
+	int32_t ret;
+
+	pthread_mutex_lock(&queue->lock);
+	while (true) {
+		while (!queue->count && !queue->stop)
+			pthread_cond_wait(&queue->cond, &queue->lock);
+
+		/* Pending requests are still executed when stopping */
+		if (!queue->count)
+			break;
+
+		job = queue->jobs[queue->head];
+		pthread_mutex_unlock(&queue->lock);
+
+		pthread_mutex_lock(&queue->exec_lock);
+		ret = job.xfer(job.dev, job.msgs, job.len);
+		pthread_mutex_unlock(&queue->exec_lock);
+
+		if (job.callback)
+			job.callback(job.ctx, ret);
+
+		pthread_mutex_lock(&queue->lock);
+		queue->head = (queue->head + 1) % queue->depth;
+		queue->count--;
+	}
+	pthread_mutex_unlock(&queue->lock);
+
+	return NULL;
+}
+
+/**
+ * @brief Create a request queue and its worker thread.
+ * @param queue - The queue.
+ * @param depth - Maximum number of queued requests, 0 for
+ *                LINUX_ASYNC_DEFAULT_DEPTH.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_async_init(struct linux_async_queue **queue, uint32_t depth)
+{
+	struct linux_async_queue *q;
+
+	if (!queue)
+		return -EINVAL;
+
+	q = calloc(1, sizeof(*q));
+	if (!q)
+		return -ENOMEM;
+
+	q->depth = depth ? depth : LINUX_ASYNC_DEFAULT_DEPTH;
+	q->jobs = calloc(q->depth, sizeof(*q->jobs));
+	if (!q->jobs)
+		goto free_queue;
+
+	pthread_mutex_init(&q->lock, NULL);
+	pthread_mutex_init(&q->exec_lock, NULL);
+	pthread_cond_init(&q->cond, NULL);
+
+	if (pthread_create(&q->thread, NULL, linux_async_worker, q))
+		goto free_sync;
+
+	*queue = q;
+
+	return SUCCESS;
+
+free_sync:
+	pthread_cond_destroy(&q->cond);
+	pthread_mutex_destroy(&q->exec_lock);
+	pthread_mutex_destroy(&q->lock);
+	free(q->jobs);
+free_queue:
+	free(q);
+
+	return -ENOMEM;
+}
+
+/**
+ * @brief Wait for the queued requests and stop the worker thread.
+ * @param queue - The queue.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_async_remove(struct linux_async_queue *queue)
+{
+	if (!queue)
+		return -EINVAL;
+
+	pthread_mutex_lock(&queue->lock);
+	queue->stop = true;
+	pthread_cond_signal(&queue->cond);
+	pthread_mutex_unlock(&queue->lock);
+
+	pthread_join(queue->thread, NULL);
+
+	pthread_cond_destroy(&queue->cond);
+	pthread_mutex_destroy(&queue->exec_lock);
+	pthread_mutex_destroy(&queue->lock);
+	free(queue->jobs);
+	free(queue);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Queue a request. The buffers referenced by the request must stay
+ * valid until the completion callback is called.
+ * @param queue - The queue.
+ * @param job - The request. Copied in the queue.
+ * @return SUCCESS in case of success, -EBUSY if the queue is full,
+ *         negative error code otherwise.
+ */
+int32_t linux_async_submit(struct linux_async_queue *queue,
+			   const struct linux_async_job *job)
+{
+	int32_t ret = SUCCESS;
+
+	if (!queue || !job || !job->xfer)
+		return -EINVAL;
+
+	pthread_mutex_lock(&queue->lock);
+	if (queue->stop) {
+		ret = -EINVAL;
+	} else if (queue->count == queue->depth) {
+		ret = -EBUSY;
+	} else {
+		queue->jobs[(queue->head + queue->count) % queue->depth] = *job;
+		queue->count++;
+		pthread_cond_signal(&queue->cond);
+	}
+	pthread_mutex_unlock(&queue->lock);
+
+	return ret;
+}
+
+/**
+ * @brief Serialize a synchronous access with the worker thread. Does nothing
+ * if queue is NULL.
+ * @param queue - The queue.
+ */
+void linux_async_lock(struct linux_async_queue *queue)
+{
+	if (queue)
+		pthread_mutex_lock(&queue->exec_lock);
+}
+
+/**
+ * @brief Release the lock taken by linux_async_lock().
+ * @param queue - The queue.
+ */
+void linux_async_unlock(struct linux_async_queue *queue)
+{
+	if (queue)
+		pthread_mutex_unlock(&queue->exec_lock);
+}
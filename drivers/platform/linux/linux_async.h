@@ -0,0 +1,100 @@
+/***************************************************************************//**
+ *   @file   linux/linux_async.h
+ *   @brief  Header of the worker thread used by the Linux platform drivers
+ *           to implement asynchronous transfers.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef LINUX_ASYNC_H_
+#define LINUX_ASYNC_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** Number of requests that can be queued when no depth is specified */
+#define LINUX_ASYNC_DEFAULT_DEPTH	16
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct linux_async_job
+ * @brief Request executed by the worker thread.
+ */
+struct linux_async_job {
+	/** Transfer function, called from the worker thread */
+	int32_t (*xfer)(void *dev, void *msgs, uint32_t len);
+	/** First parameter of xfer */
+	void *dev;
+	/** Second parameter of xfer */
+	void *msgs;
+	/** Third parameter of xfer */
+	uint32_t len;
+	/** Completion callback, called from the worker thread */
+	void (*callback)(void *ctx, int32_t status);
+	/** Parameter passed to the callback */
+	void *ctx;
+};
+
+struct linux_async_queue;
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Create a request queue and its worker thread. */
+int32_t linux_async_init(struct linux_async_queue **queue, uint32_t depth);
+
+/* Wait for the queued requests and stop the worker thread. */
+int32_t linux_async_remove(struct linux_async_queue *queue);
+
+/* Queue a request. */
+int32_t linux_async_submit(struct linux_async_queue *queue,
+			   const struct linux_async_job *job);
+
+/* Serialize a synchronous access with the worker thread. */
+void linux_async_lock(struct linux_async_queue *queue);
+
+/* Release the lock taken by linux_async_lock(). */
+void linux_async_unlock(struct linux_async_queue *queue);
+
+#endif // LINUX_ASYNC_H_
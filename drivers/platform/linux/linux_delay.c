@@ -43,6 +43,7 @@
 
 #include <stdint.h>
 #include <unistd.h>
+#include "no-os/trace.h"
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
@@ -55,7 +56,9 @@
  */
 void udelay(uint32_t usecs)
 {
+	TRACE_BEGIN(TRACE_EV_DELAY, usecs);
 	usleep(usecs);
+	TRACE_END(TRACE_EV_DELAY, 0);
 }
 
 /**
@@ -65,5 +68,7 @@ void udelay(uint32_t usecs)
  */
 void mdelay(uint32_t msecs)
 {
+	TRACE_BEGIN(TRACE_EV_DELAY, msecs * 1000);
 	usleep(msecs * 1000);
+	TRACE_END(TRACE_EV_DELAY, 0);
 }
@@ -0,0 +1,118 @@
+/***************************************************************************//**
+ *   @file   linux/linux_fw_image.c
+ *   @brief  Linux platform firmware image file mapping.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "no-os/error.h"
+#include "linux_fw_image.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Map a firmware image file and open it. The file may be a container
+ * generated by tools/scripts/fw_image.py or a plain binary. Pages are loaded
+ * by the kernel on demand while the image is decoded.
+ * @param img - The image descriptor.
+ * @param path - Path of the file.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_fw_image_open(struct fw_image **img, const char *path)
+{
+	struct stat st;
+	void *map;
+	int32_t ret;
+	int fd;
+
+	if (!img || !path)
+		return -EINVAL;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		printf("%s: Can't open %s\n\r", __func__, path);
+		return -errno;
+	}
+
+	ret = fstat(fd, &st);
+	if (ret < 0 || !st.st_size) {
+		close(fd);
+		return -EINVAL;
+	}
+
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	/* The mapping stays valid after the descriptor is closed */
+	close(fd);
+	if (map == MAP_FAILED)
+		return -errno;
+
+	madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+	ret = fw_image_init_mem(img, map, st.st_size);
+	if (IS_ERR_VALUE(ret)) {
+		munmap(map, st.st_size);
+		return ret;
+	}
+
+	(*img)->extra = map;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Close an image opened with linux_fw_image_open().
+ * @param img - The image descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_fw_image_close(struct fw_image *img)
+{
+	if (!img || !img->extra)
+		return -EINVAL;
+
+	munmap(img->extra, img->mem_size);
+
+	return fw_image_remove(img);
+}
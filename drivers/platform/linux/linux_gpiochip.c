@@ -0,0 +1,670 @@
+/***************************************************************************//**
+ *   @file   linux/linux_gpiochip.c
+ *   @brief  Implementation of Linux platform GPIO character device (uAPI v2)
+ *           driver.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "no-os/error.h"
+#include "no-os/gpio.h"
+#include "linux_gpiochip.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define LINUX_GPIO_CONSUMER	"no-os"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct linux_gpiochip_line
+ * @brief Line referred to by a GPIO descriptor (gpio_desc.extra).
+ */
+struct linux_gpiochip_line {
+	/** Group the line belongs to */
+	struct linux_gpio_lines *lines;
+	/** Index of the line in the group */
+	uint32_t index;
+	/** The group was requested by linux_gpiochip_get() for this line only */
+	bool owned;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Build the line configuration for the given direction.
+ * @param config - The configuration to be filled.
+ * @param direction - GPIO_IN or GPIO_OUT.
+ * @param edge - Edge detection used for inputs.
+ * @param num_lines - Number of lines in the request.
+ * @param values - Output values, bit i for line i.
+ */
+static void linux_gpio_config(struct gpio_v2_line_config *config,
+			      uint8_t direction, enum linux_gpio_edge edge,
+			      uint32_t num_lines, uint64_t values)
+{
+	uint64_t all = (num_lines == 64) ? ~0ULL : ((1ULL << num_lines) - 1);
+
+	memset(config, 0, sizeof(*config));
+
+	if (direction == GPIO_OUT) {
+		config->flags = GPIO_V2_LINE_FLAG_OUTPUT;
+		config->num_attrs = 1;
+		config->attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+		config->attrs[0].attr.values = values;
+		config->attrs[0].mask = all;
+		return;
+	}
+
+	config->flags = GPIO_V2_LINE_FLAG_INPUT;
+	if (edge == LINUX_GPIO_EDGE_RISING || edge == LINUX_GPIO_EDGE_BOTH)
+		config->flags |= GPIO_V2_LINE_FLAG_EDGE_RISING;
+	if (edge == LINUX_GPIO_EDGE_FALLING || edge == LINUX_GPIO_EDGE_BOTH)
+		config->flags |= GPIO_V2_LINE_FLAG_EDGE_FALLING;
+}
+
+/**
+ * @brief Request a group of lines.
+ * @param lines - The lines handle.
+ * @param param - The structure that contains the request parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_gpio_lines_get(struct linux_gpio_lines **lines,
+			     const struct linux_gpio_lines_init_param *param)
+{
+	struct gpio_v2_line_request req;
+	struct linux_gpio_lines *handle;
+	char path[64];
+	uint32_t i;
+	int chip_fd;
+	int ret;
+
+	if (!lines || !param || !param->offsets || !param->num_lines ||
+	    param->num_lines > LINUX_GPIO_LINES_MAX)
+		return -EINVAL;
+
+	handle = calloc(1, sizeof(*handle));
+	if (!handle)
+		return -ENOMEM;
+
+	snprintf(path, sizeof(path), "/dev/gpiochip%d", param->chip_id);
+	chip_fd = open(path, O_RDWR | O_CLOEXEC);
+	if (chip_fd < 0) {
+		printf("%s: Can't open %s\n\r", __func__, path);
+		ret = -errno;
+		goto free_handle;
+	}
+
+	memset(&req, 0, sizeof(req));
+	for (i = 0; i < param->num_lines; i++)
+		req.offsets[i] = param->offsets[i];
+	req.num_lines = param->num_lines;
+	strncpy(req.consumer, LINUX_GPIO_CONSUMER, sizeof(req.consumer) - 1);
+	linux_gpio_config(&req.config, param->direction, param->edge,
+			  param->num_lines, param->values);
+
+	ret = ioctl(chip_fd, GPIO_V2_GET_LINE_IOCTL, &req);
+	if (ret < 0) {
+		printf("%s: Can't request lines (%d)\n\r", __func__, errno);
+		ret = -errno;
+		close(chip_fd);
+		goto free_handle;
+	}
+
+	/* The line request fd stays valid after the chip is closed */
+	close(chip_fd);
+
+	handle->fd = req.fd;
+	handle->num_lines = param->num_lines;
+	handle->direction = param->direction;
+	handle->edge = param->edge;
+	memcpy(handle->offsets, param->offsets,
+	       param->num_lines * sizeof(*param->offsets));
+	*lines = handle;
+
+	return SUCCESS;
+
+free_handle:
+	free(handle);
+
+	return ret;
+}
+
+/**
+ * @brief Release a group of lines.
+ * @param lines - The lines handle.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_gpio_lines_remove(struct linux_gpio_lines *lines)
+{
+	int ret;
+
+	if (!lines)
+		return -EINVAL;
+
+	ret = close(lines->fd);
+	if (ret < 0) {
+		printf("%s: Can't close device\n\r", __func__);
+		return FAILURE;
+	}
+
+	free(lines);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Set the direction of all the lines in the group.
+ * @param lines - The lines handle.
+ * @param direction - GPIO_IN or GPIO_OUT.
+ * @param values - Output values, bit i for line i. Ignored for inputs.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_gpio_lines_direction(struct linux_gpio_lines *lines,
+				   uint8_t direction, uint64_t values)
+{
+	struct gpio_v2_line_config config;
+	int ret;
+
+	if (!lines)
+		return -EINVAL;
+
+	linux_gpio_config(&config, direction, lines->edge, lines->num_lines,
+			  values);
+
+	ret = ioctl(lines->fd, GPIO_V2_LINE_SET_CONFIG_IOCTL, &config);
+	if (ret < 0) {
+		printf("%s: Can't set line config (%d)\n\r", __func__, errno);
+		return -errno;
+	}
+
+	lines->direction = direction;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Set the values of the lines selected by mask in a single call.
+ * @param lines - The lines handle.
+ * @param mask - Lines to be set, bit i for line i.
+ * @param values - The values, bit i for line i.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_gpio_set_values(struct linux_gpio_lines *lines,
+			      uint64_t mask, uint64_t values)
+{
+	struct gpio_v2_line_values lv = {
+		.bits = values,
+		.mask = mask,
+	};
+
+	if (!lines)
+		return -EINVAL;
+
+	if (ioctl(lines->fd, GPIO_V2_LINE_SET_VALUES_IOCTL, &lv) < 0)
+		return -errno;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the values of the lines selected by mask in a single call.
+ * @param lines - The lines handle.
+ * @param mask - Lines to be read, bit i for line i.
+ * @param values - The values, bit i for line i.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_gpio_get_values(struct linux_gpio_lines *lines,
+			      uint64_t mask, uint64_t *values)
+{
+	struct gpio_v2_line_values lv = {
+		.mask = mask,
+	};
+
+	if (!lines || !values)
+		return -EINVAL;
+
+	if (ioctl(lines->fd, GPIO_V2_LINE_GET_VALUES_IOCTL, &lv) < 0)
+		return -errno;
+
+	*values = lv.bits & mask;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Wait for and read an edge event.
+ * @param lines - The lines handle. Must be requested as input with edge
+ *                detection enabled.
+ * @param event - The event.
+ * @param timeout_ms - Timeout in milliseconds, negative to wait forever.
+ * @return SUCCESS in case of success, -ETIMEDOUT if no event occurred,
+ *         negative error code otherwise.
+ */
+int32_t linux_gpio_read_event(struct linux_gpio_lines *lines,
+			      struct linux_gpio_event *event,
+			      int32_t timeout_ms)
+{
+	struct gpio_v2_line_event ev;
+	struct pollfd pfd;
+	ssize_t len;
+	int ret;
+
+	if (!lines || !event || lines->edge == LINUX_GPIO_EDGE_NONE)
+		return -EINVAL;
+
+	pfd.fd = lines->fd;
+	pfd.events = POLLIN;
+	ret = poll(&pfd, 1, timeout_ms);
+	if (ret < 0)
+		return -errno;
+	if (ret == 0)
+		return -ETIMEDOUT;
+
+	len = read(lines->fd, &ev, sizeof(ev));
+	if (len < 0)
+		return -errno;
+	if (len != sizeof(ev))
+		return -EIO;
+
+	event->timestamp_ns = ev.timestamp_ns;
+	event->line = ev.offset;
+	event->edge = (ev.id == GPIO_V2_LINE_EVENT_RISING_EDGE) ?
+		      LINUX_GPIO_EDGE_RISING : LINUX_GPIO_EDGE_FALLING;
+	event->seqno = ev.line_seqno;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Wait for and read an edge event of a line obtained with gpio_get().
+ * @param desc - The GPIO descriptor.
+ * @param event - The event.
+ * @param timeout_ms - Timeout in milliseconds, negative to wait forever.
+ * @return SUCCESS in case of success, -ETIMEDOUT if no event occurred,
+ *         negative error code otherwise.
+ */
+int32_t linux_gpiochip_read_event(struct gpio_desc *desc,
+				  struct linux_gpio_event *event,
+				  int32_t timeout_ms)
+{
+	struct linux_gpiochip_line *line;
+
+	if (!desc)
+		return -EINVAL;
+
+	line = desc->extra;
+
+	return linux_gpio_read_event(line->lines, event, timeout_ms);
+}
+
+/**
+ * @brief Obtain the GPIO decriptor.
+ * @param desc - The GPIO descriptor.
+ * @param param - GPIO initialization parameters
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t linux_gpiochip_get(struct gpio_desc **desc,
+				  const struct gpio_init_param *param)
+{
+	struct linux_gpiochip_init_param *chip_param;
+	struct linux_gpio_lines_init_param lines_param;
+	struct linux_gpiochip_line *line;
+	struct gpio_desc *descriptor;
+	uint32_t offset;
+	int32_t ret;
+
+	chip_param = param->extra;
+	if (!chip_param || param->number < 0)
+		return FAILURE;
+
+	descriptor = calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return FAILURE;
+
+	line = calloc(1, sizeof(*line));
+	if (!line)
+		goto free_desc;
+
+	offset = param->number;
+	if (chip_param->lines) {
+		line->lines = chip_param->lines;
+		for (line->index = 0; line->index < line->lines->num_lines;
+		     line->index++)
+			if (line->lines->offsets[line->index] == offset)
+				break;
+		if (line->index == line->lines->num_lines) {
+			printf("%s: Line %d is not in the group\n\r", __func__,
+			       param->number);
+			goto free_line;
+		}
+	} else {
+		lines_param.chip_id = chip_param->chip_id;
+		lines_param.offsets = &offset;
+		lines_param.num_lines = 1;
+		lines_param.direction = GPIO_IN;
+		lines_param.values = 0;
+		lines_param.edge = chip_param->edge;
+
+		ret = linux_gpio_lines_get(&line->lines, &lines_param);
+		if (ret != SUCCESS)
+			goto free_line;
+		line->owned = true;
+	}
+
+	descriptor->number = param->number;
+	descriptor->extra = line;
+	*desc = descriptor;
+
+	return SUCCESS;
+
+free_line:
+	free(line);
+free_desc:
+	free(descriptor);
+
+	return FAILURE;
+}
+
+/**
+ * @brief Get the value of an optional GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param param - GPIO Initialization parameters.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t linux_gpiochip_get_optional(struct gpio_desc **desc,
+		const struct gpio_init_param *param)
+{
+	return linux_gpiochip_get(desc, param);
+}
+
+/**
+ * @brief Free the resources allocated by gpio_get(). A group passed in
+ * linux_gpiochip_init_param is not released.
+ * @param desc - The GPIO descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t linux_gpiochip_remove(struct gpio_desc *desc)
+{
+	struct linux_gpiochip_line *line = desc->extra;
+	int32_t ret;
+
+	if (line->owned) {
+		ret = linux_gpio_lines_remove(line->lines);
+		if (ret != SUCCESS)
+			return FAILURE;
+	}
+
+	free(line);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Enable the input direction of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t linux_gpiochip_direction_input(struct gpio_desc *desc)
+{
+	struct linux_gpiochip_line *line = desc->extra;
+
+	if (!line->owned)
+		return line->lines->direction == GPIO_IN ? SUCCESS : FAILURE;
+
+	return linux_gpio_lines_direction(line->lines, GPIO_IN, 0) ?
+	       FAILURE : SUCCESS;
+}
+
+/**
+ * @brief Enable the output direction of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param value - The value.
+ *                Example: GPIO_HIGH
+ *                         GPIO_LOW
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t linux_gpiochip_direction_output(struct gpio_desc *desc,
+		uint8_t value)
+{
+	struct linux_gpiochip_line *line = desc->extra;
+	uint64_t bit = 1ULL << line->index;
+
+	if (!line->owned) {
+		if (line->lines->direction != GPIO_OUT)
+			return FAILURE;
+		return linux_gpio_set_values(line->lines, bit,
+					     value ? bit : 0) ? FAILURE : SUCCESS;
+	}
+
+	return linux_gpio_lines_direction(line->lines, GPIO_OUT, !!value) ?
+	       FAILURE : SUCCESS;
+}
+
+/**
+ * @brief Get the direction of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param direction - The direction.
+ *                    Example: GPIO_OUT
+ *                             GPIO_IN
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t linux_gpiochip_get_direction(struct gpio_desc *desc,
+		uint8_t *direction)
+{
+	struct linux_gpiochip_line *line = desc->extra;
+
+	*direction = line->lines->direction;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Set the value of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param value - The value.
+ *                Example: GPIO_HIGH
+ *                         GPIO_LOW
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t linux_gpiochip_set_value(struct gpio_desc *desc,
+					uint8_t value)
+{
+	struct linux_gpiochip_line *line = desc->extra;
+	uint64_t bit = 1ULL << line->index;
+
+	return linux_gpio_set_values(line->lines, bit, value ? bit : 0) ?
+	       FAILURE : SUCCESS;
+}
+
+/**
+ * @brief Get the value of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param value - The value.
+ *                Example: GPIO_HIGH
+ *                         GPIO_LOW
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t linux_gpiochip_get_value(struct gpio_desc *desc,
+					uint8_t *value)
+{
+	struct linux_gpiochip_line *line = desc->extra;
+	uint64_t bit = 1ULL << line->index;
+	uint64_t values;
+
+	if (linux_gpio_get_values(line->lines, bit, &values))
+		return FAILURE;
+
+	*value = values ? GPIO_HIGH : GPIO_LOW;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Check if an earlier descriptor of the array uses the same group.
+ * @param desc - Array of GPIO descriptors.
+ * @param i - Index of the descriptor to be checked.
+ * @return true if the group of desc[i] was already accessed.
+ */
+static bool linux_gpiochip_group_done(struct gpio_desc **desc, uint8_t i)
+{
+	struct linux_gpiochip_line *line = desc[i]->extra;
+	struct linux_gpiochip_line *prev;
+	uint8_t j;
+
+	for (j = 0; j < i; j++) {
+		prev = desc[j]->extra;
+		if (prev->lines == line->lines)
+			return true;
+	}
+
+	return false;
+}
+
+/**
+ * @brief Set the values of several GPIOs, with one ioctl per line group.
+ * @param desc - Array of GPIO descriptors.
+ * @param num - Number of descriptors.
+ * @param values - The values, values[i] for desc[i].
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t linux_gpiochip_set_values(struct gpio_desc **desc, uint8_t num,
+		const uint8_t *values)
+{
+	struct linux_gpiochip_line *line;
+	uint64_t mask, bits;
+	uint8_t i, j;
+
+	for (i = 0; i < num; i++) {
+		if (linux_gpiochip_group_done(desc, i))
+			continue;
+
+		line = desc[i]->extra;
+		mask = 0;
+		bits = 0;
+		for (j = i; j < num; j++) {
+			struct linux_gpiochip_line *l = desc[j]->extra;
+
+			if (l->lines != line->lines)
+				continue;
+			mask |= 1ULL << l->index;
+			if (values[j])
+				bits |= 1ULL << l->index;
+		}
+
+		if (linux_gpio_set_values(line->lines, mask, bits))
+			return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the values of several GPIOs, with one ioctl per line group.
+ * @param desc - Array of GPIO descriptors.
+ * @param num - Number of descriptors.
+ * @param values - The values, values[i] for desc[i].
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t linux_gpiochip_get_values(struct gpio_desc **desc, uint8_t num,
+		uint8_t *values)
+{
+	struct linux_gpiochip_line *line;
+	uint64_t mask, bits;
+	uint8_t i, j;
+
+	for (i = 0; i < num; i++) {
+		if (linux_gpiochip_group_done(desc, i))
+			continue;
+
+		line = desc[i]->extra;
+		mask = 0;
+		for (j = i; j < num; j++) {
+			struct linux_gpiochip_line *l = desc[j]->extra;
+
+			if (l->lines == line->lines)
+				mask |= 1ULL << l->index;
+		}
+
+		if (linux_gpio_get_values(line->lines, mask, &bits))
+			return FAILURE;
+
+		for (j = i; j < num; j++) {
+			struct linux_gpiochip_line *l = desc[j]->extra;
+
+			if (l->lines == line->lines)
+				values[j] = (bits >> l->index) & 1 ?
+					    GPIO_HIGH : GPIO_LOW;
+		}
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Linux GPIO character device platform ops structure
+ */
+const struct gpio_platform_ops linux_gpiochip_ops = {
+	.gpio_ops_get = &linux_gpiochip_get,
+	.gpio_ops_get_optional = &linux_gpiochip_get_optional,
+	.gpio_ops_remove = &linux_gpiochip_remove,
+	.gpio_ops_direction_input = &linux_gpiochip_direction_input,
+	.gpio_ops_direction_output = &linux_gpiochip_direction_output,
+	.gpio_ops_get_direction = &linux_gpiochip_get_direction,
+	.gpio_ops_set_value = &linux_gpiochip_set_value,
+	.gpio_ops_get_value = &linux_gpiochip_get_value,
+	.gpio_ops_set_values = &linux_gpiochip_set_values,
+	.gpio_ops_get_values = &linux_gpiochip_get_values,
+};
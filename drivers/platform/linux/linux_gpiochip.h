@@ -0,0 +1,188 @@
+/***************************************************************************//**
+ *   @file   linux/linux_gpiochip.h
+ *   @brief  Header containing types and functions of the Linux GPIO character
+ *           device (uAPI v2) driver.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef LINUX_GPIOCHIP_H_
+#define LINUX_GPIOCHIP_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include "no-os/gpio.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** Maximum number of lines handled by one request */
+#define LINUX_GPIO_LINES_MAX	64
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @enum linux_gpio_edge
+ * @brief Edges reported by linux_gpio_read_event().
+ */
+enum linux_gpio_edge {
+	/** No edge detection */
+	LINUX_GPIO_EDGE_NONE,
+	/** Rising edge */
+	LINUX_GPIO_EDGE_RISING,
+	/** Falling edge */
+	LINUX_GPIO_EDGE_FALLING,
+	/** Both edges */
+	LINUX_GPIO_EDGE_BOTH,
+};
+
+struct linux_gpio_lines;
+
+/**
+ * @struct linux_gpiochip_init_param
+ * @brief Structure holding the initialization parameters for a single line
+ * requested through linux_gpiochip_ops. The line offset is given by
+ * gpio_init_param.number.
+ *
+ * When lines is set, no new request is made: the descriptor refers to the
+ * line with the same offset in that group, and gpio_set_values() /
+ * gpio_get_values() access all the descriptors of the group with one ioctl.
+ * Such a line keeps the direction of its group.
+ */
+struct linux_gpiochip_init_param {
+	/** GPIO chip ID (/dev/gpiochip"chip_id"), unused with lines */
+	uint32_t chip_id;
+	/** Edges to be reported while the line is an input, unused with
+	 *  lines */
+	enum linux_gpio_edge edge;
+	/** Group obtained with linux_gpio_lines_get(), or NULL */
+	struct linux_gpio_lines *lines;
+};
+
+/**
+ * @struct linux_gpio_lines_init_param
+ * @brief Structure holding the initialization parameters for a group of lines
+ * of the same chip, requested and accessed through a single handle.
+ */
+struct linux_gpio_lines_init_param {
+	/** GPIO chip ID (/dev/gpiochip"chip_id") */
+	uint32_t chip_id;
+	/** Line offsets within the chip */
+	const uint32_t *offsets;
+	/** Number of lines (at most LINUX_GPIO_LINES_MAX) */
+	uint32_t num_lines;
+	/** GPIO_IN or GPIO_OUT */
+	uint8_t direction;
+	/** Initial values of the outputs, bit i for offsets[i] */
+	uint64_t values;
+	/** Edges to be reported if the lines are inputs */
+	enum linux_gpio_edge edge;
+};
+
+/**
+ * @struct linux_gpio_lines
+ * @brief Handle of a group of requested lines.
+ */
+struct linux_gpio_lines {
+	/** Line request file descriptor */
+	int fd;
+	/** Number of lines */
+	uint32_t num_lines;
+	/** Current direction (GPIO_IN or GPIO_OUT) */
+	uint8_t direction;
+	/** Edge detection used while the lines are inputs */
+	enum linux_gpio_edge edge;
+	/** Line offsets within the chip */
+	uint32_t offsets[LINUX_GPIO_LINES_MAX];
+};
+
+/**
+ * @struct linux_gpio_event
+ * @brief Edge event read from a line request.
+ */
+struct linux_gpio_event {
+	/** Kernel timestamp of the event (CLOCK_MONOTONIC), in nanoseconds */
+	uint64_t timestamp_ns;
+	/** Offset of the line within the chip */
+	uint32_t line;
+	/** LINUX_GPIO_EDGE_RISING or LINUX_GPIO_EDGE_FALLING */
+	enum linux_gpio_edge edge;
+	/** Sequence number of the event for this line */
+	uint32_t seqno;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Request a group of lines. */
+int32_t linux_gpio_lines_get(struct linux_gpio_lines **lines,
+			     const struct linux_gpio_lines_init_param *param);
+
+/* Release a group of lines. */
+int32_t linux_gpio_lines_remove(struct linux_gpio_lines *lines);
+
+/* Set the direction of all the lines in the group. */
+int32_t linux_gpio_lines_direction(struct linux_gpio_lines *lines,
+				   uint8_t direction, uint64_t values);
+
+/* Set the values of the lines selected by mask in a single call. */
+int32_t linux_gpio_set_values(struct linux_gpio_lines *lines,
+			      uint64_t mask, uint64_t values);
+
+/* Get the values of the lines selected by mask in a single call. */
+int32_t linux_gpio_get_values(struct linux_gpio_lines *lines,
+			      uint64_t mask, uint64_t *values);
+
+/* Wait for and read an edge event. */
+int32_t linux_gpio_read_event(struct linux_gpio_lines *lines,
+			      struct linux_gpio_event *event,
+			      int32_t timeout_ms);
+
+/* Wait for and read an edge event of a line obtained with gpio_get(). */
+int32_t linux_gpiochip_read_event(struct gpio_desc *desc,
+				  struct linux_gpio_event *event,
+				  int32_t timeout_ms);
+
+/**
+ * @brief Linux GPIO character device platform ops structure
+ */
+extern const struct gpio_platform_ops linux_gpiochip_ops;
+
+#endif // LINUX_GPIOCHIP_H_
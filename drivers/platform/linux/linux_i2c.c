@@ -44,6 +44,7 @@
 #include "no-os/error.h"
 #include "no-os/i2c.h"
 #include "linux_i2c.h"
+#include "linux_async.h"
 
 #include <fcntl.h>
 #include <stdio.h>
@@ -63,6 +64,10 @@
 struct linux_i2c_desc {
 	/** /dev/i2c-"device_id" file descriptor */
 	int fd;
+	/** Depth of the asynchronous request queue */
+	uint32_t async_depth;
+	/** Asynchronous request queue, created on the first async transfer */
+	struct linux_async_queue *async;
 };
 
 /******************************************************************************/
@@ -87,12 +92,13 @@ int32_t linux_i2c_init(struct i2c_desc **desc,
 	if (!descriptor)
 		return FAILURE;
 
-	linux_desc = (struct linux_i2c_desc*) malloc(sizeof(struct linux_i2c_desc));
+	linux_desc = (struct linux_i2c_desc*) calloc(1, sizeof(struct linux_i2c_desc));
 	if (!linux_desc)
 		goto free_desc;
 
 	descriptor->extra = linux_desc;
 	linux_init = param->extra;
+	linux_desc->async_depth = linux_init->async_queue_depth;
 
 	snprintf(path, sizeof(path), "/dev/i2c-%d", linux_init->device_id);
 
@@ -128,6 +134,10 @@ int32_t linux_i2c_remove(struct i2c_desc *desc)
 
 	linux_desc = desc->extra;
 
+	/* Waits for the pending asynchronous transfers */
+	if (linux_desc->async)
+		linux_async_remove(linux_desc->async);
+
 	ret = close(linux_desc->fd);
 	if (ret < 0) {
 		printf("%s: Can't close device\n\r", __func__);
@@ -150,10 +160,10 @@ int32_t linux_i2c_remove(struct i2c_desc *desc)
  *                            1 - A stop condition will be generated.
  * @return SUCCESS in case of success, FAILURE otherwise.
  */
-int32_t linux_i2c_write(struct i2c_desc *desc,
-			uint8_t *data,
-			uint8_t bytes_number,
-			uint8_t stop_bit)
+static int32_t _linux_i2c_write(struct i2c_desc *desc,
+				uint8_t *data,
+				uint8_t bytes_number,
+				uint8_t stop_bit)
 {
 	struct linux_i2c_desc *linux_desc;
 	int32_t ret;
@@ -189,10 +199,10 @@ int32_t linux_i2c_write(struct i2c_desc *desc,
  *                            1 - A stop condition will be generated.
  * @return SUCCESS in case of success, FAILURE otherwise.
  */
-int32_t linux_i2c_read(struct i2c_desc *desc,
-		       uint8_t *data,
-		       uint8_t bytes_number,
-		       uint8_t stop_bit)
+static int32_t _linux_i2c_read(struct i2c_desc *desc,
+			       uint8_t *data,
+			       uint8_t bytes_number,
+			       uint8_t stop_bit)
 {
 	struct linux_i2c_desc *linux_desc;
 	int32_t ret;
@@ -218,6 +228,123 @@ int32_t linux_i2c_read(struct i2c_desc *desc,
 	return SUCCESS;
 }
 
+/**
+ * @brief Write data to a slave device.
+ * @param desc - The I2C descriptor.
+ * @param data - Buffer that stores the transmission data.
+ * @param bytes_number - Number of bytes to write.
+ * @param stop_bit - Stop condition control.
+ *                   Example: 0 - A stop condition will not be generated;
+ *                            1 - A stop condition will be generated.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_i2c_write(struct i2c_desc *desc,
+			uint8_t *data,
+			uint8_t bytes_number,
+			uint8_t stop_bit)
+{
+	struct linux_i2c_desc *linux_desc = desc->extra;
+	int32_t ret;
+
+	linux_async_lock(linux_desc->async);
+	ret = _linux_i2c_write(desc, data, bytes_number, stop_bit);
+	linux_async_unlock(linux_desc->async);
+
+	return ret;
+}
+
+/**
+ * @brief Read data from a slave device.
+ * @param desc - The I2C descriptor.
+ * @param data - Buffer that will store the received data.
+ * @param bytes_number - Number of bytes to read.
+ * @param stop_bit - Stop condition control.
+ *                   Example: 0 - A stop condition will not be generated;
+ *                            1 - A stop condition will be generated.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_i2c_read(struct i2c_desc *desc,
+		       uint8_t *data,
+		       uint8_t bytes_number,
+		       uint8_t stop_bit)
+{
+	struct linux_i2c_desc *linux_desc = desc->extra;
+	int32_t ret;
+
+	linux_async_lock(linux_desc->async);
+	ret = _linux_i2c_read(desc, data, bytes_number, stop_bit);
+	linux_async_unlock(linux_desc->async);
+
+	return ret;
+}
+
+/**
+ * @brief Execute an array of reads/writes. Called from the worker thread.
+ * @param dev - The I2C descriptor.
+ * @param i2c_xfers - Array of struct i2c_xfer.
+ * @param len - Number of elements in the array.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t _linux_i2c_transfer(void *dev, void *i2c_xfers, uint32_t len)
+{
+	struct i2c_xfer *xfers = i2c_xfers;
+	int32_t ret = SUCCESS;
+	uint32_t i;
+
+	for (i = 0; i < len; i++) {
+		if (xfers[i].read)
+			ret = _linux_i2c_read(dev, xfers[i].data,
+					      xfers[i].bytes_number,
+					      xfers[i].stop_bit);
+		else
+			ret = _linux_i2c_write(dev, xfers[i].data,
+					       xfers[i].bytes_number,
+					       xfers[i].stop_bit);
+		if (ret != SUCCESS)
+			break;
+	}
+
+	return ret;
+}
+
+/**
+ * @brief Queue an array of reads/writes to be executed by the worker thread.
+ * @param desc - The I2C descriptor.
+ * @param xfers - Array of reads/writes. Must stay valid until callback is
+ *                called.
+ * @param len - Number of elements in the array.
+ * @param callback - Called from the worker thread with the transfer status.
+ * @param ctx - Parameter passed to the callback.
+ * @return SUCCESS in case of success, -EBUSY if the queue is full,
+ *         negative error code otherwise.
+ */
+static int32_t linux_i2c_transfer_async(struct i2c_desc *desc,
+					struct i2c_xfer *xfers,
+					uint32_t len,
+					void (*callback)(void *, int32_t),
+					void *ctx)
+{
+	struct linux_i2c_desc *linux_desc = desc->extra;
+	struct linux_async_job job = {
+		.xfer = _linux_i2c_transfer,
+		.dev = desc,
+		.msgs = xfers,
+		.len = len,
+		.callback = callback,
+		.ctx = ctx,
+	};
+	int32_t ret;
+
+	if (!linux_desc->async) {
+		ret = linux_async_init(&linux_desc->async,
+				       linux_desc->async_depth);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	return linux_async_submit(linux_desc->async, &job);
+}
+
 /**
  * @brief Linux platform specific I2C platform ops structure
  */
@@ -225,5 +352,6 @@ const struct i2c_platform_ops linux_i2c_ops = {
 	.i2c_ops_init = &linux_i2c_init,
 	.i2c_ops_write = &linux_i2c_write,
 	.i2c_ops_read = &linux_i2c_read,
-	.i2c_ops_remove = &linux_i2c_remove
+	.i2c_ops_remove = &linux_i2c_remove,
+	.i2c_ops_transfer_async = &linux_i2c_transfer_async
 };
@@ -47,6 +47,9 @@
 struct linux_i2c_init_param {
 	/** I2C bus ID (/dev/i2c-"device_id") */
 	uint32_t device_id;
+	/** Depth of the i2c_transfer_async() queue. 0 selects
+	 *  LINUX_ASYNC_DEFAULT_DEPTH. */
+	uint32_t async_queue_depth;
 };
 
 /**
@@ -0,0 +1,522 @@
+/***************************************************************************//**
+ *   @file   linux_sd_model.c
+ *   @brief  File backed SD card model for the Linux platform.
+ *           Emulates an SDHC card in SPI mode so the SD card driver and
+ *           the layers above it can be exercised and measured on a host.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "no-os/error.h"
+#include "no-os/spi.h"
+#include "linux_sd_model.h"
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define SD_MODEL_BLOCK_LEN		512u
+#define SD_MODEL_SIZE_UNIT		(512u * 1024u)
+#define SD_MODEL_MAX_BUSY_BYTES		256u
+#define SD_MODEL_OUT_LEN		(SD_MODEL_BLOCK_LEN + 8u + \
+					 SD_MODEL_MAX_BUSY_BYTES)
+#define SD_MODEL_DEFAULT_HZ		25000000u
+
+#define SD_MODEL_R1_IDLE		0x01u
+#define SD_MODEL_R1_ILLEGAL		0x04u
+#define SD_MODEL_R1_ADDRESS		0x20u
+#define SD_MODEL_DATA_ACCEPTED		0x05u
+#define SD_MODEL_DATA_WRITE_ERROR	0x0Du
+#define SD_MODEL_ERR_OUT_OF_RANGE	0x08u
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @enum linux_sd_model_state
+ * @brief What the model expects from the host
+ */
+enum linux_sd_model_state {
+	SD_MODEL_CMD,
+	SD_MODEL_WRITE_TOKEN,
+	SD_MODEL_WRITE_DATA,
+};
+
+/**
+ * @struct linux_sd_model_desc
+ * @brief SD card model descriptor
+ */
+struct linux_sd_model_desc {
+	/** Backing file */
+	int fd;
+	/** Number of blocks of the card */
+	uint32_t nb_blocks;
+	/** Busy bytes after a written block */
+	uint32_t busy_bytes;
+	/** Fixed cost of one transaction, in ns */
+	uint32_t xfer_overhead_ns;
+	/** Bus clock */
+	uint32_t hz;
+	/** Card in idle state (not initialized yet) */
+	bool idle;
+	/** Next command is an application command */
+	bool app_cmd;
+	/** Number of ACMD41 received */
+	uint32_t acmd41;
+	enum linux_sd_model_state state;
+	/** Command being received */
+	uint8_t cmd[6];
+	uint32_t cmd_len;
+	/** Bytes to be sent to the host */
+	uint8_t out[SD_MODEL_OUT_LEN];
+	uint32_t out_len;
+	uint32_t out_pos;
+	/** Block read in progress, stream until CMD12 unless read_single */
+	bool reading;
+	bool read_single;
+	uint32_t read_block;
+	/** Block write in progress */
+	bool write_multi;
+	uint32_t write_block;
+	uint8_t in[SD_MODEL_BLOCK_LEN + 2];
+	uint32_t in_len;
+	struct linux_sd_model_stats stats;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Drop the pending output of the card.
+ * @param dev - The model descriptor.
+ */
+static void sd_model_out_reset(struct linux_sd_model_desc *dev)
+{
+	dev->out_len = 0;
+	dev->out_pos = 0;
+}
+
+/**
+ * @brief Queue bytes to be sent to the host.
+ * @param dev - The model descriptor.
+ * @param val - Byte value.
+ * @param n - Number of bytes.
+ */
+static void sd_model_out_push(struct linux_sd_model_desc *dev, uint8_t val,
+			      uint32_t n)
+{
+	while (n-- && dev->out_len < SD_MODEL_OUT_LEN)
+		dev->out[dev->out_len++] = val;
+}
+
+/**
+ * @brief Get the R1 response for the current card state.
+ * @param dev - The model descriptor.
+ * @return The R1 byte.
+ */
+static inline uint8_t sd_model_r1(struct linux_sd_model_desc *dev)
+{
+	return dev->idle ? SD_MODEL_R1_IDLE : 0x00;
+}
+
+/**
+ * @brief Queue the next block of a read command.
+ * @param dev - The model descriptor.
+ */
+static void sd_model_fill_read(struct linux_sd_model_desc *dev)
+{
+	uint8_t *data;
+
+	sd_model_out_reset(dev);
+	sd_model_out_push(dev, 0xFF, 1);
+
+	if (dev->read_block >= dev->nb_blocks) {
+		sd_model_out_push(dev, SD_MODEL_ERR_OUT_OF_RANGE, 1);
+		dev->reading = false;
+		return;
+	}
+
+	sd_model_out_push(dev, 0xFE, 1);
+	data = dev->out + dev->out_len;
+	if (pread(dev->fd, data, SD_MODEL_BLOCK_LEN,
+		  (off_t)dev->read_block * SD_MODEL_BLOCK_LEN) != SD_MODEL_BLOCK_LEN)
+		memset(data, 0, SD_MODEL_BLOCK_LEN);
+	dev->out_len += SD_MODEL_BLOCK_LEN;
+	sd_model_out_push(dev, 0xFF, 2);
+
+	dev->read_block++;
+	dev->stats.blocks_read++;
+	if (dev->read_single)
+		dev->reading = false;
+}
+
+/**
+ * @brief Execute a complete command.
+ * @param dev - The model descriptor.
+ */
+static void sd_model_exec(struct linux_sd_model_desc *dev)
+{
+	uint8_t idx = dev->cmd[0] & 0x3F;
+	uint32_t arg = ((uint32_t)dev->cmd[1] << 24) | (dev->cmd[2] << 16) |
+		       (dev->cmd[3] << 8) | dev->cmd[4];
+	bool app = dev->app_cmd;
+	uint8_t csd[16] = {0x40};
+	uint32_t c_size;
+
+	dev->stats.cmds++;
+	dev->app_cmd = false;
+	dev->reading = false;
+	sd_model_out_reset(dev);
+	/* NCR */
+	sd_model_out_push(dev, 0xFF, 1);
+
+	switch (idx) {
+	case 0:
+		dev->idle = true;
+		dev->acmd41 = 0;
+		sd_model_out_push(dev, SD_MODEL_R1_IDLE, 1);
+		break;
+	case 8:
+		sd_model_out_push(dev, sd_model_r1(dev), 1);
+		sd_model_out_push(dev, 0x00, 2);
+		sd_model_out_push(dev, (arg >> 8) & 0xF, 1);
+		sd_model_out_push(dev, arg & 0xFF, 1);
+		break;
+	case 55:
+		dev->app_cmd = true;
+		sd_model_out_push(dev, sd_model_r1(dev), 1);
+		break;
+	case 41:
+		if (!app) {
+			sd_model_out_push(dev, sd_model_r1(dev) | SD_MODEL_R1_ILLEGAL, 1);
+			break;
+		}
+		/* Report the card as initializing once */
+		if (++dev->acmd41 > 1)
+			dev->idle = false;
+		sd_model_out_push(dev, sd_model_r1(dev), 1);
+		break;
+	case 58:
+		sd_model_out_push(dev, sd_model_r1(dev), 1);
+		/* Power up done, CCS set: SDHC */
+		sd_model_out_push(dev, 0xC0, 1);
+		sd_model_out_push(dev, 0xFF, 1);
+		sd_model_out_push(dev, 0x80, 1);
+		sd_model_out_push(dev, 0x00, 1);
+		break;
+	case 9:
+		c_size = dev->nb_blocks / (SD_MODEL_SIZE_UNIT / SD_MODEL_BLOCK_LEN) - 1;
+		csd[7] = (c_size >> 16) & 0x3F;
+		csd[8] = (c_size >> 8) & 0xFF;
+		csd[9] = c_size & 0xFF;
+		sd_model_out_push(dev, sd_model_r1(dev), 1);
+		sd_model_out_push(dev, 0xFF, 1);
+		sd_model_out_push(dev, 0xFE, 1);
+		memcpy(dev->out + dev->out_len, csd, sizeof(csd));
+		dev->out_len += sizeof(csd);
+		sd_model_out_push(dev, 0xFF, 2);
+		break;
+	case 12:
+		/* Stuff byte, then R1 */
+		sd_model_out_push(dev, 0xFF, 1);
+		sd_model_out_push(dev, sd_model_r1(dev), 1);
+		break;
+	case 17:
+	case 18:
+		if (arg >= dev->nb_blocks) {
+			sd_model_out_push(dev, SD_MODEL_R1_ADDRESS, 1);
+			break;
+		}
+		sd_model_out_push(dev, sd_model_r1(dev), 1);
+		dev->reading = true;
+		dev->read_single = (idx == 17);
+		dev->read_block = arg;
+		break;
+	case 24:
+	case 25:
+		if (arg >= dev->nb_blocks) {
+			sd_model_out_push(dev, SD_MODEL_R1_ADDRESS, 1);
+			break;
+		}
+		sd_model_out_push(dev, sd_model_r1(dev), 1);
+		dev->state = SD_MODEL_WRITE_TOKEN;
+		dev->write_multi = (idx == 25);
+		dev->write_block = arg;
+		break;
+	default:
+		sd_model_out_push(dev, sd_model_r1(dev) | SD_MODEL_R1_ILLEGAL, 1);
+		break;
+	}
+}
+
+/**
+ * @brief Store a received data block.
+ * @param dev - The model descriptor.
+ */
+static void sd_model_store_block(struct linux_sd_model_desc *dev)
+{
+	uint8_t resp = SD_MODEL_DATA_ACCEPTED;
+
+	if (dev->write_block >= dev->nb_blocks ||
+	    pwrite(dev->fd, dev->in, SD_MODEL_BLOCK_LEN,
+		   (off_t)dev->write_block * SD_MODEL_BLOCK_LEN) != SD_MODEL_BLOCK_LEN)
+		resp = SD_MODEL_DATA_WRITE_ERROR;
+	else
+		dev->stats.blocks_written++;
+
+	dev->write_block++;
+	sd_model_out_reset(dev);
+	sd_model_out_push(dev, resp, 1);
+	sd_model_out_push(dev, 0x00, dev->busy_bytes);
+	dev->state = dev->write_multi ? SD_MODEL_WRITE_TOKEN : SD_MODEL_CMD;
+}
+
+/**
+ * @brief Handle a byte received from the host.
+ * @param dev - The model descriptor.
+ * @param b - Received byte.
+ */
+static void sd_model_in(struct linux_sd_model_desc *dev, uint8_t b)
+{
+	switch (dev->state) {
+	case SD_MODEL_WRITE_TOKEN:
+		if ((b == 0xFE && !dev->write_multi) ||
+		    (b == 0xFC && dev->write_multi)) {
+			dev->in_len = 0;
+			dev->state = SD_MODEL_WRITE_DATA;
+			return;
+		}
+		if (b == 0xFD && dev->write_multi) {
+			sd_model_out_reset(dev);
+			sd_model_out_push(dev, 0xFF, 1);
+			sd_model_out_push(dev, 0x00, dev->busy_bytes);
+			dev->state = SD_MODEL_CMD;
+			return;
+		}
+		if ((b & 0xC0) != 0x40)
+			return;
+		/* A command aborts the write */
+		dev->state = SD_MODEL_CMD;
+	/* fall through */
+	case SD_MODEL_CMD:
+		if (!dev->cmd_len && (b & 0xC0) != 0x40)
+			return;
+		dev->cmd[dev->cmd_len++] = b;
+		if (dev->cmd_len == sizeof(dev->cmd)) {
+			dev->cmd_len = 0;
+			sd_model_exec(dev);
+		}
+		break;
+	case SD_MODEL_WRITE_DATA:
+		dev->in[dev->in_len++] = b;
+		if (dev->in_len == sizeof(dev->in))
+			sd_model_store_block(dev);
+		break;
+	}
+}
+
+/**
+ * @brief Get the next byte sent to the host.
+ * @param dev - The model descriptor.
+ * @return The byte.
+ */
+static uint8_t sd_model_out(struct linux_sd_model_desc *dev)
+{
+	if (dev->out_pos == dev->out_len && dev->reading)
+		sd_model_fill_read(dev);
+	if (dev->out_pos < dev->out_len)
+		return dev->out[dev->out_pos++];
+
+	return 0xFF;
+}
+
+/**
+ * @brief Initialize the SD card model.
+ * @param desc - The SPI descriptor.
+ * @param param - The structure that contains the SPI parameters, extra
+ * points to a struct linux_sd_model_init_param.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t linux_sd_model_init(struct spi_desc **desc,
+				   const struct spi_init_param *param)
+{
+	struct linux_sd_model_init_param *model_param;
+	struct linux_sd_model_desc *dev;
+	struct spi_desc *descriptor;
+	uint64_t size;
+
+	if (!desc || !param || !param->extra)
+		return FAILURE;
+
+	model_param = param->extra;
+	size = model_param->size - model_param->size % SD_MODEL_SIZE_UNIT;
+	if (!model_param->path || !size ||
+	    model_param->busy_bytes > SD_MODEL_MAX_BUSY_BYTES)
+		return FAILURE;
+
+	descriptor = calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return FAILURE;
+
+	dev = calloc(1, sizeof(*dev));
+	if (!dev)
+		goto free_desc;
+
+	dev->fd = open(model_param->path, O_RDWR | O_CREAT, 0644);
+	if (dev->fd < 0) {
+		printf("%s: Can't open %s\n\r", __func__, model_param->path);
+		goto free;
+	}
+
+	if (ftruncate(dev->fd, size))
+		goto close_fd;
+
+	dev->nb_blocks = size / SD_MODEL_BLOCK_LEN;
+	dev->busy_bytes = model_param->busy_bytes;
+	dev->xfer_overhead_ns = model_param->xfer_overhead_ns;
+	dev->hz = param->max_speed_hz ? param->max_speed_hz : SD_MODEL_DEFAULT_HZ;
+	dev->idle = true;
+
+	descriptor->device_id = param->device_id;
+	descriptor->max_speed_hz = param->max_speed_hz;
+	descriptor->chip_select = param->chip_select;
+	descriptor->mode = param->mode;
+	descriptor->extra = dev;
+	*desc = descriptor;
+
+	return SUCCESS;
+close_fd:
+	close(dev->fd);
+free:
+	free(dev);
+free_desc:
+	free(descriptor);
+
+	return FAILURE;
+}
+
+/**
+ * @brief Exchange bytes with the SD card model.
+ * @param desc - The SPI descriptor.
+ * @param data - Data to be sent, replaced with the received data.
+ * @param bytes_number - Number of bytes.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t linux_sd_model_write_and_read(struct spi_desc *desc,
+		uint8_t *data, uint16_t bytes_number)
+{
+	struct linux_sd_model_desc *dev;
+	uint8_t in;
+	uint16_t i;
+
+	if (!desc || !data)
+		return FAILURE;
+
+	dev = desc->extra;
+	for (i = 0; i < bytes_number; i++) {
+		in = data[i];
+		data[i] = sd_model_out(dev);
+		sd_model_in(dev, in);
+	}
+
+	dev->stats.transfers++;
+	dev->stats.bytes += bytes_number;
+	dev->stats.bus_time_ns += dev->xfer_overhead_ns +
+				  (uint64_t)bytes_number * 8 * 1000000000 / dev->hz;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the traffic counters of the model.
+ * @param desc - The SPI descriptor of the model.
+ * @param stats - Where to store the counters.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_sd_model_get_stats(struct spi_desc *desc,
+				 struct linux_sd_model_stats *stats)
+{
+	struct linux_sd_model_desc *dev;
+
+	if (!desc || !stats)
+		return FAILURE;
+
+	dev = desc->extra;
+	*stats = dev->stats;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the resources allocated by linux_sd_model_init().
+ * @param desc - The SPI descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t linux_sd_model_remove(struct spi_desc *desc)
+{
+	struct linux_sd_model_desc *dev;
+
+	if (!desc)
+		return FAILURE;
+
+	dev = desc->extra;
+	close(dev->fd);
+	free(dev);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief SD card model SPI platform ops structure
+ */
+const struct spi_platform_ops linux_sd_model_ops = {
+	.init = &linux_sd_model_init,
+	.write_and_read = &linux_sd_model_write_and_read,
+	.remove = &linux_sd_model_remove
+};
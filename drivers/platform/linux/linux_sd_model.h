@@ -0,0 +1,100 @@
+/***************************************************************************//**
+ *   @file   linux_sd_model.h
+ *   @brief  File backed SD card model for the Linux platform.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef LINUX_SD_MODEL_H_
+#define LINUX_SD_MODEL_H_
+
+#include <stdint.h>
+#include "no-os/spi.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct linux_sd_model_init_param
+ * @brief Parameters of the SD card model, passed in spi_init_param.extra.
+ *
+ * The model answers the SPI mode commands used by drivers/sd-card (CMD0, 8, 9,
+ * 12, 17, 18, 24, 25, 55, 58 and ACMD41) like an SDHC card whose content is
+ * stored in a file. It also accounts for the bus time the same traffic would
+ * take on a real SPI bus running at spi_init_param.max_speed_hz.
+ */
+struct linux_sd_model_init_param {
+	/** Backing file, created if missing */
+	const char	*path;
+	/** Card size in bytes, rounded down to a multiple of 512 KiB */
+	uint64_t	size;
+	/** Number of busy (0x00) bytes sent after every written block */
+	uint32_t	busy_bytes;
+	/** Fixed cost of one SPI transaction, in ns */
+	uint32_t	xfer_overhead_ns;
+};
+
+/**
+ * @struct linux_sd_model_stats
+ * @brief Traffic seen by the SD card model.
+ */
+struct linux_sd_model_stats {
+	/** spi_write_and_read() calls */
+	uint32_t	transfers;
+	/** Bytes clocked on the bus */
+	uint64_t	bytes;
+	/** Commands received */
+	uint32_t	cmds;
+	/** Blocks sent to the host */
+	uint32_t	blocks_read;
+	/** Blocks received from the host */
+	uint32_t	blocks_written;
+	/** Estimated bus time, in ns */
+	uint64_t	bus_time_ns;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Get the traffic counters of the model. */
+int32_t linux_sd_model_get_stats(struct spi_desc *desc,
+				 struct linux_sd_model_stats *stats);
+
+/**
+ * @brief SD card model SPI platform ops structure
+ */
+extern const struct spi_platform_ops linux_sd_model_ops;
+
+#endif // LINUX_SD_MODEL_H_
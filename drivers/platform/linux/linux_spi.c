@@ -44,10 +44,13 @@
 #include "no-os/error.h"
 #include "no-os/spi.h"
 #include "linux_spi.h"
+#include "linux_async.h"
 
 #include <fcntl.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/ioctl.h>
 #include <unistd.h>
 #include <linux/spi/spidev.h>
@@ -63,37 +66,110 @@
 struct linux_spi_desc {
 	/** /dev/spidev"device_id"."chip_select" file descriptor */
 	int spidev_fd;
+	/** Preallocated transfer array used by transfer() and the write queue */
+	struct spi_ioc_transfer *tr;
+	/** Number of entries in tr */
+	uint32_t tr_size;
+	/** Write coalescing enabled */
+	bool coalesce;
+	/** Storage for the data of the queued writes */
+	uint8_t *queue_buff;
+	/** Size of queue_buff */
+	uint32_t queue_buff_size;
+	/** Number of queued writes */
+	uint32_t queued_msgs;
+	/** Number of bytes used in queue_buff */
+	uint32_t queued_bytes;
+	/** Mask applied on the first byte to detect a read */
+	uint8_t read_flag_mask;
+	/** Number of SPI_IOC_MESSAGE() requests issued */
+	uint32_t ioctl_cnt;
+	/** Depth of the asynchronous request queue */
+	uint32_t async_depth;
+	/** Asynchronous request queue, created on the first async transfer */
+	struct linux_async_queue *async;
 };
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
 
+/**
+ * @brief Issue a single SPI_IOC_MESSAGE() request.
+ * @param linux_desc - The Linux platform specific SPI descriptor.
+ * @param tr - Array of transfers.
+ * @param len - Number of transfers.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t linux_spi_message(struct linux_spi_desc *linux_desc,
+				 struct spi_ioc_transfer *tr, uint32_t len)
+{
+	int ret;
+
+	linux_desc->ioctl_cnt++;
+	ret = ioctl(linux_desc->spidev_fd, SPI_IOC_MESSAGE(len), tr);
+	if (ret < 0) {
+		printf("%s: Can't send spi message (%d)\n\r", __func__, errno);
+		return -errno;
+	}
+
+	return SUCCESS;
+}
+
 /**
  * @brief Initialize the SPI communication peripheral.
  * @param desc - The SPI descriptor.
  * @param param - The structure that contains the SPI parameters.
- * @return SUCCESS in case of success, FAILURE otherwise.
+ * @return SUCCESS in case of success, -EINVAL if write coalescing is requested
+ * without a read_flag_mask, FAILURE otherwise.
  */
 int32_t linux_spi_init(struct spi_desc **desc,
 		       const struct spi_init_param *param)
 {
+	struct linux_spi_init_param *linux_param;
 	struct linux_spi_desc *linux_desc;
 	struct spi_desc *descriptor;
 	uint8_t bits = 8;
 	char path[64];
 	int ret;
 
+	linux_param = param->extra;
+	/* Without a read flag every message would be queued as a write */
+	if (linux_param && linux_param->max_queued_msgs > 1 &&
+	    !linux_param->read_flag_mask)
+		return -EINVAL;
+
 	descriptor = malloc(sizeof(*descriptor));
 	if (!descriptor)
 		return FAILURE;
 
-	linux_desc = (struct linux_spi_desc*) malloc(sizeof(struct linux_spi_desc));
+	linux_desc = (struct linux_spi_desc*) calloc(1, sizeof(struct linux_spi_desc));
 	if (!linux_desc)
 		goto free_desc;
 
 	descriptor->extra = linux_desc;
 
+	linux_desc->tr_size = 1;
+	if (linux_param)
+		linux_desc->async_depth = linux_param->async_queue_depth;
+	if (linux_param && linux_param->max_queued_msgs > 1) {
+		linux_desc->coalesce = true;
+		linux_desc->read_flag_mask = linux_param->read_flag_mask;
+		linux_desc->tr_size = linux_param->max_queued_msgs;
+		if (linux_desc->tr_size > LINUX_SPI_MAX_QUEUED_MSGS)
+			linux_desc->tr_size = LINUX_SPI_MAX_QUEUED_MSGS;
+		linux_desc->queue_buff_size = linux_param->max_queued_bytes ?
+					      linux_param->max_queued_bytes :
+					      LINUX_SPI_MAX_QUEUED_BYTES;
+		linux_desc->queue_buff = malloc(linux_desc->queue_buff_size);
+		if (!linux_desc->queue_buff)
+			goto free;
+	}
+
+	linux_desc->tr = calloc(linux_desc->tr_size, sizeof(*linux_desc->tr));
+	if (!linux_desc->tr)
+		goto free;
+
 	snprintf(path, sizeof(path), "/dev/spidev%d.%d",
 		 param->device_id, param->chip_select);
 
@@ -107,27 +183,31 @@ int32_t linux_spi_init(struct spi_desc **desc,
 		    &param->mode);
 	if (ret == -1) {
 		printf("%s: Can't set SPI mode\n\r", __func__);
-		goto free;
+		goto close_fd;
 	}
 
 	ret = ioctl(linux_desc->spidev_fd, SPI_IOC_WR_BITS_PER_WORD,
 		    &bits);
 	if (ret == -1) {
 		printf("%s: Can't set SPI bits per word\n\r", __func__);
-		goto free;
+		goto close_fd;
 	}
 
 	ret = ioctl(linux_desc->spidev_fd, SPI_IOC_WR_MAX_SPEED_HZ,
 		    &param->max_speed_hz);
 	if (ret == -1) {
 		printf("%s: Can't set SPI max speed hz\n\r", __func__);
-		goto free;
+		goto close_fd;
 	}
 
 	*desc = descriptor;
 
 	return SUCCESS;
+close_fd:
+	close(linux_desc->spidev_fd);
 free:
+	free(linux_desc->tr);
+	free(linux_desc->queue_buff);
 	free(linux_desc);
 free_desc:
 	free(descriptor);
@@ -135,12 +215,105 @@ free_desc:
 	return FAILURE;
 }
 
+/**
+ * @brief Send all the queued writes to the device.
+ * @param linux_desc - The Linux platform specific SPI descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t _linux_spi_flush(struct linux_spi_desc *linux_desc)
+{
+	uint32_t len;
+
+	len = linux_desc->queued_msgs;
+	if (!len)
+		return SUCCESS;
+
+	linux_desc->queued_msgs = 0;
+	linux_desc->queued_bytes = 0;
+	/* cs_change on the last transfer would leave CS asserted */
+	linux_desc->tr[len - 1].cs_change = 0;
+
+	return linux_spi_message(linux_desc, linux_desc->tr, len);
+}
+
+/**
+ * @brief Send all the queued writes to the device.
+ * @param desc - The SPI descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_spi_flush(struct spi_desc *desc)
+{
+	struct linux_spi_desc *linux_desc;
+	int32_t ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	linux_desc = desc->extra;
+
+	linux_async_lock(linux_desc->async);
+	ret = _linux_spi_flush(linux_desc);
+	linux_async_unlock(linux_desc->async);
+
+	return ret;
+}
+
+/**
+ * @brief Get the number of SPI_IOC_MESSAGE() requests issued so far.
+ * @param desc - The SPI descriptor.
+ * @return Number of requests.
+ */
+uint32_t linux_spi_get_ioctl_count(struct spi_desc *desc)
+{
+	struct linux_spi_desc *linux_desc = desc->extra;
+
+	return linux_desc->ioctl_cnt;
+}
+
+/**
+ * @brief Add a write to the queue, flushing it first if it is full.
+ * @param linux_desc - The Linux platform specific SPI descriptor.
+ * @param data - The data to be written.
+ * @param bytes_number - Number of bytes to write.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t linux_spi_queue_write(struct linux_spi_desc *linux_desc,
+				     uint8_t *data,
+				     uint16_t bytes_number)
+{
+	struct spi_ioc_transfer *tr;
+	uint8_t *buff;
+	int32_t ret;
+
+	if (linux_desc->queued_msgs == linux_desc->tr_size ||
+	    linux_desc->queued_bytes + bytes_number > linux_desc->queue_buff_size) {
+		ret = _linux_spi_flush(linux_desc);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	buff = linux_desc->queue_buff + linux_desc->queued_bytes;
+	memcpy(buff, data, bytes_number);
+
+	tr = &linux_desc->tr[linux_desc->queued_msgs];
+	memset(tr, 0, sizeof(*tr));
+	tr->tx_buf = (unsigned long)buff;
+	tr->len = bytes_number;
+	/* Keep the device framing: every write is its own CS cycle */
+	tr->cs_change = 1;
+
+	linux_desc->queued_msgs++;
+	linux_desc->queued_bytes += bytes_number;
+
+	return SUCCESS;
+}
+
 /**
  * @brief Write and read data to/from SPI.
  * @param desc - The SPI descriptor.
  * @param data - The buffer with the transmitted/received data.
  * @param bytes_number - Number of bytes to write/read.
- * @return SUCCESS in case of success, FAILURE otherwise.
+ * @return SUCCESS in case of success, negative error code otherwise.
  */
 int32_t linux_spi_write_and_read(struct spi_desc *desc,
 				 uint8_t *data,
@@ -152,17 +325,29 @@ int32_t linux_spi_write_and_read(struct spi_desc *desc,
 		.len = bytes_number,
 	};
 	struct linux_spi_desc *linux_desc;
-	int ret;
+	int32_t ret;
 
 	linux_desc = desc->extra;
 
-	ret = ioctl(linux_desc->spidev_fd, SPI_IOC_MESSAGE(1), &tr);
-	if (ret == 1) {
-		printf("%s: Can't send spi message\n\r", __func__);
-		return FAILURE;
+	linux_async_lock(linux_desc->async);
+
+	if (linux_desc->coalesce) {
+		if (bytes_number && !(data[0] & linux_desc->read_flag_mask) &&
+		    bytes_number <= linux_desc->queue_buff_size) {
+			ret = linux_spi_queue_write(linux_desc, data, bytes_number);
+			goto unlock;
+		}
+
+		ret = _linux_spi_flush(linux_desc);
+		if (IS_ERR_VALUE(ret))
+			goto unlock;
 	}
 
-	return SUCCESS;
+	ret = linux_spi_message(linux_desc, &tr, 1);
+unlock:
+	linux_async_unlock(linux_desc->async);
+
+	return ret;
 }
 
 /**
@@ -177,33 +362,53 @@ int32_t linux_spi_remove(struct spi_desc *desc)
 
 	linux_desc = desc->extra;
 
+	/* Waits for the pending asynchronous transfers */
+	if (linux_desc->async)
+		linux_async_remove(linux_desc->async);
+
+	_linux_spi_flush(linux_desc);
+
 	ret = close(linux_desc->spidev_fd);
 	if (ret < 0) {
 		printf("%s: Can't close device\n\r", __func__);
 		return FAILURE;
 	}
 
+	free(linux_desc->tr);
+	free(linux_desc->queue_buff);
 	free(desc->extra);
 	free(desc);
 
 	return SUCCESS;
 }
 
-static int32_t linux_spi_transfer(struct spi_desc *desc,
-				  struct spi_msg *msgs,
-				  uint32_t len)
-
+/**
+ * @brief Send an array of messages in a single SPI_IOC_MESSAGE() request.
+ * @param dev - The Linux platform specific SPI descriptor.
+ * @param spi_msgs - Array of struct spi_msg.
+ * @param len - Number of messages in the array.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t _linux_spi_transfer(void *dev, void *spi_msgs, uint32_t len)
 {
+	struct linux_spi_desc	*linux_desc = dev;
+	struct spi_msg		*msgs = spi_msgs;
 	struct spi_ioc_transfer *tr;
-	struct linux_spi_desc	*linux_desc;
-	int			ret;
+	int32_t			ret;
 	uint32_t		i;
 
-	linux_desc = desc->extra;
-
-	tr = (struct spi_ioc_transfer *)calloc(len, sizeof(*tr));
-	if (!tr)
-		return -ENOMEM;
+	ret = _linux_spi_flush(linux_desc);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	if (len <= linux_desc->tr_size) {
+		tr = linux_desc->tr;
+		memset(tr, 0, len * sizeof(*tr));
+	} else {
+		tr = (struct spi_ioc_transfer *)calloc(len, sizeof(*tr));
+		if (!tr)
+			return -ENOMEM;
+	}
 
 	for (i = 0; i < len; i++) {
 		tr[i].tx_buf = (unsigned long) msgs[i].tx_buff;
@@ -212,14 +417,72 @@ static int32_t linux_spi_transfer(struct spi_desc *desc,
 		tr[i].cs_change = msgs[i].cs_change;
 	}
 
-	ret = ioctl(linux_desc->spidev_fd, SPI_IOC_MESSAGE(len), tr);
-	if (ret < 0)
-		printf("%s: Can't send spi message (%d)\n\r", __func__, errno);
+	ret = linux_spi_message(linux_desc, tr, len);
+
+	if (tr != linux_desc->tr)
+		free(tr);
+
+	return ret;
+}
+
+/**
+ * @brief Send an array of messages in a single SPI_IOC_MESSAGE() request.
+ * @param desc - The SPI descriptor.
+ * @param msgs - Array of messages.
+ * @param len - Number of messages in the array.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t linux_spi_transfer(struct spi_desc *desc,
+				  struct spi_msg *msgs,
+				  uint32_t len)
+{
+	struct linux_spi_desc *linux_desc = desc->extra;
+	int32_t ret;
 
-	free(tr);
+	linux_async_lock(linux_desc->async);
+	ret = _linux_spi_transfer(linux_desc, msgs, len);
+	linux_async_unlock(linux_desc->async);
 
 	return ret;
 }
+
+/**
+ * @brief Queue an array of messages to be sent by the worker thread.
+ * @param desc - The SPI descriptor.
+ * @param msgs - Array of messages. Must stay valid until callback is called.
+ * @param len - Number of messages in the array.
+ * @param callback - Called from the worker thread with the transfer status.
+ * @param ctx - Parameter passed to the callback.
+ * @return SUCCESS in case of success, -EBUSY if the queue is full,
+ *         negative error code otherwise.
+ */
+static int32_t linux_spi_transfer_async(struct spi_desc *desc,
+					struct spi_msg *msgs,
+					uint32_t len,
+					void (*callback)(void *, int32_t),
+					void *ctx)
+{
+	struct linux_spi_desc *linux_desc = desc->extra;
+	struct linux_async_job job = {
+		.xfer = _linux_spi_transfer,
+		.dev = linux_desc,
+		.msgs = msgs,
+		.len = len,
+		.callback = callback,
+		.ctx = ctx,
+	};
+	int32_t ret;
+
+	if (!linux_desc->async) {
+		ret = linux_async_init(&linux_desc->async,
+				       linux_desc->async_depth);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	return linux_async_submit(linux_desc->async, &job);
+}
+
 /**
  * @brief Linux platform specific SPI platform ops structure
  */
@@ -227,5 +490,6 @@ const struct spi_platform_ops linux_spi_ops = {
 	.init = &linux_spi_init,
 	.write_and_read = &linux_spi_write_and_read,
 	.remove = &linux_spi_remove,
-	.transfer = &linux_spi_transfer
+	.transfer = &linux_spi_transfer,
+	.transfer_async = &linux_spi_transfer_async
 };
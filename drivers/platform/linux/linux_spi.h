@@ -40,6 +40,60 @@
 #ifndef LINUX_SPI_H_
 #define LINUX_SPI_H_
 
+#include <stdint.h>
+#include "no-os/spi.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** Upper limit of transfers that fit in a single SPI_IOC_MESSAGE() request */
+#define LINUX_SPI_MAX_QUEUED_MSGS	256
+/** Default spidev buffer size (spidev "bufsiz" module parameter) */
+#define LINUX_SPI_MAX_QUEUED_BYTES	4096
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct linux_spi_init_param
+ * @brief Structure holding the initialization parameters for Linux platform
+ * specific SPI parameters.
+ *
+ * When write coalescing is enabled (max_queued_msgs > 1), every
+ * spi_write_and_read() call whose first byte does not match read_flag_mask is
+ * treated as a write: its data is copied into an internal queue and the call
+ * returns immediately. The queue is sent as one SPI_IOC_MESSAGE(n) request
+ * when a read is issued, when spi_transfer() is called, when one of the limits
+ * is reached or when linux_spi_flush() is called. The received bytes of queued
+ * writes are discarded and errors are reported by the call that flushes them.
+ */
+struct linux_spi_init_param {
+	/** Maximum number of queued writes. 0 or 1 disables coalescing. */
+	uint32_t	max_queued_msgs;
+	/** Maximum number of queued bytes. 0 selects
+	 *  LINUX_SPI_MAX_QUEUED_BYTES. */
+	uint32_t	max_queued_bytes;
+	/** Mask applied on the first byte of a message to detect a read
+	 *  (e.g. 0x80 for ADI devices with the R/W bit in the MSB). Required
+	 *  when coalescing is enabled. */
+	uint8_t		read_flag_mask;
+	/** Depth of the spi_transfer_async() queue. 0 selects
+	 *  LINUX_ASYNC_DEFAULT_DEPTH. */
+	uint32_t	async_queue_depth;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Send all the queued writes to the device. */
+int32_t linux_spi_flush(struct spi_desc *desc);
+
+/* Get the number of SPI_IOC_MESSAGE() requests issued so far. */
+uint32_t linux_spi_get_ioctl_count(struct spi_desc *desc);
+
 /**
  * @brief Linux specific SPI platform ops structure
  */
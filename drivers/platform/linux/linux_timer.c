@@ -0,0 +1,292 @@
+/***************************************************************************//**
+ *   @file   linux/linux_timer.c
+ *   @brief  Timer implementation for the Linux platform, counting the
+ *           CLOCK_MONOTONIC time.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "no-os/error.h"
+#include "no-os/timer.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <time.h>
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct linux_timer_desc
+ * @brief Linux specific timer state.
+ */
+struct linux_timer_desc {
+	/** Monotonic time (ns) when the counter had the value in load_value */
+	uint64_t ref_ns;
+	/** Set while the counter runs */
+	bool started;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Read the monotonic clock.
+ * @return Time in nanoseconds.
+ */
+static uint64_t linux_timer_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/**
+ * @brief Compute the number of counts since the counter was last loaded.
+ * @param desc - Descriptor of the timer.
+ * @return Counts, at desc->freq_hz.
+ */
+static uint64_t linux_timer_ticks(struct timer_desc *desc)
+{
+	struct linux_timer_desc *ldesc = desc->extra;
+	uint64_t ns = linux_timer_now_ns() - ldesc->ref_ns;
+
+	/* Split to not overflow for long runs at high frequencies */
+	return (ns / 1000000000ull) * desc->freq_hz +
+	       (ns % 1000000000ull) * desc->freq_hz / 1000000000ull;
+}
+
+/**
+ * @brief Initialize the timer. The counter counts up at param->freq_hz,
+ *        starting from param->load_value.
+ * @param desc - Pointer where the timer descriptor is stored.
+ * @param param - Initialization structure.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t timer_init(struct timer_desc **desc,
+		   struct timer_init_param *param)
+{
+	struct timer_desc *dev;
+	struct linux_timer_desc *ldesc;
+
+	if (!desc || !param || !param->freq_hz)
+		return -EINVAL;
+
+	dev = calloc(1, sizeof(*dev));
+	if (!dev)
+		return -ENOMEM;
+
+	ldesc = calloc(1, sizeof(*ldesc));
+	if (!ldesc) {
+		free(dev);
+		return -ENOMEM;
+	}
+
+	dev->id = param->id;
+	dev->freq_hz = param->freq_hz;
+	dev->load_value = param->load_value;
+	dev->extra = ldesc;
+
+	*desc = dev;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the resources allocated by timer_init().
+ * @param desc - Descriptor of the timer.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t timer_remove(struct timer_desc *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	free(desc->extra);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Start the counter from its current value.
+ * @param desc - Descriptor of the timer.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t timer_start(struct timer_desc *desc)
+{
+	struct linux_timer_desc *ldesc;
+
+	if (!desc)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+	if (ldesc->started)
+		return SUCCESS;
+
+	ldesc->ref_ns = linux_timer_now_ns();
+	ldesc->started = true;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Stop the counter. It keeps its value until started again.
+ * @param desc - Descriptor of the timer.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t timer_stop(struct timer_desc *desc)
+{
+	struct linux_timer_desc *ldesc;
+	uint32_t counter;
+
+	if (!desc)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+	timer_counter_get(desc, &counter);
+	desc->load_value = counter;
+	ldesc->started = false;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the value of the counter.
+ * @param desc - Descriptor of the timer.
+ * @param counter - Pointer where the counter value is stored.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t timer_counter_get(struct timer_desc *desc, uint32_t *counter)
+{
+	struct linux_timer_desc *ldesc;
+
+	if (!desc || !counter)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+	if (!ldesc->started) {
+		*counter = desc->load_value;
+		return SUCCESS;
+	}
+
+	*counter = desc->load_value + (uint32_t)linux_timer_ticks(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Set the value of the counter.
+ * @param desc - Descriptor of the timer.
+ * @param new_val - New counter value.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t timer_counter_set(struct timer_desc *desc, uint32_t new_val)
+{
+	struct linux_timer_desc *ldesc;
+
+	if (!desc)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+	desc->load_value = new_val;
+	ldesc->ref_ns = linux_timer_now_ns();
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the counting frequency.
+ * @param desc - Descriptor of the timer.
+ * @param freq_hz - Pointer where the frequency is stored.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t timer_count_clk_get(struct timer_desc *desc, uint32_t *freq_hz)
+{
+	if (!desc || !freq_hz)
+		return -EINVAL;
+
+	*freq_hz = desc->freq_hz;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Set the counting frequency. The counter keeps its current value.
+ * @param desc - Descriptor of the timer.
+ * @param freq_hz - New frequency.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t timer_count_clk_set(struct timer_desc *desc, uint32_t freq_hz)
+{
+	uint32_t counter;
+
+	if (!desc || !freq_hz)
+		return -EINVAL;
+
+	timer_counter_get(desc, &counter);
+	timer_counter_set(desc, counter);
+	desc->freq_hz = freq_hz;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the time elapsed since the counter was last loaded.
+ * @param desc - Descriptor of the timer.
+ * @param elapsed_time - Pointer where the time (ns) is stored.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t timer_get_elapsed_time_nsec(struct timer_desc *desc,
+				    uint64_t *elapsed_time)
+{
+	struct linux_timer_desc *ldesc;
+
+	if (!desc || !elapsed_time)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+	*elapsed_time = ldesc->started ?
+			linux_timer_now_ns() - ldesc->ref_ns : 0;
+
+	return SUCCESS;
+}
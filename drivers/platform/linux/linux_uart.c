@@ -45,6 +45,9 @@
 #include "linux_uart.h"
 
 #include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <termios.h>
@@ -64,6 +67,16 @@ struct linux_uart_desc {
 	int fd;
 	/** structure containing the terminal flags/settings */
 	struct termios *terminal;
+	/** Ring filled by the receive thread */
+	uint8_t *rx_ring;
+	/** Size of rx_ring */
+	uint32_t rx_ring_size;
+	/** Index in rx_ring where the next byte is written */
+	volatile uint32_t rx_ring_head;
+	/** Set while the receive thread runs */
+	volatile bool rx_running;
+	/** Receive thread */
+	pthread_t rx_thread;
 };
 
 /******************************************************************************/
@@ -167,6 +180,21 @@ int32_t uart_init(struct uart_desc **desc, struct uart_init_param *param)
 	case 38400:
 		speed = B38400;
 		break;
+	case 57600:
+		speed = B57600;
+		break;
+	case 115200:
+		speed = B115200;
+		break;
+	case 230400:
+		speed = B230400;
+		break;
+	case 460800:
+		speed = B460800;
+		break;
+	case 921600:
+		speed = B921600;
+		break;
 	default:
 		ret = -EINVAL;
 		goto free;
@@ -220,6 +248,9 @@ int32_t uart_init(struct uart_desc **desc, struct uart_init_param *param)
 
 	tcflush(linux_desc->fd, TCIOFLUSH);
 
+	linux_desc->rx_ring = NULL;
+	linux_desc->rx_running = false;
+
 	*desc = descriptor;
 
 	return SUCCESS;
@@ -248,6 +279,11 @@ int32_t uart_remove(struct uart_desc *desc)
 
 	linux_desc = desc->extra;
 
+	if (linux_desc->rx_running) {
+		linux_desc->rx_running = false;
+		pthread_join(linux_desc->rx_thread, NULL);
+	}
+
 	ret = close(linux_desc->fd);
 	if (ret < 0)
 		printf("%s: Can't close device\n\r", __func__);
@@ -275,7 +311,7 @@ int32_t uart_write(struct uart_desc *desc, const uint8_t *data,
 	linux_desc = desc->extra;
 
 	while (count < bytes_number) {
-		ret = write(linux_desc->fd, data, bytes_number);
+		ret = write(linux_desc->fd, data + count, bytes_number - count);
 		if (ret > 0)
 			count += ret;
 	}
@@ -307,3 +343,87 @@ int32_t uart_read(struct uart_desc *desc, uint8_t *data,
 
 	return SUCCESS;
 };
+
+/**
+ * @brief Receive thread: copy the incoming bytes in the ring, the way a DMA
+ * in circular mode would. Older data is overwritten if the reader is late.
+ * @param arg - The Linux UART descriptor.
+ * @return NULL
+ */
+static void *linux_uart_rx_thread(void *arg)
+{
+	struct linux_uart_desc *linux_desc = arg;
+	struct pollfd pfd;
+	uint32_t head;
+	int ret;
+
+	pfd.fd = linux_desc->fd;
+	pfd.events = POLLIN;
+	while (linux_desc->rx_running) {
+		ret = poll(&pfd, 1, 10);
+		if (ret <= 0)
+			continue;
+
+		head = linux_desc->rx_ring_head;
+		ret = read(linux_desc->fd, linux_desc->rx_ring + head,
+			   linux_desc->rx_ring_size - head);
+		if (ret <= 0)
+			continue;
+
+		head += ret;
+		if (head == linux_desc->rx_ring_size)
+			head = 0;
+		__atomic_store_n(&linux_desc->rx_ring_head, head,
+				 __ATOMIC_RELEASE);
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Start filling a ring with the received data from a separate thread.
+ * Emulates a UART DMA in circular mode, to be used with
+ * linux_uart_rx_ring_head() (e.g. \ref at_init_param.rx_ring).
+ * @param desc - Instance of UART.
+ * @param ring - Buffer where the data is written.
+ * @param size - Size of ring.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_uart_rx_ring_start(struct uart_desc *desc, uint8_t *ring,
+				 uint32_t size)
+{
+	struct linux_uart_desc *linux_desc;
+	int ret;
+
+	if (!desc || !ring || !size)
+		return -EINVAL;
+
+	linux_desc = desc->extra;
+	if (linux_desc->rx_running)
+		return -EBUSY;
+
+	linux_desc->rx_ring = ring;
+	linux_desc->rx_ring_size = size;
+	linux_desc->rx_ring_head = 0;
+	linux_desc->rx_running = true;
+	ret = pthread_create(&linux_desc->rx_thread, NULL,
+			     linux_uart_rx_thread, linux_desc);
+	if (ret) {
+		linux_desc->rx_running = false;
+		return -ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the index in the ring where the next byte will be written.
+ * @param ctx - The UART descriptor (struct uart_desc *).
+ * @return Index in the ring.
+ */
+uint32_t linux_uart_rx_ring_head(void *ctx)
+{
+	struct linux_uart_desc *linux_desc = ((struct uart_desc *)ctx)->extra;
+
+	return __atomic_load_n(&linux_desc->rx_ring_head, __ATOMIC_ACQUIRE);
+}
@@ -39,6 +39,9 @@
 #ifndef LINUX_UART_H_
 #define LINUX_UART_H_
 
+#include <stdint.h>
+#include "no-os/uart.h"
+
 /**
  * @struct linux_uart_init_param
  * @brief Structure holding the initialization parameters for Linux platform
@@ -49,4 +52,10 @@ struct linux_uart_init_param {
 	const char *device_id;
 };
 
+/** Start a thread filling a ring with the received data (circular DMA) */
+int32_t linux_uart_rx_ring_start(struct uart_desc *desc, uint8_t *ring,
+				 uint32_t size);
+/** Index in the ring where the receive thread writes the next byte */
+uint32_t linux_uart_rx_ring_head(void *ctx);
+
 #endif // LINUX_UART_H_
@@ -37,8 +37,13 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *******************************************************************************/
 #include "no-os/delay.h"
+#include "no-os/trace.h"
 #include "mxc_delay.h"
 
+/* The delay accounting wrappers of delay.h do not apply here */
+#undef udelay
+#undef mdelay
+
 /**
  * @brief Generate microseconds delay.
  * @param usecs - Delay in microseconds.
@@ -46,7 +51,9 @@
  */
 void udelay(uint32_t usecs)
 {
+	TRACE_BEGIN(TRACE_EV_DELAY, usecs);
 	MXC_Delay(MXC_DELAY_USEC(usecs));
+	TRACE_END(TRACE_EV_DELAY, 0);
 }
 
 /**
@@ -56,5 +63,7 @@ void udelay(uint32_t usecs)
  */
 void mdelay(uint32_t msecs)
 {
+	TRACE_BEGIN(TRACE_EV_DELAY, msecs * 1000);
 	MXC_Delay(MXC_DELAY_MSEC(msecs));
+	TRACE_END(TRACE_EV_DELAY, 0);
 }
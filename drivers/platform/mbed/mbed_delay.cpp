@@ -49,6 +49,10 @@ extern "C"
 
 #include "no-os/delay.h"
 
+/* The delay accounting wrappers of delay.h do not apply here */
+#undef udelay
+#undef mdelay
+
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
@@ -39,6 +39,12 @@
 #include <stdbool.h>
 #include "stm32_hal.h"
 #include "no-os/delay.h"
+#include "no-os/trace.h"
+
+/* The delay accounting wrappers of delay.h do not apply here */
+#undef udelay
+#undef mdelay
+
 /**
  * @brief Generate microseconds delay.
  * @param usecs - Delay in microseconds.
@@ -56,15 +62,19 @@ void udelay(uint32_t usecs)
 		DWT->CTRL |= 1;
 		firstrun = false;
 	}
+	TRACE_BEGIN(TRACE_EV_DELAY, usecs);
 	volatile uint32_t start = DWT->CYCCNT;
 	while(DWT->CYCCNT - start < cycles);
+	TRACE_END(TRACE_EV_DELAY, 0);
 }
 #pragma GCC pop_options
 #else
 void udelay(uint32_t usecs)
 {
 	/* Fallback to lowest possible HAL delay of 1ms. */
+	TRACE_BEGIN(TRACE_EV_DELAY, usecs);
 	HAL_Delay(1);
+	TRACE_END(TRACE_EV_DELAY, 0);
 }
 #endif
 
@@ -75,5 +85,7 @@ void udelay(uint32_t usecs)
  */
 void mdelay(uint32_t msecs)
 {
+	TRACE_BEGIN(TRACE_EV_DELAY, msecs * 1000);
 	HAL_Delay(msecs);
+	TRACE_END(TRACE_EV_DELAY, 0);
 }
@@ -42,8 +42,13 @@
 /******************************************************************************/
 
 #include "no-os/delay.h"
+#include "no-os/trace.h"
 #include <sleep.h>
 
+/* The delay accounting wrappers of delay.h do not apply here */
+#undef udelay
+#undef mdelay
+
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
@@ -55,11 +60,13 @@
  */
 void udelay(uint32_t usecs)
 {
+	TRACE_BEGIN(TRACE_EV_DELAY, usecs);
 #ifdef _XPARAMETERS_PS_H_
 	usleep(usecs);
 #else
 	usleep(usecs / 20);	// FIXME
 #endif
+	TRACE_END(TRACE_EV_DELAY, 0);
 }
 
 /**
@@ -69,9 +76,11 @@ void udelay(uint32_t usecs)
  */
 void mdelay(uint32_t msecs)
 {
+	TRACE_BEGIN(TRACE_EV_DELAY, msecs * 1000);
 #ifdef _XPARAMETERS_PS_H_
 	usleep(msecs * 1000);
 #else
 	usleep(msecs * 50);	// FIXME
 #endif
+	TRACE_END(TRACE_EV_DELAY, 0);
 }
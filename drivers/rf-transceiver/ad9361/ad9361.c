@@ -51,6 +51,7 @@
 #include "no-os/delay.h"
 #include "ad9361_util.h"
 #include "no-os/util.h"
+#include "no-os/trace.h"
 #include "app_config.h"
 
 #define diff_abs(x, y) ((x) > (y) ? (x - y) : (y - x))
@@ -1278,24 +1279,21 @@ void ad9361_get_bist_tone(struct ad9361_rf_phy *phy,
 static int32_t ad9361_check_cal_done(struct ad9361_rf_phy *phy, uint32_t reg,
 				     uint32_t mask, uint32_t done_state)
 {
-	uint32_t timeout = 20000; /* RFDC_CAL can take long */
-	uint32_t state;
+	uint32_t interval_us = reg == REG_CALIBRATION_CTRL ? 1200 : 120;
+	int32_t ret;
 
-	do {
-		state = ad9361_spi_readf(phy->spi, reg, mask);
-		if (state == done_state)
-			return 0;
+	TRACE_BEGIN(TRACE_EV_AD9361_CAL_WAIT, (reg << 16) | mask);
 
-		if (reg == REG_CALIBRATION_CTRL)
-			udelay(1200);
-		else
-			udelay(120);
-	} while (timeout--);
+	/* RFDC_CAL can take long */
+	ret = poll_timeout_us((uint32_t)ad9361_spi_readf(phy->spi, reg, mask) ==
+			      done_state, interval_us, 20000 * interval_us);
+	if (ret)
+		dev_err(&phy->spi->dev, "Calibration TIMEOUT (0x%"PRIX32", 0x%"PRIX32")",
+			reg, mask);
 
-	dev_err(&phy->spi->dev, "Calibration TIMEOUT (0x%"PRIX32", 0x%"PRIX32")", reg,
-		mask);
+	TRACE_END(TRACE_EV_AD9361_CAL_WAIT, ret);
 
-	return -ETIMEDOUT;
+	return ret;
 }
 
 /**
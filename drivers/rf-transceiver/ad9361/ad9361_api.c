@@ -45,6 +45,7 @@
 #include "no-os/delay.h"
 #include "no-os/spi.h"
 #include "no-os/util.h"
+#include "no-os/trace.h"
 #include "app_config.h"
 #include <string.h>
 #ifndef AXI_ADC_NOT_PRESENT
@@ -113,6 +114,9 @@ int32_t ad9361_init (struct ad9361_rf_phy **ad9361_phy,
 	phy->adc_state->phy = phy;
 #endif
 
+	/* Started once nothing can return without a TRACE_END */
+	TRACE_BEGIN(TRACE_EV_AD9361_INIT, 0);
+
 	/* Device selection */
 	phy->dev_sel = init_param->dev_sel;
 
@@ -544,7 +548,9 @@ int32_t ad9361_init (struct ad9361_rf_phy **ad9361_phy,
 	if (ret < 0)
 		goto out;
 
+	TRACE_BEGIN(TRACE_EV_AD9361_SETUP, 0);
 	ret = ad9361_setup(phy);
+	TRACE_END(TRACE_EV_AD9361_SETUP, ret);
 	if (ret < 0)
 		goto out_clk;
 
@@ -552,7 +558,9 @@ int32_t ad9361_init (struct ad9361_rf_phy **ad9361_phy,
 	axi_adc_init(&phy->rx_adc, init_param->rx_adc_init);
 	axi_adc_read(phy->rx_adc, ADI_REG_VERSION, &phy->adc_state->pcore_version);
 	/* platform specific wrapper to call ad9361_post_setup() */
+	TRACE_BEGIN(TRACE_EV_AD9361_POST_SETUP, 0);
 	ret = ad9361_post_setup(phy);
+	TRACE_END(TRACE_EV_AD9361_POST_SETUP, ret);
 	if (ret < 0)
 		goto out_clk;
 #endif
@@ -561,6 +569,8 @@ int32_t ad9361_init (struct ad9361_rf_phy **ad9361_phy,
 
 	*ad9361_phy = phy;
 
+	TRACE_END(TRACE_EV_AD9361_INIT, 0);
+
 	return 0;
 
 out_clk:
@@ -575,6 +585,8 @@ out:
 	free(phy);
 	printf("%s : AD936x initialization error\n", __func__);
 
+	TRACE_END(TRACE_EV_AD9361_INIT, -ENODEV);
+
 	return -ENODEV;
 }
 
@@ -41,6 +41,7 @@
 #include "no-os/util.h"
 #include "no-os/print_log.h"
 #include "no-os/delay.h"
+#include "no-os/trace.h"
 #include "adrv9002.h"
 #include "adi_adrv9001.h"
 #include "adi_adrv9001_arm.h"
@@ -890,7 +891,9 @@ int adrv9002_setup(struct adrv9002_rf_phy *phy)
 	phy->adrv9001->common.devHalInfo = &phy->hal;
 
 	adi_common_ErrorClear(&phy->adrv9001->common);
+	TRACE_BEGIN(TRACE_EV_ADRV9002_HW_OPEN, 0);
 	ret = adi_adrv9001_HwOpen(adrv9001_device, adrv9002_spi_settings_get());
+	TRACE_END(TRACE_EV_ADRV9002_HW_OPEN, ret);
 	if (ret)
 		return adrv9002_dev_err(phy);
 
@@ -902,16 +905,22 @@ int adrv9002_setup(struct adrv9002_rf_phy *phy)
 
 	adrv9002_log_enable(&adrv9001_device->common);
 
+	TRACE_BEGIN(TRACE_EV_ADRV9002_INIT_ANALOG, 0);
 	ret = adi_adrv9001_InitAnalog(adrv9001_device, phy->curr_profile,
 				      ADI_ADRV9001_DEVICECLOCKDIVISOR_2);
+	TRACE_END(TRACE_EV_ADRV9002_INIT_ANALOG, ret);
 	if (ret)
 		return adrv9002_dev_err(phy);
 
+	TRACE_BEGIN(TRACE_EV_ADRV9002_DIGITAL_INIT, 0);
 	ret = adrv9002_digital_init(phy);
+	TRACE_END(TRACE_EV_ADRV9002_DIGITAL_INIT, ret);
 	if (ret)
 		return ret;
 
+	TRACE_BEGIN(TRACE_EV_ADRV9002_RADIO_INIT, 0);
 	ret = adrv9002_radio_init(phy);
+	TRACE_END(TRACE_EV_ADRV9002_RADIO_INIT, ret);
 	if (ret)
 		return ret;
 
@@ -920,8 +929,10 @@ int adrv9002_setup(struct adrv9002_rf_phy *phy)
 	if (ret)
 		return ret;
 
+	TRACE_BEGIN(TRACE_EV_ADRV9002_INIT_CALS, 0);
 	ret = adi_adrv9001_cals_InitCals_Run(adrv9001_device, &phy->init_cals,
 					     60000, &init_cals_error);
+	TRACE_END(TRACE_EV_ADRV9002_INIT_CALS, ret);
 	if (ret)
 		return adrv9002_dev_err(phy);
 
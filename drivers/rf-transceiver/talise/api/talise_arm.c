@@ -310,56 +310,23 @@ uint32_t TALISE_writeArmProfile(taliseDevice_t *device, taliseInit_t *init)
 	return (uint32_t)retVal;
 }
 
-uint32_t TALISE_loadArmFromBinary(taliseDevice_t *device, uint8_t *binary,
-				  uint32_t count)
+/**
+ * \brief Writes the ARM stack pointer and boot address, starts the ARM and
+ * waits for it to boot. Common part of TALISE_loadArmFromBinary() and
+ * TALISE_loadArmFromReader(), called once the program memory is written.
+ */
+static uint32_t talBootArm(taliseDevice_t *device, uint8_t *stackPtr,
+			   uint8_t *bootAddr, talRecoveryActions_t retVal)
 {
-	talRecoveryActions_t retVal = TALACT_NO_ACTION;
 	adiHalErr_t halError = ADIHAL_OK;
-	uint8_t stackPtr[4] = {0};
-	uint8_t bootAddr[4] = {0};
 	uint32_t radioStatus = 0;
 	uint32_t waitInterval_us = 0;
 	uint32_t numEventChecks = 1;
 	uint32_t eventCheck = 0;
 	uint8_t armFieldValue[1] = {0};
 
-	static const uint32_t MAX_BIN_CNT = 114688;
 	static const uint16_t TRCKINGCALS_GPINT_EN_BYTEOFFSET = 0x0044;
 
-
-#if TALISE_VERBOSE
-	halError = talWriteToLog(device->devHalInfo, ADIHAL_LOG_MSG, TAL_ERR_OK,
-				 "TALISE_loadArmFromBinary()\n");
-	retVal = talApiErrHandler(device, TAL_ERRHDL_HAL_LOG, halError, retVal,
-				  TALACT_WARN_RESET_LOG);
-#endif
-
-	if (binary == NULL) {
-		return (uint32_t)talApiErrHandler(device, TAL_ERRHDL_INVALID_PARAM,
-						  TAL_ERR_LOADBIN_NULL_PARAM, retVal, TALACT_ERR_CHECK_PARAM);
-	}
-
-	if (count != MAX_BIN_CNT) {
-		return (uint32_t)talApiErrHandler(device, TAL_ERRHDL_INVALID_PARAM,
-						  TAL_ERR_LOADBIN_INVALID_BYTECOUNT, retVal, TALACT_ERR_CHECK_PARAM);
-	} else {
-		/* extraction of stack pointer and boot address from top of array */
-		stackPtr[0] = binary[0];
-		stackPtr[1] = binary[1];
-		stackPtr[2] = binary[2];
-		stackPtr[3] = binary[3];
-
-		bootAddr[0] = binary[4];
-		bootAddr[1] = binary[5];
-		bootAddr[2] = binary[6];
-		bootAddr[3] = binary[7];
-
-		/* writing binary data to ARM memory */
-		retVal = (talRecoveryActions_t)TALISE_writeArmMem(device,
-				TALISE_ADDR_ARM_START_PROG_ADDR, &binary[0], count);
-		IF_ERR_RETURN_U32(retVal);
-	}
-
 	/* writing stack pointer [7:0] */
 	halError = talSpiWriteByte(device->devHalInfo, TALISE_ADDR_ARM_STACK_PTR_BYTE_0,
 				   stackPtr[0]);
@@ -477,6 +444,124 @@ uint32_t TALISE_loadArmFromBinary(taliseDevice_t *device, uint8_t *binary,
 	return (uint32_t)retVal;
 }
 
+uint32_t TALISE_loadArmFromBinary(taliseDevice_t *device, uint8_t *binary,
+				  uint32_t count)
+{
+	talRecoveryActions_t retVal = TALACT_NO_ACTION;
+	adiHalErr_t halError = ADIHAL_OK;
+	uint8_t stackPtr[4] = {0};
+	uint8_t bootAddr[4] = {0};
+
+	static const uint32_t MAX_BIN_CNT = 114688;
+
+#if TALISE_VERBOSE
+	halError = talWriteToLog(device->devHalInfo, ADIHAL_LOG_MSG, TAL_ERR_OK,
+				 "TALISE_loadArmFromBinary()\n");
+	retVal = talApiErrHandler(device, TAL_ERRHDL_HAL_LOG, halError, retVal,
+				  TALACT_WARN_RESET_LOG);
+#endif
+
+	if (binary == NULL) {
+		return (uint32_t)talApiErrHandler(device, TAL_ERRHDL_INVALID_PARAM,
+						  TAL_ERR_LOADBIN_NULL_PARAM, retVal, TALACT_ERR_CHECK_PARAM);
+	}
+
+	if (count != MAX_BIN_CNT) {
+		return (uint32_t)talApiErrHandler(device, TAL_ERRHDL_INVALID_PARAM,
+						  TAL_ERR_LOADBIN_INVALID_BYTECOUNT, retVal, TALACT_ERR_CHECK_PARAM);
+	} else {
+		/* extraction of stack pointer and boot address from top of array */
+		stackPtr[0] = binary[0];
+		stackPtr[1] = binary[1];
+		stackPtr[2] = binary[2];
+		stackPtr[3] = binary[3];
+
+		bootAddr[0] = binary[4];
+		bootAddr[1] = binary[5];
+		bootAddr[2] = binary[6];
+		bootAddr[3] = binary[7];
+
+		/* writing binary data to ARM memory */
+		retVal = (talRecoveryActions_t)TALISE_writeArmMem(device,
+				TALISE_ADDR_ARM_START_PROG_ADDR, &binary[0], count);
+		IF_ERR_RETURN_U32(retVal);
+	}
+
+	return talBootArm(device, stackPtr, bootAddr, retVal);
+}
+
+uint32_t TALISE_loadArmFromReader(taliseDevice_t *device,
+				  int32_t (*read)(void *ctx, uint8_t *buf, uint32_t len),
+				  void *ctx, uint32_t count)
+{
+	talRecoveryActions_t retVal = TALACT_NO_ACTION;
+	adiHalErr_t halError = ADIHAL_OK;
+	uint8_t chunk[TAL_ARM_LOAD_CHUNK_SIZE];
+	uint8_t stackPtr[4] = {0};
+	uint8_t bootAddr[4] = {0};
+	uint32_t offset = 0;
+	uint32_t fill = 0;
+	uint32_t wr = 0;
+	uint32_t i = 0;
+	int32_t len = 0;
+
+	static const uint32_t MAX_BIN_CNT = 114688;
+
+#if TALISE_VERBOSE
+	halError = talWriteToLog(device->devHalInfo, ADIHAL_LOG_MSG, TAL_ERR_OK,
+				 "TALISE_loadArmFromReader()\n");
+	retVal = talApiErrHandler(device, TAL_ERRHDL_HAL_LOG, halError, retVal,
+				  TALACT_WARN_RESET_LOG);
+#endif
+
+	if (read == NULL) {
+		return (uint32_t)talApiErrHandler(device, TAL_ERRHDL_INVALID_PARAM,
+						  TAL_ERR_LOADBIN_NULL_PARAM, retVal, TALACT_ERR_CHECK_PARAM);
+	}
+
+	if (count != MAX_BIN_CNT) {
+		return (uint32_t)talApiErrHandler(device, TAL_ERRHDL_INVALID_PARAM,
+						  TAL_ERR_LOADBIN_INVALID_BYTECOUNT, retVal, TALACT_ERR_CHECK_PARAM);
+	}
+
+	/* chunk[0..fill) holds the bytes not written yet, starting at offset */
+	while (offset < count) {
+		len = read(ctx, &chunk[fill],
+			   (count - offset - fill) < (sizeof(chunk) - fill) ?
+			   (count - offset - fill) : (sizeof(chunk) - fill));
+		if ((len <= 0) || ((uint32_t)len > (count - offset - fill))) {
+			return (uint32_t)talApiErrHandler(device, TAL_ERRHDL_INVALID_PARAM,
+							  TAL_ERR_LOADBIN_INVALID_BYTECOUNT, retVal, TALACT_ERR_CHECK_PARAM);
+		}
+
+		/* extraction of stack pointer and boot address from top of image */
+		for (i = 0; ((offset + fill + i) < 8) && (i < (uint32_t)len); i++) {
+			if ((offset + fill + i) < 4)
+				stackPtr[offset + fill + i] = chunk[fill + i];
+			else
+				bootAddr[offset + fill + i - 4] = chunk[fill + i];
+		}
+		fill += len;
+
+		/* ARM memory is written in 32 bit words: a partial word at the end
+		 * of a short read is kept for the next one */
+		wr = ((offset + fill) == count) ? fill : (fill & ~3u);
+		if (wr == 0)
+			continue;
+
+		retVal = (talRecoveryActions_t)TALISE_writeArmMem(device,
+				TALISE_ADDR_ARM_START_PROG_ADDR + offset, &chunk[0], wr);
+		IF_ERR_RETURN_U32(retVal);
+
+		for (i = 0; i < (fill - wr); i++)
+			chunk[i] = chunk[wr + i];
+		offset += wr;
+		fill -= wr;
+	}
+
+	return talBootArm(device, stackPtr, bootAddr, retVal);
+}
+
 /**
  * \brief Helper function to format ARM memory byte array with the specified ADC profile
  *
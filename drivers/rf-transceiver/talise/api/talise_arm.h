@@ -18,6 +18,10 @@ extern "C" {
 #include "talise_types.h"
 #include "talise_error_types.h"
 #include "talise_arm_types.h"
+
+/** Chunk size used by TALISE_loadArmFromReader() */
+#define TAL_ARM_LOAD_CHUNK_SIZE 1024
+
 /****************************************************************************
  * Initialization functions
  ****************************************************************************
@@ -97,6 +101,37 @@ uint32_t TALISE_writeArmProfile(taliseDevice_t *device, taliseInit_t *init);
 uint32_t TALISE_loadArmFromBinary(taliseDevice_t *device, uint8_t *binary,
 				  uint32_t count);
 
+/**
+ * \brief Loads the ARM program memory from a chunked source and boots the ARM
+ *
+ * Same as TALISE_loadArmFromBinary(), but the image is pulled through the read
+ * callback in chunks of at most TAL_ARM_LOAD_CHUNK_SIZE bytes, so it does not
+ * have to be present in memory as a whole (e.g. a compressed image decoded on
+ * the fly, or a file). The callback may return fewer bytes than requested,
+ * including counts that are not a multiple of 4: the ARM memory is still
+ * written in whole 32 bit words.
+ *
+ * \pre This function is called after the device has been initialized, PLL lock status has been verified, and
+ * the stream binary has been loaded
+ *
+ * \dep_begin
+ * \dep{device->devHalInfo}
+ * \dep_end
+ *
+ * \param device Pointer to the Talise device data structure containing settings
+ * \param read Callback filling buf with up to len bytes of the image, returns the number of bytes
+ * \param ctx Parameter passed to the read callback
+ * \param count The number of bytes in the ARM image
+ *
+ * \retval TALACT_WARN_RESET_LOG Recovery action for log reset
+ * \retval TALACT_ERR_CHECK_PARAM Recovery action for bad parameter check
+ * \retval TALACT_ERR_RESET_SPI Recovery action for SPI reset required
+ * \retval TALACT_NO_ACTION Function completed successfully, no action required
+ */
+uint32_t TALISE_loadArmFromReader(taliseDevice_t *device,
+				  int32_t (*read)(void *ctx, uint8_t *buf, uint32_t len),
+				  void *ctx, uint32_t count);
+
 /**
  * \brief Loads the ADC profile data into ARM memory
  *
@@ -46,6 +46,7 @@
 #include "sd.h"
 #include "no-os/delay.h"
 #include "no-os/error.h"
+#include "no-os/util.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -58,7 +59,10 @@
 #define ACMD(x)				(CMD(x) | BIT_APPLICATION_CMD)
 
 #define CMD0_RETRY_NUMBER		(5u)
-#define WAIT_RESP_TIMEOUT		(1000u) //1000ms
+#define WAIT_RESP_TIMEOUT_US		(1000000u) //1000ms
+#define SD_POLL_SPIN_COUNT		(64u)
+#define SD_POLL_BACKOFF_MAX_US		(64u)
+#define SD_BUSY_POLL_LEN		(8u)
 
 #define R1_READY_STATE			(0x00u)
 #define R1_IDLE_STATE			(0x01u)
@@ -91,58 +95,71 @@
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
 
+/**
+ * Read len SD card bytes.
+ * @param sd_desc	- Instance of the SD card
+ * @param data_out	- The len read bytes are wrote here
+ * @param len		- Number of bytes read at once
+ * @param idle_val	- Value read while the card is not ready
+ * @param ret		- Result of the SPI transfer
+ * @return 0 while polling should continue, 1 once the transfer failed or
+ * the card is ready.
+ */
+static inline int sd_poll_read(struct sd_desc *sd_desc, uint8_t *data_out,
+			       uint16_t len, uint8_t idle_val, int32_t *ret)
+{
+	memset(data_out, 0xFF, len);
+	*ret = spi_write_and_read(sd_desc->spi_desc, data_out, len);
+
+	return *ret != SUCCESS || data_out[len - 1] != idle_val;
+}
+
+/**
+ * Read SD card bytes until the last of len bytes is different from idle_val.
+ * The first SD_POLL_SPIN_COUNT reads are back to back, after that the delay
+ * between reads doubles up to SD_POLL_BACKOFF_MAX_US.
+ * @param sd_desc	- Instance of the SD card
+ * @param data_out	- The len read bytes are wrote here
+ * @param len		- Number of bytes read at once
+ * @param idle_val	- Value read while the card is not ready
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t sd_poll(struct sd_desc *sd_desc, uint8_t *data_out,
+		       uint16_t len, uint8_t idle_val)
+{
+	int32_t	ret;
+
+	if (poll_timeout_spin_us(sd_poll_read(sd_desc, data_out, len,
+					      idle_val, &ret),
+				 SD_POLL_SPIN_COUNT, SD_POLL_BACKOFF_MAX_US,
+				 WAIT_RESP_TIMEOUT_US))
+		return FAILURE;
+
+	return ret == SUCCESS ? SUCCESS : FAILURE;
+}
+
 /**
  * Read SD card bytes until one is different from 0xFF
  * @param sd_desc	- Instance of the SD card
  * @param data_out	- The read bytes is wrote here
  * @return SUCCESS in case of success, FAILURE otherwise.
  */
-static int32_t wait_for_response(struct sd_desc *sd_desc, uint8_t *data_out)
+static inline int32_t wait_for_response(struct sd_desc *sd_desc,
+					uint8_t *data_out)
 {
-	uint32_t	not_timeout;
-	int32_t		ret;
-
-	ret = FAILURE;
-	not_timeout = WAIT_RESP_TIMEOUT;
-	do {
-		if (SUCCESS != spi_write_and_read(sd_desc->spi_desc,
-						  data_out, 1))
-			break;
-		if (*data_out != 0xFF) {
-			ret = SUCCESS;
-			break;
-		}
-		mdelay(1);
-	} while (not_timeout--);
-
-	return ret;
+	return sd_poll(sd_desc, data_out, 1, 0xFF);
 }
 
 /**
- * Read SD card bytes until one is different from 0x00
+ * Read SD card bytes until one is different from 0x00. Clocking extra bytes
+ * after the card released the bus is harmless, so SD_BUSY_POLL_LEN bytes are
+ * read per transaction.
  * @param sd_desc - Instance of the SD card
  * @return SUCCESS in case of success, FAILURE otherwise.
  */
-static int32_t wait_until_not_busy(struct sd_desc *sd_desc)
+static inline int32_t wait_until_not_busy(struct sd_desc *sd_desc)
 {
-	uint32_t	not_timeout;
-	int32_t		ret;
-	uint8_t		data;
-
-	ret = FAILURE;
-	not_timeout = WAIT_RESP_TIMEOUT;
-	do {
-		data = 0xFF;
-		if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, &data, 1))
-			break;
-		if (data != 0x00) {
-			ret = SUCCESS;
-			break;
-		}
-		mdelay(1);
-	} while (not_timeout--);
-
-	return ret;
+	return sd_poll(sd_desc, sd_desc->buff, SD_BUSY_POLL_LEN, 0x00);
 }
 
 /**
@@ -211,31 +228,30 @@ static int32_t send_command(struct sd_desc *sd_desc, struct cmd_desc *cmd_desc)
 }
 
 /**
- * Send one block of data to the SD card
+ * Send one block of data to the SD card. The start token, the data and the
+ * CRC go out in a single SPI transaction.
  * @param sd_desc	- Instance of the SD card
  * @param data		- Data to be written
  * @param nb_of_blocks	- Number of blocks written in the executing command
  * @return SUCCESS in case of success, FAILURE otherwise.
  */
-static int32_t write_block(struct sd_desc *sd_desc, uint8_t *data,
+static int32_t write_block(struct sd_desc *sd_desc, const uint8_t *data,
 			   uint32_t nb_of_blocks)
 {
-	/* Send start block token */
-	sd_desc->buff[0] = START_N_BLOCK_TOKEN;
-	if (nb_of_blocks == 1)
-		sd_desc->buff[0] = START_1_BLOCK_TOKEN;
-	if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, sd_desc->buff, 1))
-		return FAILURE;
+	uint8_t		*buff = sd_desc->block_buff;
+	uint8_t		response;
 
-	/* Send data with CRC */
-	if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, data, DATA_BLOCK_LEN))
-		return FAILURE;
-	*((uint16_t *)sd_desc->buff) = 0xFFFF;
-	if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, sd_desc->buff, CRC_LEN))
+	buff[0] = START_N_BLOCK_TOKEN;
+	if (nb_of_blocks == 1)
+		buff[0] = START_1_BLOCK_TOKEN;
+	memcpy(buff + 1, data, DATA_BLOCK_LEN);
+	buff[DATA_BLOCK_LEN + 1] = 0xFF;
+	buff[DATA_BLOCK_LEN + 2] = 0xFF;
+	if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, buff,
+					  DATA_BLOCK_XFER_LEN))
 		return FAILURE;
 
 	/* Read response and check if write was ok */
-	uint8_t		response;
 	if (SUCCESS != wait_for_response(sd_desc, &response))
 		return FAILURE;
 	switch (response & MASK_RESPONSE_TOKEN) {
@@ -295,15 +311,12 @@ static int32_t read_block(struct sd_desc *sd_desc, uint8_t *data)
 		return FAILURE;
 	}
 
-	/* Read data block */
-	memset(data, 0xff, DATA_BLOCK_LEN);
-	if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, data, DATA_BLOCK_LEN))
-		return FAILURE;
-
-	/* Read crc*/
-	*((uint16_t *)sd_desc->buff) = 0xFFFF;
-	if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, sd_desc->buff, CRC_LEN))
+	/* Read data block and crc */
+	memset(sd_desc->block_buff, 0xff, DATA_BLOCK_LEN + CRC_LEN);
+	if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, sd_desc->block_buff,
+					  DATA_BLOCK_LEN + CRC_LEN))
 		return FAILURE;
+	memcpy(data, sd_desc->block_buff, DATA_BLOCK_LEN);
 
 	return SUCCESS;
 }
@@ -519,6 +532,135 @@ int32_t sd_write(struct sd_desc *sd_desc, uint8_t *data, uint64_t address,
 	return SUCCESS;
 }
 
+/**
+ * Read count whole blocks starting with block number block.
+ * @param sd_desc	- Instance of the SD card
+ * @param data		- Where data will be read, count * DATA_BLOCK_LEN bytes
+ * @param block		- First block number
+ * @param count		- Number of blocks
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sd_read_blocks(struct sd_desc *sd_desc, uint8_t *data, uint32_t block,
+		       uint32_t count)
+{
+	struct cmd_desc	cmd_desc;
+	uint32_t	i;
+
+	if (!sd_desc || !data || !count ||
+	    ((uint64_t)block + count) * DATA_BLOCK_LEN > sd_desc->memory_size)
+		return FAILURE;
+
+	cmd_desc.cmd = (count == 1) ? CMD(17) : CMD(18);
+	cmd_desc.arg = block;
+	cmd_desc.response_len = R1_LEN;
+	if (SUCCESS != send_command(sd_desc, &cmd_desc))
+		return FAILURE;
+	if (cmd_desc.response[0] != R1_READY_STATE) {
+		DEBUG_MSG("Failed to send read command\n");
+		return FAILURE;
+	}
+
+	for (i = 0; i < count; i++)
+		if (SUCCESS != read_block(sd_desc, data + i * DATA_BLOCK_LEN))
+			return FAILURE;
+
+	if (count == 1)
+		return SUCCESS;
+
+	cmd_desc.cmd = CMD(12);
+	cmd_desc.arg = STUFF_ARG;
+	cmd_desc.response_len = R1_LEN;
+	if (SUCCESS != send_command(sd_desc, &cmd_desc))
+		return FAILURE;
+	if (cmd_desc.response[0] != R1_READY_STATE) {
+		DEBUG_MSG("Failed to send stop transmission command\n");
+		return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * Write count whole blocks with a single CMD24 or CMD25 command. The data of
+ * block i is taken from blocks[i] if blocks is set, from data + i * 512
+ * otherwise.
+ * @param sd_desc	- Instance of the SD card
+ * @param data		- Contiguous data
+ * @param blocks	- Array of count block pointers
+ * @param block		- First block number
+ * @param count		- Number of blocks
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t write_blocks(struct sd_desc *sd_desc, const uint8_t *data,
+			    const uint8_t *const *blocks, uint32_t block,
+			    uint32_t count)
+{
+	struct cmd_desc	cmd_desc;
+	const uint8_t	*ptr;
+	uint32_t	i;
+
+	if (!sd_desc || (!data && !blocks) || !count ||
+	    ((uint64_t)block + count) * DATA_BLOCK_LEN > sd_desc->memory_size)
+		return FAILURE;
+
+	cmd_desc.cmd = (count == 1) ? CMD(24) : CMD(25);
+	cmd_desc.arg = block;
+	cmd_desc.response_len = R1_LEN;
+	if (SUCCESS != send_command(sd_desc, &cmd_desc))
+		return FAILURE;
+	if (cmd_desc.response[0] != R1_READY_STATE) {
+		DEBUG_MSG("Failed to write Data command\n");
+		return FAILURE;
+	}
+
+	for (i = 0; i < count; i++) {
+		ptr = blocks ? blocks[i] : data + i * DATA_BLOCK_LEN;
+		if (SUCCESS != write_block(sd_desc, ptr, count))
+			return FAILURE;
+	}
+
+	if (count == 1)
+		return SUCCESS;
+
+	sd_desc->buff[0] = STOP_TRANSMISSION_TOKEN;
+	sd_desc->buff[1] = 0xFF;
+	if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, sd_desc->buff, 2))
+		return FAILURE;
+
+	return wait_until_not_busy(sd_desc);
+}
+
+/**
+ * Write count whole blocks from a contiguous buffer starting with block
+ * number block. Unlike sd_write(), no block is read back.
+ * @param sd_desc	- Instance of the SD card
+ * @param data		- Data to write, count * DATA_BLOCK_LEN bytes
+ * @param block		- First block number
+ * @param count		- Number of blocks
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sd_write_blocks(struct sd_desc *sd_desc, const uint8_t *data,
+			uint32_t block, uint32_t count)
+{
+	return write_blocks(sd_desc, data, NULL, block, count);
+}
+
+/**
+ * Write count consecutive blocks whose data is scattered in memory, with a
+ * single multiple block write command.
+ * @param sd_desc	- Instance of the SD card
+ * @param blocks	- Array of count pointers to DATA_BLOCK_LEN bytes
+ * @param block		- First block number
+ * @param count		- Number of blocks
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sd_write_blocks_sg(struct sd_desc *sd_desc,
+			   const uint8_t *const *blocks, uint32_t block,
+			   uint32_t count)
+{
+	return write_blocks(sd_desc, NULL, blocks, block, count);
+}
+
 /**
  * Initialize an instance of SD card and stores it to the parameter desc
  * @param sd_desc	- Pointer where to store the instance of the SD
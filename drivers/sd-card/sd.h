@@ -66,6 +66,8 @@
 
 #define DATA_BLOCK_LEN			(512u)
 #define MAX_RESPONSE_LEN		(18u)
+/* Start token + data block + CRC, sent or received in one transaction */
+#define DATA_BLOCK_XFER_LEN		(DATA_BLOCK_LEN + 3u)
 
 #ifdef SD_DEBUG
 #include <stdio.h>
@@ -100,6 +102,8 @@ struct sd_desc {
 	uint8_t		high_capacity;
 	/** Buffer used for the driver implementation */
 	uint8_t		buff[18];
+	/** Buffer for token, data block and CRC */
+	uint8_t		block_buff[DATA_BLOCK_XFER_LEN];
 };
 
 /**
@@ -132,6 +136,18 @@ int32_t sd_write(struct sd_desc *desc,
 		 uint8_t *data,
 		 uint64_t address,
 		 uint64_t len);
+int32_t sd_read_blocks(struct sd_desc *desc,
+		       uint8_t *data,
+		       uint32_t block,
+		       uint32_t count);
+int32_t sd_write_blocks(struct sd_desc *desc,
+			const uint8_t *data,
+			uint32_t block,
+			uint32_t count);
+int32_t sd_write_blocks_sg(struct sd_desc *desc,
+			   const uint8_t *const *blocks,
+			   uint32_t block,
+			   uint32_t count);
 
 #endif /* __SD_H__ */
 
@@ -0,0 +1,344 @@
+/***************************************************************************//**
+ *   @file   sd_cache.c
+ *   @brief  Sector cache with write-behind for the SD card driver.
+ *           Least recently used sectors are evicted, dirty sectors are
+ *           written back in runs of consecutive sectors with CMD25.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "sd_cache.h"
+#include "no-os/error.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * Get the data of a cache line
+ * @param desc	- Cache descriptor
+ * @param idx	- Index of the line
+ * @return Pointer to DATA_BLOCK_LEN bytes
+ */
+static inline uint8_t *line_data(struct sd_cache_desc *desc, uint32_t idx)
+{
+	return desc->data + idx * DATA_BLOCK_LEN;
+}
+
+/**
+ * Look a sector up in the cache
+ * @param desc		- Cache descriptor
+ * @param sector	- Sector number
+ * @return Index of the line holding sector, -1 if not cached
+ */
+static int32_t find_line(struct sd_cache_desc *desc, uint32_t sector)
+{
+	uint32_t	i;
+
+	for (i = 0; i < desc->nb_lines; i++)
+		if (desc->lines[i].valid && desc->lines[i].sector == sector)
+			return i;
+
+	return -1;
+}
+
+/**
+ * Get a line for sector, evicting the least recently used one if needed.
+ * Evicting a dirty line flushes all the dirty lines, so the write-back is
+ * coalesced.
+ * @param desc		- Cache descriptor
+ * @param sector	- Sector number
+ * @param idx		- Index of the allocated line
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t alloc_line(struct sd_cache_desc *desc, uint32_t sector,
+			  uint32_t *idx)
+{
+	uint32_t	i, victim = 0;
+
+	for (i = 0; i < desc->nb_lines; i++) {
+		if (!desc->lines[i].valid) {
+			victim = i;
+			break;
+		}
+		if (desc->lines[i].last_use < desc->lines[victim].last_use)
+			victim = i;
+	}
+
+	if (desc->lines[victim].valid && desc->lines[victim].dirty)
+		if (SUCCESS != sd_cache_flush(desc))
+			return FAILURE;
+
+	desc->lines[victim].sector = sector;
+	desc->lines[victim].valid = true;
+	desc->lines[victim].dirty = false;
+	*idx = victim;
+
+	return SUCCESS;
+}
+
+/**
+ * Mark a line as most recently used
+ * @param desc	- Cache descriptor
+ * @param idx	- Index of the line
+ */
+static inline void touch_line(struct sd_cache_desc *desc, uint32_t idx)
+{
+	desc->lines[idx].last_use = ++desc->use;
+}
+
+/**
+ * Initialize a sector cache on top of an SD card
+ * @param desc	- Where to store the cache descriptor
+ * @param param	- Initialization parameters
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sd_cache_init(struct sd_cache_desc **desc,
+		      const struct sd_cache_init_param *param)
+{
+	struct sd_cache_desc	*cache;
+
+	if (!desc || !param || !param->sd)
+		return FAILURE;
+
+	cache = calloc(1, sizeof(*cache));
+	if (!cache)
+		return FAILURE;
+
+	cache->sd = param->sd;
+	cache->nb_lines = param->nb_lines ? param->nb_lines :
+			  SD_CACHE_DEFAULT_LINES;
+	cache->lines = calloc(cache->nb_lines, sizeof(*cache->lines));
+	cache->data = malloc(cache->nb_lines * DATA_BLOCK_LEN);
+	cache->order = calloc(cache->nb_lines, sizeof(*cache->order));
+	cache->blocks = calloc(cache->nb_lines, sizeof(*cache->blocks));
+	if (!cache->lines || !cache->data || !cache->order || !cache->blocks)
+		goto failure;
+
+	*desc = cache;
+
+	return SUCCESS;
+failure:
+	free(cache->lines);
+	free(cache->data);
+	free(cache->order);
+	free(cache->blocks);
+	free(cache);
+	return FAILURE;
+}
+
+/**
+ * Flush and free the sector cache
+ * @param desc	- Cache descriptor
+ * @return SUCCESS in case of success, FAILURE if the flush failed.
+ */
+int32_t sd_cache_remove(struct sd_cache_desc *desc)
+{
+	int32_t	ret;
+
+	if (!desc)
+		return FAILURE;
+
+	ret = sd_cache_flush(desc);
+
+	free(desc->lines);
+	free(desc->data);
+	free(desc->order);
+	free(desc->blocks);
+	free(desc);
+
+	return ret;
+}
+
+/**
+ * Read sectors through the cache. Runs of missing sectors are read with one
+ * multiple block command straight into data. Short runs are also kept in the
+ * cache, long sequential reads bypass it so they do not evict metadata.
+ * @param desc		- Cache descriptor
+ * @param data		- Where to store count * DATA_BLOCK_LEN bytes
+ * @param sector	- First sector
+ * @param count		- Number of sectors
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sd_cache_read(struct sd_cache_desc *desc, uint8_t *data,
+		      uint32_t sector, uint32_t count)
+{
+	uint32_t	i, j, run, idx;
+	int32_t		line;
+
+	if (!desc || !data)
+		return FAILURE;
+
+	i = 0;
+	while (i < count) {
+		line = find_line(desc, sector + i);
+		if (line >= 0) {
+			memcpy(data + i * DATA_BLOCK_LEN, line_data(desc, line),
+			       DATA_BLOCK_LEN);
+			touch_line(desc, line);
+			desc->stats.hits++;
+			i++;
+			continue;
+		}
+
+		run = 1;
+		while (i + run < count && find_line(desc, sector + i + run) < 0)
+			run++;
+
+		if (SUCCESS != sd_read_blocks(desc->sd, data + i * DATA_BLOCK_LEN,
+					      sector + i, run))
+			return FAILURE;
+		desc->stats.misses += run;
+
+		if (run <= desc->nb_lines / 2) {
+			for (j = i; j < i + run; j++) {
+				if (SUCCESS != alloc_line(desc, sector + j, &idx))
+					return FAILURE;
+				memcpy(line_data(desc, idx), data + j * DATA_BLOCK_LEN,
+				       DATA_BLOCK_LEN);
+				touch_line(desc, idx);
+			}
+		}
+		i += run;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * Write sectors through the cache. Short writes are only stored in the cache
+ * and written back later by sd_cache_flush(). Writes of half the cache or
+ * more go straight to the card and refresh the cached copies.
+ * @param desc		- Cache descriptor
+ * @param data		- count * DATA_BLOCK_LEN bytes to write
+ * @param sector	- First sector
+ * @param count		- Number of sectors
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sd_cache_write(struct sd_cache_desc *desc, const uint8_t *data,
+		       uint32_t sector, uint32_t count)
+{
+	uint32_t	i, idx;
+	int32_t		line;
+
+	if (!desc || !data)
+		return FAILURE;
+
+	if (count > desc->nb_lines / 2) {
+		if (SUCCESS != sd_write_blocks(desc->sd, data, sector, count))
+			return FAILURE;
+		desc->stats.write_cmds++;
+		desc->stats.sectors_written += count;
+
+		for (i = 0; i < count; i++) {
+			line = find_line(desc, sector + i);
+			if (line < 0)
+				continue;
+			memcpy(line_data(desc, line), data + i * DATA_BLOCK_LEN,
+			       DATA_BLOCK_LEN);
+			desc->lines[line].dirty = false;
+		}
+
+		return SUCCESS;
+	}
+
+	for (i = 0; i < count; i++) {
+		line = find_line(desc, sector + i);
+		if (line >= 0) {
+			idx = line;
+		} else if (SUCCESS != alloc_line(desc, sector + i, &idx)) {
+			return FAILURE;
+		}
+		memcpy(line_data(desc, idx), data + i * DATA_BLOCK_LEN,
+		       DATA_BLOCK_LEN);
+		desc->lines[idx].dirty = true;
+		touch_line(desc, idx);
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * Write all the dirty sectors to the card. They are sorted by sector number
+ * and every run of consecutive sectors goes out as one CMD25.
+ * @param desc	- Cache descriptor
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sd_cache_flush(struct sd_cache_desc *desc)
+{
+	uint32_t	i, j, n, run, tmp;
+
+	if (!desc)
+		return FAILURE;
+
+	/* Insertion sort of the dirty lines by sector */
+	n = 0;
+	for (i = 0; i < desc->nb_lines; i++) {
+		if (!desc->lines[i].valid || !desc->lines[i].dirty)
+			continue;
+		for (j = n; j > 0 && desc->lines[desc->order[j - 1]].sector >
+		     desc->lines[i].sector; j--)
+			desc->order[j] = desc->order[j - 1];
+		desc->order[j] = i;
+		n++;
+	}
+
+	for (i = 0; i < n; i += run) {
+		run = 0;
+		do {
+			tmp = desc->order[i + run];
+			desc->blocks[run] = line_data(desc, tmp);
+			run++;
+		} while (i + run < n && desc->lines[desc->order[i + run]].sector ==
+			 desc->lines[tmp].sector + 1);
+
+		if (SUCCESS != sd_write_blocks_sg(desc->sd, desc->blocks,
+						  desc->lines[desc->order[i]].sector,
+						  run))
+			return FAILURE;
+		desc->stats.write_cmds++;
+		desc->stats.sectors_written += run;
+
+		for (j = i; j < i + run; j++)
+			desc->lines[desc->order[j]].dirty = false;
+	}
+
+	return SUCCESS;
+}
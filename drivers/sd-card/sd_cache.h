@@ -0,0 +1,137 @@
+/***************************************************************************//**
+ *   @file   sd_cache.h
+ *   @brief  Sector cache with write-behind for the SD card driver.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef __SD_CACHE_H__
+#define __SD_CACHE_H__
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sd.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define SD_CACHE_DEFAULT_LINES		(16u)
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct sd_cache_init_param
+ * @brief Configuration structure sent in the function sd_cache_init
+ */
+struct sd_cache_init_param {
+	/** Initialized SD card */
+	struct sd_desc	*sd;
+	/** Number of cached sectors, SD_CACHE_DEFAULT_LINES if 0 */
+	uint32_t	nb_lines;
+};
+
+/**
+ * @struct sd_cache_line
+ * @brief One cached sector
+ */
+struct sd_cache_line {
+	/** Sector number */
+	uint32_t	sector;
+	/** Value of the use counter at the last access, for LRU eviction */
+	uint32_t	last_use;
+	/** Holds the data of sector */
+	bool		valid;
+	/** Data not written to the card yet */
+	bool		dirty;
+};
+
+/**
+ * @struct sd_cache_stats
+ * @brief Cache statistics
+ */
+struct sd_cache_stats {
+	/** Sectors found in the cache */
+	uint32_t	hits;
+	/** Sectors read from the card */
+	uint32_t	misses;
+	/** Write commands (CMD24/CMD25) sent to the card */
+	uint32_t	write_cmds;
+	/** Sectors written to the card */
+	uint32_t	sectors_written;
+};
+
+/**
+ * @struct sd_cache_desc
+ * @brief Sector cache descriptor
+ */
+struct sd_cache_desc {
+	/** SD card */
+	struct sd_desc		*sd;
+	/** Cache lines */
+	struct sd_cache_line	*lines;
+	/** Data of the cache lines, nb_lines * DATA_BLOCK_LEN bytes */
+	uint8_t			*data;
+	/** Number of cache lines */
+	uint32_t		nb_lines;
+	/** Use counter */
+	uint32_t		use;
+	/** Scratch list of dirty lines used by sd_cache_flush() */
+	uint32_t		*order;
+	/** Scratch list of block pointers used by sd_cache_flush() */
+	const uint8_t		**blocks;
+	/** Statistics */
+	struct sd_cache_stats	stats;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+int32_t sd_cache_init(struct sd_cache_desc **desc,
+		      const struct sd_cache_init_param *param);
+int32_t sd_cache_remove(struct sd_cache_desc *desc);
+int32_t sd_cache_read(struct sd_cache_desc *desc, uint8_t *data,
+		      uint32_t sector, uint32_t count);
+int32_t sd_cache_write(struct sd_cache_desc *desc, const uint8_t *data,
+		       uint32_t sector, uint32_t count);
+int32_t sd_cache_flush(struct sd_cache_desc *desc);
+
+#endif /* __SD_CACHE_H__ */
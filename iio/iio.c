@@ -63,6 +63,10 @@
 #include "tcp_socket.h"
 #endif
 
+#ifdef IIO_PERF
+#include "iio_perf.h"
+#endif
+
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
 /******************************************************************************/
@@ -71,6 +75,8 @@
 #define MAX_SOCKET_TO_HANDLE	10
 #define REG_ACCESS_ATTRIBUTE	"direct_reg_access"
 #define IIOD_CONN_BUFFER_SIZE	0x1000
+#define PERF_ATTRIBUTE_PREFIX	"perf_"
+#define PERF_DEVICE_NAME	"iiod"
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -124,6 +130,47 @@ struct attr_fun_params {
 	struct iio_ch_info	*ch_info;
 };
 
+#ifdef IIO_PERF
+/* Counters of a device, read through its perf_* debug attributes */
+struct iio_dev_perf {
+	/* Time source, shared by all devices */
+	struct iio_perf_clk	*clk;
+	struct iio_perf_stat	attr_read;
+	struct iio_perf_stat	attr_write;
+	struct iio_perf_stat	refill;
+	struct iio_perf_stat	push;
+	/* Buffer bytes sent to clients */
+	uint64_t		bytes_read;
+	/* Buffer bytes received from clients */
+	uint64_t		bytes_written;
+	/* Overruns of the buffers closed so far */
+	uint32_t		overruns;
+};
+
+enum iio_perf_dev_attr {
+	PERF_ATTR_READ,
+	PERF_ATTR_WRITE,
+	PERF_REFILL,
+	PERF_PUSH,
+	PERF_BYTES_READ,
+	PERF_BYTES_WRITTEN,
+	PERF_OVERRUNS,
+};
+
+enum iio_perf_ctx_attr {
+	PERF_TIMESTAMP_NS,
+	PERF_STEPS,
+	PERF_BYTES_SENT,
+	PERF_BYTES_RECV,
+	PERF_CMDS,
+	PERF_ERRORS,
+	PERF_EAGAIN,
+	PERF_RESET,
+	/* Per connection values of the counters above, as "id:value" pairs */
+	PERF_CONN = 0x100,
+};
+#endif
+
 struct iio_buffer_priv {
 	/* Field visible by user */
 	struct iio_buffer	public;
@@ -159,6 +206,9 @@ struct iio_dev_priv {
 	struct iio_device	*dev_descriptor;
 	/* Structure storing buffer related fields */
 	struct iio_buffer_priv buffer;
+#ifdef IIO_PERF
+	struct iio_dev_perf	perf;
+#endif
 };
 
 struct iio_desc {
@@ -172,6 +222,8 @@ struct iio_desc {
 	struct uart_desc	*uart_desc;
 	int (*recv)(void *conn, uint8_t *buf, uint32_t len);
 	int (*send)(void *conn, uint8_t *buf, uint32_t len);
+	/* Optional, send several buffers with one call */
+	int (*sendv)(void *conn, struct iiod_iovec *iov, uint32_t cnt);
 	/* FIFO for socket descriptors */
 	struct circular_buffer	*conns;
 #ifdef ENABLE_IIO_NETWORK
@@ -179,6 +231,11 @@ struct iio_desc {
 	/* Instance of server socket */
 	struct tcp_socket_desc	*server;
 #endif
+#ifdef IIO_PERF
+	struct iio_perf_clk	perf_clk;
+	/* Calls of iio_step() */
+	uint64_t		perf_steps;
+#endif
 };
 
 /******************************************************************************/
@@ -225,6 +282,35 @@ static int iio_send(struct iiod_ctx *ctx, uint8_t *buf, uint32_t len)
 	return desc->send(ctx->conn, buf, len);
 }
 
+static int iio_sendv(struct iiod_ctx *ctx, struct iiod_iovec *iov,
+		     uint32_t cnt)
+{
+	struct iio_desc *desc = ctx->instance;
+
+	/* A short count makes iiod send the rest later */
+	if (!desc->sendv)
+		return desc->send(ctx->conn, iov[0].buf, iov[0].len);
+
+	return desc->sendv(ctx->conn, iov, cnt);
+}
+
+#ifdef ENABLE_IIO_NETWORK
+/* Send iiod buffers with one socket_sendv call */
+static int iio_socket_sendv(void *conn, struct iiod_iovec *iov, uint32_t cnt)
+{
+	struct socket_iovec siov[4];
+	uint32_t i;
+
+	cnt = min(cnt, (uint32_t)ARRAY_SIZE(siov));
+	for (i = 0; i < cnt; i++) {
+		siov[i].base = iov[i].buf;
+		siov[i].len = iov[i].len;
+	}
+
+	return socket_sendv(conn, siov, cnt);
+}
+#endif
+
 static inline void _print_ch_id(char *buff, struct iio_channel *ch)
 {
 	if(ch->modified) {
@@ -1049,6 +1135,9 @@ static int32_t accept_network_clients(struct iio_desc *desc)
 		if (IS_ERR_VALUE(ret))
 			return ret;
 
+		/* Responses are sent with one call, do not delay them */
+		socket_setopt(sock, SOCKET_OPT_NODELAY, 1);
+
 		data.conn = sock;
 		data.buf = calloc(1, IIOD_CONN_BUFFER_SIZE);
 		data.len = IIOD_CONN_BUFFER_SIZE;
@@ -1085,6 +1174,10 @@ int iio_step(struct iio_desc *desc)
 	}
 #endif
 
+#ifdef IIO_PERF
+	desc->perf_steps++;
+#endif
+
 	ret = _pop_conn(desc, &conn_id);
 	if (IS_ERR_VALUE(ret))
 		return ret;
@@ -1105,6 +1198,307 @@ int iio_step(struct iio_desc *desc)
 	return ret;
 }
 
+#ifdef IIO_PERF
+
+static int iio_perf_dev_show(void *device, char *buf, uint32_t len,
+			     const struct iio_ch_info *channel, intptr_t priv)
+{
+	struct iio_dev_priv *dev = device;
+	struct iio_dev_perf *perf = &dev->perf;
+
+	switch (priv) {
+	case PERF_ATTR_READ:
+		return iio_perf_stat_show(perf->clk, &perf->attr_read, buf, len);
+	case PERF_ATTR_WRITE:
+		return iio_perf_stat_show(perf->clk, &perf->attr_write, buf, len);
+	case PERF_REFILL:
+		return iio_perf_stat_show(perf->clk, &perf->refill, buf, len);
+	case PERF_PUSH:
+		return iio_perf_stat_show(perf->clk, &perf->push, buf, len);
+	case PERF_BYTES_READ:
+		return snprintf(buf, len, "%"PRIu64, perf->bytes_read);
+	case PERF_BYTES_WRITTEN:
+		return snprintf(buf, len, "%"PRIu64, perf->bytes_written);
+	case PERF_OVERRUNS:
+		return snprintf(buf, len, "%"PRIu32,
+				perf->overruns + dev->buffer.cb.overruns);
+	default:
+		return -EINVAL;
+	}
+}
+
+/* Writing any of the perf_* attributes of a device clears its counters */
+static int iio_perf_dev_store(void *device, char *buf, uint32_t len,
+			      const struct iio_ch_info *channel, intptr_t priv)
+{
+	struct iio_dev_priv *dev = device;
+	struct iio_perf_clk *clk = dev->perf.clk;
+
+	memset(&dev->perf, 0, sizeof(dev->perf));
+	dev->perf.clk = clk;
+	dev->buffer.cb.overruns = 0;
+
+	return len;
+}
+
+#define IIO_PERF_DEV_ATTR(_name, _priv) {\
+	.name = PERF_ATTRIBUTE_PREFIX _name,\
+	.priv = _priv,\
+	.show = iio_perf_dev_show,\
+	.store = iio_perf_dev_store\
+}
+
+/* Added to the debug attributes of every device */
+static struct iio_attribute iio_perf_dev_attrs[] = {
+	IIO_PERF_DEV_ATTR("attr_read", PERF_ATTR_READ),
+	IIO_PERF_DEV_ATTR("attr_write", PERF_ATTR_WRITE),
+	IIO_PERF_DEV_ATTR("refill", PERF_REFILL),
+	IIO_PERF_DEV_ATTR("push", PERF_PUSH),
+	IIO_PERF_DEV_ATTR("bytes_read", PERF_BYTES_READ),
+	IIO_PERF_DEV_ATTR("bytes_written", PERF_BYTES_WRITTEN),
+	IIO_PERF_DEV_ATTR("overruns", PERF_OVERRUNS),
+	END_ATTRIBUTES_ARRAY
+};
+
+static uint64_t iio_perf_conn_val(struct iiod_conn_stats *stats,
+				  intptr_t priv)
+{
+	switch (priv) {
+	case PERF_BYTES_SENT:
+		return stats->bytes_sent;
+	case PERF_BYTES_RECV:
+		return stats->bytes_recv;
+	case PERF_CMDS:
+		return stats->cmds;
+	case PERF_ERRORS:
+		return stats->errors;
+	default:
+		return stats->eagain;
+	}
+}
+
+static int iio_perf_ctx_show(void *device, char *buf, uint32_t len,
+			     const struct iio_ch_info *channel, intptr_t priv)
+{
+	struct iio_desc *desc = device;
+	struct iiod_conn_stats stats;
+	uint64_t now;
+	uint32_t i, l;
+
+	switch (priv) {
+	case PERF_TIMESTAMP_NS:
+		now = iio_perf_now(&desc->perf_clk);
+		return snprintf(buf, len, "%"PRIu64,
+				iio_perf_ns(&desc->perf_clk, now));
+	case PERF_STEPS:
+		return snprintf(buf, len, "%"PRIu64, desc->perf_steps);
+	case PERF_RESET:
+		return snprintf(buf, len, "0");
+	default:
+		break;
+	}
+
+	if (!(priv & PERF_CONN)) {
+		iiod_get_stats(desc->iiod, IIOD_MAX_CONNECTIONS, &stats);
+		return snprintf(buf, len, "%"PRIu64,
+				iio_perf_conn_val(&stats, priv));
+	}
+
+	l = 0;
+	for (i = 0; i < IIOD_MAX_CONNECTIONS && l < len; i++) {
+		if (iiod_get_stats(desc->iiod, i, &stats))
+			continue;
+		l += snprintf(buf + l, len - l, "%"PRIu32":%"PRIu64" ", i,
+			      iio_perf_conn_val(&stats, priv & ~PERF_CONN));
+	}
+
+	return min(l, len - 1);
+}
+
+/* Writing reset clears all the counters of the context */
+static int iio_perf_ctx_store(void *device, char *buf, uint32_t len,
+			      const struct iio_ch_info *channel, intptr_t priv)
+{
+	struct iio_desc *desc = device;
+	uint32_t i;
+
+	iiod_reset_stats(desc->iiod);
+	desc->perf_steps = 0;
+	for (i = 0; i < desc->nb_devs; i++)
+		iio_perf_dev_store(&desc->devs[i], buf, len, NULL, 0);
+
+	return len;
+}
+
+#define IIO_PERF_CTX_ATTR(_name, _priv) {\
+	.name = _name,\
+	.priv = _priv,\
+	.show = iio_perf_ctx_show\
+}
+
+static struct iio_attribute iio_perf_ctx_attrs[] = {
+	IIO_PERF_CTX_ATTR("timestamp_ns", PERF_TIMESTAMP_NS),
+	IIO_PERF_CTX_ATTR("steps", PERF_STEPS),
+	IIO_PERF_CTX_ATTR("bytes_sent", PERF_BYTES_SENT),
+	IIO_PERF_CTX_ATTR("bytes_recv", PERF_BYTES_RECV),
+	IIO_PERF_CTX_ATTR("cmds", PERF_CMDS),
+	IIO_PERF_CTX_ATTR("errors", PERF_ERRORS),
+	IIO_PERF_CTX_ATTR("eagain", PERF_EAGAIN),
+	IIO_PERF_CTX_ATTR("conn_bytes_sent", PERF_CONN | PERF_BYTES_SENT),
+	IIO_PERF_CTX_ATTR("conn_bytes_recv", PERF_CONN | PERF_BYTES_RECV),
+	IIO_PERF_CTX_ATTR("conn_cmds", PERF_CONN | PERF_CMDS),
+	IIO_PERF_CTX_ATTR("conn_errors", PERF_CONN | PERF_ERRORS),
+	IIO_PERF_CTX_ATTR("conn_eagain", PERF_CONN | PERF_EAGAIN),
+	{
+		.name = "reset",
+		.priv = PERF_RESET,
+		.show = iio_perf_ctx_show,
+		.store = iio_perf_ctx_store
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+/* Device holding the counters of the context, added after the user devices */
+static struct iio_device iio_perf_device = {
+	.attributes = iio_perf_ctx_attrs
+};
+
+/*
+ * The ops below time the iio ops and count the buffer traffic of each device
+ * before calling them. The perf_* debug attributes are served here.
+ */
+static int iio_perf_rw_attr(struct iiod_ctx *ctx, const char *device,
+			    struct iiod_attr *attr, char *buf, uint32_t len,
+			    bool is_write)
+{
+	struct iio_desc *desc = ctx->instance;
+	struct attr_fun_params params;
+	struct iio_dev_priv *dev;
+	uint64_t start;
+	int ret;
+
+	dev = get_iio_device(desc, device);
+	if (!dev)
+		return -ENODEV;
+
+	if (attr->type == IIO_ATTR_TYPE_DEBUG &&
+	    !strncmp(attr->name, PERF_ATTRIBUTE_PREFIX,
+		     sizeof(PERF_ATTRIBUTE_PREFIX) - 1)) {
+		params.dev_instance = dev;
+		params.buf = buf;
+		params.len = len;
+		params.ch_info = NULL;
+
+		return iio_rd_wr_attribute(&params, iio_perf_dev_attrs,
+					   attr->name, is_write);
+	}
+
+	start = iio_perf_now(&desc->perf_clk);
+	if (is_write) {
+		ret = iio_write_attr(ctx, device, attr, buf, len);
+		iio_perf_stat_end(&desc->perf_clk, &dev->perf.attr_write,
+				  start, ret);
+	} else {
+		ret = iio_read_attr(ctx, device, attr, buf, len);
+		iio_perf_stat_end(&desc->perf_clk, &dev->perf.attr_read,
+				  start, ret);
+	}
+
+	return ret;
+}
+
+static int iio_perf_read_attr(struct iiod_ctx *ctx, const char *device,
+			      struct iiod_attr *attr, char *buf, uint32_t len)
+{
+	return iio_perf_rw_attr(ctx, device, attr, buf, len, false);
+}
+
+static int iio_perf_write_attr(struct iiod_ctx *ctx, const char *device,
+			       struct iiod_attr *attr, char *buf, uint32_t len)
+{
+	return iio_perf_rw_attr(ctx, device, attr, buf, len, true);
+}
+
+static int iio_perf_submit(struct iiod_ctx *ctx, const char *device,
+			   enum iio_buffer_direction dir)
+{
+	struct iio_desc *desc = ctx->instance;
+	struct iio_dev_priv *dev;
+	uint64_t start;
+	int ret;
+
+	dev = get_iio_device(desc, device);
+	if (!dev)
+		return -EINVAL;
+
+	start = iio_perf_now(&desc->perf_clk);
+	ret = iio_call_submit(ctx, device, dir);
+	iio_perf_stat_end(&desc->perf_clk, dir == IIO_DIRECTION_INPUT ?
+			  &dev->perf.refill : &dev->perf.push, start, ret);
+
+	return ret;
+}
+
+static int iio_perf_refill_buffer(struct iiod_ctx *ctx, const char *device)
+{
+	return iio_perf_submit(ctx, device, IIO_DIRECTION_INPUT);
+}
+
+static int iio_perf_push_buffer(struct iiod_ctx *ctx, const char *device)
+{
+	return iio_perf_submit(ctx, device, IIO_DIRECTION_OUTPUT);
+}
+
+static int iio_perf_read_buffer(struct iiod_ctx *ctx, const char *device,
+				char *buf, uint32_t bytes)
+{
+	struct iio_dev_priv *dev;
+	int ret;
+
+	ret = iio_read_buffer(ctx, device, buf, bytes);
+	dev = get_iio_device(ctx->instance, device);
+	if (!dev)
+		return ret;
+
+	if (ret > 0)
+		dev->perf.bytes_read += ret;
+	else if (ret == -EOVERRUN)
+		dev->perf.overruns++;
+
+	return ret;
+}
+
+static int iio_perf_write_buffer(struct iiod_ctx *ctx, const char *device,
+				 const char *buf, uint32_t bytes)
+{
+	struct iio_dev_priv *dev;
+	int ret;
+
+	ret = iio_write_buffer(ctx, device, (char *)buf, bytes);
+	dev = get_iio_device(ctx->instance, device);
+	if (dev && ret > 0)
+		dev->perf.bytes_written += ret;
+
+	return ret;
+}
+
+static int iio_perf_open_dev(struct iiod_ctx *ctx, const char *device,
+			     uint32_t samples, uint32_t mask, bool cyclic)
+{
+	struct iio_dev_priv *dev;
+
+	/* Opening resets the buffer, keep its overruns */
+	dev = get_iio_device(ctx->instance, device);
+	if (dev) {
+		dev->perf.overruns += dev->buffer.cb.overruns;
+		dev->buffer.cb.overruns = 0;
+	}
+
+	return iio_open_dev(ctx, device, samples, mask, cyclic);
+}
+
+#endif /* IIO_PERF */
+
 /*
  * Generate an xml describing a device and write it to buff.
  * Will return the size of the xml.
@@ -1262,6 +1656,13 @@ static uint32_t iio_generate_device_xml(struct iio_device *device, char *name,
 	if (device->debug_reg_read || device->debug_reg_write)
 		i += snprintf(buff + i, max(n - i, 0),
 			      "<debug-attribute name=\""REG_ACCESS_ATTRIBUTE"\" />");
+#ifdef IIO_PERF
+	if (device != &iio_perf_device)
+		for (j = 0; iio_perf_dev_attrs[j].name; j++)
+			i += snprintf(buff + i, max(n - i, 0),
+				      "<debug-attribute name=\"%s\" />",
+				      iio_perf_dev_attrs[j].name);
+#endif
 
 	/* Write buffer attributes */
 	if (device->buffer_attributes)
@@ -1319,6 +1720,9 @@ static int32_t iio_init_devs(struct iio_desc *desc,
 	struct iio_device_init *ndev;
 
 	desc->nb_devs = n;
+#ifdef IIO_PERF
+	desc->nb_devs++;
+#endif
 	desc->devs = (struct iio_dev_priv *)calloc(desc->nb_devs,
 			sizeof(*desc->devs));
 	if (!desc->devs)
@@ -1343,8 +1747,21 @@ static int32_t iio_init_devs(struct iio_desc *desc,
 		} else {
 			ldev->buffer.initalized = 0;
 		}
+#ifdef IIO_PERF
+		ldev->perf.clk = &desc->perf_clk;
+#endif
 	}
 
+#ifdef IIO_PERF
+	ldev = desc->devs + n;
+	ldev->dev_descriptor = &iio_perf_device;
+	sprintf(ldev->dev_id, "iio:device%"PRIu32"", i);
+	ldev->dev_instance = desc;
+	ldev->dev_data.dev = desc;
+	ldev->name = PERF_DEVICE_NAME;
+	ldev->perf.clk = &desc->perf_clk;
+#endif
+
 	ret = iio_init_xml(desc);
 	if (IS_ERR_VALUE(ret))
 		free(desc->devs);
@@ -1389,7 +1806,19 @@ int iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 	ops->open = iio_open_dev;
 	ops->close = iio_close_dev;
 	ops->send = iio_send;
+	ops->sendv = iio_sendv;
 	ops->recv = iio_recv;
+#ifdef IIO_PERF
+	ops->read_attr = iio_perf_read_attr;
+	ops->write_attr = iio_perf_write_attr;
+	ops->read_buffer = iio_perf_read_buffer;
+	ops->write_buffer = iio_perf_write_buffer;
+	ops->refill_buffer = iio_perf_refill_buffer;
+	ops->push_buffer = iio_perf_push_buffer;
+	ops->open = iio_perf_open_dev;
+	ldesc->perf_clk.timer = init_param->perf_timer;
+	iio_perf_now(&ldesc->perf_clk);
+#endif
 
 	iiod_param.instance = ldesc;
 	iiod_param.ops = ops;
@@ -1423,6 +1852,7 @@ int iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 #ifdef ENABLE_IIO_NETWORK
 	else if (init_param->phy_type == USE_NETWORK) {
 		ldesc->send = (int (*)())socket_send;
+		ldesc->sendv = iio_socket_sendv;
 		ldesc->recv = (int (*)())socket_recv;
 		ret = socket_init(&ldesc->server,
 				  init_param->tcp_socket_init_param);
@@ -50,6 +50,9 @@
 #ifdef ENABLE_IIO_NETWORK
 #include "tcp_socket.h"
 #endif
+#ifdef IIO_PERF
+#include "no-os/timer.h"
+#endif
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -88,6 +91,10 @@ struct iio_init_param {
 	};
 	struct iio_device_init *devs;
 	int32_t nb_devs;
+#ifdef IIO_PERF
+	/* Optional started, up-counting timer used to time the operations */
+	struct timer_desc *perf_timer;
+#endif
 };
 
 /******************************************************************************/
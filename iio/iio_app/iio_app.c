@@ -163,6 +163,32 @@ static int32_t print_uart_error_message(struct uart_desc **uart_desc,
 #endif
 }
 
+#ifdef IIO_PERF
+/* Time source of the iio performance counters */
+static int32_t perf_timer_setup(struct timer_desc **timer)
+{
+#ifdef LINUX_PLATFORM
+	struct timer_init_param param = {
+		.id = 0,
+		.freq_hz = 1000000,
+		.load_value = 0
+	};
+	int32_t status;
+
+	status = timer_init(timer, &param);
+	if (status < 0)
+		return status;
+
+	return timer_start(*timer);
+#else
+	/* Only count the operations, a timer needs platform parameters */
+	*timer = NULL;
+
+	return 0;
+#endif
+}
+#endif
+
 #if defined(USE_TCP_SOCKET) || defined(LINUX_PLATFORM)
 static int32_t network_setup(struct iio_init_param *iio_init_param,
 			     struct uart_desc *uart_desc,
@@ -315,6 +341,12 @@ int32_t iio_app_run(struct iio_app_device *devices, int32_t len)
 	iio_init_param.uart_desc = uart_desc;
 #endif
 
+#ifdef IIO_PERF
+	status = perf_timer_setup(&iio_init_param.perf_timer);
+	if (status < 0)
+		goto error;
+#endif
+
 	iio_init_devs = calloc(len, sizeof(*iio_init_devs));
 	if (!iio_init_devs)
 		return -ENOMEM;
@@ -0,0 +1,126 @@
+/***************************************************************************//**
+ *   @file   iio_perf.c
+ *   @brief  Performance counters of the iio layer.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdio.h>
+#include "iio_perf.h"
+#include "no-os/error.h"
+#include "no-os/util.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Read the time source.
+ * @param clk - Time source.
+ * @return Time in timer ticks, 0 if there is no timer or it can't be read.
+ */
+uint64_t iio_perf_now(struct iio_perf_clk *clk)
+{
+	uint32_t counter;
+
+	if (!clk->timer || timer_counter_get(clk->timer, &counter))
+		return clk->ticks;
+
+	clk->ticks += (uint32_t)(counter - clk->last);
+	clk->last = counter;
+
+	return clk->ticks;
+}
+
+/**
+ * @brief Convert timer ticks to nanoseconds.
+ * @param clk - Time source.
+ * @param ticks - Timer ticks.
+ * @return Nanoseconds, 0 without a timer.
+ */
+uint64_t iio_perf_ns(struct iio_perf_clk *clk, uint64_t ticks)
+{
+	uint32_t freq;
+
+	if (!clk->timer || !clk->timer->freq_hz)
+		return 0;
+
+	freq = clk->timer->freq_hz;
+
+	return ticks / freq * 1000000000ull +
+	       ticks % freq * 1000000000ull / freq;
+}
+
+/**
+ * @brief Account a call.
+ * @param clk - Time source.
+ * @param stat - Counters of the operation.
+ * @param start - Time the call started, from iio_perf_now().
+ * @param ret - Return value of the call.
+ */
+void iio_perf_stat_end(struct iio_perf_clk *clk, struct iio_perf_stat *stat,
+		       uint64_t start, int32_t ret)
+{
+	uint64_t elapsed;
+
+	elapsed = iio_perf_now(clk) - start;
+	stat->count++;
+	if (IS_ERR_VALUE(ret))
+		stat->errors++;
+	stat->total += elapsed;
+	if (elapsed > stat->max)
+		stat->max = min(elapsed, (uint64_t)UINT32_MAX);
+}
+
+/**
+ * @brief Format a stat as "count errors total_ns max_ns".
+ * @param clk - Time source.
+ * @param stat - Counters of the operation.
+ * @param buf - Where to write the string.
+ * @param len - Size of buf.
+ * @return Length of the string.
+ */
+int iio_perf_stat_show(struct iio_perf_clk *clk, struct iio_perf_stat *stat,
+		       char *buf, uint32_t len)
+{
+	return snprintf(buf, len, "%"PRIu32" %"PRIu32" %"PRIu64" %"PRIu64,
+			stat->count, stat->errors,
+			iio_perf_ns(clk, stat->total),
+			iio_perf_ns(clk, stat->max));
+}
@@ -0,0 +1,97 @@
+/***************************************************************************//**
+ *   @file   iio_perf.h
+ *   @brief  Performance counters of the iio layer.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef IIO_PERF_H_
+#define IIO_PERF_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include "no-os/timer.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct iio_perf_clk
+ * @brief Time source of the counters. The 32 bit counter of an up-counting
+ * timer is extended to 64 bits, so it must be read at least once per wrap.
+ */
+struct iio_perf_clk {
+	/** Started timer, NULL if only events are counted */
+	struct timer_desc	*timer;
+	/** Extended counter */
+	uint64_t		ticks;
+	/** Last counter value read */
+	uint32_t		last;
+};
+
+/**
+ * @struct iio_perf_stat
+ * @brief Count and duration of an operation.
+ */
+struct iio_perf_stat {
+	/** Number of calls */
+	uint32_t	count;
+	/** Number of calls that failed */
+	uint32_t	errors;
+	/** Time spent in the calls, in timer ticks */
+	uint64_t	total;
+	/** Longest call, in timer ticks */
+	uint32_t	max;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Current time in timer ticks, 0 without a timer. */
+uint64_t iio_perf_now(struct iio_perf_clk *clk);
+/* Convert timer ticks to nanoseconds. */
+uint64_t iio_perf_ns(struct iio_perf_clk *clk, uint64_t ticks);
+/* Account a call that started at start and returned ret. */
+void iio_perf_stat_end(struct iio_perf_clk *clk, struct iio_perf_stat *stat,
+		       uint64_t start, int32_t ret);
+/* Format a stat as "count errors total_ns max_ns". */
+int iio_perf_stat_show(struct iio_perf_clk *clk, struct iio_perf_stat *stat,
+		       char *buf, uint32_t len);
+
+#endif /* IIO_PERF_H_ */
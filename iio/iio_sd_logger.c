@@ -0,0 +1,389 @@
+/***************************************************************************//**
+ *   @file   iio_sd_logger.c
+ *   @brief  Logs an IIO device buffer to files on an SD card.
+ *           Data is written in cluster aligned blocks to preallocated files.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "iio_sd_logger.h"
+#include "no-os/circular_buffer.h"
+#include "no-os/error.h"
+#include "no-os/util.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Fill the parts of the file header that do not change.
+ * @param logger - Logger descriptor.
+ * @param param - Initialization parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t iio_sd_logger_fill_header(struct iio_sd_logger *logger,
+		const struct iio_sd_logger_init_param *param)
+{
+	struct iio_sd_logger_header *hdr = &logger->header;
+	struct iio_sd_logger_ch *ch;
+	struct iio_channel *chan;
+	uint32_t i;
+
+	memcpy(hdr->magic, IIO_SD_LOGGER_MAGIC, sizeof(hdr->magic));
+	hdr->version = IIO_SD_LOGGER_VERSION;
+	hdr->header_size = IIO_SD_LOGGER_HEADER_SIZE;
+	if (param->name)
+		strncpy(hdr->name, param->name, sizeof(hdr->name) - 1);
+	hdr->active_mask = param->buffer->active_mask;
+	hdr->bytes_per_scan = param->buffer->bytes_per_scan;
+
+	for (i = 0; i < param->dev->num_ch && i < IIO_SD_LOGGER_MAX_CHANNELS;
+	     i++) {
+		if (!(hdr->active_mask & BIT(i)))
+			continue;
+		chan = &param->dev->channels[i];
+		if (!chan->scan_type)
+			return -EINVAL;
+		ch = &hdr->channels[hdr->nb_channels++];
+		ch->index = i;
+		ch->ch_type = chan->ch_type;
+		ch->channel = chan->channel;
+		ch->sign = chan->scan_type->sign;
+		ch->realbits = chan->scan_type->realbits;
+		ch->storagebits = chan->scan_type->storagebits;
+		ch->shift = chan->scan_type->shift;
+		ch->is_big_endian = chan->scan_type->is_big_endian;
+	}
+
+	return hdr->nb_channels ? SUCCESS : -EINVAL;
+}
+
+/**
+ * @brief Write the header in the first sector of the current file.
+ * @param logger - Logger descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t iio_sd_logger_write_header(struct iio_sd_logger *logger)
+{
+	uint8_t sector[IIO_SD_LOGGER_HEADER_SIZE] = {0};
+	UINT bw;
+
+	memcpy(sector, &logger->header, sizeof(logger->header));
+	if (f_lseek(&logger->file, 0) != FR_OK ||
+	    f_write(&logger->file, sector, sizeof(sector), &bw) != FR_OK ||
+	    bw != sizeof(sector))
+		return -EIO;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Create the next file of the sequence and allocate its clusters.
+ * @param logger - Logger descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t iio_sd_logger_open(struct iio_sd_logger *logger)
+{
+	char path[32];
+	uint32_t cluster;
+	int32_t ret;
+	FRESULT res;
+
+	snprintf(path, sizeof(path), "%s%03"PRIu32".BIN", logger->prefix,
+		 logger->files);
+	if (f_open(&logger->file, path, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK)
+		return -EIO;
+
+	cluster = logger->file.obj.fs->csize * FF_MAX_SS;
+	if (!logger->block_size)
+		logger->block_size = cluster;
+	if (!logger->staging) {
+		logger->staging = malloc(logger->block_size);
+		if (!logger->staging) {
+			ret = -ENOMEM;
+			goto close;
+		}
+	}
+	logger->file_size = round_up(logger->file_size, cluster) * cluster;
+
+	/* Contiguous clusters when available, any free cluster otherwise */
+	res = f_expand(&logger->file, logger->file_size, 1);
+	if (res == FR_DENIED)
+		res = f_lseek(&logger->file, logger->file_size);
+	/* f_lseek() stops at the end of the volume when the disk is full */
+	if (res != FR_OK || f_size(&logger->file) != logger->file_size) {
+		ret = -ENOSPC;
+		goto close;
+	}
+
+	logger->header.file_index = logger->files;
+	logger->header.data_len = 0;
+	ret = iio_sd_logger_write_header(logger);
+	if (ret)
+		goto close;
+
+	logger->pos = IIO_SD_LOGGER_HEADER_SIZE;
+	logger->file_open = true;
+
+	return SUCCESS;
+close:
+	f_close(&logger->file);
+	f_unlink(path);
+	return ret;
+}
+
+/**
+ * @brief Complete the header of the current file, release the clusters
+ * that were not used and close it.
+ * @param logger - Logger descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t iio_sd_logger_close(struct iio_sd_logger *logger)
+{
+	int32_t ret;
+
+	logger->file_open = false;
+	logger->files++;
+	logger->header.overruns = logger->overruns;
+	logger->header.data_len = logger->pos - IIO_SD_LOGGER_HEADER_SIZE;
+
+	ret = SUCCESS;
+	if (f_lseek(&logger->file, logger->pos) != FR_OK ||
+	    f_truncate(&logger->file) != FR_OK)
+		ret = -EIO;
+	if (!ret)
+		ret = iio_sd_logger_write_header(logger);
+	if (f_close(&logger->file) != FR_OK && !ret)
+		ret = -EIO;
+
+	return ret;
+}
+
+/**
+ * @brief Append data to the current file, switching to the next file when
+ * it is full.
+ * @param logger - Logger descriptor.
+ * @param data - Data to write.
+ * @param len - Number of bytes.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t iio_sd_logger_write(struct iio_sd_logger *logger,
+				   const void *data, uint32_t len)
+{
+	UINT bw;
+
+	if (f_write(&logger->file, data, len, &bw) != FR_OK || bw != len)
+		return -EIO;
+
+	logger->pos += len;
+	logger->bytes_written += len;
+	if (logger->pos >= logger->file_size)
+		return iio_sd_logger_close(logger);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Move the data available in the device buffer to the SD card.
+ * @param logger - Logger descriptor.
+ * @param final - Also write the last incomplete block.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t iio_sd_logger_drain(struct iio_sd_logger *logger, bool final)
+{
+	struct circular_buffer *cb = logger->buffer->buf;
+	uint32_t want, n;
+	int32_t ret;
+	void *ptr;
+
+	while (true) {
+		if (!logger->file_open) {
+			/* Only start the next file when there is data for it */
+			ret = cb_size(cb, &n);
+			if (ret == SUCCESS && !n)
+				break;
+
+			ret = iio_sd_logger_open(logger);
+			if (ret)
+				return ret;
+		}
+
+		/* Keep the writes aligned to block_size in the file */
+		want = logger->block_size - logger->pos % logger->block_size;
+		want = min(want, logger->file_size - logger->pos);
+
+		ret = cb_prepare_async_read(cb, want - logger->staged, &ptr, &n);
+		if (ret == -EAGAIN)
+			break;
+		if (ret == -EOVERRUN)
+			logger->overruns++;
+		else if (ret)
+			return ret;
+
+		if (!logger->staged && n == want) {
+			/* Whole block in place, write it from the device buffer */
+			ret = iio_sd_logger_write(logger, ptr, n);
+			cb_end_async_read(cb);
+			if (ret)
+				return ret;
+			continue;
+		}
+
+		memcpy(logger->staging + logger->staged, ptr, n);
+		cb_end_async_read(cb);
+		logger->staged += n;
+		if (logger->staged == want) {
+			logger->staged = 0;
+			ret = iio_sd_logger_write(logger, logger->staging, want);
+			if (ret)
+				return ret;
+		}
+	}
+
+	if (final && logger->staged) {
+		n = logger->staged;
+		logger->staged = 0;
+		return iio_sd_logger_write(logger, logger->staging, n);
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Initialize a logger. Files are created by iio_sd_logger_process()
+ * when it finds data to write. The volume must be mounted.
+ *
+ * The device buffer is written in place whenever a whole block is available
+ * without wrapping, so it acts as the second buffer of a double buffer: it
+ * should hold at least two blocks, for the producer to fill one while the
+ * other is written.
+ * @param logger - Where to store the logger descriptor.
+ * @param param - Initialization parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_sd_logger_init(struct iio_sd_logger **logger,
+			   const struct iio_sd_logger_init_param *param)
+{
+	struct iio_sd_logger *ldesc;
+	int32_t ret;
+
+	if (!logger || !param || !param->dev || !param->buffer ||
+	    !param->buffer->buf || !param->prefix ||
+	    param->block_size % FF_MAX_SS)
+		return -EINVAL;
+
+	ldesc = calloc(1, sizeof(*ldesc));
+	if (!ldesc)
+		return -ENOMEM;
+
+	ret = iio_sd_logger_fill_header(ldesc, param);
+	if (ret) {
+		free(ldesc);
+		return ret;
+	}
+
+	ldesc->buffer = param->buffer;
+	ldesc->prefix = param->prefix;
+	ldesc->block_size = param->block_size;
+	ldesc->file_size = param->file_size ? param->file_size :
+			   IIO_SD_LOGGER_DEFAULT_FILE_SIZE;
+	*logger = ldesc;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Write the complete blocks available in the device buffer. To be
+ * called periodically, often enough for the device buffer not to overrun.
+ * @param logger - Logger descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_sd_logger_process(struct iio_sd_logger *logger)
+{
+	if (!logger)
+		return -EINVAL;
+
+	return iio_sd_logger_drain(logger, false);
+}
+
+/**
+ * @brief Write all the buffered data and close the current file. Logging
+ * continues in a new file once iio_sd_logger_process() finds new data.
+ * @param logger - Logger descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_sd_logger_stop(struct iio_sd_logger *logger)
+{
+	int32_t ret;
+
+	if (!logger)
+		return -EINVAL;
+
+	ret = iio_sd_logger_drain(logger, true);
+	if (logger->file_open) {
+		if (ret)
+			iio_sd_logger_close(logger);
+		else
+			ret = iio_sd_logger_close(logger);
+	}
+
+	return ret;
+}
+
+/**
+ * @brief Free the logger. Call iio_sd_logger_stop() first to keep the
+ * buffered data.
+ * @param logger - Logger descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_sd_logger_remove(struct iio_sd_logger *logger)
+{
+	if (!logger)
+		return -EINVAL;
+
+	if (logger->file_open)
+		f_close(&logger->file);
+	free(logger->staging);
+	free(logger);
+
+	return SUCCESS;
+}
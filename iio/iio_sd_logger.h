@@ -0,0 +1,164 @@
+/***************************************************************************//**
+ *   @file   iio_sd_logger.h
+ *   @brief  Logs an IIO device buffer to files on an SD card.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef IIO_SD_LOGGER_H
+#define IIO_SD_LOGGER_H
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include "iio_types.h"
+#include "ff.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define IIO_SD_LOGGER_MAGIC		"IIOL"
+#define IIO_SD_LOGGER_VERSION		1
+/* The header takes one sector, data starts sector aligned */
+#define IIO_SD_LOGGER_HEADER_SIZE	512
+#define IIO_SD_LOGGER_MAX_CHANNELS	32
+#define IIO_SD_LOGGER_DEFAULT_FILE_SIZE	(64u * 1024u * 1024u)
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct iio_sd_logger_ch
+ * @brief Description of one logged channel, as stored in the file header.
+ */
+struct iio_sd_logger_ch {
+	/** Index of the channel in the device */
+	uint8_t		index;
+	/** enum iio_chan_type */
+	uint8_t		ch_type;
+	/** Channel number */
+	uint8_t		channel;
+	/** scan_type */
+	uint8_t		sign;
+	uint8_t		realbits;
+	uint8_t		storagebits;
+	uint8_t		shift;
+	uint8_t		is_big_endian;
+} __attribute__((packed));
+
+/**
+ * @struct iio_sd_logger_header
+ * @brief Header written in the first sector of every file. All the fields
+ * are little endian. Scans of the active channels, in index order, follow
+ * the header.
+ */
+struct iio_sd_logger_header {
+	char			magic[4];
+	uint16_t		version;
+	uint16_t		header_size;
+	/** Device name */
+	char			name[32];
+	/** Number of the file in the sequence, starting from 0 */
+	uint32_t		file_index;
+	uint32_t		active_mask;
+	uint32_t		bytes_per_scan;
+	uint32_t		nb_channels;
+	/** Overruns counted since the logger was started, at file close */
+	uint32_t		overruns;
+	uint32_t		reserved;
+	/** Bytes of data after the header, set at file close */
+	uint64_t		data_len;
+	struct iio_sd_logger_ch	channels[IIO_SD_LOGGER_MAX_CHANNELS];
+} __attribute__((packed));
+
+/**
+ * @struct iio_sd_logger_init_param
+ * @brief Logger initialization parameters.
+ */
+struct iio_sd_logger_init_param {
+	/** Device name written in the file headers */
+	const char		*name;
+	/** Device descriptor, for the channel scan types */
+	struct iio_device	*dev;
+	/** Device buffer to be drained, active_mask and bytes_per_scan set */
+	struct iio_buffer	*buffer;
+	/** Files are named <prefix>NNN.BIN. Keep the prefix to 5 characters
+	 *  when FatFs long file names are disabled. */
+	const char		*prefix;
+	/** Size of a file, rounded up to a whole number of clusters.
+	 *  IIO_SD_LOGGER_DEFAULT_FILE_SIZE if 0. */
+	uint32_t		file_size;
+	/** Bytes written at once, multiple of 512. One cluster if 0. */
+	uint32_t		block_size;
+};
+
+/**
+ * @struct iio_sd_logger
+ * @brief Logger descriptor.
+ */
+struct iio_sd_logger {
+	struct iio_buffer	*buffer;
+	const char		*prefix;
+	uint32_t		file_size;
+	uint32_t		block_size;
+	/** Used when a block wraps around the end of the device buffer */
+	uint8_t			*staging;
+	uint32_t		staged;
+	/** Current file */
+	FIL			file;
+	bool			file_open;
+	/** Write position in the current file */
+	uint32_t		pos;
+	struct iio_sd_logger_header	header;
+	/** Statistics */
+	uint32_t		overruns;
+	uint32_t		files;
+	uint64_t		bytes_written;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+int32_t iio_sd_logger_init(struct iio_sd_logger **logger,
+			   const struct iio_sd_logger_init_param *param);
+int32_t iio_sd_logger_process(struct iio_sd_logger *logger);
+int32_t iio_sd_logger_stop(struct iio_sd_logger *logger);
+int32_t iio_sd_logger_remove(struct iio_sd_logger *logger);
+
+#endif /* IIO_SD_LOGGER_H */
@@ -331,6 +331,7 @@ int32_t iiod_copy_ops(struct iiod_ops *ops, struct iiod_ops *new_ops)
 
 	ops->recv = new_ops->recv;
 	ops->send = new_ops->send;
+	ops->sendv = new_ops->sendv;
 
 	ops->open = SET_DUMMY_IF_NULL(new_ops->open, dummy_open);
 	ops->close = SET_DUMMY_IF_NULL(new_ops->close, dummy_close);
@@ -490,21 +491,84 @@ static int32_t rw_iiod_buff(struct iiod_desc *desc, struct iiod_conn_priv *conn,
 		if (IS_ERR_VALUE(ret))
 			return ret;
 
+		if (flags & IIOD_WR)
+			IIOD_STAT_ADD(desc, conn, bytes_sent, ret);
+		else
+			IIOD_STAT_ADD(desc, conn, bytes_recv, ret);
 		buf->idx += ret;
 		if (ret < len)
 			return -EAGAIN;
 	}
 
-	if (flags & IIOD_ENDL) {
-		ret = desc->ops.send(&ctx, (uint8_t *)"\n", 1);
+	return SUCCESS;
+}
+
+/*
+ * Send the result of a command without blocking: the value followed by "\n"
+ * if write_val is set, then buf followed by "\n" if buf is not empty.
+ * All the pieces go out with a single sendv call when the application
+ * provides it. Returns 0 when done and -EAGAIN while there is still data to
+ * be sent.
+ */
+static int32_t iiod_send_result(struct iiod_desc *desc,
+				struct iiod_conn_priv *conn)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	struct iiod_run_cmd_result *res = &conn->res;
+	struct iiod_iovec iov[3];
+	uint32_t cnt, total, skip, i;
+	int32_t ret;
+
+	cnt = 0;
+	if (res->write_val) {
+		if (conn->nb_buf.len == 0) {
+			conn->nb_buf.buf = conn->parser_buf;
+			ret = sprintf(conn->nb_buf.buf, "%"PRIi32"\n", res->val);
+			conn->nb_buf.len = ret;
+			conn->nb_buf.idx = 0;
+		}
+		iov[cnt].buf = (uint8_t *)conn->nb_buf.buf;
+		iov[cnt++].len = conn->nb_buf.len;
+	}
+	if (res->buf.buf && res->buf.len) {
+		iov[cnt].buf = (uint8_t *)res->buf.buf;
+		iov[cnt++].len = res->buf.len;
+		iov[cnt].buf = (uint8_t *)"\n";
+		iov[cnt++].len = 1;
+	}
+
+	/* Drop what was already sent */
+	total = 0;
+	for (i = 0; i < cnt; i++)
+		total += iov[i].len;
+	skip = res->sent;
+	i = 0;
+	while (i < cnt && skip >= iov[i].len)
+		skip -= iov[i++].len;
+	if (i == cnt)
+		return SUCCESS;
+	iov[i].buf += skip;
+	iov[i].len -= skip;
+
+	if (desc->ops.sendv) {
+		ret = desc->ops.sendv(&ctx, &iov[i], cnt - i);
 		if (IS_ERR_VALUE(ret))
 			return ret;
-
-		if (ret != 1)
-			return -EAGAIN;
+		IIOD_STAT_ADD(desc, conn, bytes_sent, ret);
+		res->sent += ret;
+	} else {
+		for (; i < cnt; i++) {
+			ret = desc->ops.send(&ctx, iov[i].buf, iov[i].len);
+			if (IS_ERR_VALUE(ret))
+				return ret;
+			IIOD_STAT_ADD(desc, conn, bytes_sent, ret);
+			res->sent += ret;
+			if ((uint32_t)ret < iov[i].len)
+				break;
+		}
 	}
 
-	return SUCCESS;
+	return res->sent < total ? -EAGAIN : SUCCESS;
 }
 
 static int32_t do_read_buff(struct iiod_desc *desc, struct iiod_conn_priv *conn)
@@ -680,6 +744,7 @@ static int32_t iiod_read_line(struct iiod_desc *desc,
 		if (IS_ERR_VALUE(ret))
 			goto end;
 
+		IIOD_STAT_ADD(desc, conn, bytes_recv, ret);
 		if (conn->parser_idx == 0 && (*ch == '\n' || *ch == '\r'))
 			continue ;
 
@@ -748,34 +813,16 @@ static int32_t iiod_run_state(struct iiod_desc *desc,
 
 		return SUCCESS;
 	case IIOD_WRITING_CMD_RESULT:
-		/* Write result or the length of data to be sent*/
-		if (conn->res.write_val) {
-			if (conn->nb_buf.len == 0) {
-				conn->nb_buf.buf = conn->parser_buf;
-				ret = sprintf(conn->nb_buf.buf, "%"PRIi32,
-					      conn->res.val);
-				conn->nb_buf.len = ret;
-				conn->nb_buf.idx = 0;
-			}
-			/* Non-blocking. Will enter here until val is sent */
-			if (conn->nb_buf.idx < conn->nb_buf.len) {
-				ret = rw_iiod_buff(desc, conn, &conn->nb_buf,
-						   IIOD_WR | IIOD_ENDL);
-				if (IS_ERR_VALUE(ret))
-					return ret;
-			}
-		}
-		/* Send buf from result. Non blocking */
-		if (conn->res.buf.buf &&
-		    conn->res.buf.idx < conn->res.buf.len) {
-			ret = rw_iiod_buff(desc, conn, &conn->res.buf,
-					   IIOD_WR | IIOD_ENDL);
-			if (IS_ERR_VALUE(ret))
-				return ret;
-		}
+		/* Write result or the length of data to be sent and the buf
+		 * from result. Non blocking, will enter here until all sent */
+		ret = iiod_send_result(desc, conn);
+		if (IS_ERR_VALUE(ret))
+			return ret;
 
-		if (conn->cmd_data.cmd != IIOD_CMD_READBUF &&
-		    conn->cmd_data.cmd != IIOD_CMD_WRITEBUF) {
+		/* A failed refill has no data to follow the result */
+		if ((conn->cmd_data.cmd != IIOD_CMD_READBUF &&
+		     conn->cmd_data.cmd != IIOD_CMD_WRITEBUF) ||
+		    (int32_t)conn->res.val < 0) {
 			conn->state = IIOD_LINE_DONE;
 		} else {
 			/* Preapre for IIOD_RW_BUF state */
@@ -795,14 +842,12 @@ static int32_t iiod_run_state(struct iiod_desc *desc,
 				conn->res.write_val = 1;
 				ret = desc->ops.push_buffer(&ctx,
 							    conn->cmd_data.device);
-				if (IS_ERR_VALUE(ret)) {
-					conn->res.val = ret;
-					conn->state = IIOD_LINE_DONE;
-
-					return SUCCESS;
-				}
 				memset(&conn->res.buf, 0, sizeof(conn->res.buf));
-				conn->res.val = conn->cmd_data.bytes_count;
+				conn->res.sent = 0;
+				if (IS_ERR_VALUE(ret))
+					conn->res.val = ret;
+				else
+					conn->res.val = conn->cmd_data.bytes_count;
 				conn->cmd_data.cmd = IIOD_CMD_PRINT;
 				conn->state = IIOD_WRITING_CMD_RESULT;
 
@@ -842,14 +887,53 @@ int32_t iiod_conn_step(struct iiod_desc *desc, uint32_t conn_id)
 	conn = &desc->conns[conn_id];
 	do {
 		ret = iiod_run_state(desc, conn);
-		if (ret == -EAGAIN)
+		if (ret == -EAGAIN) {
+			IIOD_STAT_ADD(desc, conn, eagain, 1);
 			return ret;
+		}
 		if (IS_ERR_VALUE(ret) || conn->state == IIOD_LINE_DONE)
 			break;
 		//The loop will continue because the state was changed.
 	} while (true);
 
+	if (conn->state == IIOD_LINE_DONE) {
+		IIOD_STAT_ADD(desc, conn, cmds, 1);
+		if (conn->res.write_val && (int32_t)conn->res.val < 0)
+			IIOD_STAT_ADD(desc, conn, errors, 1);
+	}
+
 	conn_clean_state(conn);
 
 	return ret;
 }
+
+#ifdef IIO_PERF
+int32_t iiod_get_stats(struct iiod_desc *desc, uint32_t conn_id,
+		       struct iiod_conn_stats *stats)
+{
+	if (!desc || !stats || conn_id > IIOD_MAX_CONNECTIONS)
+		return -EINVAL;
+
+	if (conn_id == IIOD_MAX_CONNECTIONS) {
+		*stats = desc->stats;
+
+		return SUCCESS;
+	}
+
+	if (!desc->conns[conn_id].used)
+		return -ENOENT;
+
+	*stats = desc->conns[conn_id].stats;
+
+	return SUCCESS;
+}
+
+void iiod_reset_stats(struct iiod_desc *desc)
+{
+	uint32_t i;
+
+	for (i = 0; i < IIOD_MAX_CONNECTIONS; i++)
+		memset(&desc->conns[i].stats, 0, sizeof(desc->conns[i].stats));
+	memset(&desc->stats, 0, sizeof(desc->stats));
+}
+#endif
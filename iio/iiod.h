@@ -83,6 +83,26 @@ struct iiod_conn_data {
 	uint32_t len;
 };
 
+/* One buffer of a sendv call */
+struct iiod_iovec {
+	uint8_t *buf;
+	uint32_t len;
+};
+
+#ifdef IIO_PERF
+/* Traffic counters of a connection */
+struct iiod_conn_stats {
+	uint64_t bytes_sent;
+	uint64_t bytes_recv;
+	/* Commands handled */
+	uint32_t cmds;
+	/* Commands that returned an error code */
+	uint32_t errors;
+	/* Steps that returned -EAGAIN, waiting for I/O */
+	uint32_t eagain;
+};
+#endif
+
 /* Functions should return a negative error code on failure */
 struct iiod_ops {
 	/*
@@ -96,6 +116,13 @@ struct iiod_ops {
 	 */
 	int (*send)(struct iiod_ctx *ctx, uint8_t *buf, uint32_t len);
 	int (*recv)(struct iiod_ctx *ctx, uint8_t *buf, uint32_t len);
+	/*
+	 * Optional. Send cnt buffers, in order, with one call. Same return
+	 * values as send. When set, a command result (value, payload and line
+	 * ends) is sent with one call instead of one send per piece.
+	 */
+	int (*sendv)(struct iiod_ctx *ctx, struct iiod_iovec *iov,
+		     uint32_t cnt);
 
 	/*
 	 * This is the equivalent of libiio iio_device_create_buffer.
@@ -186,4 +213,15 @@ int32_t iiod_conn_remove(struct iiod_desc *desc, uint32_t conn_id,
 /* Advance in the state machine of a connection. Will not block */
 int32_t iiod_conn_step(struct iiod_desc *desc, uint32_t conn_id);
 
+#ifdef IIO_PERF
+/*
+ * Get the counters of conn_id. With conn_id == IIOD_MAX_CONNECTIONS get the
+ * totals of all the connections, removed ones included.
+ */
+int32_t iiod_get_stats(struct iiod_desc *desc, uint32_t conn_id,
+		       struct iiod_conn_stats *stats);
+/* Clear the counters of all the connections and the totals */
+void iiod_reset_stats(struct iiod_desc *desc);
+#endif
+
 #endif //IIOD_H
@@ -41,7 +41,6 @@
 #define IIOD_PRIVATE_H
 
 #define IIOD_WR				0x1
-#define IIOD_ENDL			0x2
 #define IIOD_RD				0x4
 #define IIOD_PARSER_MAX_BUF_SIZE	128
 
@@ -50,6 +49,16 @@
 #define IIOD_CTX(desc, conn) {.instance = (desc)->app_instance,\
 			      .conn = (conn)->conn}
 
+/* Add val to a counter of conn and to the totals */
+#ifdef IIO_PERF
+#define IIOD_STAT_ADD(desc, conn, field, val) do {\
+		(conn)->stats.field += (val);\
+		(desc)->stats.field += (val);\
+	} while (0)
+#else
+#define IIOD_STAT_ADD(desc, conn, field, val) do {} while (0)
+#endif
+
 
 /* Used to store a string and its size */
 struct iiod_str {
@@ -111,6 +120,8 @@ struct iiod_run_cmd_result {
 	bool write_val;
 	/* If buf.len != 0 buf has to be sent */
 	struct iiod_buff buf;
+	/* Bytes of the result (val line, buf and its line end) already sent */
+	uint32_t sent;
 };
 
 /* Internal structure to handle a connection state */
@@ -157,6 +168,10 @@ struct iiod_conn_priv {
 	char buf_mask[10];
 	/* Context for strtok_r function */
 	char *strtok_ctx;
+#ifdef IIO_PERF
+	/* Traffic counters */
+	struct iiod_conn_stats stats;
+#endif
 };
 
 /* Private iiod information */
@@ -171,6 +186,10 @@ struct iiod_desc {
 	char *xml;
 	/* XML length in bytes */
 	uint32_t xml_len;
+#ifdef IIO_PERF
+	/* Counters of all the connections */
+	struct iiod_conn_stats stats;
+#endif
 };
 
 #endif //IIOD_PRIVATE_H
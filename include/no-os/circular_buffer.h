@@ -79,6 +79,8 @@ struct circular_buffer {
 	struct cb_ptr	write;
 	/** Read pointer */
 	struct cb_ptr	read;
+	/** Number of times unread data was overwritten */
+	uint32_t	overruns;
 };
 
 /******************************************************************************/
@@ -44,6 +44,27 @@
 /******************************************************************************/
 #include <stdint.h>
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+/**
+ * Cache the rate between clk_recalc_rate() calls and skip clk_set_rate() when
+ * the requested rate is already programmed. Only for providers that keep
+ * their rate across resets, otherwise every call reaches the provider.
+ */
+#define CLK_CACHE_RATE		(1 << 0)
+/** Forward clk_set_rate() to the parent when the clock has no set_rate op */
+#define CLK_SET_RATE_PARENT	(1 << 1)
+/**
+ * Reference count clk_enable()/clk_disable() and enable the parent first,
+ * otherwise every call reaches the provider.
+ */
+#define CLK_ENABLE_REFCOUNT	(1 << 2)
+/* Internal: rate change scheduled by clk_set_rates() */
+#define CLK_RATE_PENDING	(1 << 8)
+/* Internal: req_rate is programmed and the parent did not change since */
+#define CLK_RATE_APPLIED	(1 << 9)
+
 /******************************************************************************/
 /************************* Structure Declarations *****************************/
 /******************************************************************************/
@@ -56,16 +77,48 @@ struct clk_hw {
 	int32_t (*dev_clk_round_rate)();
 };
 
+/**
+ * @struct clk
+ * @brief Clock node. The fields after name are managed by the framework and
+ * must start zeroed (static/calloc storage or clk_register()).
+ */
 struct clk {
 	struct clk_hw	*hw;
 	uint32_t	hw_ch_num;
 	const char	*name;
+	/** CLK_* flags */
+	uint32_t	flags;
+	/** Clock this one is derived from, NULL for a root clock */
+	struct clk	*parent;
+	/** First child, linked through sibling */
+	struct clk	*child;
+	struct clk	*sibling;
+	/** Cached rate, 0 when unknown */
+	uint64_t	rate;
+	/** Last rate requested by a consumer, re-applied when the parent changes */
+	uint64_t	req_rate;
+	/** clk_enable() calls not balanced by clk_disable(), CLK_ENABLE_REFCOUNT */
+	uint32_t	enable_count;
+};
+
+/**
+ * @struct clk_rate_request
+ * @brief One entry of a batched rate change, see clk_set_rates().
+ */
+struct clk_rate_request {
+	struct clk	*clk;
+	uint64_t	rate;
 };
 
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
 
+/* Reset the framework state of the clock and attach it to a parent. */
+int32_t clk_register(struct clk *clk,
+		     struct clk *parent,
+		     uint32_t flags);
+
 /* Start the clock. */
 int32_t clk_enable(struct clk * clk);
 
@@ -85,4 +138,11 @@ int32_t clk_round_rate(struct clk *clk,
 int32_t clk_set_rate(struct clk *clk,
 		     uint64_t rate);
 
+/* Change the frequency of several clocks, parents first. */
+int32_t clk_set_rates(struct clk_rate_request *req,
+		      uint32_t count);
+
+/* Drop the cached rate of the clock and of everything derived from it. */
+void clk_invalidate_rate(struct clk *clk);
+
 #endif // CLK_H_
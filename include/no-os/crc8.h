@@ -47,6 +47,12 @@
 #define DECLARE_CRC8_TABLE(_table) \
 	static uint8_t _table[CRC8_TABLE_SIZE]
 
+/* x^8 + x^2 + x^1 + 1, the CRC-8 used by most of the ADI SPI devices */
+#define CRC8_POLY_07	0x07
+
+/* Precomputed table for CRC8_POLY_07, placed in read-only memory */
+extern const uint8_t crc8_table_07[CRC8_TABLE_SIZE];
+
 void crc8_populate_msb(uint8_t * table, const uint8_t polynomial);
 uint8_t crc8(const uint8_t * table, const uint8_t *pdata, size_t nbytes,
 	     uint8_t crc);
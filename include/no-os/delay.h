@@ -45,6 +45,99 @@
 /******************************************************************************/
 
 #include <stdint.h>
+#include "no-os/error.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Number of back to back evaluations of the condition in poll_timeout_us() */
+#ifndef POLL_SPIN_COUNT
+#define POLL_SPIN_COUNT		16
+#endif
+
+/* Number of call sites tracked separately by the delay accounting */
+#ifndef DELAY_ACCT_SITES
+#define DELAY_ACCT_SITES	32
+#endif
+
+/**
+ * @brief Poll a condition until it is true or the timeout expires.
+ * The condition is first evaluated spins times back to back, which catches
+ * the common case of a register that is ready after a few reads without
+ * sleeping. After that the delay between evaluations starts at 1us and
+ * doubles as long as it does not exceed interval_us. The condition is
+ * evaluated a last time once the timeout expired.
+ * @param cond - Expression evaluated on every iteration.
+ * @param spins - Number of evaluations before the first delay.
+ * @param interval_us - Longest delay between two evaluations.
+ * @param timeout_us - Sum of the delays after which polling stops.
+ * @return 0 once cond is true, -ETIMEDOUT otherwise.
+ */
+#define poll_timeout_spin_us(cond, spins, interval_us, timeout_us) ({	\
+	uint32_t __spin = (spins);					\
+	uint32_t __delay = 1;						\
+	uint32_t __elapsed = 0;						\
+	int32_t __ret;							\
+	while (1) {							\
+		if (cond) {						\
+			__ret = 0;					\
+			break;						\
+		}							\
+		if (__elapsed >= (uint32_t)(timeout_us)) {		\
+			__ret = -ETIMEDOUT;				\
+			break;						\
+		}							\
+		if (__spin) {						\
+			__spin--;					\
+			continue;					\
+		}							\
+		udelay(__delay);					\
+		__elapsed += __delay;					\
+		if (__delay * 2 <= (uint32_t)(interval_us))		\
+			__delay *= 2;					\
+	}								\
+	__ret;								\
+})
+
+/* poll_timeout_spin_us() with POLL_SPIN_COUNT spins */
+#define poll_timeout_us(cond, interval_us, timeout_us)			\
+	poll_timeout_spin_us(cond, POLL_SPIN_COUNT, interval_us, timeout_us)
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct delay_acct_site
+ * @brief Delay requested from one call site.
+ */
+struct delay_acct_site {
+	/** Calling function */
+	const char	*func;
+	/** Line of the call */
+	uint32_t	line;
+	/** Number of calls */
+	uint32_t	count;
+	/** Sum of the requested delays */
+	uint64_t	total_us;
+};
+
+/**
+ * @struct delay_acct
+ * @brief Delay accounting state.
+ */
+struct delay_acct {
+	/** Sum of all the requested delays */
+	uint64_t		total_us;
+	/** Number of calls */
+	uint32_t		count;
+	/** Calls not tracked because sites was full */
+	uint32_t		untracked;
+	/** Number of used entries of sites */
+	uint32_t		nb_sites;
+	struct delay_acct_site	sites[DELAY_ACCT_SITES];
+};
 
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
@@ -56,4 +149,29 @@ void udelay(uint32_t usecs);
 /* Generate miliseconds delay. */
 void mdelay(uint32_t msecs);
 
+/* Account and generate microseconds delay. */
+void delay_acct_udelay(uint32_t usecs, const char *func, uint32_t line);
+
+/* Account and generate miliseconds delay. */
+void delay_acct_mdelay(uint32_t msecs, const char *func, uint32_t line);
+
+/* Get the delay accounting state. */
+const struct delay_acct *delay_acct_get(void);
+
+/* Clear the delay accounting. */
+void delay_acct_reset(void);
+
+/* Print the delay per call site, longest first. */
+void delay_acct_print(void);
+
+/*
+ * Built with NO_OS_DELAY_ACCT, the delays requested through udelay() and
+ * mdelay() are summed per call site (function and line). The platform
+ * implementations #undef these wrappers.
+ */
+#ifdef NO_OS_DELAY_ACCT
+#define udelay(usecs)	delay_acct_udelay(usecs, __func__, __LINE__)
+#define mdelay(msecs)	delay_acct_mdelay(msecs, __func__, __LINE__)
+#endif
+
 #endif // DELAY_H_
@@ -0,0 +1,145 @@
+/***************************************************************************//**
+ *   @file   drdy_acq.h
+ *   @brief  Header file of the data-ready driven acquisition helper.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef DRDY_ACQ_H_
+#define DRDY_ACQ_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "no-os/irq.h"
+#include "no-os/circular_buffer.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct drdy_acq_init_param
+ * @brief Structure holding the parameters for the acquisition initialization.
+ */
+struct drdy_acq_init_param {
+	/** Interrupt controller handling the DRDY/BUSY pin (e.g. a GPIO IRQ
+	 *  controller) */
+	struct irq_ctrl_desc *irq_ctrl;
+	/** Interrupt identifier of the DRDY/BUSY pin */
+	uint32_t irq_id;
+	/** Edge signaling that a sample is available */
+	enum irq_trig_level trig;
+	/** Size in bytes of a sample (all the channels of one conversion) */
+	uint32_t sample_size;
+	/** Number of samples the ring can hold */
+	uint32_t nb_samples;
+	/** If set, the interrupt only flags the sample and the read is done by
+	 *  drdy_acq_process(). Otherwise the sample is read in the interrupt. */
+	bool deferred;
+	/** Device passed to the callbacks */
+	void *dev;
+	/** Read one sample from the device into data. Mandatory. */
+	int32_t (*read_sample)(void *dev, uint8_t *data);
+	/** Start the next conversion. Optional, for parts paced by CONVST. */
+	int32_t (*trigger)(void *dev);
+};
+
+/**
+ * @struct drdy_acq_desc
+ * @brief Acquisition descriptor.
+ */
+struct drdy_acq_desc {
+	/** Interrupt controller */
+	struct irq_ctrl_desc *irq_ctrl;
+	/** Interrupt identifier */
+	uint32_t irq_id;
+	/** Edge signaling that a sample is available */
+	enum irq_trig_level trig;
+	/** Sample size in bytes */
+	uint32_t sample_size;
+	/** Read done by drdy_acq_process() */
+	bool deferred;
+	/** Device passed to the callbacks */
+	void *dev;
+	/** Read one sample */
+	int32_t (*read_sample)(void *dev, uint8_t *data);
+	/** Start the next conversion */
+	int32_t (*trigger)(void *dev);
+	/** Samples ring */
+	struct circular_buffer *ring;
+	/** Scratch buffer for one sample */
+	uint8_t *sample;
+	/** Number of DRDY events not yet handled (deferred mode) */
+	volatile uint32_t pending;
+	/** Number of samples dropped because the ring was full or because a
+	 *  new DRDY event occurred before the previous sample was read */
+	volatile uint32_t overruns;
+	/** Number of failed sample reads */
+	volatile uint32_t errors;
+	/** Acquisition running */
+	volatile bool running;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Initialize the acquisition. */
+int32_t drdy_acq_init(struct drdy_acq_desc **desc,
+		      const struct drdy_acq_init_param *param);
+
+/* Free the resources allocated by drdy_acq_init(). */
+int32_t drdy_acq_remove(struct drdy_acq_desc *desc);
+
+/* Enable the DRDY interrupt and start the acquisition. */
+int32_t drdy_acq_start(struct drdy_acq_desc *desc);
+
+/* Disable the DRDY interrupt. */
+int32_t drdy_acq_stop(struct drdy_acq_desc *desc);
+
+/* Read the pending sample in deferred mode. */
+int32_t drdy_acq_process(struct drdy_acq_desc *desc);
+
+/* Get the number of samples available in the ring. */
+int32_t drdy_acq_available(struct drdy_acq_desc *desc, uint32_t *nb_samples);
+
+/* Copy samples from the ring. */
+int32_t drdy_acq_read(struct drdy_acq_desc *desc, void *data,
+		      uint32_t nb_samples);
+
+#endif // DRDY_ACQ_H_
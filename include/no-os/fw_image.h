@@ -0,0 +1,164 @@
+/***************************************************************************//**
+ *   @file   fw_image.h
+ *   @brief  Header file of the firmware image container and streaming decoder.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef FW_IMAGE_H_
+#define FW_IMAGE_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** Container magic: "NFWI" */
+#define FW_IMAGE_MAGIC		0x4957464E
+#define FW_IMAGE_VERSION	1
+/** Size of the container header in bytes */
+#define FW_IMAGE_HEADER_SIZE	16
+/** Maximum LZSS window size (log2) accepted by the decoder */
+#define FW_IMAGE_MAX_WINDOW_SZ2	14
+/** Size of the input buffer used with reader sources */
+#define FW_IMAGE_READ_BUFF_SIZE	256
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @enum fw_image_codec
+ * @brief Encoding of the image payload.
+ */
+enum fw_image_codec {
+	/** Payload stored as is */
+	FW_IMAGE_CODEC_RAW,
+	/** LZSS bit stream, heatshrink compatible */
+	FW_IMAGE_CODEC_LZSS,
+};
+
+/**
+ * @struct fw_image_reader
+ * @brief Callbacks used to fetch a container stored outside the address
+ * space, e.g. a file on the SD card (wrap f_read()/f_lseek()).
+ */
+struct fw_image_reader {
+	/** Read up to len bytes, return the number of bytes read or a negative
+	 *  error code. */
+	int32_t (*read)(void *ctx, uint8_t *buf, uint32_t len);
+	/** Go back to the start of the container. Optional, needed only by
+	 *  fw_image_rewind(). */
+	int32_t (*rewind)(void *ctx);
+	/** Parameter passed to the callbacks */
+	void *ctx;
+};
+
+/**
+ * @struct fw_image
+ * @brief Firmware image descriptor.
+ */
+struct fw_image {
+	/** Memory source: start of the payload (NULL for reader sources) */
+	const uint8_t *mem;
+	/** Memory source: size of the whole mapped data */
+	uint32_t mem_size;
+	/** Memory source: offset of the payload in mem */
+	uint32_t mem_start;
+	/** Memory source: read position */
+	uint32_t mem_pos;
+	/** Reader source */
+	struct fw_image_reader reader;
+	/** Reader source: input buffer */
+	uint8_t *in_buff;
+	/** Reader source: valid bytes in in_buff */
+	uint32_t in_len;
+	/** Reader source: read position in in_buff */
+	uint32_t in_pos;
+	/** Payload encoding */
+	enum fw_image_codec codec;
+	/** Decoded image size */
+	uint32_t size;
+	/** Decoded bytes so far */
+	uint32_t pos;
+	/** LZSS: log2 of the window size */
+	uint8_t window_sz2;
+	/** LZSS: log2 of the maximum match length */
+	uint8_t lookahead_sz2;
+	/** LZSS: history of the decoded data */
+	uint8_t *window;
+	/** LZSS: write position in window */
+	uint32_t window_pos;
+	/** LZSS: current input byte */
+	uint8_t bit_buff;
+	/** LZSS: mask of the next bit to be read from bit_buff */
+	uint8_t bit_mask;
+	/** LZSS: distance of the back-reference being copied */
+	uint16_t br_offset;
+	/** LZSS: bytes left to copy from the back-reference */
+	uint16_t br_count;
+	/** Platform specific data (e.g. a mapping to be released) */
+	void *extra;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Open an image stored in memory (flash array or mapped file). */
+int32_t fw_image_init_mem(struct fw_image **img, const uint8_t *data,
+			  uint32_t size);
+
+/* Open an image fetched through reader callbacks. */
+int32_t fw_image_init_reader(struct fw_image **img,
+			     const struct fw_image_reader *reader);
+
+/* Free the resources allocated by fw_image_init_*(). */
+int32_t fw_image_remove(struct fw_image *img);
+
+/* Decode the next bytes of the image. */
+int32_t fw_image_read(struct fw_image *img, uint8_t *buf, uint32_t len);
+
+/* Restart decoding from the beginning of the image. */
+int32_t fw_image_rewind(struct fw_image *img);
+
+/* Decoded image size. */
+uint32_t fw_image_size(struct fw_image *img);
+
+#endif // FW_IMAGE_H_
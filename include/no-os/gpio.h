@@ -126,6 +126,11 @@ struct gpio_platform_ops {
 	int32_t (*gpio_ops_set_value)(struct gpio_desc *, uint8_t);
 	/** gpio get value function pointer */
 	int32_t (*gpio_ops_get_value)(struct gpio_desc *, uint8_t *);
+	/** gpio set values function pointer, optional */
+	int32_t (*gpio_ops_set_values)(struct gpio_desc **, uint8_t,
+				       const uint8_t *);
+	/** gpio get values function pointer, optional */
+	int32_t (*gpio_ops_get_values)(struct gpio_desc **, uint8_t, uint8_t *);
 };
 
 /******************************************************************************/
@@ -162,4 +167,12 @@ int32_t gpio_set_value(struct gpio_desc *desc,
 int32_t gpio_get_value(struct gpio_desc *desc,
 		       uint8_t *value);
 
+/* Set the values of several GPIOs. */
+int32_t gpio_set_values(struct gpio_desc **desc, uint8_t num,
+			const uint8_t *values);
+
+/* Get the values of several GPIOs. */
+int32_t gpio_get_values(struct gpio_desc **desc, uint8_t num,
+			uint8_t *values);
+
 #endif // GPIO_H_
@@ -91,6 +91,21 @@ typedef struct i2c_desc {
 	void		*extra;
 } i2c_desc;
 
+/**
+ * @struct i2c_xfer
+ * @brief Structure describing one read or write of an I2C transfer
+ */
+struct i2c_xfer {
+	/** Buffer with the data to send or where to store the received data */
+	uint8_t		*data;
+	/** Number of bytes to transfer */
+	uint8_t		bytes_number;
+	/** If set, a stop condition is generated after this message */
+	uint8_t		stop_bit;
+	/** If set, data is read from the slave, otherwise it is written */
+	uint8_t		read;
+};
+
 /**
  * @struct i2c_platform_ops
  * @brief Structure holding i2c function pointers that point to the platform
@@ -105,6 +120,10 @@ struct i2c_platform_ops {
 	int32_t (*i2c_ops_read)(struct i2c_desc *, uint8_t *, uint8_t, uint8_t);
 	/** i2c remove function pointer */
 	int32_t (*i2c_ops_remove)(struct i2c_desc *);
+	/** i2c asynchronous transfer function pointer */
+	int32_t (*i2c_ops_transfer_async)(struct i2c_desc *, struct i2c_xfer *,
+					  uint32_t, void (*)(void *, int32_t),
+					  void *);
 };
 
 /******************************************************************************/
@@ -130,4 +149,11 @@ int32_t i2c_read(struct i2c_desc *desc,
 		 uint8_t bytes_number,
 		 uint8_t stop_bit);
 
+/* Queue an array of reads/writes and call callback when they are done. */
+int32_t i2c_transfer_async(struct i2c_desc *desc,
+			   struct i2c_xfer *xfers,
+			   uint32_t len,
+			   void (*callback)(void *ctx, int32_t status),
+			   void *ctx);
+
 #endif // I2C_H_
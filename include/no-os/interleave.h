@@ -0,0 +1,151 @@
+/***************************************************************************//**
+ *   @file   interleave.h
+ *   @brief  Channel interleave and sample format conversion kernels.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef __INTERLEAVE_H
+#define __INTERLEAVE_H
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/* Maximum number of channels of a scan mask */
+#define INTERLEAVE_MAX_CH	32
+
+/**
+ * @struct interleave_plan
+ * @brief Kernels selected for a channel mask. Move the samples of the active
+ * channels between a buffer of frames (one sample of each active channel,
+ * in increasing channel order) and one buffer per channel.
+ */
+struct interleave_plan {
+	/** Number of active channels */
+	uint32_t nb_ch;
+	/** Indexes of the active channels, in increasing order */
+	uint8_t ch[INTERLEAVE_MAX_CH];
+	/** Size of a sample in bytes */
+	uint32_t size;
+	/** Copy samples from nb_ch channel buffers into frames */
+	void (*interleave)(void *dst, const void * const *src, uint32_t nb_ch,
+			   uint32_t samples);
+	/** Copy samples from frames into nb_ch channel buffers */
+	void (*deinterleave)(void * const *dst, const void *src, uint32_t nb_ch,
+			     uint32_t samples);
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Select the kernels for a channel mask and a sample size (2 or 4 bytes) */
+int32_t interleave_plan_init(struct interleave_plan *plan, uint32_t mask,
+			     uint32_t size);
+
+/* Sign extend, in place, samples of the given number of bits */
+void sample_sign_extend32(int32_t *buf, uint32_t samples, uint32_t bits);
+/* Swap the bytes of 16-bit samples, in place */
+void sample_swab16(uint16_t *buf, uint32_t samples);
+/* Swap the bytes of 32-bit samples, in place */
+void sample_swab32(uint32_t *buf, uint32_t samples);
+
+/**
+ * @brief Convert big endian 16-bit samples to 32-bit.
+ * Inline so that drivers can use it without building interleave.c.
+ * @param dst - Destination buffer of samples 32-bit words.
+ * @param src - Source buffer of 2 * samples bytes.
+ * @param samples - Number of samples.
+ */
+static inline void sample_be16_to_u32(uint32_t *dst, const uint8_t *src,
+				      uint32_t samples)
+{
+	uint32_t i;
+
+	for (i = 0; i < samples; i++, src += 2)
+		dst[i] = ((uint32_t)src[0] << 8) | src[1];
+}
+
+/**
+ * @brief Convert packed big endian 24-bit samples to 32-bit.
+ * Inline so that drivers can use it without building interleave.c.
+ * @param dst - Destination buffer of samples 32-bit words.
+ * @param src - Source buffer of 3 * samples bytes.
+ * @param samples - Number of samples.
+ */
+static inline void sample_be24_to_u32(uint32_t *dst, const uint8_t *src,
+				      uint32_t samples)
+{
+	uint32_t i;
+
+	for (i = 0; i < samples; i++, src += 3)
+		dst[i] = ((uint32_t)src[0] << 16) | ((uint32_t)src[1] << 8) |
+			 src[2];
+}
+
+/**
+ * @brief Interleave samples of the active channels into frames.
+ * @param plan - Plan built by interleave_plan_init().
+ * @param dst - Buffer of samples * plan->nb_ch samples.
+ * @param src - One buffer of samples for each active channel.
+ * @param samples - Number of samples of each channel.
+ */
+static inline void interleave_frames(const struct interleave_plan *plan,
+				     void *dst, const void * const *src,
+				     uint32_t samples)
+{
+	plan->interleave(dst, src, plan->nb_ch, samples);
+}
+
+/**
+ * @brief Split frames into the buffers of the active channels.
+ * @param plan - Plan built by interleave_plan_init().
+ * @param dst - One buffer of samples for each active channel.
+ * @param src - Buffer of samples * plan->nb_ch samples.
+ * @param samples - Number of samples of each channel.
+ */
+static inline void deinterleave_frames(const struct interleave_plan *plan,
+				       void * const *dst, const void *src,
+				       uint32_t samples)
+{
+	plan->deinterleave(dst, src, plan->nb_ch, samples);
+}
+
+#endif // __INTERLEAVE_H
@@ -157,6 +157,9 @@ struct spi_platform_ops {
 	int32_t (*write_and_read)(struct spi_desc *, uint8_t *, uint16_t);
 	/** Iterate over the spi_msg array and send all messages at once */
 	int32_t (*transfer)(struct spi_desc *, struct spi_msg *, uint32_t);
+	/** Queue the spi_msg array and return before the transfer is done */
+	int32_t (*transfer_async)(struct spi_desc *, struct spi_msg *, uint32_t,
+				  void (*)(void *, int32_t), void *);
 	/** SPI remove function pointer */
 	int32_t (*remove)(struct spi_desc *);
 };
@@ -180,5 +183,11 @@ int32_t spi_write_and_read(struct spi_desc *desc,
 /* Iterate over the spi_msg array and send all messages at once */
 int32_t spi_transfer(struct spi_desc *desc, struct spi_msg *msgs, uint32_t len);
 
+/* Queue the spi_msg array and call callback when all messages are sent */
+int32_t spi_transfer_async(struct spi_desc *desc, struct spi_msg *msgs,
+			   uint32_t len,
+			   void (*callback)(void *ctx, int32_t status),
+			   void *ctx);
+
 
 #endif // SPI_H_
@@ -0,0 +1,220 @@
+/***************************************************************************//**
+ *   @file   trace.h
+ *   @brief  Binary event trace ring.
+ *           Timestamped records of SPI transfers, delays and driver phases,
+ *           decoded on the host by tools/scripts/trace_decode.py.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Number of records in the ring, a power of 2 */
+#ifndef TRACE_RING_SIZE
+#define TRACE_RING_SIZE		1024
+#endif
+
+#if TRACE_RING_SIZE & (TRACE_RING_SIZE - 1)
+#error "TRACE_RING_SIZE must be a power of 2"
+#endif
+
+#define TRACE_MAGIC		0x52544f4e	/* "NOTR" */
+#define TRACE_VERSION		1
+
+/*
+ * TRACE_BEGIN/TRACE_END delimit a slice of the timeline and must nest.
+ * The begin arg and the end arg (usually the return code) are both kept.
+ * Built without NO_OS_TRACE they compile to nothing.
+ */
+#ifdef NO_OS_TRACE
+#define TRACE_BEGIN(id, arg)	trace_record(id, TRACE_TYPE_BEGIN, arg)
+#define TRACE_END(id, arg)	trace_record(id, TRACE_TYPE_END, arg)
+#define TRACE_INSTANT(id, arg)	trace_record(id, TRACE_TYPE_INSTANT, arg)
+#define TRACE_COUNTER(id, val)	trace_record(id, TRACE_TYPE_COUNTER, val)
+#else
+#define TRACE_BEGIN(id, arg)	do {} while (0)
+#define TRACE_END(id, arg)	do {} while (0)
+#define TRACE_INSTANT(id, arg)	do {} while (0)
+#define TRACE_COUNTER(id, val)	do {} while (0)
+#endif
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/*
+ * Event ids. trace_decode.py reads the names from this enum, so add new
+ * events here with an explicit value and never renumber the existing ones.
+ */
+enum trace_event {
+	/* arg: chip select << 16 | bytes, end arg: return code */
+	TRACE_EV_SPI = 1,
+	/* arg: requested delay in us */
+	TRACE_EV_DELAY = 2,
+	/* end arg: return code */
+	TRACE_EV_AD9361_INIT = 16,
+	TRACE_EV_AD9361_SETUP = 17,
+	TRACE_EV_AD9361_POST_SETUP = 18,
+	/* arg: register << 16 | mask of the calibration or lock bit */
+	TRACE_EV_AD9361_CAL_WAIT = 19,
+	TRACE_EV_ADRV9002_HW_OPEN = 32,
+	TRACE_EV_ADRV9002_INIT_ANALOG = 33,
+	TRACE_EV_ADRV9002_DIGITAL_INIT = 34,
+	TRACE_EV_ADRV9002_RADIO_INIT = 35,
+	TRACE_EV_ADRV9002_INIT_CALS = 36,
+	TRACE_EV_AD9081_RESET = 48,
+	TRACE_EV_AD9081_SETUP = 49,
+	/* instant, arg: link index << 8 | new state */
+	TRACE_EV_JESD204_LINK_STATE = 64,
+	/* Project specific events start here */
+	TRACE_EV_USER = 0x8000,
+};
+
+enum trace_type {
+	TRACE_TYPE_BEGIN,
+	TRACE_TYPE_END,
+	TRACE_TYPE_INSTANT,
+	TRACE_TYPE_COUNTER,
+};
+
+enum trace_mode {
+	/* Overwrite the oldest records, keeps the last TRACE_RING_SIZE */
+	TRACE_MODE_RING,
+	/* Stop when the ring is full, keeps the first TRACE_RING_SIZE */
+	TRACE_MODE_ONESHOT,
+};
+
+/**
+ * @struct trace_record
+ * @brief One event of the trace.
+ */
+struct trace_record {
+	/** Timestamp, in ticks of the time source */
+	uint32_t	ts;
+	/** enum trace_event */
+	uint16_t	id;
+	/** enum trace_type */
+	uint8_t		type;
+	uint8_t		reserved;
+	uint32_t	arg;
+};
+
+/**
+ * @struct trace_buffer
+ * @brief The trace ring. Its memory is the dump read by the decoder, so it
+ * can also be saved with a debugger.
+ */
+struct trace_buffer {
+	/** TRACE_MAGIC */
+	uint32_t		magic;
+	/** TRACE_VERSION */
+	uint16_t		version;
+	/** sizeof(struct trace_record) */
+	uint16_t		record_size;
+	/** Frequency of the time source */
+	uint32_t		freq_hz;
+	/** Number of records of the ring */
+	uint32_t		size;
+	/** Number of records written since trace_start() */
+	uint32_t		head;
+	/** No record is written once head reaches limit */
+	uint32_t		limit;
+	/** Records, the one written at head n is at n % size */
+	struct trace_record	records[TRACE_RING_SIZE];
+};
+
+/**
+ * @struct trace_init_param
+ * @brief Parameters of trace_start().
+ */
+struct trace_init_param {
+	/** Free running, up-counting time source read on every record */
+	uint32_t	(*timestamp)(void);
+	/** Frequency of the time source */
+	uint32_t	freq_hz;
+	/** Ring or one shot */
+	enum trace_mode	mode;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+extern struct trace_buffer trace_buf;
+extern uint32_t (*trace_timestamp)(void);
+
+/* Clear the ring and start recording. */
+int32_t trace_start(const struct trace_init_param *param);
+/* Stop recording, the ring is kept for the dump. */
+void trace_stop(void);
+/* Get the ring as the binary dump read by the decoder. */
+void trace_dump(const void **buf, uint32_t *len);
+/* Print the dump as hex lines, for consoles. */
+void trace_print(void);
+
+/**
+ * @brief Write a record. Not reentrant: records written from interrupts may
+ * overwrite one another.
+ * @param id - enum trace_event.
+ * @param type - enum trace_type.
+ * @param arg - Event argument.
+ */
+static inline void trace_record(uint16_t id, uint8_t type, uint32_t arg)
+{
+	struct trace_record *rec;
+	uint32_t head = trace_buf.head;
+
+	if (head >= trace_buf.limit)
+		return;
+
+	rec = &trace_buf.records[head & (TRACE_RING_SIZE - 1)];
+	rec->ts = trace_timestamp();
+	rec->id = id;
+	rec->type = type;
+	rec->arg = arg;
+	trace_buf.head = head + 1;
+}
+
+#endif /* TRACE_H_ */
@@ -45,6 +45,9 @@
 #include "diskio.h"		/* Declarations of disk functions */
 
 #include "sd.h"
+#ifdef FATFS_SD_CACHE
+#include "sd_cache.h"
+#endif
 #include "no-os/error.h"
 #include <stdio.h>
 
@@ -59,6 +62,10 @@
 #define ERASE_SECTOR_SIZE	1u
 uint8_t			sd_init_var = false;
 extern struct sd_desc	*sd_desc;
+#ifdef FATFS_SD_CACHE
+/* Set by the application to access the card through a sector cache */
+struct sd_cache_desc	*sd_cache;
+#endif
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
@@ -67,7 +74,7 @@ extern struct sd_desc	*sd_desc;
 DSTATUS SD_disk_status();
 DSTATUS SD_disk_initialize();
 DRESULT SD_disk_read(BYTE *buff, LBA_t sector, UINT count);
-DRESULT SD_disk_write(BYTE *buff, LBA_t sector, UINT count);
+DRESULT SD_disk_write(const BYTE *buff, LBA_t sector, UINT count);
 
 /*-----------------------------------------------------------------------*/
 /* Get Drive Status                                                      */
@@ -168,7 +175,12 @@ DRESULT disk_ioctl (
 	switch(pdrv) {
 	case DEV_SD:
 		switch (cmd){
-		case CTRL_SYNC: return RES_OK;
+		case CTRL_SYNC:
+#ifdef FATFS_SD_CACHE
+			if (sd_cache && SUCCESS != sd_cache_flush(sd_cache))
+				return RES_ERROR;
+#endif
+			return RES_OK;
 		case GET_SECTOR_COUNT:
 			*(LBA_t *)buff = sd_desc->memory_size / DATA_BLOCK_LEN;
 			return RES_OK;
@@ -212,19 +224,35 @@ DSTATUS SD_disk_initialize()
 
 DRESULT SD_disk_read(BYTE *buff, LBA_t sector, UINT count)
 {
+	int32_t ret;
+
 	if (!sd_init_var)
 		return RES_NOTRDY;
-	if (SUCCESS != sd_read(sd_desc, buff, (uint64_t)sector * 512, (uint64_t)count * 512))
+#ifdef FATFS_SD_CACHE
+	if (sd_cache)
+		ret = sd_cache_read(sd_cache, buff, sector, count);
+	else
+#endif
+		ret = sd_read_blocks(sd_desc, buff, sector, count);
+	if (SUCCESS != ret)
 		return RES_ERROR;
 
 	return RES_OK;
 }
 
-DRESULT SD_disk_write(BYTE *buff, LBA_t sector, UINT count)
+DRESULT SD_disk_write(const BYTE *buff, LBA_t sector, UINT count)
 {
+	int32_t ret;
+
 	if (!sd_init_var)
 		return RES_NOTRDY;
-	if (SUCCESS != sd_write(sd_desc, buff, (uint64_t)sector * 512, (uint64_t)count * 512))
+#ifdef FATFS_SD_CACHE
+	if (sd_cache)
+		ret = sd_cache_write(sd_cache, buff, sector, count);
+	else
+#endif
+		ret = sd_write_blocks(sd_desc, buff, sector, count);
+	if (SUCCESS != ret)
 		return RES_ERROR;
 
 	return RES_OK;
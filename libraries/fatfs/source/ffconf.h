@@ -38,7 +38,9 @@
 /  f_findnext(). (0:Disable, 1:Enable 2:Enable with matching altname[] too) */
 
 
+#ifndef FF_USE_MKFS
 #define FF_USE_MKFS		0
+#endif
 /* This option switches f_mkfs() function. (0:Disable or 1:Enable) */
 
 
@@ -46,7 +48,7 @@
 /* This option switches fast seek function. (0:Disable or 1:Enable) */
 
 
-#define FF_USE_EXPAND	0
+#define FF_USE_EXPAND	1
 /* This option switches f_expand function. (0:Disable or 1:Enable) */
 
 
@@ -46,14 +46,43 @@
 #include "mqtt_client.h"
 #include "MQTTClient.h"
 #include "no-os/error.h"
+#include "no-os/util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Last MQTT packet identifier, as in MQTTClient.c */
+#define MQTT_MAX_PACKET_ID	65535
+
+/* Time waited by mqtt_flush for the broker at each step */
+#define MQTT_FLUSH_YIELD_MS	10
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
 
+/* Queued QOS1 or QOS2 message waiting for an acknowledge */
+struct mqtt_inflight {
+	/* Packet identifier */
+	uint16_t		packet_id;
+	/* Awaited acknowledge: PUBACK, PUBREC or PUBCOMP. 0 if slot is free */
+	uint8_t			wait;
+	/* End of the packet in the queue buffer. 0 once it has been written */
+	uint32_t		queue_end;
+};
+
 struct mqtt_desc {
 	MQTTClient		mqtt_client[1];
 	Network			network;
+	/* Serialized messages not written to the socket yet */
+	uint8_t			*queue_buff;
+	uint32_t		queue_buff_size;
+	uint32_t		queue_len;
+	/* Messages waiting for an acknowledge */
+	struct mqtt_inflight	*inflight;
+	uint32_t		max_inflight;
+	struct mqtt_queue_stats	stats;
 };
 
 /******************************************************************************/
@@ -91,6 +120,98 @@ static void mqtt_default_message_handler(MessageData *msg)
 	free(data.topic);
 }
 
+/* Called by the network layer when a publish acknowledge is received */
+static void mqtt_ack_handler(void *ctx, uint8_t type, uint16_t packet_id)
+{
+	struct mqtt_desc	*desc = ctx;
+	struct mqtt_inflight	*msg;
+	uint32_t		i;
+
+	for (i = 0; i < desc->max_inflight; i++) {
+		msg = &desc->inflight[i];
+		if (msg->wait != type || msg->packet_id != packet_id)
+			continue;
+
+		/* PUBREL is sent by MQTTClient.c when PUBREC is received */
+		if (type == PUBREC) {
+			msg->wait = PUBCOMP;
+			return ;
+		}
+
+		msg->wait = 0;
+		desc->stats.inflight--;
+		desc->stats.acked++;
+		return ;
+	}
+}
+
+/*
+ * Free the slots of the queued messages whose packet was not written
+ * completely. With all set, every slot is freed, as when a new session
+ * starts.
+ */
+static void mqtt_inflight_release(struct mqtt_desc *desc, uint32_t sent,
+				  bool all)
+{
+	struct mqtt_inflight	*msg;
+	uint32_t		i;
+
+	for (i = 0; i < desc->max_inflight; i++) {
+		msg = &desc->inflight[i];
+		if (!msg->wait)
+			continue;
+
+		if (all || msg->queue_end > sent) {
+			msg->wait = 0;
+			desc->stats.inflight--;
+			if (!all)
+				desc->stats.dropped++;
+		}
+		msg->queue_end = 0;
+	}
+}
+
+/* Write the queued messages to the socket */
+static int32_t mqtt_queue_write(struct mqtt_desc *desc)
+{
+	MQTTClient	*c = desc->mqtt_client;
+	Timer		timer;
+	uint32_t	len;
+	uint32_t	sent;
+	int32_t		ret;
+
+	len = desc->queue_len;
+	if (!len)
+		return SUCCESS;
+
+	TimerInit(&timer);
+	TimerCountdownMS(&timer, c->command_timeout_ms);
+	sent = 0;
+	do {
+		ret = socket_send(desc->network.sock, desc->queue_buff + sent,
+				  len - sent);
+		if (ret == -EAGAIN)
+			continue;
+		if (IS_ERR_VALUE(ret))
+			break;
+		sent += ret;
+	} while (sent < len && !TimerIsExpired(&timer));
+
+	/* Partly written packets can't be sent again, the session is broken */
+	mqtt_inflight_release(desc, sent, false);
+	desc->queue_len = 0;
+	desc->stats.writes++;
+	if (ret != -EAGAIN && IS_ERR_VALUE(ret))
+		return ret;
+	if (sent < len)
+		return -ETIMEDOUT;
+
+	/* Keep alive is measured from the last packet sent */
+	TimerCountdown(&c->last_sent, c->keepAliveInterval);
+
+	return SUCCESS;
+}
+
 /**
  * @brief Initialize the MQTT client
  * @param desc - Address where to store the MQTT client reference
@@ -122,6 +243,22 @@ int32_t mqtt_init(struct mqtt_desc **desc,
 	ldesc->network.mqttread = mqtt_noos_read;
 	ldesc->network.mqttwrite = mqtt_noos_write;
 
+	if (param->queue_buff) {
+		ldesc->max_inflight = param->max_inflight ?
+				      param->max_inflight : 1;
+		ldesc->inflight = calloc(ldesc->max_inflight,
+					 sizeof(*ldesc->inflight));
+		if (!ldesc->inflight) {
+			mqtt_timer_remove();
+			free(ldesc);
+			return FAILURE;
+		}
+		ldesc->queue_buff = param->queue_buff;
+		ldesc->queue_buff_size = param->queue_buff_size;
+		ldesc->network.ack_handler = mqtt_ack_handler;
+		ldesc->network.ack_ctx = ldesc;
+	}
+
 	app_handler = param->message_handler;
 
 	MQTTClientInit(ldesc->mqtt_client, &ldesc->network,
@@ -148,6 +285,7 @@ int32_t mqtt_remove(struct mqtt_desc *desc)
 	if (!desc)
 		return FAILURE;
 
+	free(desc->inflight);
 	free(desc);
 	mqtt_timer_remove();
 
@@ -181,6 +319,12 @@ int32_t mqtt_connect(struct mqtt_desc *desc,
 	data.password.cstring = (char *)conf->password;
 	data.keepAliveInterval = (unsigned short)conf->keep_alive_ms;
 
+	/* Acknowledges of the previous connection will never come */
+	if (desc->inflight) {
+		desc->queue_len = 0;
+		mqtt_inflight_release(desc, 0, true);
+	}
+
 	ret = MQTTConnectWithResults(desc->mqtt_client, &data, &res);
 	if (result_optional) {
 		result_optional->rc = res.rc;
@@ -202,6 +346,11 @@ int32_t mqtt_disconnect(struct mqtt_desc *desc)
 	if (!desc)
 		return FAILURE;
 
+	if (desc->inflight) {
+		desc->queue_len = 0;
+		mqtt_inflight_release(desc, 0, true);
+	}
+
 	return MQTTDisconnect(desc->mqtt_client);
 }
 
@@ -230,6 +379,178 @@ int32_t mqtt_publish(struct mqtt_desc *desc, const int8_t* topic,
 	return MQTTPublish(desc->mqtt_client, (char *)topic, &message);
 }
 
+/**
+ * @brief Queue a publish to be sent along with other messages.
+ *
+ * The message is serialized in \ref mqtt_init_param.queue_buff, so the
+ * payload can be reused when the function returns. QOS1 and QOS2 messages
+ * do not wait for their acknowledge: up to
+ * \ref mqtt_init_param.max_inflight of them can wait at the same time.
+ * @param desc - Reference to MQTT client
+ * @param topic - Topic to publish to
+ * @param msg - Message to send
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EAGAIN : If max_inflight messages wait for an acknowledge. Call
+ *  \ref mqtt_yield or \ref mqtt_flush and try again.
+ *  - -ENOMEM : If the message does not fit in the queue buffer
+ *  - Negative error code if writing the queue to the socket failed
+ */
+int32_t mqtt_publish_queued(struct mqtt_desc *desc, const int8_t *topic,
+			    const struct mqtt_message *msg)
+{
+	MQTTString		topic_str = MQTTString_initializer;
+	struct mqtt_inflight	*slot;
+	uint16_t		packet_id;
+	uint32_t		i;
+	int32_t			ret;
+
+	if (!desc || !topic || !msg || !desc->queue_buff)
+		return -EINVAL;
+
+	slot = NULL;
+	packet_id = 0;
+	if (msg->qos != MQTT_QOS0) {
+		for (i = 0; i < desc->max_inflight; i++)
+			if (!desc->inflight[i].wait) {
+				slot = &desc->inflight[i];
+				break;
+			}
+		if (!slot)
+			return -EAGAIN;
+
+		packet_id = desc->mqtt_client->next_packetid;
+		packet_id = packet_id == MQTT_MAX_PACKET_ID ? 1 : packet_id + 1;
+	}
+
+	topic_str.cstring = (char *)topic;
+	ret = MQTTSerialize_publish(desc->queue_buff + desc->queue_len,
+				    desc->queue_buff_size - desc->queue_len,
+				    0, msg->qos, msg->retained, packet_id,
+				    topic_str, msg->payload, msg->len);
+	if (ret == MQTTPACKET_BUFFER_TOO_SHORT && desc->queue_len) {
+		ret = mqtt_queue_write(desc);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+		ret = MQTTSerialize_publish(desc->queue_buff,
+					    desc->queue_buff_size, 0,
+					    msg->qos, msg->retained, packet_id,
+					    topic_str, msg->payload, msg->len);
+	}
+	if (ret <= 0)
+		return -ENOMEM;
+
+	desc->queue_len += ret;
+	desc->stats.queued++;
+	if (slot) {
+		desc->mqtt_client->next_packetid = packet_id;
+		slot->packet_id = packet_id;
+		slot->wait = msg->qos == MQTT_QOS1 ? PUBACK : PUBREC;
+		slot->queue_end = desc->queue_len;
+		desc->stats.inflight++;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Send the queued messages and wait for their acknowledges.
+ * Incoming messages are handled while waiting, as in \ref mqtt_yield.
+ * @param desc - Reference to MQTT client
+ * @param timeout_ms - Maximum time to wait for the acknowledges. With 0 the
+ * queue is only written to the socket.
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -ETIMEDOUT : If messages still wait for an acknowledge
+ *  - Negative error code otherwise
+ */
+int32_t mqtt_flush(struct mqtt_desc *desc, uint32_t timeout_ms)
+{
+	Timer	timer;
+	int32_t	ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	ret = mqtt_queue_write(desc);
+	if (IS_ERR_VALUE(ret) || !timeout_ms)
+		return ret;
+
+	TimerInit(&timer);
+	TimerCountdownMS(&timer, timeout_ms);
+	while (desc->stats.inflight) {
+		if (TimerIsExpired(&timer))
+			return -ETIMEDOUT;
+		ret = MQTTYield(desc->mqtt_client, MQTT_FLUSH_YIELD_MS);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the counters of the publish queue
+ * @param desc - Reference to MQTT client
+ * @param stats - Where to store the counters
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EINVAL : On invalid parameters
+ */
+int32_t mqtt_queue_stats(struct mqtt_desc *desc,
+			 struct mqtt_queue_stats *stats)
+{
+	if (!desc || !stats)
+		return -EINVAL;
+
+	*stats = desc->stats;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Pack IIO scans in a frame to be used as message payload.
+ * See \ref mqtt_scan_frame for the layout.
+ * @param buff - Where to write the frame
+ * @param size - Size of buff
+ * @param frame - Scans and their description
+ * @return
+ *  - Length of the frame on success
+ *  - -ENOMEM : If the frame does not fit in buff
+ *  - -EINVAL : On invalid parameters
+ */
+int32_t mqtt_pack_scan_frame(uint8_t *buff, uint32_t size,
+			     const struct mqtt_scan_frame *frame)
+{
+	uint32_t	nb_ch;
+	uint32_t	len;
+
+	if (!buff || !frame || (!frame->data && frame->nb_scans))
+		return -EINVAL;
+
+	/* hweight8() counts the set bits of the whole word */
+	nb_ch = hweight8(frame->ch_mask);
+	len = nb_ch * frame->bytes_per_sample * frame->nb_scans;
+	if (MQTT_SCAN_FRAME_HDR_LEN + len > size)
+		return -ENOMEM;
+
+	buff[0] = MQTT_SCAN_FRAME_MAGIC;
+	buff[1] = MQTT_SCAN_FRAME_VERSION;
+	buff[2] = frame->seq;
+	buff[3] = frame->seq >> 8;
+	buff[4] = frame->ch_mask;
+	buff[5] = frame->ch_mask >> 8;
+	buff[6] = frame->ch_mask >> 16;
+	buff[7] = frame->ch_mask >> 24;
+	buff[8] = frame->nb_scans;
+	buff[9] = frame->nb_scans >> 8;
+	buff[10] = frame->bytes_per_sample;
+	buff[11] = 0;
+	memcpy(buff + MQTT_SCAN_FRAME_HDR_LEN, frame->data, len);
+
+	return MQTT_SCAN_FRAME_HDR_LEN + len;
+}
+
 /**
  * @brief Send subscribe to MQTT broker
  * @param desc - Reference to MQTT client
@@ -282,7 +603,9 @@ int32_t mqtt_unsubscribe(struct mqtt_desc *desc, const int8_t* topic)
  * A call to this API must be made within the
  * \ref mqtt_connect_config.keep_alive_ms interval to keep the MQTT connection
  * alive. \n
- * Yield can be called if no other MQTT operation is needed.
+ * Yield can be called if no other MQTT operation is needed. \n
+ * Messages queued with \ref mqtt_publish_queued are written first and
+ * their acknowledges are handled.
  * @param desc - Reference to MQTT client
  * @param timeout_ms - Time for yield to be executed
  * @return
@@ -291,5 +614,11 @@ int32_t mqtt_unsubscribe(struct mqtt_desc *desc, const int8_t* topic)
  */
 int32_t mqtt_yield(struct mqtt_desc *desc, uint32_t timeout_ms)
 {
+	int32_t ret;
+
+	ret = mqtt_queue_write(desc);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
 	return MQTTYield(desc->mqtt_client, timeout_ms);
 }
@@ -232,8 +232,69 @@ struct mqtt_init_param {
 	 * @param Message received from the broker.
 	 */
 	void			(*message_handler)(struct mqtt_message_data *);
+	/**
+	 * Buffer where \ref mqtt_publish_queued serializes messages. The
+	 * queued messages are written to the socket at once when the buffer
+	 * is full or on \ref mqtt_flush and \ref mqtt_yield.
+	 * NULL if the publish queue is not used.
+	 */
+	uint8_t			*queue_buff;
+	/** Size of queue_buff */
+	uint32_t		queue_buff_size;
+	/**
+	 * Maximum number of queued QOS1 and QOS2 messages waiting for their
+	 * acknowledge. 1 if 0.
+	 */
+	uint32_t		max_inflight;
+};
+
+/**
+ * @struct mqtt_queue_stats
+ * @brief Counters of the publish queue
+ */
+struct mqtt_queue_stats {
+	/** Messages queued by \ref mqtt_publish_queued */
+	uint32_t	queued;
+	/** Socket writes done to send the queued messages */
+	uint32_t	writes;
+	/** QOS1 and QOS2 messages acknowledged by the broker */
+	uint32_t	acked;
+	/** QOS1 and QOS2 messages waiting for their acknowledge */
+	uint32_t	inflight;
+	/** QOS1 and QOS2 messages dropped because the queue write failed */
+	uint32_t	dropped;
 };
 
+/**
+ * @struct mqtt_scan_frame
+ * @brief Block of IIO scans packed by \ref mqtt_pack_scan_frame.
+ *
+ * The frame is a header of MQTT_SCAN_FRAME_HDR_LEN bytes followed by the
+ * scans as they are in the IIO buffer: one sample of each enabled channel,
+ * in channel order. The header fields are little endian:
+ * magic (1), version (1), seq (2), ch_mask (4), nb_scans (2),
+ * bytes_per_sample (1), reserved (1).
+ */
+struct mqtt_scan_frame {
+	/** Frame sequence number, used to detect lost frames */
+	uint16_t	seq;
+	/** Enabled channels, bit n for channel n */
+	uint32_t	ch_mask;
+	/** Number of scans in data */
+	uint16_t	nb_scans;
+	/** Storage size of a sample in bytes */
+	uint8_t		bytes_per_sample;
+	/** Scans */
+	const void	*data;
+};
+
+/** Magic byte of a \ref mqtt_scan_frame */
+#define MQTT_SCAN_FRAME_MAGIC	0xA5
+/** Version of the \ref mqtt_scan_frame layout */
+#define MQTT_SCAN_FRAME_VERSION	1
+/** Length of the \ref mqtt_scan_frame header */
+#define MQTT_SCAN_FRAME_HDR_LEN	12
+
 /**
  * @struct mqtt_desc
  * @brief Reference to MQTT client
@@ -260,6 +321,17 @@ int32_t mqtt_disconnect(struct mqtt_desc *desc);
 /* Send publish to MQTT broker */
 int32_t mqtt_publish(struct mqtt_desc *desc, const int8_t* topic,
 		     const struct mqtt_message* msg);
+/* Queue a publish to be sent along with other messages */
+int32_t mqtt_publish_queued(struct mqtt_desc *desc, const int8_t *topic,
+			    const struct mqtt_message *msg);
+/* Send the queued messages and wait for their acknowledges */
+int32_t mqtt_flush(struct mqtt_desc *desc, uint32_t timeout_ms);
+/* Get the counters of the publish queue */
+int32_t mqtt_queue_stats(struct mqtt_desc *desc,
+			 struct mqtt_queue_stats *stats);
+/* Pack IIO scans in a frame to be used as message payload */
+int32_t mqtt_pack_scan_frame(uint8_t *buff, uint32_t size,
+			     const struct mqtt_scan_frame *frame);
 /* Send subscribe to MQTT broker */
 int32_t mqtt_subscribe(struct mqtt_desc *desc, const int8_t *topic,
 		       enum mqtt_qos qos, enum mqtt_qos *granted_qos_optional);
@@ -43,12 +43,27 @@
 
 #include "mqtt_noos_support.h"
 #include <stdlib.h>
+#include <stdbool.h>
 #include "no-os/timer.h"
 #include "no-os/error.h"
 #include "no-os/util.h"
 #include "no-os/delay.h"
 #include "no-os/error.h"
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* MQTT control packet types */
+#define MQTT_PUBACK	4
+#define MQTT_PUBREC	5
+#define MQTT_PUBCOMP	7
+
+/* Incoming packet parser states */
+#define MQTT_PARSE_HEADER	0
+#define MQTT_PARSE_LENGTH	1
+#define MQTT_PARSE_BODY		2
+
 /******************************************************************************/
 /**************************** Global Variables ********************************/
 /******************************************************************************/
@@ -147,6 +162,52 @@ char TimerIsExpired(Timer* t)
 	return false;
 }
 
+/* Follow the packets read from the socket and report the acknowledges */
+static void mqtt_noos_parse(Network *net, const uint8_t *buff, uint32_t len)
+{
+	uint32_t	i;
+	bool		is_ack;
+
+	for (i = 0; i < len; i++) {
+		switch (net->parser.state) {
+		case MQTT_PARSE_HEADER:
+			net->parser.type = buff[i] >> 4;
+			net->parser.rem = 0;
+			net->parser.shift = 0;
+			net->parser.state = MQTT_PARSE_LENGTH;
+			break;
+		case MQTT_PARSE_LENGTH:
+			net->parser.rem |= (uint32_t)(buff[i] & 0x7F) <<
+					   net->parser.shift;
+			net->parser.shift += 7;
+			if (buff[i] & 0x80)
+				break;
+			net->parser.pos = 0;
+			net->parser.id = 0;
+			net->parser.state = net->parser.rem ?
+					    MQTT_PARSE_BODY : MQTT_PARSE_HEADER;
+			break;
+		case MQTT_PARSE_BODY:
+			if (net->parser.pos < 2) {
+				net->parser.id = (net->parser.id << 8) |
+						 buff[i];
+				net->parser.pos++;
+			}
+			if (--net->parser.rem)
+				break;
+			net->parser.state = MQTT_PARSE_HEADER;
+			is_ack = net->parser.type == MQTT_PUBACK ||
+				 net->parser.type == MQTT_PUBREC ||
+				 net->parser.type == MQTT_PUBCOMP;
+			if (is_ack && net->parser.pos == 2 && net->ack_handler)
+				net->ack_handler(net->ack_ctx,
+						 net->parser.type,
+						 net->parser.id);
+			break;
+		}
+	}
+}
+
 /* Implementation of mqtt_noos_read used by MQTTClient.c */
 int mqtt_noos_read(Network* net, unsigned char* buff, int len, int timeout)
 {
@@ -164,13 +225,15 @@ int mqtt_noos_read(Network* net, unsigned char* buff, int len, int timeout)
 			if (IS_ERR_VALUE(rc))
 				return rc;
 
+			mqtt_noos_parse(net, buff + sent, rc);
 			sent += rc;
 			if (sent >= len)
 				return sent;
 		}
 
 		mdelay(1);
-	} while (--timeout);
+	/* With a timeout of 0 try once instead of waiting forever */
+	} while (--timeout > 0);
 
 	/* 0 bytes have been read */
 	return 0;
@@ -80,6 +80,29 @@ struct network_port_noos {
 	/** Reference to no-os network wrapper write function */
 	int			(*mqttwrite)(Network*, unsigned char*, int,
 					     int);
+	/**
+	 * Called for each PUBACK, PUBREC and PUBCOMP read from the socket.
+	 * Can be NULL.
+	 */
+	void			(*ack_handler)(void *ctx, uint8_t type,
+					       uint16_t packet_id);
+	/** Context passed to ack_handler */
+	void			*ack_ctx;
+	/** State of the incoming packet parser used for ack_handler */
+	struct {
+		/** Packet part being parsed: header, length or body */
+		uint8_t		state;
+		/** Packet type */
+		uint8_t		type;
+		/** Shift of the next remaining length byte */
+		uint8_t		shift;
+		/** Number of body bytes parsed */
+		uint8_t		pos;
+		/** Remaining length of the packet */
+		uint32_t	rem;
+		/** Packet identifier */
+		uint16_t	id;
+	}			parser;
 };
 
 /******************************************************************************/
@@ -58,6 +58,18 @@
 #include <netdb.h>
 #include <string.h>
 #include <fcntl.h>
+#include <sys/uio.h>
+#include <poll.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Segments sent with one sendmsg() call */
+#define LINUX_SOCKET_MAX_IOV	16
+
+/* Time to wait for a connection to be established */
+#define LINUX_SOCKET_CONNECT_TIMEOUT_MS	5000
 
 /******************************************************************************/
 /*************************** FUnctions Declarations *******************************/
@@ -109,6 +121,23 @@ static int32_t linux_socket_connect(void *desc, uint32_t sock_id,
 
 	ret = connect(sock_id,(struct sockaddr*) &saddr,len);
 
+	/* The socket is non blocking, wait for the connection to complete */
+	if (ret < 0 && errno == EINPROGRESS) {
+		struct pollfd pfd = {
+			.fd = sock_id,
+			.events = POLLOUT
+		};
+		int err = 0;
+
+		len = sizeof(err);
+		if (poll(&pfd, 1, LINUX_SOCKET_CONNECT_TIMEOUT_MS) != 1)
+			return -ETIMEDOUT;
+		if (getsockopt(sock_id, SOL_SOCKET, SO_ERROR, &err, &len) < 0)
+			return -errno;
+
+		return err ? -err : SUCCESS;
+	}
+
 	if(ret < 0)
 		return -errno;
 
@@ -120,13 +149,26 @@ static int32_t linux_socket_connect(void *desc, uint32_t sock_id,
 static int32_t linux_socket_disconnect(void *desc,
 				       uint32_t sock_id)
 {
-	int32_t ret;
-
-	ret = linux_socket_close(desc, sock_id);
-
-	if(ret < 0)
+	int32_t flags;
+	int fd;
+
+	/*
+	 * Put a new socket in place of the connected one, so the id can
+	 * connect again and is still closed by socket_close.
+	 */
+	fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (fd < 0)
 		return -errno;
 
+	flags = fcntl(fd, F_GETFL);
+	fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+	if (dup2(fd, sock_id) < 0) {
+		flags = -errno;
+		close(fd);
+		return flags;
+	}
+	close(fd);
+
 	return SUCCESS;
 }
 
@@ -136,12 +178,76 @@ static int32_t linux_socket_send(void *desc, uint32_t sock_id,
 {
 	int32_t ret;
 
-	ret = send(sock_id, data, size, 0);
+	/* Report a closed peer as an error instead of raising SIGPIPE */
+	ret = send(sock_id, data, size, MSG_NOSIGNAL);
+
+	if(ret < 0)
+		return -errno;
+
+	/* May be less than size, the caller sends the rest */
+	return ret;
+}
+
+/** @brief See \ref network_interface.socket_sendv */
+static int32_t linux_socket_sendv(void *desc, uint32_t sock_id,
+				  const struct socket_iovec *iov,
+				  uint32_t iovcnt)
+{
+	struct iovec vec[LINUX_SOCKET_MAX_IOV];
+	struct msghdr msg = {0};
+	uint32_t i;
+	int32_t ret;
+
+	/* The remaining segments are sent by the caller after a short count */
+	iovcnt = min(iovcnt, (uint32_t)LINUX_SOCKET_MAX_IOV);
+	for (i = 0; i < iovcnt; i++) {
+		vec[i].iov_base = (void *)iov[i].base;
+		vec[i].iov_len = iov[i].len;
+	}
+	msg.msg_iov = vec;
+	msg.msg_iovlen = iovcnt;
 
+	ret = sendmsg(sock_id, &msg, MSG_NOSIGNAL);
 	if(ret < 0)
 		return -errno;
 
-	return size;
+	return ret;
+}
+
+/** @brief See \ref network_interface.socket_setopt */
+static int32_t linux_socket_setopt(void *desc, uint32_t sock_id,
+				   enum socket_option opt, uint32_t val)
+{
+	int level, name;
+	int value = val;
+	int32_t ret;
+
+	switch (opt) {
+	case SOCKET_OPT_NODELAY:
+		level = IPPROTO_TCP;
+		name = TCP_NODELAY;
+		break;
+	case SOCKET_OPT_CORK:
+		level = IPPROTO_TCP;
+		name = TCP_CORK;
+		break;
+	case SOCKET_OPT_SNDBUF:
+		level = SOL_SOCKET;
+		name = SO_SNDBUF;
+		break;
+	case SOCKET_OPT_RCVBUF:
+		level = SOL_SOCKET;
+		name = SO_RCVBUF;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	ret = setsockopt(sock_id, level, name, &value, sizeof(value));
+	if(ret < 0)
+		return -errno;
+
+	return SUCCESS;
 }
 
 /** @brief See \ref network_interface.socket_recv */
@@ -276,7 +382,9 @@ struct network_interface linux_net = {
 	.socket_recvfrom = (int32_t (*)(void *, uint32_t, void *, uint32_t, struct socket_address* from))linux_socket_recvfrom,
 	.socket_bind = (int32_t (*)(void *, uint32_t, uint16_t))linux_socket_bind,
 	.socket_listen = (int32_t (*)(void *, uint32_t, uint32_t))linux_socket_listen,
-	.socket_accept= (int32_t (*)(void *, uint32_t, uint32_t*))linux_socket_accept
+	.socket_accept= (int32_t (*)(void *, uint32_t, uint32_t*))linux_socket_accept,
+	.socket_sendv = linux_socket_sendv,
+	.socket_setopt = linux_socket_setopt
 };
 
 #endif
@@ -73,6 +73,32 @@ struct socket_address {
 	uint16_t	port;
 };
 
+/**
+ * @struct socket_iovec
+ * @brief One segment of a scatter-gather send.
+ */
+struct socket_iovec {
+	/** Segment data */
+	const void	*base;
+	/** Segment length in bytes */
+	uint32_t	len;
+};
+
+/**
+ * @enum socket_option
+ * @brief Options set with network_interface.socket_setopt
+ */
+enum socket_option {
+	/** Send small segments without waiting (TCP_NODELAY). Value 0 or 1 */
+	SOCKET_OPT_NODELAY,
+	/** Only send full segments until uncorked (TCP_CORK). Value 0 or 1 */
+	SOCKET_OPT_CORK,
+	/** Size of the send buffer in bytes */
+	SOCKET_OPT_SNDBUF,
+	/** Size of the receive buffer in bytes */
+	SOCKET_OPT_RCVBUF
+};
+
 /**
  * @struct network_interface
  * @brief Interface that connect the data layer with the transport layer
@@ -218,6 +244,38 @@ struct network_interface {
 	 */
 	int32_t (*socket_accept)(void *net, uint32_t sock_id,
 				 uint32_t *client_socket_id);
+
+	/**
+	 * @brief Send several buffers over a TCP socket with one call.
+	 *
+	 * Optional. The segments are sent in order, as if they were one
+	 * buffer, so small pieces of a message can leave in one TCP segment.
+	 * @param net - Network interface
+	 * @param sock_id - Socket id
+	 * @param iov - Array of segments
+	 * @param iovcnt - Number of segments
+	 * @return
+	 *  - Number of sent bytes, less than the total on a partial send
+	 *  - \ref Negative error code on failure
+	 */
+	int32_t (*socket_sendv)(void *net, uint32_t sock_id,
+				const struct socket_iovec *iov,
+				uint32_t iovcnt);
+
+	/**
+	 * @brief Set a socket option.
+	 *
+	 * Optional.
+	 * @param net - Network interface
+	 * @param sock_id - Socket id
+	 * @param opt - Option to set
+	 * @param val - Option value
+	 * @return
+	 *  - \ref SUCCESS : On success
+	 *  - \ref Negative error code on failure
+	 */
+	int32_t (*socket_setopt)(void *net, uint32_t sock_id,
+				 enum socket_option opt, uint32_t val);
 };
 
 #endif
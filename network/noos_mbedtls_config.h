@@ -99,6 +99,22 @@
  */
 #define ENABLE_MEMORY_OPTIMIZATIONS
 
+/*
+ * Resume sessions with RFC 5077 session tickets. Without it sessions are
+ * resumed by session ID, which needs a session cache on the server.
+ * A resumed handshake skips the certificate verification and the key
+ * exchange, the most expensive part of a connection on a Cortex-M.
+ * Adds the ticket parsing code and keeps the ticket in RAM.
+ */
+//#define ENABLE_SESSION_TICKETS
+
+/*
+ * Negotiate the maximum fragment length (RFC 6066) given by
+ * secure_init_param.max_frag_len, up to MAX_CONTENT_LEN. After the handshake
+ * the record buffers are resized to the negotiated length.
+ */
+//#define ENABLE_MAX_FRAGMENT_LENGTH
+
 /******************************************************************************/
 /********************* Minimal tls client requirements ************************/
 /******************************************************************************/
@@ -130,6 +146,15 @@
 #define MBEDTLS_SSL_MAX_CONTENT_LEN	MAX_CONTENT_LEN
 #endif
 
+#ifdef ENABLE_SESSION_TICKETS
+#define MBEDTLS_SSL_SESSION_TICKETS
+#endif
+
+#ifdef ENABLE_MAX_FRAGMENT_LENGTH
+#define MBEDTLS_SSL_MAX_FRAGMENT_LENGTH
+#define MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH
+#endif
+
 #ifdef ENABLE_TLS1_2
 
 #define MBEDTLS_SSL_PROTO_TLS1_2
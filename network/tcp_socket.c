@@ -43,6 +43,7 @@
 /******************************************************************************/
 
 #include <stdlib.h>
+#include <string.h>
 #include "no-os/error.h"
 #include "tcp_socket.h"
 #include "no-os/util.h"
@@ -69,6 +70,12 @@
 #define DEFAULT_CONNECTION_BUFFER_SIZE 16384
 #endif /* MAX_CONTENT_LEN */
 
+/*
+ * Worst case TLS record expansion: header (5), explicit IV (16),
+ * MAC (48) and CBC padding (256)
+ */
+#define SECURE_RECORD_OVERHEAD 325
+
 #endif /* DISABLE_SECURE_SOCKET */
 
 /******************************************************************************/
@@ -76,6 +83,38 @@
 /******************************************************************************/
 
 #ifndef DISABLE_SECURE_SOCKET
+/* Fields of the ServerHello read by stcp_scan_hello() */
+enum stcp_hello_field {
+	HELLO_REC_TYPE,
+	HELLO_REC_LEN,
+	HELLO_MSG_TYPE,
+	HELLO_MSG_LEN,
+	HELLO_SID_LEN,
+	HELLO_EXTS_LEN,
+	HELLO_EXT_TYPE,
+	HELLO_EXT_LEN,
+	HELLO_DONE
+};
+
+/* Progress of the ServerHello scan, over the bytes received so far */
+struct stcp_hello_scan {
+	/* Field being read */
+	enum stcp_hello_field	field;
+	/* Bytes of the field read so far and their value */
+	uint8_t			got;
+	uint32_t		val;
+	/* Bytes to skip before the field */
+	uint32_t		skip;
+	/* Bytes received since the start of the handshake */
+	uint32_t		pos;
+	/* Position of the end of the first record, then of the ServerHello */
+	uint32_t		end;
+	/* Type of the extension being read */
+	uint16_t		ext_type;
+	/* True if the server echoed the max fragment length extension */
+	bool			mfl;
+};
+
 /**
  * @struct secure_socket_desc
  * @brief Fields used by secure socket
@@ -94,6 +133,22 @@ struct secure_socket_desc {
 	mbedtls_ssl_config	conf;
 	/** Mbedtls tls context */
 	mbedtls_ssl_context	ssl;
+	/** Session of the last connection, offered on the next handshake */
+	mbedtls_ssl_session	session;
+	/** True if session holds a session that can be resumed */
+	bool			session_valid;
+	/** True to always run a full handshake */
+	bool			disable_resumption;
+	/** True if ssl was used by a previous connection */
+	bool			used;
+	/** Maximum fragment length requested, 0 if none */
+	uint16_t		max_frag_len;
+	/** True if the server accepted max_frag_len for the current session */
+	bool			mfl_accepted;
+	/** ServerHello scan of the current handshake */
+	struct stcp_hello_scan	hello;
+	/** Handshake counters */
+	struct secure_socket_stats	stats;
 };
 #endif /* DISABLE_SECURE_SOCKET */
 
@@ -106,6 +161,10 @@ struct tcp_socket_desc {
 #ifndef DISABLE_SECURE_SOCKET
 	/* Reference to secure descriptor */
 	struct secure_socket_desc	*secure;
+	/* Receive buffer size given to socket_open */
+	uint32_t			buff_size;
+	/* True if the receive buffer was shrunk to the fragment length */
+	bool				buff_shrunk;
 #endif /* DISABLE_SECURE_SOCKET */
 };
 
@@ -114,6 +173,103 @@ struct tcp_socket_desc {
 /******************************************************************************/
 
 #ifndef DISABLE_SECURE_SOCKET
+/*
+ * Look for the max fragment length extension in the ServerHello, the first
+ * message received. mbedtls only checks that the echoed length matches the
+ * requested one, it does not tell whether the server accepted it. The
+ * message is only looked for in the first record.
+ */
+static void stcp_scan_hello(struct stcp_hello_scan *s, const uint8_t *buf,
+			    uint32_t len)
+{
+	static const uint8_t field_len[] = {
+		[HELLO_REC_TYPE] = 1,
+		[HELLO_REC_LEN] = 2,
+		[HELLO_MSG_TYPE] = 1,
+		[HELLO_MSG_LEN] = 3,
+		[HELLO_SID_LEN] = 1,
+		[HELLO_EXTS_LEN] = 2,
+		[HELLO_EXT_TYPE] = 2,
+		[HELLO_EXT_LEN] = 2,
+	};
+	uint32_t n, val;
+
+	while (len && s->field != HELLO_DONE) {
+		/* The extensions are optional and end with the message */
+		if (s->field >= HELLO_EXTS_LEN && !s->got &&
+		    s->pos + s->skip >= s->end) {
+			s->field = HELLO_DONE;
+			break;
+		}
+		if (s->skip) {
+			n = min(s->skip, len);
+			s->skip -= n;
+			s->pos += n;
+			buf += n;
+			len -= n;
+			continue;
+		}
+
+		s->val = (s->val << 8) | *buf++;
+		s->pos++;
+		len--;
+		if (++s->got < field_len[s->field])
+			continue;
+
+		val = s->val;
+		s->val = 0;
+		s->got = 0;
+		switch (s->field) {
+		case HELLO_REC_TYPE:
+			/* Handshake record, skip the version */
+			s->field = val == 22 ? HELLO_REC_LEN : HELLO_DONE;
+			s->skip = 2;
+			break;
+		case HELLO_REC_LEN:
+			s->end = s->pos + val;
+			s->field = HELLO_MSG_TYPE;
+			break;
+		case HELLO_MSG_TYPE:
+			s->field = val == 2 ? HELLO_MSG_LEN : HELLO_DONE;
+			break;
+		case HELLO_MSG_LEN:
+			if (s->pos + val > s->end) {
+				s->field = HELLO_DONE;
+				break;
+			}
+			s->end = s->pos + val;
+			/* Version and random */
+			s->skip = 34;
+			s->field = HELLO_SID_LEN;
+			break;
+		case HELLO_SID_LEN:
+			/* Session ID, cipher suite and compression method */
+			s->skip = val + 3;
+			s->field = HELLO_EXTS_LEN;
+			break;
+		case HELLO_EXTS_LEN:
+			s->field = HELLO_EXT_TYPE;
+			break;
+		case HELLO_EXT_TYPE:
+			s->ext_type = val;
+			s->field = HELLO_EXT_LEN;
+			break;
+		case HELLO_EXT_LEN:
+			if (s->ext_type == MBEDTLS_TLS_EXT_MAX_FRAGMENT_LENGTH) {
+				s->mfl = true;
+				s->field = HELLO_DONE;
+				break;
+			}
+			s->skip = val;
+			s->field = HELLO_EXT_TYPE;
+			break;
+		default:
+			s->field = HELLO_DONE;
+			break;
+		}
+	}
+}
+
 /* Wrapper over socket_recv */
 static int tls_net_recv(struct tcp_socket_desc *sock, unsigned char *buff,
 			size_t len)
@@ -124,6 +280,9 @@ static int tls_net_recv(struct tcp_socket_desc *sock, unsigned char *buff,
 	if (ret == -EAGAIN)
 		return MBEDTLS_ERR_SSL_WANT_READ;
 
+	if (ret > 0 && sock->secure->hello.field != HELLO_DONE)
+		stcp_scan_hello(&sock->secure->hello, buff, ret);
+
 	return ret;
 }
 
@@ -137,6 +296,8 @@ static int tls_net_send(struct tcp_socket_desc *sock, unsigned char *buff,
 /* Remove secure descriptor*/
 static void stcp_socket_remove(struct secure_socket_desc *desc)
 {
+	mbedtls_ssl_session_free(&desc->session);
+	mbedtls_ssl_free(&desc->ssl);
 	mbedtls_pk_free(&desc->pkey);
 	mbedtls_x509_crt_free(&desc->clicert);
 	mbedtls_x509_crt_free(&desc->cacert);
@@ -147,6 +308,29 @@ static void stcp_socket_remove(struct secure_socket_desc *desc)
 	free(desc);
 }
 
+#ifdef MBEDTLS_SSL_MAX_FRAGMENT_LENGTH
+/* Get the RFC 6066 code of a maximum fragment length */
+static int32_t stcp_max_frag_len_code(uint16_t len)
+{
+	/* The record buffers are only MBEDTLS_SSL_MAX_CONTENT_LEN long */
+	if (len > MBEDTLS_SSL_MAX_CONTENT_LEN)
+		return -EINVAL;
+
+	switch (len) {
+	case 512:
+		return MBEDTLS_SSL_MAX_FRAG_LEN_512;
+	case 1024:
+		return MBEDTLS_SSL_MAX_FRAG_LEN_1024;
+	case 2048:
+		return MBEDTLS_SSL_MAX_FRAG_LEN_2048;
+	case 4096:
+		return MBEDTLS_SSL_MAX_FRAG_LEN_4096;
+	default:
+		return -EINVAL;
+	}
+}
+#endif /* MBEDTLS_SSL_MAX_FRAGMENT_LENGTH */
+
 /* Init secure descriptor */
 static int32_t stcp_socket_init(struct secure_socket_desc **desc,
 				struct tcp_socket_desc *sock,
@@ -163,6 +347,8 @@ static int32_t stcp_socket_init(struct secure_socket_desc **desc,
 		return FAILURE;
 
 	/* Initialize structures */
+	mbedtls_ssl_init(&ldesc->ssl);
+	mbedtls_ssl_session_init(&ldesc->session);
 	mbedtls_ssl_config_init(&ldesc->conf);
 	mbedtls_x509_crt_init(&ldesc->cacert);
 	mbedtls_x509_crt_init(&ldesc->clicert);
@@ -229,6 +415,30 @@ static int32_t stcp_socket_init(struct secure_socket_desc **desc,
 			goto exit;
 	}
 
+	if (param->max_frag_len) {
+#ifdef MBEDTLS_SSL_MAX_FRAGMENT_LENGTH
+		ret = stcp_max_frag_len_code(param->max_frag_len);
+		if (IS_ERR_VALUE(ret))
+			goto exit;
+		ret = mbedtls_ssl_conf_max_frag_len(&ldesc->conf,
+						    (unsigned char)ret);
+		if (IS_ERR_VALUE(ret))
+			goto exit;
+		ldesc->max_frag_len = param->max_frag_len;
+#else
+		ret = -ENOSYS;
+		goto exit;
+#endif /* MBEDTLS_SSL_MAX_FRAGMENT_LENGTH */
+	}
+
+	ldesc->disable_resumption = param->disable_resumption;
+#ifdef MBEDTLS_SSL_SESSION_TICKETS
+	mbedtls_ssl_conf_session_tickets(&ldesc->conf,
+					 param->disable_resumption ?
+					 MBEDTLS_SSL_SESSION_TICKETS_DISABLED :
+					 MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif /* MBEDTLS_SSL_SESSION_TICKETS */
+
 	/* Config Random number generator */
 	mbedtls_ssl_conf_rng(&ldesc->conf,
 			     (int (*)(void *, unsigned char *, size_t))
@@ -254,6 +464,85 @@ exit:
 
 	return ret;
 }
+
+/* Save the session of the current connection to resume it next time */
+static void stcp_socket_save_session(struct secure_socket_desc *desc)
+{
+	mbedtls_ssl_session	session;
+	bool			resumed;
+
+	mbedtls_ssl_session_init(&session);
+	if (mbedtls_ssl_get_session(&desc->ssl, &session)) {
+		mbedtls_ssl_session_free(&session);
+		mbedtls_ssl_session_free(&desc->session);
+		desc->session_valid = false;
+		return;
+	}
+
+	/*
+	 * A resumed session keeps the master secret of the saved one, a full
+	 * handshake derives a new one. The session ID can't tell: along with
+	 * a ticket the client sends a new random ID, which the server echoes.
+	 */
+	resumed = desc->session_valid &&
+		  !memcmp(session.master, desc->session.master,
+			  sizeof(session.master));
+	if (resumed)
+		desc->stats.resumed++;
+	/* A resumed session keeps the fragment length negotiated for it */
+	if (resumed && desc->mfl_accepted)
+		desc->hello.mfl = true;
+
+	mbedtls_ssl_session_free(&desc->session);
+	desc->session = session;
+	desc->session_valid = true;
+}
+
+/* Run the handshake, offering the saved session if there is one */
+static int32_t stcp_socket_handshake(struct secure_socket_desc *desc)
+{
+	int32_t ret;
+
+	/* The context keeps the state of the previous connection */
+	if (desc->used) {
+		ret = mbedtls_ssl_session_reset(&desc->ssl);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+	desc->used = true;
+
+	if (desc->session_valid && !desc->disable_resumption) {
+		ret = mbedtls_ssl_set_session(&desc->ssl, &desc->session);
+		/* Not fatal, a full handshake is done instead */
+		if (IS_ERR_VALUE(ret))
+			desc->session_valid = false;
+	}
+
+	memset(&desc->hello, 0, sizeof(desc->hello));
+	if (!desc->max_frag_len)
+		desc->hello.field = HELLO_DONE;
+
+	do {
+		ret = mbedtls_ssl_handshake(&desc->ssl);
+	} while (ret == MBEDTLS_ERR_SSL_WANT_READ ||
+		 ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+	desc->hello.field = HELLO_DONE;
+	if (IS_ERR_VALUE(ret)) {
+		/* Do not offer again a session the server may have refused */
+		mbedtls_ssl_session_free(&desc->session);
+		desc->session_valid = false;
+		return ret;
+	}
+
+	desc->stats.handshakes++;
+	if (!desc->disable_resumption)
+		stcp_socket_save_session(desc);
+	desc->mfl_accepted = desc->hello.mfl;
+	if (desc->mfl_accepted)
+		desc->stats.frag_len_accepted++;
+
+	return SUCCESS;
+}
 #endif /* DISABLE_SECURE_SOCKET */
 
 /**
@@ -279,7 +568,15 @@ int32_t socket_init(struct tcp_socket_desc **desc,
 		return FAILURE;
 
 	ldesc->net = param->net;
+#ifndef DISABLE_SECURE_SOCKET
+	if (!param->max_buff_size)
+		ldesc->buff_size = DEFAULT_CONNECTION_BUFFER_SIZE;
+#endif /* DISABLE_SECURE_SOCKET */
 
+	/*
+	 * With a max fragment length, the buffer is shrunk once the server
+	 * accepts it. Until then records can be as long as the default.
+	 */
 	if (param->max_buff_size != 0)
 		buff_size = param->max_buff_size;
 	else
@@ -337,6 +634,28 @@ int32_t socket_remove(struct tcp_socket_desc *desc)
 	return SUCCESS;
 }
 
+#ifndef DISABLE_SECURE_SOCKET
+/*
+ * The server does not send records longer than an accepted max fragment
+ * length, so the receive buffer is shrunk to match after the handshake. It
+ * gets its full size back before the next one. Backends that can't resize
+ * keep the buffer as it is.
+ */
+static void stcp_socket_fit_buffer(struct tcp_socket_desc *desc, bool shrink)
+{
+	uint32_t size;
+
+	/* Set by the user with max_buff_size */
+	if (!desc->buff_size || (!shrink && !desc->buff_shrunk))
+		return;
+
+	size = shrink ? desc->secure->max_frag_len + SECURE_RECORD_OVERHEAD :
+	       desc->buff_size;
+	if (!IS_ERR_VALUE(socket_setopt(desc, SOCKET_OPT_RCVBUF, size)))
+		desc->buff_shrunk = shrink;
+}
+#endif /* DISABLE_SECURE_SOCKET */
+
 /** @brief See \ref network_interface.socket_connect */
 int32_t socket_connect(struct tcp_socket_desc *desc,
 		       struct socket_address *addr)
@@ -353,11 +672,12 @@ int32_t socket_connect(struct tcp_socket_desc *desc,
 
 #ifndef DISABLE_SECURE_SOCKET
 	if (desc->secure) {
-		do {
-			ret = mbedtls_ssl_handshake(&desc->secure->ssl);
-		} while (ret == MBEDTLS_ERR_SSL_WANT_READ);
+		stcp_socket_fit_buffer(desc, false);
+		ret = stcp_socket_handshake(desc->secure);
 		if (IS_ERR_VALUE(ret))
 			return ret;
+		if (desc->secure->mfl_accepted)
+			stcp_socket_fit_buffer(desc, true);
 	}
 #endif /* DISABLE_SECURE_SOCKET */
 
@@ -395,6 +715,92 @@ int32_t socket_send(struct tcp_socket_desc *desc, const void *data,
 				      data, len);
 }
 
+/**
+ * @brief Send several buffers. Uses network_interface.socket_sendv when
+ * available, sends the segments one by one otherwise.
+ * @param desc - Socket descriptor
+ * @param iov - Array of segments
+ * @param iovcnt - Number of segments
+ * @return
+ *  - Number of sent bytes, less than the total on a partial send
+ *  - Negative error code on failure
+ */
+int32_t socket_sendv(struct tcp_socket_desc *desc,
+		     const struct socket_iovec *iov, uint32_t iovcnt)
+{
+	int32_t		ret;
+	uint32_t	sent;
+	uint32_t	i;
+
+	if (!desc || (!iov && iovcnt))
+		return FAILURE;
+
+#ifndef DISABLE_SECURE_SOCKET
+	if (!desc->secure && desc->net->socket_sendv)
+#else
+	if (desc->net->socket_sendv)
+#endif /* DISABLE_SECURE_SOCKET */
+		return desc->net->socket_sendv(desc->net->net, desc->id, iov,
+					       iovcnt);
+
+	sent = 0;
+	for (i = 0; i < iovcnt; i++) {
+		if (!iov[i].len)
+			continue;
+		ret = socket_send(desc, iov[i].base, iov[i].len);
+		if (IS_ERR_VALUE(ret))
+			return sent ? (int32_t)sent : ret;
+		sent += ret;
+		if ((uint32_t)ret < iov[i].len)
+			break;
+	}
+
+	return sent;
+}
+
+/**
+ * @brief Set a socket option.
+ * @param desc - Socket descriptor
+ * @param opt - Option to set
+ * @param val - Option value
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -ENOSYS : If the network interface has no socket options
+ *  - Negative error code on failure
+ */
+int32_t socket_setopt(struct tcp_socket_desc *desc, enum socket_option opt,
+		      uint32_t val)
+{
+	if (!desc)
+		return FAILURE;
+
+	if (!desc->net->socket_setopt)
+		return -ENOSYS;
+
+	return desc->net->socket_setopt(desc->net->net, desc->id, opt, val);
+}
+
+#ifndef DISABLE_SECURE_SOCKET
+/**
+ * @brief Get the handshake counters of a secure socket.
+ * @param desc - Socket descriptor
+ * @param stats - Where to store the counters
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EINVAL : If the socket is not a secure socket
+ */
+int32_t socket_secure_stats(struct tcp_socket_desc *desc,
+			    struct secure_socket_stats *stats)
+{
+	if (!desc || !stats || !desc->secure)
+		return -EINVAL;
+
+	*stats = desc->secure->stats;
+
+	return SUCCESS;
+}
+#endif /* DISABLE_SECURE_SOCKET */
+
 /** @brief See \ref network_interface.socket_recv */
 int32_t socket_recv(struct tcp_socket_desc *desc, void *data, uint32_t len)
 {
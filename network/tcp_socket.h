@@ -47,6 +47,7 @@
 
 #include "network_interface.h"
 #include <stdint.h>
+#include <stdbool.h>
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -95,6 +96,36 @@ struct secure_init_param {
 	uint8_t			*cli_pk;
 	/** cli_pk length */
 	uint32_t		cli_pk_len;
+	/**
+	 * Maximum TLS record payload to negotiate with the server (RFC 6066):
+	 * 512, 1024, 2048 or 4096, at most MAX_CONTENT_LEN. Records received
+	 * from a server that accepts it are at most this long, so once it is
+	 * accepted the receive buffer of the socket shrinks to match, when
+	 * max_buff_size is 0 and the network interface supports
+	 * SOCKET_OPT_RCVBUF. 0 to not negotiate. Needs
+	 * ENABLE_MAX_FRAGMENT_LENGTH.
+	 */
+	uint16_t		max_frag_len;
+	/**
+	 * If true, every socket_connect() runs a full handshake.
+	 * Otherwise the session of the last connection is offered to the
+	 * server (session ticket if ENABLE_SESSION_TICKETS, session ID
+	 * otherwise), which skips the key exchange when the server accepts.
+	 */
+	bool			disable_resumption;
+};
+
+/**
+ * @struct secure_socket_stats
+ * @brief Handshake counters of a secure socket
+ */
+struct secure_socket_stats {
+	/** Number of completed handshakes */
+	uint32_t	handshakes;
+	/** Number of handshakes that resumed the previous session */
+	uint32_t	resumed;
+	/** Number of handshakes where the server accepted max_frag_len */
+	uint32_t	frag_len_accepted;
 };
 
 #endif /* DISABLE_SECURE_SOCKET */
@@ -143,6 +174,20 @@ int32_t socket_disconnect(struct tcp_socket_desc *desc);
 int32_t socket_send(struct tcp_socket_desc *desc, const void *data,
 		    uint32_t len);
 
+/* Socket send of several buffers */
+int32_t socket_sendv(struct tcp_socket_desc *desc,
+		     const struct socket_iovec *iov, uint32_t iovcnt);
+
+/* Socket set option */
+int32_t socket_setopt(struct tcp_socket_desc *desc, enum socket_option opt,
+		      uint32_t val);
+
+#ifndef DISABLE_SECURE_SOCKET
+/* Secure socket handshake counters */
+int32_t socket_secure_stats(struct tcp_socket_desc *desc,
+			    struct secure_socket_stats *stats);
+#endif /* DISABLE_SECURE_SOCKET */
+
 /* Socket recv */
 int32_t socket_recv(struct tcp_socket_desc *desc, void *data, uint32_t len);
 
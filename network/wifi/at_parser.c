@@ -71,6 +71,13 @@
 #define PUI8(X)			((uint8_t *)(X))
 /* Timeout waiting for module response. (20 seconds) */
 #define MODULE_TIMEOUT		20000
+/*
+ * The module sends the passthrough data it gathered for this long. "+++" must
+ * be alone in such a packet to leave passthrough.
+ */
+#define PASSTHROUGH_PACKING_MS	20
+/* Time to wait after "+++" before sending a new command */
+#define PASSTHROUGH_EXIT_MS	1000
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -96,7 +103,7 @@ static const struct cmd_desc g_map[] = {
 	{{PUI8("+CWLIF"), 6}, AT_EXECUTE_OP},
 	{{PUI8("+CIPSTATUS"), 10}, AT_EXECUTE_OP},
 	{{PUI8("+CIPSTART"), 9}, AT_TEST_OP | AT_SET_OP},
-	{{PUI8("+CIPSEND"), 8}, AT_SET_OP},
+	{{PUI8("+CIPSEND"), 8}, AT_SET_OP | AT_EXECUTE_OP},
 	{{PUI8("+CIPCLOSE"), 9}, AT_EXECUTE_OP | AT_SET_OP},
 	{{PUI8("+CIFSR"), 6}, AT_EXECUTE_OP},
 	{{PUI8("+CIPMUX"), 7}, AT_QUERY_OP | AT_SET_OP},
@@ -127,6 +134,16 @@ struct at_desc {
 	struct irq_ctrl_desc	*irq_desc;
 	/* Uart irq id */
 	uint32_t		uart_irq_id;
+	/* Ring filled by the UART DMA, NULL if the UART interrupt is used */
+	uint8_t			*rx_ring;
+	/* Size of rx_ring */
+	uint32_t		rx_ring_size;
+	/* Index of the next byte to be parsed from rx_ring */
+	uint32_t		rx_ring_tail;
+	/* Get the index of the next byte written by the DMA in rx_ring */
+	uint32_t		(*rx_ring_head)(void *ctx);
+	/* Context passed to rx_ring_head */
+	void			*rx_ring_ctx;
 
 	/* - Connection related fields */
 	/* Structures storing connections status */
@@ -164,9 +181,14 @@ struct at_desc {
 		/* Used when a reset command have been sent */
 		RESETTING_MODULE,
 		/* Used when using AT_SEND to wait for the character '>' */
-		WAITING_SEND
-
+		WAITING_SEND,
+		/* All data received goes to connection 0. See CIPMODE=1 */
+		PASSTHROUGH
 	}			callback_operation;
+	/* Enter PASSTHROUGH instead of sending data when '>' is received */
+	bool			enter_passthrough;
+	/* The current payload interrupted WAITING_SEND */
+	bool			payload_in_send;
 	/* Indexes in the ready message */
 	uint8_t			ready_idx;
 	/* Indexes in the async response given by the driver */
@@ -365,17 +387,14 @@ static inline void end_conn_read(struct at_desc *desc)
 	cb_end_async_write(conn->cbuff);
 }
 
-/* Start new read operation */
-static inline void start_conn_read(struct at_desc *desc, bool is_new_message)
+/* Ask the application for a buffer if the payload is for a new connection */
+static inline void notify_new_conn(struct at_desc *desc)
 {
 	struct connection_desc	*conn;
-	uint8_t			*buff;
-	uint32_t		available_len;
-	uint32_t		ret;
 
 	conn = &desc->conn[desc->current_conn];
 
-	if (is_new_message && !conn->active) {
+	if (!conn->active) {
 		/*
 		 * Notify that a new connection has started. Application needs
 		 * to set a cbuff for the connection where data will be written.
@@ -393,6 +412,20 @@ static inline void start_conn_read(struct at_desc *desc, bool is_new_message)
 		 * uart_write_nonblocking
 		 */
 	}
+}
+
+/* Start new read operation */
+static inline void start_conn_read(struct at_desc *desc, bool is_new_message)
+{
+	struct connection_desc	*conn;
+	uint8_t			*buff;
+	uint32_t		available_len;
+	uint32_t		ret;
+
+	conn = &desc->conn[desc->current_conn];
+
+	if (is_new_message)
+		notify_new_conn(desc);
 
 	if (!conn->cbuff)
 		/* There is no buffer set for this connection */
@@ -416,46 +449,137 @@ dummy_read:
 	conn->to_read -= 1;
 }
 
-/* Handle the uart events */
-static void at_callback(struct at_desc *desc, uint32_t event, uint8_t *data)
+/*
+ * Interpret a character received outside of a payload.
+ * Return true if it is the last character of a +IPD header, the payload
+ * follows.
+ */
+static bool parse_char(struct at_desc *desc, uint8_t ch)
 {
 	static const struct at_buff ready_msg = {PUI8("ready\r\n"), 7};
 
+	switch (desc->callback_operation) {
+	case RESETTING_MODULE:
+		if (match_message(&ready_msg, &desc->ready_idx, ch))
+			desc->callback_operation = READING_RESPONSES;
+		break;
+	case WAITING_SEND:
+	case READING_RESPONSES:
+		if (is_payload_message(desc, ch)) {
+			/* New payload received */
+			desc->payload_in_send =
+				desc->callback_operation == WAITING_SEND;
+			desc->callback_operation = READING_PAYLOAD;
+			return true;
+		}
+
+		if (ch == '>' && desc->callback_operation == WAITING_SEND) {
+			desc->callback_operation = desc->enter_passthrough ?
+						   PASSTHROUGH :
+						   READING_RESPONSES;
+		} else if (desc->result.len >= RESULT_BUFF_LEN) {
+			desc->errors |= AT_ERROR_INTERNAL_BUFFER_OVERFLOW;
+			desc->result.len = 0;
+		} else if (!is_async_messages(desc, ch))
+			/* Add received character to result buffer */
+			desc->result.buff[desc->result.len++] = ch;
+		break;
+	default:
+		break;
+	}
+
+	return false;
+}
+
+/* Go back to the state the payload interrupted */
+static inline void end_payload(struct at_desc *desc)
+{
+	desc->callback_operation = desc->payload_in_send ? WAITING_SEND :
+				   READING_RESPONSES;
+	desc->current_conn = -1;
+}
+
+/* Write received payload to the connection buffer */
+static void write_conn_data(struct at_desc *desc, uint32_t conn_id,
+			    const uint8_t *data, uint32_t len)
+{
+	struct circular_buffer *cb = desc->conn[conn_id].cbuff;
+
+	if (!cb)
+		/* There is no buffer set for this connection, discard */
+		return ;
+
+	if (cb_write(cb, data, len) == -EOVERRUN)
+		desc->errors |= AT_ERROR_CONN_BUFFER_OVERRUN;
+}
+
+/*
+ * Parse the data the DMA wrote in the receive ring. Payloads are copied in
+ * bulk to the connection buffers, the rest is parsed character by character.
+ */
+static void process_rx_ring(struct at_desc *desc)
+{
+	struct connection_desc	*conn;
+	uint8_t			*data;
+	uint32_t		head;
+	uint32_t		len;
+
+	head = desc->rx_ring_head(desc->rx_ring_ctx);
+	while (desc->rx_ring_tail != head) {
+		data = desc->rx_ring + desc->rx_ring_tail;
+		/* Contiguous data up to the head or the end of the ring */
+		if (head > desc->rx_ring_tail)
+			len = head - desc->rx_ring_tail;
+		else
+			len = desc->rx_ring_size - desc->rx_ring_tail;
+
+		switch (desc->callback_operation) {
+		case PASSTHROUGH:
+			write_conn_data(desc, 0, data, len);
+			break;
+		case READING_PAYLOAD:
+			conn = &desc->conn[desc->current_conn];
+			len = min(len, conn->to_read);
+			write_conn_data(desc, desc->current_conn, data, len);
+			conn->to_read -= len;
+			if (!conn->to_read)
+				end_payload(desc);
+			break;
+		default:
+			len = 1;
+			if (parse_char(desc, *data))
+				notify_new_conn(desc);
+			break;
+		}
+
+		desc->rx_ring_tail += len;
+		if (desc->rx_ring_tail == desc->rx_ring_size)
+			desc->rx_ring_tail = 0;
+	}
+}
+
+/* Handle the uart events */
+static void at_callback(struct at_desc *desc, uint32_t event, uint8_t *data)
+{
 	switch (event) {
 	case IRQ_READ_DONE:
 		switch (desc->callback_operation) {
 		case RESETTING_MODULE:
-			if (match_message(&ready_msg, &desc->ready_idx,
-					  desc->read_ch))
-				desc->callback_operation = READING_RESPONSES;
-			break;
 		case WAITING_SEND:
 		case READING_RESPONSES:
-			if (is_payload_message(desc, desc->read_ch)) {
-				/* New payload received */
-				desc->callback_operation = READING_PAYLOAD;
+			if (parse_char(desc, desc->read_ch)) {
 				start_conn_read(desc, true);
 				return ;
 			}
-
-			if (desc->read_ch == '>' && desc->callback_operation ==
-			    WAITING_SEND) {
-				desc->callback_operation = READING_RESPONSES;
-			} else if (desc->result.len >= RESULT_BUFF_LEN) {
-				desc->errors |=
-					AT_ERROR_INTERNAL_BUFFER_OVERFLOW;
-				desc->result.len = 0;
-			} else if (!is_async_messages(desc, desc->read_ch))
-				/* Add received character to result buffer */
-				desc->result.buff[desc->result.len++] =
-					desc->read_ch;
+			break;
+		case PASSTHROUGH:
+			write_conn_data(desc, 0, &desc->read_ch, 1);
 			break;
 		case READING_PAYLOAD:
 			/* Receiving payload from connection */
 			end_conn_read(desc);
 			if (!desc->conn[desc->current_conn].to_read) {
-				desc->callback_operation = READING_RESPONSES;
-				desc->current_conn = -1;
+				end_payload(desc);
 				break;
 			} else {
 				start_conn_read(desc, false);
@@ -494,7 +618,9 @@ static int32_t wait_for_response(struct at_desc *desc)
 	timeout = MODULE_TIMEOUT;
 	result = FAILURE;
 	do {
-		if (i < desc->result.len) {
+		at_poll(desc);
+		/* Check everything received before sleeping again */
+		while (i < desc->result.len) {
 			for (j = 0; j < NB_RESPONSE_MESSAGES; j++)
 				if (match_message(&responses[j],
 						  &desc->resp_idx[j],
@@ -527,39 +653,69 @@ end:
 	return result;
 }
 
+/* Send the AT_SEND command in desc->cmd and wait for the '>' prompt */
+static int32_t wait_send_prompt(struct at_desc *desc)
+{
+	uint32_t timeout = MODULE_TIMEOUT;
+
+	/* Let the payload being received end before changing the state */
+	while (desc->callback_operation == READING_PAYLOAD && --timeout) {
+		at_poll(desc);
+		mdelay(1);
+	}
+	if (!timeout)
+		return FAILURE;
+	timeout = MODULE_TIMEOUT;
+
+	desc->callback_operation = WAITING_SEND;
+	uart_write(desc->uart_desc, desc->cmd.buff, desc->cmd.len);
+	/* Waiting for ok */
+	if (SUCCESS != wait_for_response(desc)) {
+		desc->callback_operation = READING_RESPONSES;
+		return FAILURE;
+	}
+	/* Wait until '>' is received */
+	while (--timeout) {
+		at_poll(desc);
+		if (WAITING_SEND != desc->callback_operation)
+			break;
+		mdelay(1);
+	}
+	if (!timeout) {
+		desc->callback_operation = READING_RESPONSES;
+		return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
 /* Send what is in desc->cmd over the UART and handle special case of AT_SEND */
 static int32_t send_cmd(struct at_desc *desc, enum at_cmd cmd,
 			union in_param *in_param)
 {
 	uint32_t timeout = MODULE_TIMEOUT;
 
-	uart_write(desc->uart_desc, desc->cmd.buff, desc->cmd.len);
 	if (cmd == AT_SEND) {
-		desc->callback_operation = WAITING_SEND;
-		/* Waiting for ok */
-		if (SUCCESS != wait_for_response(desc))
-			return FAILURE;
-		/* Wait until '>' is received */
-		while (timeout--) {
-			if (WAITING_SEND != desc->callback_operation)
-				break;
-			mdelay(1);
-		}
-		if (timeout == 0)
+		if (SUCCESS != wait_send_prompt(desc))
 			return FAILURE;
 		/* Write payload */
 		uart_write(desc->uart_desc, in_param->send_data.data.buff,
 			   in_param->send_data.data.len);
-	} else if (cmd == AT_DISCONNECT_NETWORK) {
+	} else {
+		uart_write(desc->uart_desc, desc->cmd.buff, desc->cmd.len);
+	}
+
+	if (cmd == AT_DISCONNECT_NETWORK) {
 		if (desc->is_wifi_connected) {
 			/* Wait for WIFI_DISCONNECT */
 			do {
+				at_poll(desc);
 				if (desc->is_wifi_connected == 0)
 					break;
 				mdelay(1);
-			} while (timeout--);
+			} while (--timeout);
 
-			if (timeout == 0)
+			if (!timeout)
 				return FAILURE;
 
 			return SUCCESS;
@@ -570,6 +726,30 @@ static int32_t send_cmd(struct at_desc *desc, enum at_cmd cmd,
 	return wait_for_response(desc);
 }
 
+/* Write nb in decimal at the end of dest */
+static void concat_int(struct at_buff *dest, int32_t nb)
+{
+	uint8_t		digits[10];
+	uint32_t	val;
+	uint32_t	i;
+
+	if (nb < 0) {
+		dest->buff[dest->len++] = '-';
+		val = -(uint32_t)nb;
+	} else {
+		val = nb;
+	}
+
+	i = 0;
+	do {
+		digits[i++] = '0' + val % 10;
+		val /= 10;
+	} while (val);
+
+	while (i)
+		dest->buff[dest->len++] = digits[--i];
+}
+
 /*
  * @brief Create formated string in dest according with fmt
  * The formated string is concatenated to dest.
@@ -583,20 +763,14 @@ static int32_t send_cmd(struct at_desc *desc, enum at_cmd cmd,
 static void set_params(struct at_buff *dest, uint8_t *fmt, ...)
 {
 	va_list		args;
-	char		buff[12]; //A MAX int32_t fits
 	struct at_buff	*str;
 	uint32_t		i;
-	int32_t		nb = 0;
 
 	va_start (args, fmt);
 	while (*fmt) {
 		switch (*fmt) {
 		case 'd':
-			nb = va_arg(args, int32_t);
-			itoa(nb, buff, 10);
-			/* Concatenate buff to dest */
-			memcpy(dest->buff + dest->len, buff, strlen(buff));
-			dest->len += strlen(buff);
+			concat_int(dest, va_arg(args, int32_t));
 			break;
 		case 's':
 			str = va_arg(args, struct at_buff *);
@@ -797,15 +971,16 @@ static int32_t handle_special(struct at_desc *desc, enum at_cmd cmd)
 		uart_write(desc->uart_desc, desc->cmd.buff, desc->cmd.len);
 		timeout = MODULE_TIMEOUT;
 		do {
+			at_poll(desc);
 			/* Wait for "ready" message */
 			if (desc->callback_operation != RESETTING_MODULE)
 				break;
 			mdelay(1);
-		} while (timeout--);
+		} while (--timeout);
 		if (!timeout)
 			return FAILURE;
 
-		desc->callback_operation = READING_PAYLOAD;
+		desc->callback_operation = READING_RESPONSES;
 		desc->result.len = 0;
 		if (SUCCESS != stop_echo(desc))
 			return FAILURE;
@@ -852,9 +1027,13 @@ int32_t at_run_cmd(struct at_desc *desc, enum at_cmd cmd, enum cmd_operation op,
 	uint32_t	id;
 	int32_t		ret;
 
-	if (!desc || cmd == AT_SET_TRANSPORT_MODE)
+	if (!desc)
 		return FAILURE;
 
+	/* Commands can't be sent until passthrough is stopped */
+	if (desc->callback_operation == PASSTHROUGH)
+		return -EBUSY;
+
 	if (!(g_map[cmd].type & op))
 		return FAILURE;
 
@@ -915,6 +1094,9 @@ int32_t at_init(struct at_desc **desc, const struct at_init_param *param)
 	if (!desc || !param || !param->connection_callback)
 		return FAILURE;
 
+	if (param->rx_ring && (!param->rx_ring_head || !param->rx_ring_size))
+		return -EINVAL;
+
 	ldesc = calloc(1, sizeof(*ldesc));
 	if (!ldesc)
 		return FAILURE;
@@ -925,20 +1107,29 @@ int32_t at_init(struct at_desc **desc, const struct at_init_param *param)
 	ldesc->uart_desc = param->uart_desc;
 	ldesc->irq_desc = param->irq_desc;
 	ldesc->uart_irq_id = param->uart_irq_id;
-	callback_desc.callback =
-		(void (*)(void*, uint32_t, void*))at_callback;
-	callback_desc.ctx = ldesc;
-	callback_desc.config = param->uart_irq_conf;
-	if (SUCCESS != irq_register_callback(ldesc->irq_desc,
-					     ldesc->uart_irq_id,
-					     &callback_desc))
-		goto free_desc;
-
-	if (SUCCESS != irq_enable(ldesc->irq_desc, ldesc->uart_irq_id))
-		goto free_irq;
-
-	/* The read will be handled by the callback */
-	uart_read_nonblocking(ldesc->uart_desc, &ldesc->read_ch, 1);
+	ldesc->rx_ring = param->rx_ring;
+	ldesc->rx_ring_size = param->rx_ring_size;
+	ldesc->rx_ring_head = param->rx_ring_head;
+	ldesc->rx_ring_ctx = param->rx_ring_ctx;
+	if (ldesc->rx_ring) {
+		/* Start parsing from the data received from now on */
+		ldesc->rx_ring_tail = ldesc->rx_ring_head(ldesc->rx_ring_ctx);
+	} else {
+		callback_desc.callback =
+			(void (*)(void*, uint32_t, void*))at_callback;
+		callback_desc.ctx = ldesc;
+		callback_desc.config = param->uart_irq_conf;
+		if (SUCCESS != irq_register_callback(ldesc->irq_desc,
+						     ldesc->uart_irq_id,
+						     &callback_desc))
+			goto free_desc;
+
+		if (SUCCESS != irq_enable(ldesc->irq_desc, ldesc->uart_irq_id))
+			goto free_irq;
+
+		/* The read will be handled by the callback */
+		uart_read_nonblocking(ldesc->uart_desc, &ldesc->read_ch, 1);
+	}
 
 	/* Link buffer structure with static buffers */
 	ldesc->result.buff = ldesc->buffers.result_buff;
@@ -973,7 +1164,8 @@ int32_t at_init(struct at_desc **desc, const struct at_init_param *param)
 	return SUCCESS;
 
 free_irq:
-	irq_unregister(ldesc->irq_desc, ldesc->uart_irq_id);
+	if (!ldesc->rx_ring)
+		irq_unregister(ldesc->irq_desc, ldesc->uart_irq_id);
 free_desc:
 	free(ldesc);
 	*desc = NULL;
@@ -992,12 +1184,147 @@ int32_t at_remove(struct at_desc *desc)
 	if (!desc)
 		return FAILURE;
 
-	irq_unregister(desc->irq_desc, desc->uart_irq_id);
+	if (!desc->rx_ring)
+		irq_unregister(desc->irq_desc, desc->uart_irq_id);
 	free(desc);
 
 	return SUCCESS;
 }
 
+/**
+ * @brief Parse the data received in the receive ring.
+ *
+ * Needed only when \ref at_init_param.rx_ring is used. The parser calls it
+ * while waiting for the module, the user must call it before reading the
+ * connection buffers.
+ * @param desc - AT parser reference
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EINVAL : On invalid parameters
+ */
+int32_t at_poll(struct at_desc *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	if (desc->rx_ring)
+		process_rx_ring(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Enter passthrough (CIPMODE=1) on the connection of a module in
+ * \ref SINGLE_CONNECTION mode.
+ *
+ * After this, data written with \ref at_passthrough_write is sent with no
+ * AT+CIPSEND round trip and all the data received goes to the buffer of
+ * connection 0, with no +IPD header. Commands can't be used until
+ * \ref at_passthrough_stop is called.
+ * @param desc - AT parser reference
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EINVAL : If multiple connection mode is used
+ *  - \ref FAILURE : Otherwise
+ */
+int32_t at_passthrough_start(struct at_desc *desc)
+{
+	union in_out_param	param;
+	int32_t			ret;
+
+	if (!desc || desc->multiple_conections)
+		return -EINVAL;
+
+	param.in.transport_mode = UNVARNISHED_MODE;
+	ret = at_run_cmd(desc, AT_SET_TRANSPORT_MODE, AT_SET_OP, &param);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	/* The connection buffer is set by the first payload */
+	desc->current_conn = 0;
+	notify_new_conn(desc);
+
+	build_cmd(desc, AT_SEND, AT_EXECUTE_OP, NULL);
+	desc->enter_passthrough = true;
+	ret = wait_send_prompt(desc);
+	desc->enter_passthrough = false;
+	if (IS_ERR_VALUE(ret)) {
+		param.in.transport_mode = NORMAL_MODE;
+		at_run_cmd(desc, AT_SET_TRANSPORT_MODE, AT_SET_OP, &param);
+		return ret;
+	}
+	desc->result.len = 0;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Send data in passthrough mode
+ *
+ * The module sends "+++" received alone in a packet as the passthrough exit
+ * sequence and not as data.
+ * @param desc - AT parser reference
+ * @param data - Data to send
+ * @param len - Length of data
+ * @return
+ *  - Number of bytes sent on success
+ *  - -ENOTCONN : If passthrough is not started
+ */
+int32_t at_passthrough_write(struct at_desc *desc, const uint8_t *data,
+			     uint32_t len)
+{
+	int32_t ret;
+
+	if (!desc || (!data && len))
+		return -EINVAL;
+
+	if (desc->callback_operation != PASSTHROUGH)
+		return -ENOTCONN;
+
+	/* Move what was received out of the ring before it can wrap */
+	at_poll(desc);
+
+	ret = uart_write(desc->uart_desc, data, len);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	return len;
+}
+
+/**
+ * @brief Leave passthrough and go back to command mode (CIPMODE=0).
+ * The connection is kept.
+ * @param desc - AT parser reference
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - \ref FAILURE : Otherwise
+ */
+int32_t at_passthrough_stop(struct at_desc *desc)
+{
+	union in_out_param	param;
+	uint32_t		i;
+
+	if (!desc)
+		return -EINVAL;
+
+	if (desc->callback_operation != PASSTHROUGH)
+		return SUCCESS;
+
+	mdelay(PASSTHROUGH_PACKING_MS);
+	uart_write(desc->uart_desc, PUI8("+++"), 3);
+	/* Data received until the module leaves passthrough is still kept */
+	for (i = 0; i < PASSTHROUGH_EXIT_MS; i++) {
+		at_poll(desc);
+		mdelay(1);
+	}
+	desc->callback_operation = READING_RESPONSES;
+	desc->result.len = 0;
+
+	param.in.transport_mode = NORMAL_MODE;
+
+	return at_run_cmd(desc, AT_SET_TRANSPORT_MODE, AT_SET_OP, &param);
+}
+
 /**
  * @brief Convert null terminated string to at_buff
  * @param dest - Destination buffer
@@ -203,8 +203,9 @@ enum at_cmd {
 	 */
 	AT_SET_SERVER,			// "+CIPSERVER"
 	/**
-	 * Set transport mode: Not supported command.
-	 * Use \ref in_param.transport_mode as set parameter
+	 * Set transport mode.
+	 * Use \ref in_param.transport_mode as set parameter.
+	 * Passthrough is entered with \ref at_passthrough_start
 	 */
 	AT_SET_TRANSPORT_MODE,		// "+CIPMODE"
 	/**
@@ -329,6 +330,20 @@ struct at_init_param {
 			enum at_event event,
 			uint32_t conn_id,
 			struct circular_buffer **cb);
+	/*
+	 * Optional ring written by the UART DMA in circular mode. If set, the
+	 * UART interrupt is not used: received data is parsed in bulk by
+	 * at_poll and payloads are copied to the connection buffers in one go
+	 * instead of one interrupt per character. It must hold what the
+	 * module can send between two calls of at_poll, older data is lost.
+	 */
+	uint8_t			*rx_ring;
+	/* Size of rx_ring */
+	uint32_t		rx_ring_size;
+	/* Return the index in rx_ring where the DMA writes the next byte */
+	uint32_t		(*rx_ring_head)(void *ctx);
+	/* Context passed to rx_ring_head */
+	void			*rx_ring_ctx;
 };
 
 /**
@@ -349,6 +364,15 @@ int32_t at_remove(struct at_desc *desc);
 /* Execute an AT command */
 int32_t at_run_cmd(struct at_desc *desc, enum at_cmd cmd, enum cmd_operation op,
 		   union in_out_param *param);
+/* Parse the data received in the receive ring */
+int32_t at_poll(struct at_desc *desc);
+/* Enter passthrough mode on the single connection */
+int32_t at_passthrough_start(struct at_desc *desc);
+/* Send data in passthrough mode */
+int32_t at_passthrough_write(struct at_desc *desc, const uint8_t *data,
+			     uint32_t len);
+/* Leave passthrough mode */
+int32_t at_passthrough_stop(struct at_desc *desc);
 /* Convert null terminated string to at_buff */
 int32_t str_to_at(struct at_buff *dest, const uint8_t *src);
 /* Convert at_buff to null terminated string */
@@ -71,6 +71,12 @@ struct socket_desc {
 	enum socket_protocol	type;
 	/* Connection id */
 	uint32_t		conn_id;
+	/* Data gathered to be sent with a single AT+CIPSEND */
+	uint8_t			*tx_buff;
+	/* Length of data in tx_buff */
+	uint32_t		tx_len;
+	/* If set, sends are gathered in tx_buff until uncorked or full */
+	bool			cork;
 	/* States of a socket structure */
 	enum {
 		/* The socket structure is unused */
@@ -109,6 +115,8 @@ struct wifi_desc {
 	struct network_interface	interface;
 	/* Will be used in callback */
 	int32_t				conn_id_to_sock_id[MAX_CONNECTIONS];
+	/* Single connection in passthrough mode */
+	bool				passthrough;
 };
 
 /******************************************************************************/
@@ -125,6 +133,11 @@ static int32_t wifi_socket_send(struct wifi_desc *desc, uint32_t sock_id,
 				const void *data, uint32_t size);
 static int32_t wifi_socket_recv(struct wifi_desc *desc, uint32_t sock_id,
 				void *data, uint32_t size);
+static int32_t wifi_socket_sendv(struct wifi_desc *desc, uint32_t sock_id,
+				 const struct socket_iovec *iov,
+				 uint32_t iovcnt);
+static int32_t wifi_socket_setopt(struct wifi_desc *desc, uint32_t sock_id,
+				  enum socket_option opt, uint32_t val);
 static int32_t wifi_socket_sendto(struct wifi_desc *desc, uint32_t sock_id,
 				  const void *data, uint32_t size,
 				  struct socket_address to);
@@ -196,6 +209,56 @@ static inline void _wifi_release_conn(struct wifi_desc *desc,
 	}
 }
 
+/* Send the data gathered in the socket transmit buffer with one AT+CIPSEND */
+static int32_t _wifi_flush(struct wifi_desc *desc, struct socket_desc *sock)
+{
+	union in_out_param	param;
+	int32_t			ret;
+
+	if (!sock->tx_len)
+		return SUCCESS;
+
+	param.in.send_data.id = sock->conn_id;
+	param.in.send_data.data.buff = sock->tx_buff;
+	param.in.send_data.data.len = sock->tx_len;
+	ret = at_run_cmd(desc->at, AT_SEND, AT_SET_OP, &param);
+	sock->tx_len = 0;
+
+	return ret;
+}
+
+/*
+ * Copy data to the socket transmit buffer, sending it each time
+ * MAX_CIPSEND_DATA bytes are gathered
+ */
+static int32_t _wifi_gather(struct wifi_desc *desc, struct socket_desc *sock,
+			    const uint8_t *data, uint32_t len)
+{
+	uint32_t	to_copy;
+	int32_t		ret;
+
+	if (!sock->tx_buff) {
+		sock->tx_buff = malloc(MAX_CIPSEND_DATA);
+		if (!sock->tx_buff)
+			return -ENOMEM;
+	}
+
+	while (len) {
+		to_copy = min(len, MAX_CIPSEND_DATA - sock->tx_len);
+		memcpy(sock->tx_buff + sock->tx_len, data, to_copy);
+		sock->tx_len += to_copy;
+		data += to_copy;
+		len -= to_copy;
+		if (sock->tx_len == MAX_CIPSEND_DATA) {
+			ret = _wifi_flush(desc, sock);
+			if (IS_ERR_VALUE(ret))
+				return ret;
+		}
+	}
+
+	return SUCCESS;
+}
+
 /* Connect internal functions to the network interface */
 static void wifi_init_interface(struct wifi_desc *desc)
 {
@@ -236,6 +299,13 @@ static void wifi_init_interface(struct wifi_desc *desc)
 	desc->interface.socket_accept =
 		(int32_t (*)(void *, uint32_t, uint32_t*))
 		wifi_socket_accept;
+	desc->interface.socket_sendv =
+		(int32_t (*)(void *, uint32_t, const struct socket_iovec *,
+			     uint32_t))
+		wifi_socket_sendv;
+	desc->interface.socket_setopt =
+		(int32_t (*)(void *, uint32_t, enum socket_option, uint32_t))
+		wifi_socket_setopt;
 }
 
 static inline int32_t _get_initialized_client_id(struct wifi_desc *desc)
@@ -323,6 +393,11 @@ int32_t wifi_init(struct wifi_desc **desc, struct wifi_init_param *param)
 	at_param.uart_irq_id = param->uart_irq_id;
 	at_param.connection_callback = _wifi_connection_callback;
 	at_param.callback_ctx = ldesc;
+	at_param.rx_ring = param->rx_ring;
+	at_param.rx_ring_size = param->rx_ring_size;
+	at_param.rx_ring_head = param->rx_ring_head;
+	at_param.rx_ring_ctx = param->rx_ring_ctx;
+	ldesc->passthrough = param->passthrough;
 
 	result = at_init(&ldesc->at, &at_param);
 	if (IS_ERR_VALUE(result))
@@ -339,7 +414,9 @@ int32_t wifi_init(struct wifi_desc **desc, struct wifi_init_param *param)
 	if (IS_ERR_VALUE(result))
 		goto at_err;
 
-	par.in.conn_type = MULTIPLE_CONNECTION;
+	/* Passthrough is only available with a single connection */
+	par.in.conn_type = ldesc->passthrough ? SINGLE_CONNECTION :
+			   MULTIPLE_CONNECTION;
 	result = at_run_cmd(ldesc->at, AT_SET_CONNECTION_TYPE, AT_SET_OP, &par);
 	if (IS_ERR_VALUE(result))
 		goto at_err;
@@ -523,6 +600,11 @@ static int32_t wifi_socket_close(struct wifi_desc *desc, uint32_t sock_id)
 	if (IS_ERR_VALUE(ret))
 		return ret;
 
+	free(sock->tx_buff);
+	sock->tx_buff = NULL;
+	sock->tx_len = 0;
+	sock->cork = false;
+
 	/* Server socket circular buffer will be released only when server
 	 * is removed */
 	if (!_is_server_socket(desc, sock_id)) {
@@ -545,7 +627,7 @@ static int32_t wifi_socket_connect(struct wifi_desc *desc, uint32_t sock_id,
 				   struct socket_address *addr)
 {
 	union in_out_param	param;
-	uint32_t		ret;
+	int32_t			ret;
 	struct socket_desc	*sock;
 
 	if (!desc || !addr || sock_id >= NB_SOCKETS ||
@@ -559,6 +641,10 @@ static int32_t wifi_socket_connect(struct wifi_desc *desc, uint32_t sock_id,
 	if (sock->state == SOCKET_CONNECTED)
 		return -EISCONN;
 
+	/* The module runs a single connection */
+	if (desc->passthrough && desc->conn_id_to_sock_id[0] != INVALID_ID)
+		return -EMLINK;
+
 	ret = _wifi_get_unused_conn(desc, sock_id);
 	if (IS_ERR_VALUE(ret))
 		return ret;
@@ -574,6 +660,16 @@ static int32_t wifi_socket_connect(struct wifi_desc *desc, uint32_t sock_id,
 		return ret;
 	}
 
+	if (desc->passthrough) {
+		ret = at_passthrough_start(desc->at);
+		if (IS_ERR_VALUE(ret)) {
+			at_run_cmd(desc->at, AT_STOP_CONNECTION, AT_EXECUTE_OP,
+				   NULL);
+			_wifi_release_conn(desc, sock_id);
+			return ret;
+		}
+	}
+
 	sock->state = SOCKET_CONNECTED;
 
 	return SUCCESS;
@@ -595,7 +691,7 @@ static void _remove_server_back_log(struct wifi_desc *desc)
 static int32_t wifi_socket_disconnect(struct wifi_desc *desc, uint32_t sock_id)
 {
 	union in_out_param	param;
-	uint32_t		ret;
+	int32_t			ret;
 	struct socket_desc	*sock;
 
 	if (!desc || sock_id >= NB_SOCKETS)
@@ -619,7 +715,18 @@ static int32_t wifi_socket_disconnect(struct wifi_desc *desc, uint32_t sock_id)
 
 		/* Remove server reference */
 		desc->server.id = INVALID_ID;
+	} else if (desc->passthrough) {
+		ret = at_passthrough_stop(desc->at);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+		ret = at_run_cmd(desc->at, AT_STOP_CONNECTION, AT_EXECUTE_OP,
+				 NULL);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+		_wifi_release_conn(desc, sock_id);
 	} else {
+		/* Data gathered by socket_setopt(SOCKET_OPT_CORK) */
+		_wifi_flush(desc, sock);
 		param.in.conn_id = sock->conn_id;
 		ret = at_run_cmd(desc->at, AT_STOP_CONNECTION, AT_SET_OP,
 				 &param);
@@ -638,7 +745,7 @@ static int32_t wifi_socket_send(struct wifi_desc *desc, uint32_t sock_id,
 				const void *data, uint32_t size)
 {
 	union in_out_param	param;
-	uint32_t		ret;
+	int32_t			ret;
 	struct socket_desc	*sock;
 	uint32_t		to_send;
 	uint32_t		i;
@@ -650,6 +757,22 @@ static int32_t wifi_socket_send(struct wifi_desc *desc, uint32_t sock_id,
 	if (sock->state != SOCKET_CONNECTED)
 		return -ENOTCONN;
 
+	if (desc->passthrough)
+		return at_passthrough_write(desc->at, data, size);
+
+	if (sock->cork) {
+		ret = _wifi_gather(desc, sock, data, size);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+
+		return (int32_t)size;
+	}
+
+	/* Keep the order with data gathered before */
+	ret = _wifi_flush(desc, sock);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
 	i = 0;
 	do {
 		to_send = min(size - i, MAX_CIPSEND_DATA);
@@ -683,6 +806,9 @@ static int32_t wifi_socket_recv(struct wifi_desc *desc, uint32_t sock_id,
 	if (sock->state != SOCKET_CONNECTED)
 		return -ENOTCONN;
 
+	/* Parse what the DMA received since the last call */
+	at_poll(desc->at);
+
 	cb_size(sock->cb, &available_size);
 	if (available_size == 0)
 		return -EAGAIN;
@@ -695,6 +821,75 @@ static int32_t wifi_socket_recv(struct wifi_desc *desc, uint32_t sock_id,
 	return size;
 }
 
+/**
+ * @brief Send several buffers. They are gathered in AT+CIPSEND commands of
+ * up to MAX_CIPSEND_DATA bytes instead of one command per buffer.
+ */
+static int32_t wifi_socket_sendv(struct wifi_desc *desc, uint32_t sock_id,
+				 const struct socket_iovec *iov,
+				 uint32_t iovcnt)
+{
+	struct socket_desc	*sock;
+	uint32_t		sent;
+	uint32_t		i;
+	int32_t			ret;
+
+	if (!desc || sock_id >= NB_SOCKETS || desc->server.id == sock_id)
+		return -EINVAL;
+
+	sock = &desc->sockets[sock_id];
+	if (sock->state != SOCKET_CONNECTED)
+		return -ENOTCONN;
+
+	sent = 0;
+	for (i = 0; i < iovcnt; i++) {
+		if (desc->passthrough)
+			ret = at_passthrough_write(desc->at, iov[i].base,
+						   iov[i].len);
+		else
+			ret = _wifi_gather(desc, sock, iov[i].base, iov[i].len);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+		sent += iov[i].len;
+	}
+
+	if (!sock->cork) {
+		ret = _wifi_flush(desc, sock);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	return sent;
+}
+
+/**
+ * @brief Set a socket option. SOCKET_OPT_CORK gathers the sent data in
+ * AT+CIPSEND commands of MAX_CIPSEND_DATA bytes until it is cleared.
+ */
+static int32_t wifi_socket_setopt(struct wifi_desc *desc, uint32_t sock_id,
+				  enum socket_option opt, uint32_t val)
+{
+	struct socket_desc *sock;
+
+	if (!desc || sock_id >= NB_SOCKETS)
+		return -EINVAL;
+
+	sock = &desc->sockets[sock_id];
+	switch (opt) {
+	case SOCKET_OPT_CORK:
+		sock->cork = !!val;
+		if (sock->cork || sock->state != SOCKET_CONNECTED)
+			return SUCCESS;
+
+		return _wifi_flush(desc, sock);
+	case SOCKET_OPT_NODELAY:
+		/* Data is not delayed unless the socket is corked */
+		return SUCCESS;
+	default:
+		return -ENOSYS;
+	}
+}
+
 /** @brief See \ref network_interface.socket_sendto */
 static int32_t wifi_socket_sendto(struct wifi_desc *desc, uint32_t sock_id,
 				  const void *data, uint32_t size,
@@ -736,6 +931,10 @@ static int32_t wifi_socket_bind(struct wifi_desc *desc, uint32_t sock_id,
 	if (desc->server.id != INVALID_ID)
 		return -EMLINK;
 
+	/* The module can't run a server in single connection mode */
+	if (desc->passthrough)
+		return -ENOSYS;
+
 	if (desc->sockets[sock_id].state == SOCKET_UNUSED)
 		return -ENODEV;
 
@@ -825,6 +1024,9 @@ static int32_t wifi_socket_accept(struct wifi_desc *desc, uint32_t sock_id,
 	if (desc->sockets[desc->server.id].state != SOCKET_LISTENING)
 		return -ENOTCONN;
 
+	/* New connections are notified while parsing */
+	at_poll(desc->at);
+
 	for (i = 0; i < NB_SOCKETS; i++)
 		if (desc->sockets[i].state == SOCKET_WAITING_ACCEPT) {
 			desc->sockets[i].state = SOCKET_CONNECTED;
@@ -46,6 +46,7 @@
 /******************************************************************************/
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "network_interface.h"
 #include "no-os/uart.h"
 #include "no-os/irq.h"
@@ -73,6 +74,24 @@ struct wifi_init_param {
 	uint32_t		uart_irq_id;
 	/** Configuration param for registering uart callback */
 	void			*uart_irq_conf;
+	/**
+	 * Optional ring written by the UART DMA in circular mode.
+	 * See \ref at_init_param.rx_ring
+	 */
+	uint8_t			*rx_ring;
+	/** Size of rx_ring */
+	uint32_t		rx_ring_size;
+	/** Return the index in rx_ring where the DMA writes the next byte */
+	uint32_t		(*rx_ring_head)(void *ctx);
+	/** Context passed to rx_ring_head */
+	void			*rx_ring_ctx;
+	/**
+	 * Throughput mode: the module runs a single connection in
+	 * passthrough (CIPMODE=1), so sends don't need an AT+CIPSEND round
+	 * trip and received data has no +IPD header. Only one socket can be
+	 * connected at a time and server sockets are not available.
+	 */
+	bool			passthrough;
 };
 
 /******************************************************************************/
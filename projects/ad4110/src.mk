@@ -20,7 +20,8 @@ SRCS += $(PLATFORM_DRIVERS)/xilinx_spi.c \
 	$(PLATFORM_DRIVERS)/xilinx_gpio.c \
 	$(PLATFORM_DRIVERS)/xilinx_gpio_irq.c \
 	$(PLATFORM_DRIVERS)/delay.c \
-	$(NO-OS)/util/list.c
+	$(NO-OS)/util/list.c \
+	$(NO-OS)/util/crc8.c
 
 INCS += $(DRIVERS)/afe/ad4110/ad4110.h
 
@@ -36,4 +37,5 @@ INCS += $(INCLUDE)/no-os/spi.h \
 	$(INCLUDE)/no-os/irq.h \
 	$(INCLUDE)/no-os/util.h \
 	$(INCLUDE)/no-os/print_log.h \
-	$(INCLUDE)/no-os/list.h
+	$(INCLUDE)/no-os/list.h \
+	$(INCLUDE)/no-os/crc8.h
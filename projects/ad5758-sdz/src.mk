@@ -5,6 +5,7 @@ SRCS += $(DRIVERS)/api/gpio.c \
         $(PLATFORM_DRIVERS)/$(PLATFORM)_spi.c \
         $(PLATFORM_DRIVERS)/$(PLATFORM)_gpio.c \
 	$(PLATFORM_DRIVERS)/delay.c \
+	$(NO-OS)/util/crc8.c \
 	$(DRIVERS)/dac/ad5758/ad5758.c
 
 INCS += $(INCLUDE)/no-os/gpio.h \
@@ -12,6 +13,7 @@ INCS += $(INCLUDE)/no-os/gpio.h \
         $(INCLUDE)/no-os/error.h \
         $(INCLUDE)/no-os/delay.h \
         $(INCLUDE)/no-os/print_log.h \
+	$(INCLUDE)/no-os/crc8.h \
         $(PLATFORM_DRIVERS)/gpio_extra.h \
 	$(PLATFORM_DRIVERS)/spi_extra.h	\
 	$(DRIVERS)/dac/ad5758/ad5758.h
@@ -46,6 +46,7 @@ INCS += $(DRIVERS)/axi_core/axi_adc_core/axi_adc_core.h \
 	$(DRIVERS)/axi_core/jesd204/axi_adxcvr.h \
 	$(DRIVERS)/axi_core/jesd204/axi_jesd204_rx.h \
 	$(DRIVERS)/axi_core/jesd204/xilinx_transceiver.h \
+	$(DRIVERS)/axi_core/jesd204/xilinx_transceiver_pll_table.h \
 	$(DRIVERS)/io-expander/demux_spi/demux_spi.h \
 	$(DRIVERS)/adc/ad6676/ad6676.h
 INCS +=	$(PLATFORM_DRIVERS)/spi_extra.h \
@@ -11,15 +11,21 @@
 
 SRCS += $(PROJECT)/src/ad7124-4sdz.c
 SRCS += $(DRIVERS)/api/spi.c \
+	$(DRIVERS)/api/irq.c \
 	$(DRIVERS)/adc/ad7124/ad7124.c \
 	$(DRIVERS)/adc/ad7124/ad7124_regs.c				
 SRCS +=	$(PLATFORM_DRIVERS)/axi_io.c \
 	$(PLATFORM_DRIVERS)/xilinx_spi.c \
+	$(PLATFORM_DRIVERS)/timer.c \
 	$(PLATFORM_DRIVERS)/delay.c
+SRCS += $(NO-OS)/util/crc8.c \
+	$(NO-OS)/util/circular_buffer.c \
+	$(NO-OS)/util/drdy_acq.c
 INCS += $(DRIVERS)/adc/ad7124/ad7124.h \
 	$(DRIVERS)/adc/ad7124/ad7124_regs.h
 
 INCS +=	$(PLATFORM_DRIVERS)/spi_extra.h \
+	$(PLATFORM_DRIVERS)/timer_extra.h \
 	$(PLATFORM_DRIVERS)/irq_extra.h \
 	$(PLATFORM_DRIVERS)/uart_extra.h \
 	$(PLATFORM_DRIVERS)/gpio_extra.h
@@ -30,4 +36,8 @@ INCS +=	$(INCLUDE)/no-os/axi_io.h \
 	$(INCLUDE)/no-os/delay.h \
 	$(INCLUDE)/no-os/irq.h \
 	$(INCLUDE)/no-os/uart.h \
+	$(INCLUDE)/no-os/timer.h \
+	$(INCLUDE)/no-os/crc8.h \
+	$(INCLUDE)/no-os/circular_buffer.h \
+	$(INCLUDE)/no-os/drdy_acq.h \
 	$(INCLUDE)/no-os/util.h
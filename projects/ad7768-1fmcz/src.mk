@@ -17,6 +17,8 @@ SRCS += $(DRIVERS)/api/spi.c \
 	$(DRIVERS)/adc/ad7768-1/ad77681.c \
 	$(DRIVERS)/axi_core/axi_dmac/axi_dmac.c \
 	$(DRIVERS)/axi_core/spi_engine/spi_engine.c \
+	$(NO-OS)/util/crc8.c \
+	$(NO-OS)/util/circular_buffer.c \
 	$(NO-OS)/util/util.c
 SRCS +=	$(PLATFORM_DRIVERS)/axi_io.c \
 	$(PLATFORM_DRIVERS)/xilinx_gpio.c \
@@ -38,4 +40,6 @@ INCS +=	$(INCLUDE)/no-os/axi_io.h \
 	$(INCLUDE)/no-os/delay.h \
 	$(INCLUDE)/no-os/irq.h \
 	$(INCLUDE)/no-os/uart.h \
+	$(INCLUDE)/no-os/crc8.h \
+	$(INCLUDE)/no-os/circular_buffer.h \
 	$(INCLUDE)/no-os/util.h
@@ -54,6 +54,7 @@
 #include "parameters.h"
 #include "no-os/delay.h"
 #include "no-os/error.h"
+#include "no-os/util.h"
 
 uint32_t spi_msg_cmds[6] = {CS_LOW, CS_HIGH, CS_LOW, WRITE_READ(1), CS_HIGH};
 
@@ -103,16 +104,38 @@ struct axi_clkgen_init clkgen_init = {
 	.parent_rate = 100000000,
 };
 
+struct ad77681_capture_init_param capture_init_param = {
+	.burst_len = AD77681_EVB_SAMPLE_NO,
+	.ring_len = AD77681_EVB_SAMPLE_NO * 4,
+};
+
+/* Print the captured samples and the frames dropped so far */
+static void ad77681evb_print_samples(struct ad77681_dev *dev)
+{
+	int32_t samples[AD77681_EVB_SAMPLE_NO];
+	uint32_t nb, i;
+
+	if (ad77681_capture_available(dev, &nb) != SUCCESS)
+		return;
+
+	nb = min(nb, (uint32_t)AD77681_EVB_SAMPLE_NO);
+	if (ad77681_capture_read(dev, samples, nb) != SUCCESS)
+		return;
+
+	for (i = 0; i < nb; i++)
+		printf("[ADC DATA]: %ld\r\n", (long)samples[i]);
+	printf("[CRC ERRORS]: %lu\r\n", (unsigned long)dev->capture->crc_errors);
+}
+
 int main()
 {
 	struct ad77681_dev	*adc_dev;
 	struct ad77681_status_registers *adc_status;
 	struct axi_clkgen *clkgen;
-	uint8_t			adc_data[5];
-	uint8_t 		*data;
 	uint32_t 		i;
 	int32_t ret;
-	uint8_t commands_data[4] = {0, 0, 0, AD77681_REG_READ(AD77681_REG_ADC_DATA)};
+	/* Continuous read mode: SDI stays low, so the exit key is never sent */
+	uint32_t commands_data[1] = {0};
 	struct spi_engine_offload_init_param spi_engine_offload_init_param = {
 		.offload_config = (OFFLOAD_RX_EN | OFFLOAD_TX_EN),
 		.rx_dma_baseaddr = AD77681_DMA_1_BASEADDR,
@@ -136,15 +159,24 @@ int main()
 
 	ad77681_setup(&adc_dev, ADC_default_init_param, &adc_status);
 
+	ret = ad77681_capture_init(adc_dev, &capture_init_param);
+	if (ret != SUCCESS)
+		return ret;
+
+	/* Enters continuous read mode */
+	ret = ad77681_capture_start(adc_dev);
+	if (ret != SUCCESS)
+		return ret;
+
 	if (SPI_ENGINE_OFFLOAD_EXAMPLE == 0) {
 		while(1) {
-			ad77681_spi_read_adc_data(adc_dev, adc_data,
-						  AD77681_CONTINUOUS_DATA_READ);
-			printf("[ADC DATA]: 0x");
-			for(i = 0; i < sizeof(adc_data) / sizeof(uint8_t); i++) {
-				printf("%x", adc_data[i]);
+			/* DRDY is not wired to an interrupt here, read one
+			 * frame per conversion period instead */
+			for (i = 0; i < AD77681_EVB_SAMPLE_NO; i++) {
+				ad77681_capture_drdy_handler(adc_dev, 0, NULL);
+				udelay(1000000 / adc_dev->sample_rate + 1);
 			}
-			printf("\r\n");
+			ad77681evb_print_samples(adc_dev);
 			mdelay(1000);
 		}
 	} else {
@@ -169,12 +201,22 @@ int main()
 		Xil_DCacheInvalidateRange(spi_engine_offload_message.rx_addr,
 					  AD77681_EVB_SAMPLE_NO * 4);
 
-		for (i = 0; i < AD77681_EVB_SAMPLE_NO * 4 ; i++) {
-			printf("%x\r\n", *data);
-			data += sizeof(uint8_t);
-		}
+		/* With a 32-bit data width the offload writes one frame per
+		 * word. Frames of 5 bytes (24-bit data, status and CRC) need a
+		 * 64-bit data width and AD77681_FRAME_WORD64. */
+		ret = ad77681_capture_push(adc_dev,
+					   (void *)(uintptr_t)spi_engine_offload_message.rx_addr,
+					   AD77681_EVB_SAMPLE_NO,
+					   AD77681_FRAME_WORD32);
+		if (ret != SUCCESS)
+			return ret;
+
+		ad77681evb_print_samples(adc_dev);
 	}
 
+	/* Exits continuous read mode */
+	ad77681_capture_remove(adc_dev);
+
 	printf("Bye\n");
 
 	Xil_DCacheDisable();
@@ -82,6 +82,7 @@ INCS +=	$(PROJECT)/src/app_clock.h \
 	$(DRIVERS)/axi_core/jesd204/axi_jesd204_tx.h \
 	$(DRIVERS)/axi_core/jesd204/jesd204_clk.h \
 	$(DRIVERS)/axi_core/jesd204/xilinx_transceiver.h \
+	$(DRIVERS)/axi_core/jesd204/xilinx_transceiver_pll_table.h \
 	$(PLATFORM_DRIVERS)/gpio_extra.h \
 	$(PLATFORM_DRIVERS)/spi_extra.h \
 	$(INCLUDE)/no-os/axi_io.h \
@@ -336,6 +336,7 @@ int32_t app_clock_init(struct clk dev_refclk[MULTIDEVICE_INSTANCE_COUNT])
 		dev_refclk[i].hw = &adf4371_hw[i];
 		dev_refclk[i].hw_ch_num = 2;
 		dev_refclk[i].name = "dev_refclk";
+		clk_register(&dev_refclk[i], NULL, CLK_CACHE_RATE);
 	}
 #else
 	hmc7044_hw.dev = hmc7044_dev;
@@ -346,6 +347,7 @@ int32_t app_clock_init(struct clk dev_refclk[MULTIDEVICE_INSTANCE_COUNT])
 	dev_refclk[0].hw = &hmc7044_hw;
 	dev_refclk[0].hw_ch_num = 0;
 	dev_refclk[0].name = "dev_refclk";
+	clk_register(&dev_refclk[0], NULL, CLK_CACHE_RATE);
 #endif
 
 	return SUCCESS;
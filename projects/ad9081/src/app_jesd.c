@@ -171,11 +171,14 @@ int32_t app_jesd_init(struct clk clk[2],
 	jesd_tx_hw.dev_clk_disable = jesd204_clk_disable;
 	jesd_tx_hw.dev_clk_set_rate = jesd204_clk_set_rate;
 
+	/* The lane rate only changes through clk_set_rate(), it can be cached */
 	clk[0].name = "jesd_rx";
 	clk[0].hw = &jesd_rx_hw;
+	clk_register(&clk[0], NULL, CLK_CACHE_RATE);
 
 	clk[1].name = "jesd_tx";
 	clk[1].hw = &jesd_tx_hw;
+	clk_register(&clk[1], NULL, CLK_CACHE_RATE);
 
 	return SUCCESS;
 }
@@ -53,7 +53,8 @@ INCS += $(DRIVERS)/axi_core/axi_adc_core/axi_adc_core.h \
 	$(DRIVERS)/axi_core/jesd204/axi_jesd204_rx.h \
 	$(DRIVERS)/axi_core/jesd204/axi_jesd204_tx.h \
 	$(DRIVERS)/axi_core/jesd204/jesd204_clk.h \
-	$(DRIVERS)/axi_core/jesd204/xilinx_transceiver.h
+	$(DRIVERS)/axi_core/jesd204/xilinx_transceiver.h \
+	$(DRIVERS)/axi_core/jesd204/xilinx_transceiver_pll_table.h
 INCS +=	$(PLATFORM_DRIVERS)/spi_extra.h \
 	$(PLATFORM_DRIVERS)/gpio_extra.h
 INCS +=	$(INCLUDE)/no-os/axi_io.h \
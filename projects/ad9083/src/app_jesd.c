@@ -115,8 +115,10 @@ int32_t app_jesd_init(struct app_jesd **app, struct app_jesd_init *init_param)
 	app_jesd->jesd_rx_hw.dev_clk_enable = jesd204_clk_enable;
 	app_jesd->jesd_rx_hw.dev_clk_disable = jesd204_clk_disable;
 	app_jesd->jesd_rx_hw.dev_clk_set_rate = jesd204_clk_set_rate;
+	/* The lane rate only changes through clk_set_rate(), it can be cached */
 	app_jesd->jesd_rx_clk.name = "jesd_rx";
 	app_jesd->jesd_rx_clk.hw = &app_jesd->jesd_rx_hw;
+	clk_register(&app_jesd->jesd_rx_clk, NULL, CLK_CACHE_RATE);
 
 	*app = app_jesd;
 
@@ -24,7 +24,8 @@ SRCS +=	$(PLATFORM_DRIVERS)/axi_io.c
 SRCS +=	$(PLATFORM_DRIVERS)/$(PLATFORM)_spi.c \
 	$(PLATFORM_DRIVERS)/$(PLATFORM)_gpio.c
 ifeq (linux,$(strip $(PLATFORM)))
-SRCS +=	$(PLATFORM_DRIVERS)/linux_delay.c
+SRCS +=	$(PLATFORM_DRIVERS)/linux_delay.c \
+	$(PLATFORM_DRIVERS)/linux_async.c
 else
 SRCS +=	$(PLATFORM_DRIVERS)/delay.c
 endif
@@ -62,6 +63,7 @@ INCS += $(DRIVERS)/axi_core/axi_adc_core/axi_adc_core.h \
 ifeq (linux,$(strip $(PLATFORM)))
 CFLAGS += -DPLATFORM_MB
 INCS +=	$(PLATFORM_DRIVERS)/linux_spi.h \
+	$(PLATFORM_DRIVERS)/linux_async.h \
 	$(PLATFORM_DRIVERS)/linux_gpio.h \
 	$(PLATFORM_DRIVERS)/linux_uart.h
 endif
@@ -48,6 +48,7 @@ INCS += $(DRIVERS)/axi_core/axi_adc_core/axi_adc_core.h \
         $(DRIVERS)/axi_core/jesd204/axi_adxcvr.h \
         $(DRIVERS)/axi_core/jesd204/axi_jesd204_rx.h \
         $(DRIVERS)/axi_core/jesd204/xilinx_transceiver.h \
+        $(DRIVERS)/axi_core/jesd204/xilinx_transceiver_pll_table.h \
         $(DRIVERS)/adc/ad9656/ad9656.h
 INCS +=	$(PLATFORM_DRIVERS)/spi_extra.h
 INCS +=	$(INCLUDE)/no-os/axi_io.h \
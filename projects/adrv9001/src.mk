@@ -33,6 +33,7 @@ SRCS += $(PLATFORM_DRIVERS)/xilinx_gpio.c \
 	$(PLATFORM_DRIVERS)/xilinx_spi.c \
 	$(PLATFORM_DRIVERS)/delay.c \
 	$(NO-OS)/util/util.c \
+	$(NO-OS)/util/fw_image.c \
 	$(DRIVERS)/axi_core/axi_adc_core/axi_adc_core.c \
 	$(DRIVERS)/axi_core/axi_dac_core/axi_dac_core.c \
 	$(DRIVERS)/axi_core/axi_dmac/axi_dmac.c \
@@ -44,6 +45,7 @@ INCS +=	$(INCLUDE)/no-os/spi.h \
 	$(INCLUDE)/no-os/error.h \
 	$(INCLUDE)/no-os/delay.h \
 	$(INCLUDE)/no-os/util.h \
+	$(INCLUDE)/no-os/fw_image.h \
 	$(INCLUDE)/no-os/print_log.h \
 	$(DRIVERS)/axi_core/axi_adc_core/axi_adc_core.h \
 	$(DRIVERS)/axi_core/axi_dac_core/axi_dac_core.h \
@@ -48,6 +48,8 @@
 #include "spi_extra.h"
 #include "no-os/error.h"
 #include "no-os/delay.h"
+#include "no-os/util.h"
+#include "no-os/fw_image.h"
 #include "adi_common_error.h"
 #include "Navassa_EvaluationFw.h"
 #include "Navassa_Stream.h"
@@ -422,25 +424,84 @@ int32_t no_os_ssi_reset(void* devHalCfg)
 	return ADI_COMMON_ERR_OK;
 }
 
+/*
+ * The firmware arrays may be raw blobs or fw_image containers
+ * (tools/scripts/fw_image.py). The API requests the pages in order, so each
+ * image is decoded on the fly and kept open until its last page is read.
+ */
+struct no_os_image {
+	const char *path;
+	const uint8_t *data;
+	uint32_t size;
+	struct fw_image *img;
+	uint32_t next_page;
+};
+
+static struct no_os_image no_os_images[] = {
+	{
+		.path = "Navassa_EvaluationFw.bin",
+		.data = Navassa_EvaluationFw_bin,
+		.size = sizeof(Navassa_EvaluationFw_bin),
+	},
+	{
+		.path = "Navassa_Stream.bin",
+		.data = Navassa_Stream_bin,
+		.size = sizeof(Navassa_Stream_bin),
+	},
+};
+
 int32_t no_os_image_page_get(void *devHalCfg, const char *ImagePath,
 			     uint32_t pageIndex, uint32_t pageSize, uint8_t *rdBuff)
 {
-	unsigned char *bin;
-	if (!strcmp(ImagePath, "Navassa_EvaluationFw.bin")) {
-		if ((pageIndex * pageSize) > sizeof(Navassa_EvaluationFw_bin))
-			return -EINVAL;
+	struct no_os_image *image = NULL;
+	uint32_t i;
+	int32_t ret;
 
-		bin = Navassa_EvaluationFw_bin;
-	} else if (!strcmp(ImagePath, "Navassa_Stream.bin")) {
-		if ((pageIndex * pageSize) > sizeof(Navassa_Stream_bin))
-			return -EINVAL;
-		bin = Navassa_Stream_bin;
-	} else
+	for (i = 0; i < ARRAY_SIZE(no_os_images); i++)
+		if (!strcmp(ImagePath, no_os_images[i].path))
+			image = &no_os_images[i];
+	if (!image)
 		return ADI_COMMON_ERR_INV_PARAM;
 
-	memcpy(rdBuff, &bin[pageIndex * pageSize], pageSize);
+	if (!image->img) {
+		ret = fw_image_init_mem(&image->img, image->data, image->size);
+		if (ret)
+			return ret;
+		image->next_page = 0;
+	}
 
-	return ADI_COMMON_ERR_OK;
+	if ((pageIndex * pageSize) >= fw_image_size(image->img)) {
+		ret = -EINVAL;
+		goto close;
+	}
+
+	/* Out of order page: decode again from the start up to it */
+	if (pageIndex != image->next_page) {
+		ret = fw_image_rewind(image->img);
+		if (ret)
+			goto close;
+		for (i = 0; i < pageIndex; i++) {
+			ret = fw_image_read(image->img, rdBuff, pageSize);
+			if (ret < 0)
+				goto close;
+		}
+	}
+
+	ret = fw_image_read(image->img, rdBuff, pageSize);
+	if (ret < 0)
+		goto close;
+	memset(&rdBuff[ret], 0, pageSize - ret);
+	image->next_page = pageIndex + 1;
+
+	if ((image->next_page * pageSize) < fw_image_size(image->img))
+		return ADI_COMMON_ERR_OK;
+
+	ret = ADI_COMMON_ERR_OK;
+close:
+	fw_image_remove(image->img);
+	image->img = NULL;
+
+	return ret;
 }
 
 int32_t no_os_rx_gain_table_entry_get(void *devHalCfg,
@@ -61,7 +61,8 @@ SRCS += $(NO-OS)/util/fifo.c \
 	$(PLATFORM_DRIVERS)/uart.c \
 	$(PLATFORM_DRIVERS)/$(PLATFORM)_irq.c
 endif
-SRCS +=	$(NO-OS)/util/util.c
+SRCS +=	$(NO-OS)/util/util.c \
+	$(NO-OS)/util/fw_image.c
 ifeq (xilinx,$(strip $(PLATFORM)))
 SRCS += $(DRIVERS)/axi_core/jesd204/xilinx_transceiver.c \
 	$(DRIVERS)/axi_core/jesd204/axi_adxcvr.c \
@@ -123,6 +124,7 @@ INCS += $(DRIVERS)/axi_core/axi_adc_core/axi_adc_core.h \
 	$(DRIVERS)/axi_core/jesd204/axi_jesd204_tx.h
 ifeq (xilinx,$(strip $(PLATFORM)))
 INCS += $(DRIVERS)/axi_core/jesd204/xilinx_transceiver.h \
+	$(DRIVERS)/axi_core/jesd204/xilinx_transceiver_pll_table.h \
 	$(DRIVERS)/axi_core/jesd204/axi_adxcvr.h \
 	$(DRIVERS)/axi_core/clk_axi_clkgen/clk_axi_clkgen.h
 else
@@ -138,7 +140,8 @@ INCS +=	$(INCLUDE)/no-os/axi_io.h \
 	$(INCLUDE)/no-os/gpio.h \
 	$(INCLUDE)/no-os/error.h \
 	$(INCLUDE)/no-os/delay.h \
-	$(INCLUDE)/no-os/util.h
+	$(INCLUDE)/no-os/util.h \
+	$(INCLUDE)/no-os/fw_image.h
 ifeq (y,$(strip $(TINYIIOD)))
 INCS +=	$(INCLUDE)/no-os/fifo.h \
 	$(INCLUDE)/no-os/irq.h \
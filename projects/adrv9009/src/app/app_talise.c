@@ -46,6 +46,7 @@
 #include "no-os/error.h"
 #include "no-os/delay.h"
 #include "no-os/util.h"
+#include "no-os/fw_image.h"
 
 // talise
 #include "talise.h"
@@ -72,6 +73,11 @@
 #include "app_talise.h"
 #include "app_jesd.h"
 
+/* Feed the ARM loader from the firmware image decoder. */
+static int32_t talise_arm_image_read(void *ctx, uint8_t *buf, uint32_t len)
+{
+	return fw_image_read(ctx, buf, len);
+}
 
 bool adrv9009_check_sysref_rate(uint32_t lmfc, uint32_t sysref)
 {
@@ -92,7 +98,8 @@ adiHalErr_t talise_setup(taliseDevice_t * const pd, taliseInit_t * const pi)
 	uint8_t pllLockStatus = 0;
 	uint16_t deframerStatus = 0;
 	uint8_t framerStatus = 0;
-	uint32_t count = sizeof(armBinary);
+	struct fw_image *arm_image;
+	int32_t ret;
 	taliseArmVersionInfo_t talArmVersionInfo;
 #if defined(ADRV9008_1)
 	uint32_t initCalMask = TAL_ADC_TUNER | TAL_TIA_3DB_CORNER | TAL_DC_OFFSET |
@@ -213,10 +220,21 @@ adiHalErr_t talise_setup(taliseDevice_t * const pd, taliseInit_t * const pi)
 			goto error_11;
 		}
 
-		talAction = TALISE_loadArmFromBinary(pd, &armBinary[0], count);
+		/* armBinary may be a raw blob or a fw_image container
+		 * (tools/scripts/fw_image.py), it is decoded while uploading.
+		 */
+		ret = fw_image_init_mem(&arm_image, armBinary, sizeof(armBinary));
+		if (ret != SUCCESS) {
+			printf("error: fw_image_init_mem() failed\n");
+			goto error_11;
+		}
+
+		talAction = TALISE_loadArmFromReader(pd, talise_arm_image_read,
+						     arm_image, fw_image_size(arm_image));
+		fw_image_remove(arm_image);
 		if (talAction != TALACT_NO_ACTION) {
 			/*** < User: decide what to do based on Talise recovery action returned > ***/
-			printf("error: TALISE_loadArmFromBinary() failed\n");
+			printf("error: TALISE_loadArmFromReader() failed\n");
 			goto error_11;
 		}
 
@@ -57,6 +57,7 @@ INCS += $(DRIVERS)/axi_core/axi_adc_core/axi_adc_core.h \
 	$(DRIVERS)/axi_core/jesd204/axi_jesd204_rx.h \
 	$(DRIVERS)/axi_core/jesd204/axi_jesd204_tx.h \
 	$(DRIVERS)/axi_core/jesd204/xilinx_transceiver.h \
+	$(DRIVERS)/axi_core/jesd204/xilinx_transceiver_pll_table.h \
 	$(DRIVERS)/frequency/ad9523/ad9523.h \
 	$(DRIVERS)/adc/ad9680/ad9680.h \
 	$(DRIVERS)/dac/ad9144/ad9144.h					
@@ -4,7 +4,8 @@ SRC_DIRS += $(NO-OS)/iio/iio_app
 
 SRCS +=	$(NO-OS)/util/list.c \
 	$(NO-OS)/util/fifo.c \
-	$(NO-OS)/util/util.c
+	$(NO-OS)/util/util.c \
+	$(NO-OS)/util/interleave.c
 
 #drivers
 SRCS += $(DRIVERS)/adc/adc_demo/adc_demo.c \
@@ -16,6 +17,7 @@ INCS += $(INCLUDE)/no-os/fifo.h \
 	$(INCLUDE)/no-os/uart.h \
 	$(INCLUDE)/no-os/list.h \
 	$(INCLUDE)/no-os/util.h \
+	$(INCLUDE)/no-os/interleave.h \
 	$(INCLUDE)/no-os/error.h
 
 INCS += $(DRIVERS)/adc/adc_demo/iio_adc_demo.h \
@@ -25,9 +27,12 @@ INCS += $(DRIVERS)/adc/adc_demo/iio_adc_demo.h \
 
 ifeq ($(PLATFORM),$(filter $(PLATFORM),xilinx aducm3029))
 SRCS += $(PLATFORM_DRIVERS)/delay.c \
+	$(PLATFORM_DRIVERS)/timer.c \
 	$(DRIVERS)/api/irq.c
+INCS += $(PLATFORM_DRIVERS)/timer_extra.h
 endif
-INCS += $(INCLUDE)/no-os/delay.h
+INCS += $(INCLUDE)/no-os/delay.h \
+	$(INCLUDE)/no-os/timer.h
 
 ifeq ($(PLATFORM),$(filter $(PLATFORM),xilinx aducm3029))
 # For the moment there is support only for aducm for iio with network backend
@@ -42,10 +47,7 @@ ifeq (y,$(strip $(ENABLE_IIO_NETWORK)))
 DISABLE_SECURE_SOCKET ?= y
 SRC_DIRS += $(NO-OS)/network
 SRCS	 += $(NO-OS)/util/circular_buffer.c
-SRCS	 += $(PLATFORM_DRIVERS)/timer.c
-INCS	 += $(INCLUDE)/no-os/timer.h \
-		$(INCLUDE)/no-os/circular_buffer.h \
-		$(PLATFORM_DRIVERS)/timer_extra.h \
+INCS	 += $(INCLUDE)/no-os/circular_buffer.h \
 		$(PLATFORM_DRIVERS)/rtc_extra.h
 endif
 
@@ -62,6 +64,7 @@ endif
 # stm32
 ifeq (stm32, $(PLATFORM))
 SRCS += $(PLATFORM_DRIVERS)/stm32_delay.c \
+	$(DRIVERS)/platform/generic/timer.c \
 	$(PLATFORM_DRIVERS)/stm32_uart.c \
 	$(PLATFORM_DRIVERS)/stm32_uart_stdio.c
 INCS += $(PLATFORM_DRIVERS)/stm32_uart_stdio.h \
@@ -81,7 +84,8 @@ SRCS += $(NO-OS)/iio/iio_app/iio_app.c
 SRCS += $(NO-OS)/util/circular_buffer.c
 
 SRCS += $(DRIVERS)/platform/generic/uart.c \
-		$(DRIVERS)/platform/generic/delay.c
+		$(DRIVERS)/platform/linux/linux_delay.c \
+		$(DRIVERS)/platform/linux/linux_timer.c
 
 INCS += $(NO-OS)/network/tcp_socket.h \
 		$(NO-OS)/network/network_interface.h \
@@ -87,6 +87,18 @@ static uint8_t out_buff[MAX_SIZE_BASE_ADDR];
 
 #endif
 
+#ifdef LINUX_PLATFORM
+/* Paces the demo buffers once their sampling_frequency is set */
+static struct timer_init_param demo_timer_param = {
+	.id = 0,
+	.freq_hz = 1000000,
+	.load_value = 0,
+};
+#define DEMO_TIMER_PARAM	(&demo_timer_param)
+#else
+#define DEMO_TIMER_PARAM	NULL
+#endif
+
 int32_t platform_init()
 {
 #if defined(ADUCM_PLATFORM)
@@ -143,7 +155,8 @@ int main(void)
 		.ext_buff_len = SAMPLES_PER_CHANNEL,
 		.ext_buff = loopback_buffs,
 		.dev_global_attr = 3333,
-		.dev_ch_attr = {1111,1112,1113,1114,1115,1116,1117,1118,1119,1120,1121,1122,1123,1124,1125,1126}
+		.dev_ch_attr = {1111,1112,1113,1114,1115,1116,1117,1118,1119,1120,1121,1122,1123,1124,1125,1126},
+		.timer_param_optional = DEMO_TIMER_PARAM
 	};
 	status = adc_demo_init(&adc_desc, &adc_init_par);
 	if (status != SUCCESS)
@@ -153,7 +166,8 @@ int main(void)
 		.loopback_buffer_len = SAMPLES_PER_CHANNEL,
 		.loopback_buffers = loopback_buffs,
 		.dev_global_attr = 4444,
-		.dev_ch_attr = {1111,1112,1113,1114,1115,1116,1117,1118,1119,1120,1121,1122,1123,1124,1125,1126}
+		.dev_ch_attr = {1111,1112,1113,1114,1115,1116,1117,1118,1119,1120,1121,1122,1123,1124,1125,1126},
+		.timer_param_optional = DEMO_TIMER_PARAM
 	};
 	status = dac_demo_init(&dac_desc, &dac_init_par);
 	if (status != SUCCESS)
@@ -0,0 +1,120 @@
+################################################################################
+#									       #
+#     Shared variables:							       #
+#	- PROJECT							       #
+#	- DRIVERS							       #
+#	- INCLUDE							       #
+#	- PLATFORM_DRIVERS						       #
+#	- NO-OS								       #
+#									       #
+################################################################################
+
+SRCS += $(PROJECT)/src/main.c \
+	$(PROJECT)/src/clk_bench.c \
+	$(PROJECT)/src/crc8_bench.c \
+	$(PROJECT)/src/gpio_bench.c \
+	$(PROJECT)/src/interleave_bench.c \
+	$(PROJECT)/src/jesd204_bench.c \
+	$(PROJECT)/src/sd_bench.c \
+	$(PROJECT)/src/sdlog_bench.c \
+	$(PROJECT)/src/wifi_bench.c
+INCS += $(PROJECT)/src/bench.h
+
+# gpio
+SRCS += $(DRIVERS)/api/gpio.c \
+	$(PLATFORM_DRIVERS)/linux_gpio.c \
+	$(PLATFORM_DRIVERS)/linux_gpiochip.c
+INCS += $(INCLUDE)/no-os/gpio.h \
+	$(PLATFORM_DRIVERS)/linux_gpio.h \
+	$(PLATFORM_DRIVERS)/linux_gpiochip.h
+
+# crc8
+SRCS += $(NO-OS)/util/crc8.c
+INCS += $(INCLUDE)/no-os/crc8.h
+
+# interleave
+SRCS += $(NO-OS)/util/interleave.c
+INCS += $(INCLUDE)/no-os/interleave.h
+
+# clk
+SRCS += $(NO-OS)/util/clk.c
+INCS += $(INCLUDE)/no-os/clk.h
+
+# jesd204, the transceiver and link core drivers are simulated by the bench
+SRCS += $(DRIVERS)/axi_core/jesd204/jesd204_link_fsm.c \
+	$(PLATFORM_DRIVERS)/linux_timer.c
+INCS += $(DRIVERS)/axi_core/jesd204/jesd204_link_fsm.h \
+	$(DRIVERS)/axi_core/jesd204/axi_adxcvr.h \
+	$(DRIVERS)/axi_core/jesd204/axi_jesd204_rx.h \
+	$(DRIVERS)/axi_core/jesd204/axi_jesd204_tx.h \
+	$(DRIVERS)/axi_core/jesd204/xilinx_transceiver.h \
+	$(INCLUDE)/no-os/timer.h \
+	$(INCLUDE)/no-os/trace.h
+
+# sd, the card is emulated by the SPI backend
+SRCS += $(DRIVERS)/sd-card/sd.c \
+	$(DRIVERS)/sd-card/sd_cache.c \
+	$(DRIVERS)/api/spi.c \
+	$(PLATFORM_DRIVERS)/linux_sd_model.c
+INCS += $(DRIVERS)/sd-card/sd.h \
+	$(DRIVERS)/sd-card/sd_cache.h \
+	$(INCLUDE)/no-os/spi.h \
+	$(PLATFORM_DRIVERS)/linux_sd_model.h
+
+# sdlog, FatFs is built here rather than as libfatfs, to format the card
+# and to use the sector cache
+CFLAGS += -DFATFS_SD_CACHE -DFF_USE_MKFS=1
+SRCS += $(NO-OS)/iio/iio_sd_logger.c \
+	$(NO-OS)/util/circular_buffer.c \
+	$(NO-OS)/libraries/fatfs/adi_diskio.c \
+	$(NO-OS)/libraries/fatfs/source/ff.c \
+	$(NO-OS)/libraries/fatfs/source/ffsystem.c \
+	$(NO-OS)/libraries/fatfs/source/ffunicode.c
+INCS += $(NO-OS)/iio/iio_sd_logger.h \
+	$(NO-OS)/iio/iio_types.h \
+	$(INCLUDE)/no-os/circular_buffer.h \
+	$(NO-OS)/libraries/fatfs/source/ff.h \
+	$(NO-OS)/libraries/fatfs/source/ffconf.h \
+	$(NO-OS)/libraries/fatfs/source/diskio.h
+
+# tls, needs the mbedtls submodule
+ifeq (y,$(strip $(TLS)))
+LIBRARIES += mbedtls
+CFLAGS += -DTLS_BENCH
+SRCS += $(PROJECT)/src/tls_bench.c
+INCS += $(NO-OS)/network/noos_mbedtls_config.h \
+	$(INCLUDE)/no-os/trng.h
+endif
+
+# mqtt, needs the paho submodule
+ifeq (y,$(strip $(MQTT)))
+LIBRARIES += mqtt
+CFLAGS += -DMQTT_BENCH
+SRCS += $(PROJECT)/src/mqtt_bench.c
+endif
+
+# wifi, the ESP8266 is simulated on a pty by the bench
+SRCS += $(NO-OS)/network/wifi/wifi.c \
+	$(NO-OS)/network/wifi/at_parser.c \
+	$(DRIVERS)/api/irq.c \
+	$(PLATFORM_DRIVERS)/linux_uart.c
+INCS += $(NO-OS)/network/wifi/wifi.h \
+	$(NO-OS)/network/wifi/at_parser.h \
+	$(NO-OS)/network/wifi/at_params.h \
+	$(NO-OS)/network/network_interface.h \
+	$(INCLUDE)/no-os/irq.h \
+	$(INCLUDE)/no-os/uart.h \
+	$(PLATFORM_DRIVERS)/linux_uart.h
+
+ifneq (,$(filter y,$(strip $(TLS)) $(strip $(MQTT))))
+SRCS += $(NO-OS)/network/tcp_socket.c \
+	$(NO-OS)/network/linux_socket/linux_socket.c
+INCS += $(NO-OS)/network/tcp_socket.h \
+	$(NO-OS)/network/linux_socket/linux_socket.h
+endif
+
+SRCS += $(PLATFORM_DRIVERS)/linux_delay.c \
+	$(NO-OS)/util/util.c
+INCS += $(INCLUDE)/no-os/error.h \
+	$(INCLUDE)/no-os/delay.h \
+	$(INCLUDE)/no-os/util.h
@@ -0,0 +1,129 @@
+/***************************************************************************//**
+ *   @file   bench.h
+ *   @brief  Common definitions of the Linux benchmarks.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include "no-os/error.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Print the failed check and return FAILURE from the calling function */
+#define BENCH_CHECK(cond) do {						\
+	if (!(cond)) {							\
+		printf("%s:%d: check failed: %s\n", __func__, __LINE__,	\
+		       #cond);						\
+		return FAILURE;						\
+	}								\
+} while (0)
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct bench
+ * @brief A benchmark selected by name on the command line.
+ */
+struct bench {
+	/** Name given as first argument */
+	const char *name;
+	/** Arguments, printed by the usage */
+	const char *usage;
+	/** Run the benchmark with the remaining arguments */
+	int32_t (*run)(int argc, char **argv);
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/**
+ * @brief Read the monotonic clock.
+ * @return Time in nanoseconds.
+ */
+static inline uint64_t bench_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/* Clock framework checks and rate read cost, simulated providers. */
+int32_t clk_bench(int argc, char **argv);
+
+/* Shared CRC-8 table checks and cost against the bit serial CRC. */
+int32_t crc8_bench(int argc, char **argv);
+
+/* GPIO toggle rate, sysfs and character device backends. */
+int32_t gpio_bench(int argc, char **argv);
+
+/* Channel interleave kernel checks and throughput. */
+int32_t interleave_bench(int argc, char **argv);
+
+/* JESD204 link state machine checks and cost, simulated links. */
+int32_t jesd204_bench(int argc, char **argv);
+
+/* MQTT publish rate, blocking and queued, built with MQTT=y. */
+int32_t mqtt_bench(int argc, char **argv);
+
+/* SD card driver and sector cache throughput, file backed card model. */
+int32_t sd_bench(int argc, char **argv);
+
+/* IIO SD card logger checks and throughput, FatFs on the card model. */
+int32_t sdlog_bench(int argc, char **argv);
+
+/* TLS handshake time and heap of the secure socket, built with TLS=y. */
+int32_t tls_bench(int argc, char **argv);
+
+/* ESP8266 socket throughput, module simulated on a pty. */
+int32_t wifi_bench(int argc, char **argv);
+
+#endif // BENCH_H_
@@ -0,0 +1,326 @@
+/***************************************************************************//**
+ *   @file   clk_bench.c
+ *   @brief  Clock framework checks and cost, with simulated providers.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "bench.h"
+#include "no-os/clk.h"
+#include "no-os/error.h"
+#include "no-os/util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define CLK_BENCH_LOOPS		1000000
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct clk_bench_dev
+ * @brief Simulated clock provider, counts the calls that reach it.
+ */
+struct clk_bench_dev {
+	/** Programmed rate */
+	uint64_t rate;
+	uint32_t enable_calls;
+	uint32_t disable_calls;
+	uint32_t recalc_calls;
+	uint32_t set_calls;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static int32_t clk_bench_enable(struct clk_bench_dev *dev)
+{
+	dev->enable_calls++;
+
+	return SUCCESS;
+}
+
+static int32_t clk_bench_disable(struct clk_bench_dev *dev)
+{
+	dev->disable_calls++;
+
+	return SUCCESS;
+}
+
+static int32_t clk_bench_recalc_rate(struct clk_bench_dev *dev,
+				     uint32_t chan, uint64_t *rate)
+{
+	dev->recalc_calls++;
+	*rate = dev->rate;
+
+	return SUCCESS;
+}
+
+static int32_t clk_bench_set_rate(struct clk_bench_dev *dev,
+				  uint32_t chan, uint64_t rate)
+{
+	dev->set_calls++;
+	dev->rate = rate;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Set up a simulated clock.
+ * @param clk - The clock.
+ * @param hw - Provider ops, bound to dev.
+ * @param dev - The simulated provider, zeroed.
+ * @param parent - Parent clock or NULL.
+ * @param flags - CLK_* flags.
+ */
+static void clk_bench_clk(struct clk *clk, struct clk_hw *hw,
+			  struct clk_bench_dev *dev, struct clk *parent,
+			  uint32_t flags)
+{
+	memset(dev, 0, sizeof(*dev));
+	hw->dev = dev;
+	hw->dev_clk_enable = clk_bench_enable;
+	hw->dev_clk_disable = clk_bench_disable;
+	hw->dev_clk_recalc_rate = clk_bench_recalc_rate;
+	hw->dev_clk_set_rate = clk_bench_set_rate;
+	hw->dev_clk_round_rate = NULL;
+	clk->hw = hw;
+	clk->hw_ch_num = 0;
+	clk->name = "sim";
+	clk_register(clk, parent, flags);
+}
+
+/**
+ * @brief Without flags every call reaches the provider, so a lane rate
+ * requested again after a link reset is programmed again.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t clk_bench_check_default(void)
+{
+	struct clk_bench_dev dev;
+	struct clk_hw hw;
+	struct clk clk;
+	uint64_t rate;
+
+	clk_bench_clk(&clk, &hw, &dev, NULL, 0);
+
+	BENCH_CHECK(!clk_set_rate(&clk, 10000000));
+	BENCH_CHECK(!clk_set_rate(&clk, 10000000));
+	BENCH_CHECK(dev.set_calls == 2);
+
+	BENCH_CHECK(!clk_recalc_rate(&clk, &rate));
+	BENCH_CHECK(!clk_recalc_rate(&clk, &rate));
+	BENCH_CHECK(rate == 10000000 && dev.recalc_calls == 2);
+
+	BENCH_CHECK(!clk_enable(&clk));
+	BENCH_CHECK(!clk_enable(&clk));
+	BENCH_CHECK(!clk_disable(&clk));
+	BENCH_CHECK(dev.enable_calls == 2 && dev.disable_calls == 1);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief CLK_CACHE_RATE: repeated requests and reads are served by the
+ * framework until the parent is reprogrammed.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t clk_bench_check_cache(void)
+{
+	struct clk_bench_dev dev[2];
+	struct clk_hw hw[2];
+	struct clk clk[2];
+	uint64_t rate;
+
+	clk_bench_clk(&clk[0], &hw[0], &dev[0], NULL, CLK_CACHE_RATE);
+	clk_bench_clk(&clk[1], &hw[1], &dev[1], &clk[0], CLK_CACHE_RATE);
+
+	BENCH_CHECK(!clk_set_rate(&clk[1], 250000000));
+	BENCH_CHECK(!clk_set_rate(&clk[1], 250000000));
+	BENCH_CHECK(dev[1].set_calls == 1);
+
+	BENCH_CHECK(!clk_recalc_rate(&clk[1], &rate));
+	BENCH_CHECK(!clk_recalc_rate(&clk[1], &rate));
+	BENCH_CHECK(rate == 250000000 && dev[1].recalc_calls == 1);
+
+	/* A new parent rate re-applies the child and drops its cached rate. */
+	BENCH_CHECK(!clk_set_rate(&clk[0], 1000000000));
+	BENCH_CHECK(dev[0].set_calls == 1 && dev[1].set_calls == 2);
+	BENCH_CHECK(!clk_recalc_rate(&clk[1], &rate));
+	BENCH_CHECK(dev[1].recalc_calls == 2);
+
+	clk_invalidate_rate(&clk[0]);
+	BENCH_CHECK(!clk_set_rate(&clk[1], 250000000));
+	BENCH_CHECK(dev[1].set_calls == 3);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief CLK_ENABLE_REFCOUNT: only the first enable and the last disable
+ * reach the provider, parents are started first and stopped last.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t clk_bench_check_refcount(void)
+{
+	struct clk_bench_dev dev[2];
+	struct clk_hw hw[2];
+	struct clk clk[2];
+
+	clk_bench_clk(&clk[0], &hw[0], &dev[0], NULL, CLK_ENABLE_REFCOUNT);
+	clk_bench_clk(&clk[1], &hw[1], &dev[1], &clk[0], CLK_ENABLE_REFCOUNT);
+
+	BENCH_CHECK(!clk_enable(&clk[1]));
+	BENCH_CHECK(!clk_enable(&clk[1]));
+	BENCH_CHECK(dev[0].enable_calls == 1 && dev[1].enable_calls == 1);
+
+	BENCH_CHECK(!clk_disable(&clk[1]));
+	BENCH_CHECK(dev[1].disable_calls == 0);
+	BENCH_CHECK(!clk_disable(&clk[1]));
+	BENCH_CHECK(dev[0].disable_calls == 1 && dev[1].disable_calls == 1);
+	BENCH_CHECK(!clk[0].enable_count && !clk[1].enable_count);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief A batch touching a parent and its children programs each provider
+ * once, parents first.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t clk_bench_check_batch(void)
+{
+	struct clk_bench_dev dev[3];
+	struct clk_hw hw[3];
+	struct clk clk[3];
+	struct clk_rate_request req[3] = {
+		{ .clk = &clk[2], .rate = 122880000 },
+		{ .clk = &clk[1], .rate = 245760000 },
+		{ .clk = &clk[0], .rate = 2949120000 },
+	};
+	uint32_t i;
+
+	clk_bench_clk(&clk[0], &hw[0], &dev[0], NULL, 0);
+	clk_bench_clk(&clk[1], &hw[1], &dev[1], &clk[0], 0);
+	clk_bench_clk(&clk[2], &hw[2], &dev[2], &clk[0], 0);
+
+	BENCH_CHECK(!clk_set_rates(req, ARRAY_SIZE(req)));
+	for (i = 0; i < ARRAY_SIZE(req); i++) {
+		BENCH_CHECK(dev[i].set_calls == 1);
+		BENCH_CHECK(dev[i].rate == req[2 - i].rate);
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Print the cost of clk_recalc_rate() with and without the cache.
+ * @param loops - Number of calls.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t clk_bench_recalc(uint32_t loops)
+{
+	static const uint32_t flags[] = { 0, CLK_CACHE_RATE };
+	struct clk_bench_dev dev[2];
+	struct clk_hw hw[2];
+	struct clk clk[2];
+	uint64_t start, ns, rate;
+	uint32_t i, j;
+
+	for (i = 0; i < ARRAY_SIZE(flags); i++) {
+		/* The leaf has no recalc op and reads the rate of its parent. */
+		clk_bench_clk(&clk[0], &hw[0], &dev[0], NULL, flags[i]);
+		clk_bench_clk(&clk[1], &hw[1], &dev[1], &clk[0], flags[i]);
+		hw[1].dev_clk_recalc_rate = NULL;
+		dev[0].rate = 100000000;
+
+		start = bench_now_ns();
+		for (j = 0; j < loops; j++)
+			if (clk_recalc_rate(&clk[1], &rate))
+				return FAILURE;
+		ns = bench_now_ns() - start;
+
+		printf("%-28s %8.1f ns/call %10u provider calls\n",
+		       flags[i] ? "recalc_rate, cached" : "recalc_rate",
+		       (double)ns / loops, dev[0].recalc_calls);
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Clock framework checks with simulated providers, then the cost of
+ * a rate read.
+ * -n loops: number of clk_recalc_rate() calls
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t clk_bench(int argc, char **argv)
+{
+	uint32_t loops = CLK_BENCH_LOOPS;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:")) != -1) {
+		switch (opt) {
+		case 'n':
+			loops = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			return -EINVAL;
+		}
+	}
+
+	if (!loops)
+		return -EINVAL;
+
+	if (clk_bench_check_default() || clk_bench_check_cache() ||
+	    clk_bench_check_refcount() || clk_bench_check_batch())
+		return FAILURE;
+	printf("clk: checks passed\n");
+
+	return clk_bench_recalc(loops);
+}
@@ -0,0 +1,202 @@
+/***************************************************************************//**
+ *   @file   crc8_bench.c
+ *   @brief  Checks and cost of the shared CRC-8 table.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "bench.h"
+#include "no-os/crc8.h"
+#include "no-os/error.h"
+#include "no-os/util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define CRC8_BENCH_LOOPS	5000000
+#define CRC8_BENCH_BULK_LEN	4096
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Bit serial CRC-8 of x^8 + x^2 + x^1 + 1, as the drivers computed it
+ * before the shared table.
+ * @param data - Data.
+ * @param len - Number of bytes.
+ * @param crc - Initial value.
+ * @return CRC-8 value.
+ */
+static uint8_t __attribute__((noinline))
+crc8_bench_bitwise(const uint8_t *data, uint32_t len, uint8_t crc)
+{
+	uint8_t i;
+
+	while (len--) {
+		crc ^= *data++;
+		for (i = 0; i < 8; i++)
+			crc = crc & 0x80 ? (crc << 1) ^ CRC8_POLY_07 : crc << 1;
+	}
+
+	return crc;
+}
+
+/**
+ * @brief crc8_table_07 is the table crc8_populate_msb() builds, and crc8()
+ * with it gives the bit serial result and the CRC-8 check value.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t crc8_bench_check(void)
+{
+	static const uint8_t check[] = "123456789";
+	uint8_t table[CRC8_TABLE_SIZE];
+	uint8_t buf[64];
+	uint32_t len, i;
+
+	crc8_populate_msb(table, CRC8_POLY_07);
+	BENCH_CHECK(!memcmp(table, crc8_table_07, sizeof(table)));
+
+	/* Check value of CRC-8 with this polynomial and no final xor */
+	BENCH_CHECK(crc8(crc8_table_07, check, 9, 0) == 0xF4);
+
+	for (len = 0; len <= sizeof(buf); len++) {
+		for (i = 0; i < len; i++)
+			buf[i] = rand();
+		i = rand() & 0xFF;
+		BENCH_CHECK(crc8(crc8_table_07, buf, len, i) ==
+			    crc8_bench_bitwise(buf, len, i));
+		/* Cascaded calls give the result of a single call */
+		BENCH_CHECK(crc8(crc8_table_07, buf + len / 2,
+				 len - len / 2,
+				 crc8(crc8_table_07, buf, len / 2, i)) ==
+			    crc8(crc8_table_07, buf, len, i));
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Print the cost of the CRC of one frame, bit serial and with the
+ * table.
+ * @param len - Frame length.
+ * @param loops - Number of frames.
+ */
+static void crc8_bench_frame(uint32_t len, uint32_t loops)
+{
+	uint8_t frame[CRC8_BENCH_BULK_LEN];
+	volatile uint8_t sink = 0;
+	uint64_t start, ns[2];
+	uint32_t i;
+
+	for (i = 0; i < len; i++)
+		frame[i] = rand();
+
+	start = bench_now_ns();
+	for (i = 0; i < loops; i++) {
+		frame[0] = i;
+		sink += crc8_bench_bitwise(frame, len, 0);
+	}
+	ns[0] = bench_now_ns() - start;
+
+	start = bench_now_ns();
+	for (i = 0; i < loops; i++) {
+		frame[0] = i;
+		sink += crc8(crc8_table_07, frame, len, 0);
+	}
+	ns[1] = bench_now_ns() - start;
+
+	printf("%4u byte frame  bitwise %8.1f ns  table %8.1f ns\n", len,
+	       (double)ns[0] / loops, (double)ns[1] / loops);
+}
+
+/**
+ * @brief Check the shared CRC-8 table, then print the CRC cost of the frame
+ * sizes the drivers use, bit serial and with the table, and the cost of
+ * building a table at run time, which the shared table saves.
+ * -n loops: number of frames
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t crc8_bench(int argc, char **argv)
+{
+	/* ad7124 status read, ad77681 16 and 24-bit frames, ad7124 data */
+	static const uint32_t lens[] = { 2, 3, 5, 6, CRC8_BENCH_BULK_LEN };
+	uint32_t loops = CRC8_BENCH_LOOPS;
+	uint8_t table[CRC8_TABLE_SIZE];
+	uint64_t start;
+	uint32_t i;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:")) != -1) {
+		switch (opt) {
+		case 'n':
+			loops = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			return -EINVAL;
+		}
+	}
+
+	if (!loops)
+		return -EINVAL;
+
+	if (crc8_bench_check())
+		return FAILURE;
+	printf("crc8: checks passed\n");
+
+	for (i = 0; i < ARRAY_SIZE(lens); i++)
+		crc8_bench_frame(lens[i],
+				 lens[i] == CRC8_BENCH_BULK_LEN ?
+				 max(loops / CRC8_BENCH_BULK_LEN, 1u) : loops);
+
+	start = bench_now_ns();
+	for (i = 0; i < 1000; i++) {
+		table[0] = i;
+		crc8_populate_msb(table, CRC8_POLY_07);
+	}
+	printf("crc8_populate_msb %.1f ns, %u bytes of RAM per table\n",
+	       (bench_now_ns() - start) / 1000.0, CRC8_TABLE_SIZE);
+
+	return SUCCESS;
+}
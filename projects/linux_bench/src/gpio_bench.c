@@ -0,0 +1,252 @@
+/***************************************************************************//**
+ *   @file   gpio_bench.c
+ *   @brief  GPIO toggle rate of the sysfs and character device backends.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include "bench.h"
+#include "no-os/gpio.h"
+#include "no-os/error.h"
+#include "linux_gpio.h"
+#include "linux_gpiochip.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define GPIO_BENCH_TOGGLES	100000
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Print the rate of a toggle loop.
+ * @param name - Name of the measurement.
+ * @param toggles - Number of value changes of each line.
+ * @param lines - Number of lines changed by each toggle.
+ * @param ns - Duration of the loop.
+ */
+static void gpio_bench_report(const char *name, uint32_t toggles,
+			      uint32_t lines, uint64_t ns)
+{
+	printf("%-28s %10.0f toggles/s %8.0f ns/toggle %10.0f line changes/s\n",
+	       name, toggles * 1e9 / ns, (double)ns / toggles,
+	       (double)toggles * lines * 1e9 / ns);
+}
+
+/**
+ * @brief Toggle one line with gpio_set_value().
+ * @param name - Name of the measurement.
+ * @param param - Parameters of the line.
+ * @param toggles - Number of value changes.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t gpio_bench_single(const char *name,
+				 const struct gpio_init_param *param,
+				 uint32_t toggles)
+{
+	struct gpio_desc *desc;
+	uint64_t start;
+	int32_t ret;
+	uint32_t i;
+
+	ret = gpio_get(&desc, param);
+	if (ret != SUCCESS)
+		return ret;
+
+	ret = gpio_direction_output(desc, GPIO_LOW);
+	if (ret != SUCCESS)
+		goto out;
+
+	start = bench_now_ns();
+	for (i = 0; i < toggles; i++) {
+		ret = gpio_set_value(desc, i & 1 ? GPIO_LOW : GPIO_HIGH);
+		if (ret != SUCCESS)
+			goto out;
+	}
+	gpio_bench_report(name, toggles, 1, bench_now_ns() - start);
+
+out:
+	gpio_remove(desc);
+
+	return ret;
+}
+
+/**
+ * @brief Toggle a group of lines, one gpio_set_value() per line and then with
+ * gpio_set_values().
+ * @param chip - GPIO chip ID.
+ * @param offsets - Line offsets.
+ * @param num - Number of lines.
+ * @param toggles - Number of value changes.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t gpio_bench_group(uint32_t chip, const uint32_t *offsets,
+				uint8_t num, uint32_t toggles)
+{
+	struct linux_gpio_lines_init_param lines_param = {
+		.chip_id = chip,
+		.offsets = offsets,
+		.num_lines = num,
+		.direction = GPIO_OUT,
+	};
+	struct linux_gpiochip_init_param chip_param = { 0 };
+	struct gpio_init_param param = {
+		.platform_ops = &linux_gpiochip_ops,
+		.extra = &chip_param,
+	};
+	struct gpio_desc *desc[LINUX_GPIO_LINES_MAX] = { 0 };
+	uint8_t values[LINUX_GPIO_LINES_MAX];
+	struct linux_gpio_lines *lines;
+	uint64_t start;
+	int32_t ret;
+	uint32_t i, j;
+
+	ret = linux_gpio_lines_get(&lines, &lines_param);
+	if (ret != SUCCESS)
+		return ret;
+
+	chip_param.lines = lines;
+	for (j = 0; j < num; j++) {
+		param.number = offsets[j];
+		ret = gpio_get(&desc[j], &param);
+		if (ret != SUCCESS)
+			goto out;
+	}
+
+	start = bench_now_ns();
+	for (i = 0; i < toggles; i++) {
+		for (j = 0; j < num; j++) {
+			ret = gpio_set_value(desc[j], i & 1 ? GPIO_LOW : GPIO_HIGH);
+			if (ret != SUCCESS)
+				goto out;
+		}
+	}
+	gpio_bench_report("chardev, one call per line", toggles, num,
+			  bench_now_ns() - start);
+
+	start = bench_now_ns();
+	for (i = 0; i < toggles; i++) {
+		memset(values, i & 1 ? GPIO_LOW : GPIO_HIGH, num);
+		ret = gpio_set_values(desc, num, values);
+		if (ret != SUCCESS)
+			goto out;
+	}
+	gpio_bench_report("chardev, gpio_set_values", toggles, num,
+			  bench_now_ns() - start);
+
+out:
+	for (j = 0; j < num; j++)
+		gpio_remove(desc[j]);
+	linux_gpio_lines_remove(lines);
+
+	return ret;
+}
+
+/**
+ * @brief GPIO toggle rate benchmark.
+ * -c chip: /dev/gpiochip index
+ * -l offsets: comma separated line offsets, all toggled by the group test
+ * -s gpio: global number of the first line, to compare with the sysfs backend
+ * -n toggles: number of value changes per test
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t gpio_bench(int argc, char **argv)
+{
+	struct linux_gpiochip_init_param chip_param = { 0 };
+	struct gpio_init_param param = { 0 };
+	uint32_t offsets[LINUX_GPIO_LINES_MAX];
+	uint32_t toggles = GPIO_BENCH_TOGGLES;
+	int32_t sysfs_gpio = -1;
+	uint8_t num = 0;
+	char *tok;
+	int32_t ret;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "c:l:s:n:")) != -1) {
+		switch (opt) {
+		case 'c':
+			chip_param.chip_id = strtoul(optarg, NULL, 0);
+			break;
+		case 'l':
+			for (tok = strtok(optarg, ","); tok &&
+			     num < LINUX_GPIO_LINES_MAX; tok = strtok(NULL, ","))
+				offsets[num++] = strtoul(tok, NULL, 0);
+			break;
+		case 's':
+			sysfs_gpio = strtol(optarg, NULL, 0);
+			break;
+		case 'n':
+			toggles = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			return -EINVAL;
+		}
+	}
+
+	if (!num || !toggles) {
+		printf("gpio: at least one line (-l) is needed\n");
+		return -EINVAL;
+	}
+
+	if (sysfs_gpio >= 0) {
+		param.number = sysfs_gpio;
+		param.platform_ops = &linux_gpio_ops;
+		param.extra = NULL;
+		ret = gpio_bench_single("sysfs", &param, toggles);
+		if (ret != SUCCESS)
+			return ret;
+	}
+
+	param.number = offsets[0];
+	param.platform_ops = &linux_gpiochip_ops;
+	param.extra = &chip_param;
+	ret = gpio_bench_single("chardev", &param, toggles);
+	if (ret != SUCCESS)
+		return ret;
+
+	return gpio_bench_group(chip_param.chip_id, offsets, num, toggles);
+}
@@ -0,0 +1,379 @@
+/***************************************************************************//**
+ *   @file   interleave_bench.c
+ *   @brief  Checks and throughput of the channel interleave kernels.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "bench.h"
+#include "no-os/interleave.h"
+#include "no-os/error.h"
+#include "no-os/util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define INTERLEAVE_BENCH_SAMPLES	(1 << 20)
+#define INTERLEAVE_BENCH_REPEATS	20
+
+/* Channels and lengths checked against the reference */
+#define INTERLEAVE_BENCH_CHECK_CH	6
+#define INTERLEAVE_BENCH_CHECK_LEN	41
+
+/* Channels of the throughput runs */
+#define INTERLEAVE_BENCH_MAX_CH		8
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Fill a buffer with pseudo random bytes.
+ * @param buf - Buffer.
+ * @param len - Length in bytes.
+ */
+static void interleave_bench_fill(void *buf, uint32_t len)
+{
+	uint8_t *b = buf;
+
+	while (len--)
+		*b++ = rand();
+}
+
+/**
+ * @brief Scalar interleave, the loop the kernels replace.
+ * @param dst - Frames.
+ * @param src - One buffer per channel.
+ * @param nb_ch - Number of channels.
+ * @param size - Size of a sample in bytes.
+ * @param samples - Number of samples of each channel.
+ */
+static void __attribute__((noinline))
+interleave_bench_ref(void *dst, const void * const *src, uint32_t nb_ch,
+		     uint32_t size, uint32_t samples)
+{
+	uint8_t *d = dst;
+	uint32_t i, j;
+
+	for (i = 0; i < samples; i++)
+		for (j = 0; j < nb_ch; j++, d += size)
+			memcpy(d, (const uint8_t *)src[j] + i * size, size);
+}
+
+/**
+ * @brief Scalar deinterleave, the loop the kernels replace.
+ * @param dst - One buffer per channel.
+ * @param src - Frames.
+ * @param nb_ch - Number of channels.
+ * @param size - Size of a sample in bytes.
+ * @param samples - Number of samples of each channel.
+ */
+static void __attribute__((noinline))
+deinterleave_bench_ref(void * const *dst, const void *src, uint32_t nb_ch,
+		       uint32_t size, uint32_t samples)
+{
+	const uint8_t *s = src;
+	uint32_t i, j;
+
+	for (i = 0; i < samples; i++)
+		for (j = 0; j < nb_ch; j++, s += size)
+			memcpy((uint8_t *)dst[j] + i * size, s, size);
+}
+
+/**
+ * @brief The kernels of every mask of up to 6 channels, for 2 and 4 byte
+ * samples and every length up to 40, give the reference result and round
+ * trip.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t interleave_bench_check_kernels(void)
+{
+	static uint8_t ch[INTERLEAVE_BENCH_CHECK_CH][INTERLEAVE_BENCH_CHECK_LEN * 4];
+	static uint8_t out[INTERLEAVE_BENCH_CHECK_CH][INTERLEAVE_BENCH_CHECK_LEN * 4];
+	static uint8_t frames[sizeof(ch)], ref[sizeof(ch)];
+	void *src[INTERLEAVE_BENCH_CHECK_CH], *dst[INTERLEAVE_BENCH_CHECK_CH];
+	struct interleave_plan plan;
+	uint32_t size, mask, len, j;
+
+	for (j = 0; j < INTERLEAVE_BENCH_CHECK_CH; j++) {
+		src[j] = ch[j];
+		dst[j] = out[j];
+	}
+
+	for (size = 2; size <= 4; size += 2) {
+		for (mask = 0; mask < (1 << INTERLEAVE_BENCH_CHECK_CH); mask++) {
+			BENCH_CHECK(!interleave_plan_init(&plan, mask, size));
+			BENCH_CHECK(plan.nb_ch == hweight8(mask));
+			for (len = 0; len < INTERLEAVE_BENCH_CHECK_LEN; len++) {
+				interleave_bench_fill(ch, sizeof(ch));
+				interleave_bench_ref(ref, (const void * const *)src,
+						     plan.nb_ch, size, len);
+				interleave_frames(&plan, frames,
+						  (const void * const *)src, len);
+				BENCH_CHECK(!memcmp(frames, ref,
+						    plan.nb_ch * size * len));
+
+				deinterleave_frames(&plan, dst, frames, len);
+				for (j = 0; j < plan.nb_ch; j++)
+					BENCH_CHECK(!memcmp(out[j], ch[j],
+							    size * len));
+			}
+		}
+	}
+
+	BENCH_CHECK(interleave_plan_init(&plan, 1, 3) == -EINVAL);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief The sample conversion helpers give the byte wise result.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t interleave_bench_check_samples(void)
+{
+	uint8_t b[INTERLEAVE_BENCH_CHECK_LEN * 3];
+	uint32_t d[INTERLEAVE_BENCH_CHECK_LEN], w[INTERLEAVE_BENCH_CHECK_LEN];
+	uint32_t w0[INTERLEAVE_BENCH_CHECK_LEN];
+	uint16_t h[INTERLEAVE_BENCH_CHECK_LEN], h0[INTERLEAVE_BENCH_CHECK_LEN];
+	int32_t s[INTERLEAVE_BENCH_CHECK_LEN], r[INTERLEAVE_BENCH_CHECK_LEN];
+	uint32_t len, bits, i;
+
+	for (len = 0; len < INTERLEAVE_BENCH_CHECK_LEN; len++) {
+		interleave_bench_fill(b, sizeof(b));
+		sample_be16_to_u32(d, b, len);
+		for (i = 0; i < len; i++)
+			BENCH_CHECK(d[i] == ((uint32_t)b[2 * i] << 8 |
+					     b[2 * i + 1]));
+		sample_be24_to_u32(d, b, len);
+		for (i = 0; i < len; i++)
+			BENCH_CHECK(d[i] == ((uint32_t)b[3 * i] << 16 |
+					     (uint32_t)b[3 * i + 1] << 8 |
+					     b[3 * i + 2]));
+
+		for (bits = 1; bits <= 32; bits++) {
+			interleave_bench_fill(s, sizeof(s));
+			for (i = 0; i < len; i++) {
+				/* Shift the sign bit to bit 31 and back */
+				r[i] = (int32_t)((uint32_t)s[i] << (32 - bits)) >>
+				       (32 - bits);
+			}
+			sample_sign_extend32(s, len, bits);
+			BENCH_CHECK(!memcmp(s, r, len * sizeof(*s)));
+		}
+
+		interleave_bench_fill(h0, sizeof(h0));
+		interleave_bench_fill(w0, sizeof(w0));
+		memcpy(h, h0, sizeof(h));
+		memcpy(w, w0, sizeof(w));
+		sample_swab16(h, len);
+		sample_swab32(w, len);
+		for (i = 0; i < len; i++) {
+			BENCH_CHECK(h[i] == __builtin_bswap16(h0[i]));
+			BENCH_CHECK(w[i] == __builtin_bswap32(w0[i]));
+		}
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Print the interleave and deinterleave throughput of the kernels
+ * and of the scalar loop.
+ * @param mask - Mask of the active channels.
+ * @param size - Size of a sample in bytes.
+ * @param samples - Samples of each channel.
+ * @param repeats - Number of runs.
+ * @param ch - Channel buffers.
+ * @param frames - Frame buffer.
+ */
+static void interleave_bench_rate(uint32_t mask, uint32_t size,
+				  uint32_t samples, uint32_t repeats,
+				  void * const *ch, void *frames)
+{
+	struct interleave_plan plan;
+	uint64_t ns[4], start;
+	double mb;
+	uint32_t i;
+
+	interleave_plan_init(&plan, mask, size);
+	mb = (double)plan.nb_ch * size * samples * repeats / 1e6;
+
+	start = bench_now_ns();
+	for (i = 0; i < repeats; i++)
+		interleave_bench_ref(frames, (const void * const *)ch,
+				     plan.nb_ch, size, samples);
+	ns[0] = bench_now_ns() - start;
+
+	start = bench_now_ns();
+	for (i = 0; i < repeats; i++)
+		interleave_frames(&plan, frames, (const void * const *)ch,
+				  samples);
+	ns[1] = bench_now_ns() - start;
+
+	start = bench_now_ns();
+	for (i = 0; i < repeats; i++)
+		deinterleave_bench_ref(ch, frames, plan.nb_ch, size, samples);
+	ns[2] = bench_now_ns() - start;
+
+	start = bench_now_ns();
+	for (i = 0; i < repeats; i++)
+		deinterleave_frames(&plan, ch, frames, samples);
+	ns[3] = bench_now_ns() - start;
+
+	printf("%2u-bit %u ch  interleave %6.0f MB/s (loop %5.0f)  deinterleave %6.0f MB/s (loop %5.0f)\n",
+	       size * 8, plan.nb_ch, mb * 1e9 / ns[1], mb * 1e9 / ns[0],
+	       mb * 1e9 / ns[3], mb * 1e9 / ns[2]);
+}
+
+/**
+ * @brief Print the throughput of the sample conversion helpers.
+ * @param samples - Samples converted in a run.
+ * @param repeats - Number of runs.
+ * @param buf - Buffer of 4 * samples bytes.
+ * @param tmp - Buffer of 4 * samples bytes.
+ */
+static void interleave_bench_samples_rate(uint32_t samples, uint32_t repeats,
+		void *buf, void *tmp)
+{
+	uint64_t ns[5], start;
+	double ms;
+	uint32_t i;
+
+	ms = (double)samples * repeats / 1e6;
+
+	start = bench_now_ns();
+	for (i = 0; i < repeats; i++)
+		sample_be16_to_u32(buf, tmp, samples);
+	ns[0] = bench_now_ns() - start;
+
+	start = bench_now_ns();
+	for (i = 0; i < repeats; i++)
+		sample_be24_to_u32(buf, tmp, samples);
+	ns[1] = bench_now_ns() - start;
+
+	start = bench_now_ns();
+	for (i = 0; i < repeats; i++)
+		sample_sign_extend32(buf, samples, 24);
+	ns[2] = bench_now_ns() - start;
+
+	start = bench_now_ns();
+	for (i = 0; i < repeats; i++)
+		sample_swab16(buf, samples);
+	ns[3] = bench_now_ns() - start;
+
+	start = bench_now_ns();
+	for (i = 0; i < repeats; i++)
+		sample_swab32(buf, samples);
+	ns[4] = bench_now_ns() - start;
+
+	printf("be16_to_u32 %6.0f MS/s  be24_to_u32 %6.0f MS/s  sign_extend32 %6.0f MS/s\n",
+	       ms * 1e9 / ns[0], ms * 1e9 / ns[1], ms * 1e9 / ns[2]);
+	printf("swab16      %6.0f MS/s  swab32      %6.0f MS/s\n",
+	       ms * 1e9 / ns[3], ms * 1e9 / ns[4]);
+}
+
+/**
+ * @brief Check the interleave kernels and the sample conversion helpers
+ * against scalar references, then print their throughput.
+ * -n samples: samples of each channel in a run
+ * -r repeats: number of runs
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t interleave_bench(int argc, char **argv)
+{
+	static const uint32_t masks[] = { 0x1, 0x3, 0x7, 0xF, 0xFF };
+	uint32_t samples = INTERLEAVE_BENCH_SAMPLES;
+	uint32_t repeats = INTERLEAVE_BENCH_REPEATS;
+	void *ch[INTERLEAVE_BENCH_MAX_CH];
+	void *frames;
+	int32_t ret = -ENOMEM;
+	uint32_t i, j;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:r:")) != -1) {
+		switch (opt) {
+		case 'n':
+			samples = strtoul(optarg, NULL, 0);
+			break;
+		case 'r':
+			repeats = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			return -EINVAL;
+		}
+	}
+
+	if (!samples || !repeats)
+		return -EINVAL;
+
+	if (interleave_bench_check_kernels() ||
+	    interleave_bench_check_samples())
+		return FAILURE;
+	printf("interleave: checks passed\n");
+
+	memset(ch, 0, sizeof(ch));
+	frames = calloc(INTERLEAVE_BENCH_MAX_CH, samples * 4);
+	if (!frames)
+		return -ENOMEM;
+	for (i = 0; i < INTERLEAVE_BENCH_MAX_CH; i++) {
+		ch[i] = calloc(samples, 4);
+		if (!ch[i])
+			goto out;
+	}
+
+	for (i = 2; i <= 4; i += 2)
+		for (j = 0; j < ARRAY_SIZE(masks); j++)
+			interleave_bench_rate(masks[j], i, samples, repeats, ch,
+					      frames);
+	interleave_bench_samples_rate(samples, repeats, ch[0], frames);
+	ret = SUCCESS;
+
+out:
+	for (i = 0; i < INTERLEAVE_BENCH_MAX_CH; i++)
+		free(ch[i]);
+	free(frames);
+
+	return ret;
+}
@@ -0,0 +1,549 @@
+/***************************************************************************//**
+ *   @file   jesd204_bench.c
+ *   @brief  JESD204 link state machine against simulated links.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "bench.h"
+#include "jesd204_link_fsm.h"
+#include "no-os/error.h"
+#include "no-os/util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define JESD204_BENCH_LINKS		2
+#define JESD204_BENCH_POLL_US		100
+#define JESD204_BENCH_TIMEOUT_US	10000
+#define JESD204_BENCH_LOOPS		10000
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct jesd204_bench_sim
+ * @brief Simulated link: transceiver and link core. Each condition becomes
+ * true after the given number of polls once its stage is entered, -1 never.
+ */
+struct jesd204_bench_sim {
+	struct adxcvr xcvr;
+	struct axi_jesd204_rx rx;
+	struct axi_jesd204_tx tx;
+	/** Polls until the PLLs lock, after the PHY reset is released */
+	int32_t phy_polls;
+	/** Polls until the link leaves reset, after the lane clock is enabled */
+	int32_t link_polls;
+	/** Polls until SYSREF is captured, after the SYSREF pulse */
+	int32_t sysref_polls;
+	/** Polls until DATA, after SYSREF is captured */
+	int32_t data_polls;
+	/** Error returned by adxcvr_clk_set_rate() */
+	int32_t set_rate_error;
+	/** -EAGAIN returns of setup_clocks() before it succeeds */
+	uint32_t clocks_again;
+	/* Simulated hardware state */
+	bool phy_reset;
+	bool lane_clk;
+	uint32_t phy_count;
+	uint32_t link_count;
+	uint32_t sysref_count;
+	uint32_t data_count;
+	/* Calls seen by the simulated hardware */
+	uint32_t set_rate_khz;
+	uint32_t clocks_calls;
+	uint32_t phy_releases;
+	uint32_t lane_clk_enables;
+};
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+
+static struct jesd204_bench_sim jesd204_bench_sims[JESD204_BENCH_LINKS];
+static uint32_t jesd204_bench_sysref_pulses;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Find the simulated link of a transceiver or link core.
+ * @param ptr - Transceiver or link core descriptor.
+ * @return The simulated link.
+ */
+static struct jesd204_bench_sim *jesd204_bench_find(const void *ptr)
+{
+	struct jesd204_bench_sim *sim;
+	uint32_t i;
+
+	for (i = 0; i < JESD204_BENCH_LINKS; i++) {
+		sim = &jesd204_bench_sims[i];
+		if (ptr == &sim->xcvr || ptr == &sim->rx || ptr == &sim->tx)
+			return sim;
+	}
+
+	printf("jesd204: unknown descriptor %p\n", ptr);
+	exit(1);
+}
+
+/**
+ * @brief Count one poll of a condition.
+ * @param count - Polls seen so far.
+ * @param polls - Polls needed, -1 never.
+ * @return true once the condition is met.
+ */
+static bool jesd204_bench_poll(uint32_t *count, int32_t polls)
+{
+	if (polls < 0)
+		return false;
+	if (*count < (uint32_t)polls) {
+		(*count)++;
+		return false;
+	}
+
+	return true;
+}
+
+/* Simulated transceiver, replaces axi_adxcvr.c */
+
+int32_t adxcvr_clk_set_rate(struct adxcvr *xcvr, uint32_t rate,
+			    uint32_t parent_rate)
+{
+	struct jesd204_bench_sim *sim = jesd204_bench_find(xcvr);
+
+	if (!sim->phy_reset)
+		return FAILURE;
+	if (sim->set_rate_error)
+		return sim->set_rate_error;
+	sim->set_rate_khz = rate;
+
+	return SUCCESS;
+}
+
+int32_t adxcvr_clk_disable(struct adxcvr *xcvr)
+{
+	struct jesd204_bench_sim *sim = jesd204_bench_find(xcvr);
+
+	sim->phy_reset = true;
+	sim->phy_count = 0;
+
+	return SUCCESS;
+}
+
+int32_t adxcvr_clk_enable_nowait(struct adxcvr *xcvr)
+{
+	struct jesd204_bench_sim *sim = jesd204_bench_find(xcvr);
+
+	sim->phy_reset = false;
+	sim->phy_releases++;
+
+	return SUCCESS;
+}
+
+bool adxcvr_status_ready(struct adxcvr *xcvr)
+{
+	struct jesd204_bench_sim *sim = jesd204_bench_find(xcvr);
+
+	return !sim->phy_reset && jesd204_bench_poll(&sim->phy_count,
+			sim->phy_polls);
+}
+
+/* Simulated link cores, replace axi_jesd204_rx.c and axi_jesd204_tx.c */
+
+/**
+ * @brief Lane clock change of a simulated link core.
+ * @param ptr - Link core descriptor.
+ * @param enable - New lane clock state.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t jesd204_bench_lane_clk(const void *ptr, bool enable)
+{
+	struct jesd204_bench_sim *sim = jesd204_bench_find(ptr);
+
+	/* The link core is only enabled once the PHY is up. */
+	if (enable && (sim->phy_reset || sim->phy_polls < 0))
+		return FAILURE;
+
+	sim->lane_clk = enable;
+	sim->link_count = 0;
+	sim->sysref_count = 0;
+	sim->data_count = 0;
+	if (enable)
+		sim->lane_clk_enables++;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Status of a simulated link core.
+ * @param ptr - Link core descriptor.
+ * @param enabled - Link out of reset.
+ * @param sysref_captured - SYSREF captured.
+ * @param data - Link in the DATA state.
+ * @return SUCCESS.
+ */
+static int32_t jesd204_bench_link_poll(const void *ptr, bool *enabled,
+				       bool *sysref_captured, bool *data)
+{
+	struct jesd204_bench_sim *sim = jesd204_bench_find(ptr);
+
+	*enabled = sim->lane_clk && jesd204_bench_poll(&sim->link_count,
+			sim->link_polls);
+	*sysref_captured = *enabled && jesd204_bench_sysref_pulses &&
+			   jesd204_bench_poll(&sim->sysref_count,
+					   sim->sysref_polls);
+	*data = *sysref_captured && jesd204_bench_poll(&sim->data_count,
+			sim->data_polls);
+
+	return SUCCESS;
+}
+
+int32_t axi_jesd204_rx_lane_clk_enable(struct axi_jesd204_rx *jesd)
+{
+	return jesd204_bench_lane_clk(jesd, true);
+}
+
+int32_t axi_jesd204_rx_lane_clk_disable(struct axi_jesd204_rx *jesd)
+{
+	return jesd204_bench_lane_clk(jesd, false);
+}
+
+int32_t axi_jesd204_rx_link_poll(struct axi_jesd204_rx *jesd, bool *enabled,
+				 bool *sysref_captured, bool *data)
+{
+	return jesd204_bench_link_poll(jesd, enabled, sysref_captured, data);
+}
+
+int32_t axi_jesd204_tx_lane_clk_enable(struct axi_jesd204_tx *jesd)
+{
+	return jesd204_bench_lane_clk(jesd, true);
+}
+
+int32_t axi_jesd204_tx_lane_clk_disable(struct axi_jesd204_tx *jesd)
+{
+	return jesd204_bench_lane_clk(jesd, false);
+}
+
+int32_t axi_jesd204_tx_link_poll(struct axi_jesd204_tx *jesd, bool *enabled,
+				 bool *sysref_captured, bool *data)
+{
+	return jesd204_bench_link_poll(jesd, enabled, sysref_captured, data);
+}
+
+/**
+ * @brief Simulated device clock setup, not ready for the first calls.
+ * @param ctx - Simulated link.
+ * @return SUCCESS or -EAGAIN.
+ */
+static int32_t jesd204_bench_setup_clocks(void *ctx)
+{
+	struct jesd204_bench_sim *sim = ctx;
+
+	if (sim->clocks_calls++ < sim->clocks_again)
+		return -EAGAIN;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Simulated SYSREF generator.
+ * @param ctx - Unused.
+ * @return SUCCESS.
+ */
+static int32_t jesd204_bench_sysref(void *ctx)
+{
+	jesd204_bench_sysref_pulses++;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Reset the simulation: an RX and a TX link with a lane rate, that
+ * come up within a few polls.
+ * @param links - State machine links, bound to the simulated links.
+ */
+static void jesd204_bench_setup(struct jesd204_link_fsm_link *links)
+{
+	struct jesd204_bench_sim *sim;
+	uint32_t i;
+
+	memset(jesd204_bench_sims, 0, sizeof(jesd204_bench_sims));
+	memset(links, 0, JESD204_BENCH_LINKS * sizeof(*links));
+	jesd204_bench_sysref_pulses = 0;
+
+	for (i = 0; i < JESD204_BENCH_LINKS; i++) {
+		sim = &jesd204_bench_sims[i];
+		sim->phy_polls = 3 + i;
+		sim->link_polls = 1;
+		sim->sysref_polls = 2;
+		sim->data_polls = 4 - i;
+		sim->xcvr.ref_rate_khz = 250000;
+
+		links[i].name = i ? "tx" : "rx";
+		links[i].xcvr = &sim->xcvr;
+		links[i].lane_rate_khz = 10000000;
+		links[i].setup_clocks = jesd204_bench_setup_clocks;
+		links[i].ctx = sim;
+		if (i)
+			links[i].tx = &sim->tx;
+		else
+			links[i].rx = &sim->rx;
+	}
+}
+
+/**
+ * @brief Step the state machine with a simulated clock.
+ * @param fsm - The state machine descriptor.
+ * @param steps - Number of steps taken.
+ * @return The result of the last step.
+ */
+static int32_t jesd204_bench_steps(struct jesd204_link_fsm *fsm,
+				   uint32_t *steps)
+{
+	int32_t ret;
+
+	*steps = 0;
+	while ((ret = jesd204_link_fsm_step(fsm)) == -EAGAIN) {
+		fsm->now_us += fsm->poll_us;
+		(*steps)++;
+	}
+
+	return ret;
+}
+
+/**
+ * @brief Both links come up, SYSREF is sent once when both wait for it and
+ * the stages see the hardware in the expected order.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t jesd204_bench_check_up(void)
+{
+	struct jesd204_link_fsm_link links[JESD204_BENCH_LINKS];
+	struct jesd204_link_fsm_init_param param = {
+		.links = links,
+		.num_links = JESD204_BENCH_LINKS,
+		.sysref = jesd204_bench_sysref,
+		.poll_us = JESD204_BENCH_POLL_US,
+		.stage_timeout_us = JESD204_BENCH_TIMEOUT_US,
+	};
+	struct jesd204_link_fsm *fsm;
+	struct jesd204_bench_sim *sim;
+	uint32_t steps, i;
+	int32_t ret;
+
+	jesd204_bench_setup(links);
+	jesd204_bench_sims[1].clocks_again = 2;
+
+	BENCH_CHECK(!jesd204_link_fsm_init(&fsm, &param));
+	ret = jesd204_bench_steps(fsm, &steps);
+	jesd204_link_fsm_print_timing(fsm);
+	jesd204_link_fsm_remove(fsm);
+
+	BENCH_CHECK(ret == SUCCESS);
+	BENCH_CHECK(jesd204_bench_sysref_pulses == 1);
+	for (i = 0; i < JESD204_BENCH_LINKS; i++) {
+		sim = &jesd204_bench_sims[i];
+		BENCH_CHECK(links[i].state == JESD204_LINK_FSM_DONE);
+		BENCH_CHECK(sim->set_rate_khz == links[i].lane_rate_khz);
+		BENCH_CHECK(sim->phy_releases == 1);
+		BENCH_CHECK(sim->lane_clk_enables == 1);
+		BENCH_CHECK(sim->clocks_calls == sim->clocks_again + 1);
+	}
+	/* The slowest link sets the pace: PHY lock and DATA of the TX link. */
+	BENCH_CHECK(steps < 16);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief A link that never reaches a stage fails with -ETIMEDOUT once the
+ * stage timeout is exceeded, and SYSREF is never sent.
+ * @param stage - Stage that never completes.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t jesd204_bench_check_timeout(enum jesd204_link_fsm_state stage)
+{
+	struct jesd204_link_fsm_link links[JESD204_BENCH_LINKS];
+	struct jesd204_link_fsm_init_param param = {
+		.links = links,
+		.num_links = JESD204_BENCH_LINKS,
+		.sysref = jesd204_bench_sysref,
+		.poll_us = JESD204_BENCH_POLL_US,
+		.stage_timeout_us = JESD204_BENCH_TIMEOUT_US,
+	};
+	struct jesd204_link_fsm *fsm;
+	uint32_t steps;
+	int32_t ret;
+
+	jesd204_bench_setup(links);
+	if (stage == JESD204_LINK_FSM_PHY)
+		jesd204_bench_sims[1].phy_polls = -1;
+	else
+		jesd204_bench_sims[1].data_polls = -1;
+
+	BENCH_CHECK(!jesd204_link_fsm_init(&fsm, &param));
+	ret = jesd204_bench_steps(fsm, &steps);
+	jesd204_link_fsm_remove(fsm);
+
+	BENCH_CHECK(ret == -ETIMEDOUT);
+	BENCH_CHECK(links[1].state == JESD204_LINK_FSM_FAILED);
+	BENCH_CHECK(links[1].error == -ETIMEDOUT);
+	BENCH_CHECK(steps * JESD204_BENCH_POLL_US <=
+		    2 * JESD204_BENCH_TIMEOUT_US);
+	BENCH_CHECK(jesd204_bench_sysref_pulses ==
+		    (stage == JESD204_LINK_FSM_PHY ? 0 : 1));
+
+	return SUCCESS;
+}
+
+/**
+ * @brief A lane rate the transceiver rejects fails the CLOCKS stage with
+ * the transceiver error, the PHY stays in reset.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t jesd204_bench_check_set_rate(void)
+{
+	struct jesd204_link_fsm_link links[JESD204_BENCH_LINKS];
+	struct jesd204_link_fsm_init_param param = {
+		.links = links,
+		.num_links = JESD204_BENCH_LINKS,
+		.poll_us = JESD204_BENCH_POLL_US,
+		.stage_timeout_us = JESD204_BENCH_TIMEOUT_US,
+	};
+	struct jesd204_link_fsm *fsm;
+	uint32_t steps;
+	int32_t ret;
+
+	jesd204_bench_setup(links);
+	jesd204_bench_sims[0].set_rate_error = -EINVAL;
+
+	BENCH_CHECK(!jesd204_link_fsm_init(&fsm, &param));
+	ret = jesd204_bench_steps(fsm, &steps);
+	jesd204_link_fsm_remove(fsm);
+
+	BENCH_CHECK(ret == -EINVAL && steps == 0);
+	BENCH_CHECK(links[0].state == JESD204_LINK_FSM_FAILED);
+	BENCH_CHECK(!jesd204_bench_sims[0].phy_releases);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Print the cost of a complete simulated bring-up.
+ * @param loops - Number of bring-ups.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t jesd204_bench_cost(uint32_t loops)
+{
+	struct jesd204_link_fsm_link links[JESD204_BENCH_LINKS];
+	struct jesd204_link_fsm_init_param param = {
+		.links = links,
+		.num_links = JESD204_BENCH_LINKS,
+		.sysref = jesd204_bench_sysref,
+		.poll_us = JESD204_BENCH_POLL_US,
+		.stage_timeout_us = JESD204_BENCH_TIMEOUT_US,
+	};
+	struct jesd204_link_fsm *fsm;
+	uint64_t start, ns = 0;
+	uint32_t steps, total = 0;
+	uint32_t i;
+	int32_t ret;
+
+	for (i = 0; i < loops; i++) {
+		jesd204_bench_setup(links);
+		if (jesd204_link_fsm_init(&fsm, &param))
+			return FAILURE;
+
+		start = bench_now_ns();
+		ret = jesd204_bench_steps(fsm, &steps);
+		ns += bench_now_ns() - start;
+		jesd204_link_fsm_remove(fsm);
+		if (ret)
+			return ret;
+
+		total += steps + 1;
+	}
+
+	printf("%-28s %8.1f ns/step %10.1f ns/bring-up\n", "link_fsm_step",
+	       (double)ns / total, (double)ns / loops);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief JESD204 link state machine checks against simulated links, then
+ * the CPU cost of a bring-up.
+ * -n loops: number of simulated bring-ups timed
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t jesd204_bench(int argc, char **argv)
+{
+	uint32_t loops = JESD204_BENCH_LOOPS;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:")) != -1) {
+		switch (opt) {
+		case 'n':
+			loops = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			return -EINVAL;
+		}
+	}
+
+	if (!loops)
+		return -EINVAL;
+
+	if (jesd204_bench_check_up() ||
+	    jesd204_bench_check_timeout(JESD204_LINK_FSM_PHY) ||
+	    jesd204_bench_check_timeout(JESD204_LINK_FSM_DATA) ||
+	    jesd204_bench_check_set_rate())
+		return FAILURE;
+	printf("jesd204: checks passed\n");
+
+	return jesd204_bench_cost(loops);
+}
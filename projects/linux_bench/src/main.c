@@ -0,0 +1,148 @@
+/***************************************************************************//**
+ *   @file   linux_bench/src/main.c
+ *   @brief  Benchmarks of the no-OS Linux platform drivers and utilities.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "bench.h"
+#include "no-os/util.h"
+#include "no-os/error.h"
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+
+static const struct bench benches[] = {
+	{
+		.name = "clk",
+		.usage = "[-n loops]",
+		.run = clk_bench,
+	},
+	{
+		.name = "crc8",
+		.usage = "[-n loops]",
+		.run = crc8_bench,
+	},
+	{
+		.name = "gpio",
+		.usage = "-c chip -l offset[,offset...] [-s sysfs_gpio] [-n toggles]",
+		.run = gpio_bench,
+	},
+	{
+		.name = "interleave",
+		.usage = "[-n samples] [-r repeats]",
+		.run = interleave_bench,
+	},
+	{
+		.name = "jesd204",
+		.usage = "[-n loops]",
+		.run = jesd204_bench,
+	},
+	{
+		.name = "sd",
+		.usage = "[-f file] [-n writes] [-s spi_hz] [-b busy_bytes] [-o xfer_ns]",
+		.run = sd_bench,
+	},
+	{
+		.name = "sdlog",
+		.usage = "[-f file] [-n bytes] [-s spi_hz]",
+		.run = sdlog_bench,
+	},
+	{
+		.name = "wifi",
+		.usage = "[-n bytes] [-s send_bytes] [-l latency_ms]",
+		.run = wifi_bench,
+	},
+#ifdef MQTT_BENCH
+	{
+		.name = "mqtt",
+		.usage = "[-n msgs] [-d ack_delay_ms]",
+		.run = mqtt_bench,
+	},
+#endif
+#ifdef TLS_BENCH
+	{
+		.name = "tls",
+		.usage = "[-a addr] [-p port] [-c ca.der] [-n connections] [-f max_frag_len] [-r]",
+		.run = tls_bench,
+	},
+#endif
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Print the available benchmarks.
+ * @param name - Program name.
+ */
+static void usage(const char *name)
+{
+	uint32_t i;
+
+	printf("usage: %s <bench> [args]\n", name);
+	for (i = 0; i < ARRAY_SIZE(benches); i++)
+		printf("  %s %s\n", benches[i].name, benches[i].usage);
+}
+
+/**
+ * @brief Run the benchmark selected by the first argument.
+ * @return 0 in case of success, 1 otherwise.
+ */
+int main(int argc, char **argv)
+{
+	uint32_t i;
+
+	if (argc < 2) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(benches); i++)
+		if (!strcmp(argv[1], benches[i].name))
+			return benches[i].run(argc - 1, argv + 1) ? 1 : 0;
+
+	usage(argv[0]);
+
+	return 1;
+}
@@ -0,0 +1,530 @@
+/***************************************************************************//**
+ *   @file   mqtt_bench.c
+ *   @brief  MQTT publish rate, blocking and queued, against a loopback broker.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "bench.h"
+#include "mqtt_client.h"
+#include "tcp_socket.h"
+#include "linux_socket.h"
+#include "no-os/error.h"
+#include "no-os/util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define MQTT_BENCH_MSGS		500
+#define MQTT_BENCH_ACK_DELAY_MS	5
+#define MQTT_BENCH_SCANS	16
+#define MQTT_BENCH_CHANNELS	4
+#define MQTT_BENCH_TOPIC	"adc/scan"
+#define MQTT_BENCH_TIMEOUT_MS	5000
+
+/* Acknowledges the broker can delay at the same time, a power of 2 */
+#define MQTT_BENCH_MAX_ACKS	1024
+#define MQTT_BENCH_BROKER_BUFF	16384
+
+/* MQTT control packet types */
+#define MQTT_BENCH_CONNECT	1
+#define MQTT_BENCH_PUBLISH	3
+#define MQTT_BENCH_PUBREL	6
+#define MQTT_BENCH_PINGREQ	12
+#define MQTT_BENCH_DISCONNECT	14
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct mqtt_bench_ack
+ * @brief Acknowledge sent by the broker once its delay expired.
+ */
+struct mqtt_bench_ack {
+	/** Monotonic time (ns) when the acknowledge is sent */
+	uint64_t due_ns;
+	/** PUBACK, PUBREC or PUBCOMP packet */
+	uint8_t pkt[4];
+};
+
+/**
+ * @struct mqtt_bench_broker
+ * @brief Loopback broker serving one client. It answers CONNECT and PINGREQ
+ * at once and acknowledges publishes after delay_ms, as a broker at the other
+ * end of a network link would.
+ */
+struct mqtt_bench_broker {
+	/** Listening socket */
+	int listen_fd;
+	/** Port of the listening socket */
+	uint16_t port;
+	/** Delay of the publish acknowledges */
+	uint32_t delay_ms;
+	/** Publishes received */
+	uint32_t publishes;
+	/** Acknowledges waiting for their delay, a ring */
+	struct mqtt_bench_ack acks[MQTT_BENCH_MAX_ACKS];
+	uint32_t ack_head;
+	uint32_t ack_tail;
+	pthread_t thread;
+};
+
+/**
+ * @struct mqtt_bench_case
+ * @brief Publish mode measured.
+ */
+struct mqtt_bench_case {
+	enum mqtt_qos qos;
+	/** Use mqtt_publish_queued() instead of mqtt_publish() */
+	bool queued;
+	/** Acknowledges awaited at the same time by the queue */
+	uint32_t max_inflight;
+};
+
+/******************************************************************************/
+/**************************** Global Variables ********************************/
+/******************************************************************************/
+
+static const struct mqtt_bench_case mqtt_bench_cases[] = {
+	{ MQTT_QOS0, false, 0 },
+	{ MQTT_QOS0, true, 0 },
+	{ MQTT_QOS1, false, 0 },
+	{ MQTT_QOS1, true, 1 },
+	{ MQTT_QOS1, true, 8 },
+	{ MQTT_QOS1, true, 32 },
+	{ MQTT_QOS2, false, 0 },
+	{ MQTT_QOS2, true, 32 },
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Queue an acknowledge to be sent after the broker delay.
+ * @param b - Broker.
+ * @param type - Packet type.
+ * @param id - Packet identifier, big endian as in the packet.
+ */
+static void mqtt_bench_ack_queue(struct mqtt_bench_broker *b, uint8_t type,
+				 const uint8_t *id)
+{
+	struct mqtt_bench_ack *ack;
+
+	if (b->ack_head - b->ack_tail == MQTT_BENCH_MAX_ACKS)
+		return;
+
+	ack = &b->acks[b->ack_head++ % MQTT_BENCH_MAX_ACKS];
+	ack->due_ns = bench_now_ns() + b->delay_ms * 1000000ull;
+	ack->pkt[0] = type << 4;
+	ack->pkt[1] = 2;
+	ack->pkt[2] = id[0];
+	ack->pkt[3] = id[1];
+}
+
+/**
+ * @brief Handle a packet received by the broker.
+ * @param b - Broker.
+ * @param fd - Client connection.
+ * @param pkt - Packet.
+ * @param hdr_len - Length of the fixed header.
+ * @return false if the client disconnected.
+ */
+static bool mqtt_bench_broker_packet(struct mqtt_bench_broker *b, int fd,
+				     const uint8_t *pkt, uint32_t hdr_len)
+{
+	static const uint8_t connack[] = { 0x20, 2, 0, 0 };
+	static const uint8_t pingresp[] = { 0xD0, 0 };
+	const uint8_t *body = pkt + hdr_len;
+	uint32_t topic_len;
+	uint8_t qos;
+
+	switch (pkt[0] >> 4) {
+	case MQTT_BENCH_CONNECT:
+		return write(fd, connack, sizeof(connack)) == sizeof(connack);
+	case MQTT_BENCH_PINGREQ:
+		return write(fd, pingresp, sizeof(pingresp)) == sizeof(pingresp);
+	case MQTT_BENCH_PUBLISH:
+		b->publishes++;
+		qos = (pkt[0] >> 1) & 3;
+		if (!qos)
+			break;
+		topic_len = body[0] << 8 | body[1];
+		mqtt_bench_ack_queue(b, qos == MQTT_QOS1 ? 4 : 5,
+				     body + 2 + topic_len);
+		break;
+	case MQTT_BENCH_PUBREL:
+		mqtt_bench_ack_queue(b, 7, body);
+		break;
+	case MQTT_BENCH_DISCONNECT:
+		return false;
+	default:
+		break;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Parse the packets read by the broker.
+ * @param b - Broker.
+ * @param fd - Client connection.
+ * @param buff - Received data, the incomplete packet left is moved first.
+ * @param len - Length of the data, updated.
+ * @return false if the client disconnected.
+ */
+static bool mqtt_bench_broker_parse(struct mqtt_bench_broker *b, int fd,
+				    uint8_t *buff, uint32_t *len)
+{
+	uint32_t pos = 0, hdr_len, rem, shift;
+	bool complete;
+
+	while (*len - pos >= 2) {
+		rem = 0;
+		shift = 0;
+		hdr_len = 1;
+		complete = false;
+		while (pos + hdr_len < *len && hdr_len <= 4) {
+			rem |= (buff[pos + hdr_len] & 0x7F) << shift;
+			shift += 7;
+			if (!(buff[pos + hdr_len++] & 0x80)) {
+				complete = true;
+				break;
+			}
+		}
+		if (!complete || pos + hdr_len + rem > *len)
+			break;
+
+		if (!mqtt_bench_broker_packet(b, fd, buff + pos, hdr_len))
+			return false;
+		pos += hdr_len + rem;
+	}
+
+	*len -= pos;
+	memmove(buff, buff + pos, *len);
+
+	return true;
+}
+
+/**
+ * @brief Broker thread, serves one connection until the client leaves.
+ * @param arg - Broker.
+ * @return NULL.
+ */
+static void *mqtt_bench_broker_run(void *arg)
+{
+	static uint8_t buff[MQTT_BENCH_BROKER_BUFF];
+	struct mqtt_bench_broker *b = arg;
+	struct mqtt_bench_ack *ack;
+	struct pollfd pfd;
+	uint32_t len = 0;
+	int64_t wait_ns;
+	ssize_t n;
+
+	pfd.fd = accept(b->listen_fd, NULL, NULL);
+	if (pfd.fd < 0)
+		return NULL;
+	pfd.events = POLLIN;
+
+	while (true) {
+		wait_ns = -1;
+		if (b->ack_head != b->ack_tail) {
+			ack = &b->acks[b->ack_tail % MQTT_BENCH_MAX_ACKS];
+			wait_ns = max((int64_t)(ack->due_ns - bench_now_ns()),
+				      (int64_t)0);
+		}
+		if (poll(&pfd, 1, wait_ns < 0 ? -1 :
+			 (wait_ns + 999999) / 1000000) < 0)
+			break;
+
+		if (pfd.revents & (POLLIN | POLLHUP)) {
+			n = read(pfd.fd, buff + len, sizeof(buff) - len);
+			if (n <= 0)
+				break;
+			len += n;
+			if (!mqtt_bench_broker_parse(b, pfd.fd, buff, &len))
+				break;
+		}
+
+		while (b->ack_head != b->ack_tail) {
+			ack = &b->acks[b->ack_tail % MQTT_BENCH_MAX_ACKS];
+			if (ack->due_ns > bench_now_ns())
+				break;
+			if (write(pfd.fd, ack->pkt, sizeof(ack->pkt)) < 0)
+				break;
+			b->ack_tail++;
+		}
+	}
+
+	close(pfd.fd);
+
+	return NULL;
+}
+
+/**
+ * @brief Start a broker on a free loopback port.
+ * @param b - Broker, delay_ms set by the caller.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t mqtt_bench_broker_start(struct mqtt_bench_broker *b)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+	};
+	socklen_t len = sizeof(addr);
+
+	b->publishes = 0;
+	b->ack_head = 0;
+	b->ack_tail = 0;
+
+	b->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (b->listen_fd < 0)
+		return -errno;
+
+	if (bind(b->listen_fd, (struct sockaddr *)&addr, len) ||
+	    listen(b->listen_fd, 1) ||
+	    getsockname(b->listen_fd, (struct sockaddr *)&addr, &len) ||
+	    pthread_create(&b->thread, NULL, mqtt_bench_broker_run, b)) {
+		close(b->listen_fd);
+		return -errno;
+	}
+	b->port = ntohs(addr.sin_port);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Wait for the broker to see the client leave.
+ * @param b - Broker.
+ */
+static void mqtt_bench_broker_stop(struct mqtt_bench_broker *b)
+{
+	pthread_join(b->thread, NULL);
+	close(b->listen_fd);
+}
+
+/* Messages received on subscribed topics, none are expected */
+static void mqtt_bench_handler(struct mqtt_message_data *msg)
+{
+	UNUSED_PARAM(msg);
+}
+
+/**
+ * @brief Publish IIO scan frames in one mode and print the rate.
+ * @param c - Publish mode.
+ * @param b - Broker, started.
+ * @param msgs - Number of messages.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t mqtt_bench_case_run(const struct mqtt_bench_case *c,
+				   struct mqtt_bench_broker *b, uint32_t msgs)
+{
+	static uint8_t send_buff[1024], read_buff[1024], queue_buff[8192];
+	static int16_t scans[MQTT_BENCH_SCANS][MQTT_BENCH_CHANNELS];
+	static uint8_t payload[MQTT_SCAN_FRAME_HDR_LEN + sizeof(scans)];
+	struct tcp_socket_init_param sock_param = {
+		.net = &linux_net,
+	};
+	struct socket_address addr = {
+		.addr = "127.0.0.1",
+		.port = b->port,
+	};
+	struct mqtt_connect_config conn = {
+		.version = MQTT_VERSION_3_1_1,
+		.keep_alive_ms = 7200,
+		.client_name = (int8_t *)"linux_bench",
+	};
+	struct mqtt_init_param param = {
+		.command_timeout_ms = MQTT_BENCH_TIMEOUT_MS,
+		.send_buff = send_buff,
+		.read_buff = read_buff,
+		.send_buff_size = sizeof(send_buff),
+		.read_buff_size = sizeof(read_buff),
+		.message_handler = mqtt_bench_handler,
+		.queue_buff = c->queued ? queue_buff : NULL,
+		.queue_buff_size = sizeof(queue_buff),
+		.max_inflight = c->max_inflight,
+	};
+	struct mqtt_scan_frame frame = {
+		.ch_mask = (1 << MQTT_BENCH_CHANNELS) - 1,
+		.nb_scans = MQTT_BENCH_SCANS,
+		.bytes_per_sample = sizeof(scans[0][0]),
+		.data = scans,
+	};
+	struct mqtt_message msg = {
+		.qos = c->qos,
+		.payload = payload,
+	};
+	struct mqtt_queue_stats stats = { 0 };
+	struct tcp_socket_desc *sock;
+	struct mqtt_desc *mqtt;
+	uint64_t start;
+	int32_t ret;
+	uint32_t i;
+
+	ret = socket_init(&sock, &sock_param);
+	if (ret)
+		return ret;
+	ret = socket_connect(sock, &addr);
+	if (ret)
+		goto err_sock;
+
+	param.sock = sock;
+	ret = mqtt_init(&mqtt, &param);
+	if (ret)
+		goto err_disconnect;
+	ret = mqtt_connect(mqtt, &conn, NULL);
+	if (ret)
+		goto err_mqtt;
+
+	start = bench_now_ns();
+	for (i = 0; i < msgs; i++) {
+		frame.seq = i;
+		msg.len = mqtt_pack_scan_frame(payload, sizeof(payload),
+					       &frame);
+		if (!c->queued) {
+			ret = mqtt_publish(mqtt, (int8_t *)MQTT_BENCH_TOPIC,
+					   &msg);
+		} else {
+			do {
+				ret = mqtt_publish_queued(mqtt,
+							  (int8_t *)MQTT_BENCH_TOPIC,
+							  &msg);
+				if (ret == -EAGAIN)
+					mqtt_yield(mqtt, 1);
+			} while (ret == -EAGAIN);
+		}
+		if (ret)
+			break;
+	}
+	if (!ret && c->queued)
+		ret = mqtt_flush(mqtt, MQTT_BENCH_TIMEOUT_MS);
+	start = bench_now_ns() - start;
+	if (c->queued)
+		mqtt_queue_stats(mqtt, &stats);
+	else
+		stats.writes = i;
+
+	mqtt_disconnect(mqtt);
+err_mqtt:
+	mqtt_remove(mqtt);
+err_disconnect:
+	socket_disconnect(sock);
+err_sock:
+	socket_remove(sock);
+	/* The broker may still wait for the client to connect */
+	if (ret)
+		shutdown(b->listen_fd, SHUT_RDWR);
+	mqtt_bench_broker_stop(b);
+	if (ret)
+		return ret;
+
+	printf("qos%d %-8s window %2"PRIu32": %5"PRIu32" msgs %9.1f ms %8.0f msg/s %5"PRIu32" writes\n",
+	       c->qos, c->queued ? "queued" : "blocking", c->max_inflight,
+	       msgs, start / 1e6, msgs * 1e9 / start, stats.writes);
+
+	BENCH_CHECK(b->publishes == msgs);
+	BENCH_CHECK(!c->queued || stats.queued == msgs);
+	BENCH_CHECK(!c->queued || !stats.inflight);
+	BENCH_CHECK(!c->queued || c->qos == MQTT_QOS0 || stats.acked == msgs);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Publish IIO scan frames with mqtt_publish() and with
+ * mqtt_publish_queued() to a loopback broker and print the message rates.
+ * -n msgs: messages published in each mode
+ * -d ms: delay of the broker acknowledges, a network round trip
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t mqtt_bench(int argc, char **argv)
+{
+	static struct mqtt_bench_broker broker;
+	uint32_t msgs = MQTT_BENCH_MSGS;
+	int32_t ret;
+	uint32_t i;
+	int opt;
+
+	broker.delay_ms = MQTT_BENCH_ACK_DELAY_MS;
+	while ((opt = getopt(argc, argv, "n:d:")) != -1) {
+		switch (opt) {
+		case 'n':
+			msgs = strtoul(optarg, NULL, 0);
+			break;
+		case 'd':
+			broker.delay_ms = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			return -EINVAL;
+		}
+	}
+
+	if (!msgs)
+		return -EINVAL;
+
+	printf("%u byte frames, acknowledges delayed %"PRIu32" ms\n",
+	       (unsigned int)(MQTT_SCAN_FRAME_HDR_LEN + MQTT_BENCH_SCANS *
+			      MQTT_BENCH_CHANNELS * sizeof(int16_t)),
+	       broker.delay_ms);
+
+	for (i = 0; i < ARRAY_SIZE(mqtt_bench_cases); i++) {
+		ret = mqtt_bench_broker_start(&broker);
+		if (ret)
+			return ret;
+		ret = mqtt_bench_case_run(&mqtt_bench_cases[i], &broker, msgs);
+		if (ret)
+			return ret;
+	}
+
+	return SUCCESS;
+}
@@ -0,0 +1,280 @@
+/***************************************************************************//**
+ *   @file   sd_bench.c
+ *   @brief  SD card driver and sector cache throughput on the card model.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include "bench.h"
+#include "sd.h"
+#include "sd_cache.h"
+#include "linux_sd_model.h"
+#include "no-os/error.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define SD_BENCH_PATH		"/tmp/linux_bench_sd.img"
+#define SD_BENCH_SIZE		(64ull << 20)
+#define SD_BENCH_HZ		20000000
+#define SD_BENCH_BUSY_BYTES	8
+#define SD_BENCH_OVERHEAD_NS	2000
+#define SD_BENCH_WRITES		2000
+/* One write in SD_BENCH_META_EVERY goes to one of SD_BENCH_META_SECTORS */
+#define SD_BENCH_META_EVERY	4
+#define SD_BENCH_META_SECTORS	4
+#define SD_BENCH_DATA_SECTOR	1024
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Sector written by a step of the workload, FatFs-like: data is
+ * appended and a few metadata sectors (FAT, directory) are read, updated and
+ * written back.
+ * @param i - Index of the write.
+ * @return The sector.
+ */
+static uint32_t sd_bench_sector(uint32_t i)
+{
+	if (i % SD_BENCH_META_EVERY == SD_BENCH_META_EVERY - 1)
+		return (i / SD_BENCH_META_EVERY) % SD_BENCH_META_SECTORS;
+
+	return SD_BENCH_DATA_SECTOR + i - i / SD_BENCH_META_EVERY;
+}
+
+/**
+ * @brief Fill a block with a pattern that depends on the write.
+ * @param block - The block.
+ * @param i - Index of the write.
+ */
+static void sd_bench_fill(uint8_t *block, uint32_t i)
+{
+	uint32_t j;
+
+	for (j = 0; j < DATA_BLOCK_LEN; j++)
+		block[j] = (uint8_t)(i * 31 + j);
+}
+
+/**
+ * @brief Read back every sector written by the workload.
+ * @param sd - The SD card.
+ * @param writes - Number of writes of the workload.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t sd_bench_verify(struct sd_desc *sd, uint32_t writes)
+{
+	uint8_t expected[DATA_BLOCK_LEN], block[DATA_BLOCK_LEN];
+	uint32_t i, j, sector;
+
+	for (i = 0; i < writes; i++) {
+		sector = sd_bench_sector(i);
+		/* Only the last write of a metadata sector is on the card. */
+		for (j = i + 1; j < writes; j++)
+			if (sd_bench_sector(j) == sector)
+				break;
+		if (j < writes)
+			continue;
+
+		sd_bench_fill(expected, i);
+		if (sd_read_blocks(sd, block, sector, 1) != SUCCESS ||
+		    memcmp(block, expected, DATA_BLOCK_LEN)) {
+			printf("sd: sector %"PRIu32" read back failed\n", sector);
+			return FAILURE;
+		}
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Run the workload on a fresh card, directly or through the cache.
+ * @param spi_param - SPI parameters of the card model.
+ * @param writes - Number of single sector writes.
+ * @param cached - Go through sd_cache, flushed at the end.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sd_bench_run(const struct spi_init_param *spi_param,
+			    uint32_t writes, bool cached)
+{
+	struct sd_cache_init_param cache_param = { 0 };
+	struct linux_sd_model_stats start, end;
+	struct sd_init_param sd_param = { 0 };
+	struct sd_cache_desc *cache = NULL;
+	uint8_t block[DATA_BLOCK_LEN];
+	struct spi_desc *spi;
+	struct sd_desc *sd;
+	uint64_t start_ns, ns;
+	uint32_t i, sector;
+	int32_t ret;
+
+	ret = spi_init(&spi, spi_param);
+	if (ret != SUCCESS)
+		return ret;
+
+	sd_param.spi_desc = spi;
+	ret = sd_init(&sd, &sd_param);
+	if (ret != SUCCESS)
+		goto remove_spi;
+
+	if (cached) {
+		cache_param.sd = sd;
+		ret = sd_cache_init(&cache, &cache_param);
+		if (ret != SUCCESS)
+			goto remove_sd;
+	}
+
+	linux_sd_model_get_stats(spi, &start);
+	start_ns = bench_now_ns();
+	for (i = 0; i < writes; i++) {
+		sector = sd_bench_sector(i);
+		if (sector < SD_BENCH_DATA_SECTOR) {
+			if (cached)
+				ret = sd_cache_read(cache, block, sector, 1);
+			else
+				ret = sd_read_blocks(sd, block, sector, 1);
+			if (ret != SUCCESS)
+				goto remove_cache;
+		}
+
+		sd_bench_fill(block, i);
+		if (cached)
+			ret = sd_cache_write(cache, block, sector, 1);
+		else
+			ret = sd_write_blocks(sd, block, sector, 1);
+		if (ret != SUCCESS)
+			goto remove_cache;
+	}
+	if (cached) {
+		ret = sd_cache_flush(cache);
+		if (ret != SUCCESS)
+			goto remove_cache;
+	}
+	ns = bench_now_ns() - start_ns;
+	linux_sd_model_get_stats(spi, &end);
+
+	printf("%-12s %8"PRIu32" transfers %6"PRIu32" cmds %6"PRIu32
+	       " read %6"PRIu32" written %8.1f ms bus %8.1f ms cpu\n",
+	       cached ? "sd_cache" : "sd_write", end.transfers - start.transfers,
+	       end.cmds - start.cmds, end.blocks_read - start.blocks_read,
+	       end.blocks_written - start.blocks_written,
+	       (end.bus_time_ns - start.bus_time_ns) / 1e6, ns / 1e6);
+	if (cached)
+		printf("%-12s %8"PRIu32" hits %9"PRIu32" misses %4"PRIu32
+		       " write cmds\n", "", cache->stats.hits, cache->stats.misses,
+		       cache->stats.write_cmds);
+
+	ret = sd_bench_verify(sd, writes);
+
+remove_cache:
+	if (cache)
+		sd_cache_remove(cache);
+remove_sd:
+	sd_remove(sd);
+remove_spi:
+	spi_remove(spi);
+
+	return ret;
+}
+
+/**
+ * @brief SD card throughput benchmark on the file backed card model.
+ * -f path: backing file of the card
+ * -n writes: number of single sector writes
+ * -s hz: SPI clock used for the bus time estimate
+ * -b bytes: busy bytes after every written block
+ * -o ns: fixed cost of one SPI transaction
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sd_bench(int argc, char **argv)
+{
+	struct linux_sd_model_init_param model_param = {
+		.path = SD_BENCH_PATH,
+		.size = SD_BENCH_SIZE,
+		.busy_bytes = SD_BENCH_BUSY_BYTES,
+		.xfer_overhead_ns = SD_BENCH_OVERHEAD_NS,
+	};
+	struct spi_init_param spi_param = {
+		.max_speed_hz = SD_BENCH_HZ,
+		.platform_ops = &linux_sd_model_ops,
+		.extra = &model_param,
+	};
+	uint32_t writes = SD_BENCH_WRITES;
+	int32_t ret;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "f:n:s:b:o:")) != -1) {
+		switch (opt) {
+		case 'f':
+			model_param.path = optarg;
+			break;
+		case 'n':
+			writes = strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			spi_param.max_speed_hz = strtoul(optarg, NULL, 0);
+			break;
+		case 'b':
+			model_param.busy_bytes = strtoul(optarg, NULL, 0);
+			break;
+		case 'o':
+			model_param.xfer_overhead_ns = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			return -EINVAL;
+		}
+	}
+
+	if (!writes)
+		return -EINVAL;
+
+	ret = sd_bench_run(&spi_param, writes, false);
+	if (ret != SUCCESS)
+		return ret;
+
+	return sd_bench_run(&spi_param, writes, true);
+}
@@ -0,0 +1,472 @@
+/***************************************************************************//**
+ *   @file   sdlog_bench.c
+ *   @brief  IIO SD card logger on FatFs and the SD card model.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include "bench.h"
+#include "ff.h"
+#include "diskio.h"
+#include "sd.h"
+#include "sd_cache.h"
+#include "linux_sd_model.h"
+#include "iio_sd_logger.h"
+#include "no-os/circular_buffer.h"
+#include "no-os/error.h"
+#include "no-os/util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define SDLOG_BENCH_PATH	"/tmp/linux_bench_sdlog.img"
+#define SDLOG_BENCH_CARD_SIZE	(64ull << 20)
+/* Too small for one file of SDLOG_BENCH_FILE_SIZE */
+#define SDLOG_BENCH_SMALL_CARD	(1ull << 20)
+#define SDLOG_BENCH_FILE_SIZE	(1u << 20)
+#define SDLOG_BENCH_BYTES	(8u << 20)
+#define SDLOG_BENCH_HZ		20000000
+#define SDLOG_BENCH_CHANNELS	4
+/* Device buffer and producer chunk */
+#define SDLOG_BENCH_CB_SIZE	(32u << 10)
+#define SDLOG_BENCH_CHUNK	(4u << 10)
+#define SDLOG_BENCH_PREFIX	"LOG"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct sdlog_bench
+ * @brief Card, volume and logged device of a run.
+ */
+struct sdlog_bench {
+	struct spi_desc		*spi;
+	struct sd_desc		*sd;
+	struct sd_cache_desc	*cache;
+	FATFS			fs;
+	struct iio_device	dev;
+	struct iio_buffer	buffer;
+	struct iio_sd_logger	*logger;
+	/** Bytes given to the device buffer so far */
+	uint32_t		produced;
+};
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+
+/* Card and cache used by the FatFs glue (adi_diskio.c) */
+struct sd_desc *sd_desc;
+extern struct sd_cache_desc *sd_cache;
+
+static struct scan_type sdlog_bench_scan_type = {
+	.sign = 's',
+	.realbits = 16,
+	.storagebits = 16,
+	.shift = 0,
+	.is_big_endian = false,
+};
+
+static struct iio_channel sdlog_bench_channels[SDLOG_BENCH_CHANNELS] = {
+	{ .ch_type = IIO_VOLTAGE, .channel = 0, .scan_type = &sdlog_bench_scan_type },
+	{ .ch_type = IIO_VOLTAGE, .channel = 1, .scan_type = &sdlog_bench_scan_type },
+	{ .ch_type = IIO_VOLTAGE, .channel = 2, .scan_type = &sdlog_bench_scan_type },
+	{ .ch_type = IIO_VOLTAGE, .channel = 3, .scan_type = &sdlog_bench_scan_type },
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief FatFs timestamp, fixed so the images are reproducible.
+ * @return 2021-01-01 00:00:00 in FatFs format.
+ */
+DWORD get_fattime(void)
+{
+	return ((DWORD)(2021 - 1980) << 25) | (1 << 21) | (1 << 16);
+}
+
+/**
+ * @brief Byte of the logged stream at a given offset.
+ * @param offset - Offset in the stream.
+ * @return The byte.
+ */
+static inline uint8_t sdlog_bench_byte(uint32_t offset)
+{
+	return (uint8_t)(offset * 7 + (offset >> 9));
+}
+
+/**
+ * @brief Create a formatted card and a logger for a 4 channel device.
+ * @param bench - The run.
+ * @param spi_param - SPI parameters of the card model.
+ * @param cached - Access the card through sd_cache.
+ * @param file_size - Size of a log file.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sdlog_bench_setup(struct sdlog_bench *bench,
+				 const struct spi_init_param *spi_param,
+				 bool cached, uint32_t file_size)
+{
+	struct sd_cache_init_param cache_param = { 0 };
+	struct sd_init_param sd_param = { 0 };
+	struct iio_sd_logger_init_param logger_param = {
+		.name = "sdlog_bench",
+		.dev = &bench->dev,
+		.buffer = &bench->buffer,
+		.prefix = SDLOG_BENCH_PREFIX,
+		.file_size = file_size,
+	};
+	MKFS_PARM mkfs_param = { .fmt = FM_ANY | FM_SFD };
+	uint8_t work[FF_MAX_SS];
+	int32_t ret;
+
+	memset(bench, 0, sizeof(*bench));
+
+	ret = spi_init(&bench->spi, spi_param);
+	if (ret != SUCCESS)
+		return ret;
+
+	sd_param.spi_desc = bench->spi;
+	ret = sd_init(&bench->sd, &sd_param);
+	if (ret != SUCCESS)
+		return ret;
+	sd_desc = bench->sd;
+
+	if (cached) {
+		cache_param.sd = bench->sd;
+		ret = sd_cache_init(&bench->cache, &cache_param);
+		if (ret != SUCCESS)
+			return ret;
+		sd_cache = bench->cache;
+	}
+
+	if (f_mkfs("", &mkfs_param, work, sizeof(work)) != FR_OK ||
+	    f_mount(&bench->fs, "", 1) != FR_OK)
+		return -EIO;
+
+	bench->dev.num_ch = SDLOG_BENCH_CHANNELS;
+	bench->dev.channels = sdlog_bench_channels;
+	bench->buffer.active_mask = GENMASK(SDLOG_BENCH_CHANNELS - 1, 0);
+	bench->buffer.bytes_per_scan = SDLOG_BENCH_CHANNELS *
+				       sdlog_bench_scan_type.storagebits / 8;
+	bench->buffer.dir = IIO_DIRECTION_INPUT;
+	bench->buffer.size = SDLOG_BENCH_CB_SIZE;
+	ret = cb_init(&bench->buffer.buf, SDLOG_BENCH_CB_SIZE);
+	if (ret != SUCCESS)
+		return ret;
+
+	return iio_sd_logger_init(&bench->logger, &logger_param);
+}
+
+/**
+ * @brief Free everything sdlog_bench_setup() created.
+ * @param bench - The run.
+ */
+static void sdlog_bench_cleanup(struct sdlog_bench *bench)
+{
+	if (bench->logger)
+		iio_sd_logger_remove(bench->logger);
+	if (bench->buffer.buf)
+		cb_remove(bench->buffer.buf);
+	f_mount(NULL, "", 0);
+	if (bench->cache)
+		sd_cache_remove(bench->cache);
+	sd_cache = NULL;
+	if (bench->sd)
+		sd_remove(bench->sd);
+	sd_desc = NULL;
+	if (bench->spi)
+		spi_remove(bench->spi);
+}
+
+/**
+ * @brief Feed the device buffer like a device would, processing the logger
+ * after every chunk.
+ * @param bench - The run.
+ * @param bytes - Number of bytes to produce.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sdlog_bench_produce(struct sdlog_bench *bench, uint32_t bytes)
+{
+	uint8_t chunk[SDLOG_BENCH_CHUNK];
+	uint32_t i, n;
+	int32_t ret;
+
+	while (bytes) {
+		n = min(bytes, (uint32_t)SDLOG_BENCH_CHUNK);
+		for (i = 0; i < n; i++)
+			chunk[i] = sdlog_bench_byte(bench->produced + i);
+
+		ret = cb_write(bench->buffer.buf, chunk, n);
+		if (ret != SUCCESS)
+			return ret;
+		bench->produced += n;
+		bytes -= n;
+
+		ret = iio_sd_logger_process(bench->logger);
+		if (ret != SUCCESS)
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Check the files of the volume against the produced stream.
+ * @param bench - The run.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t sdlog_bench_verify(struct sdlog_bench *bench)
+{
+	struct iio_sd_logger_header hdr;
+	uint8_t data[FF_MAX_SS];
+	uint32_t offset = 0;
+	uint32_t i, j, n;
+	char path[16];
+	FILINFO info;
+	UINT br;
+	FIL fil;
+
+	for (i = 0; i < bench->logger->files; i++) {
+		snprintf(path, sizeof(path), SDLOG_BENCH_PREFIX "%03"PRIu32".BIN", i);
+		BENCH_CHECK(f_open(&fil, path, FA_READ) == FR_OK);
+		BENCH_CHECK(f_read(&fil, &hdr, sizeof(hdr), &br) == FR_OK &&
+			    br == sizeof(hdr));
+		BENCH_CHECK(!memcmp(hdr.magic, IIO_SD_LOGGER_MAGIC, 4));
+		BENCH_CHECK(hdr.file_index == i);
+		BENCH_CHECK(hdr.nb_channels == SDLOG_BENCH_CHANNELS);
+		BENCH_CHECK(f_size(&fil) == IIO_SD_LOGGER_HEADER_SIZE +
+			    hdr.data_len);
+		BENCH_CHECK(f_lseek(&fil, IIO_SD_LOGGER_HEADER_SIZE) == FR_OK);
+
+		for (n = 0; n < hdr.data_len; n += br) {
+			BENCH_CHECK(f_read(&fil, data, sizeof(data), &br) ==
+				    FR_OK && br);
+			for (j = 0; j < br; j++)
+				BENCH_CHECK(data[j] ==
+					    sdlog_bench_byte(offset + n + j));
+		}
+		offset += hdr.data_len;
+		f_close(&fil);
+	}
+
+	BENCH_CHECK(offset == bench->produced);
+	/* No file past the last one, not even an empty one */
+	snprintf(path, sizeof(path), SDLOG_BENCH_PREFIX "%03"PRIu32".BIN", i);
+	BENCH_CHECK(f_stat(path, &info) == FR_NO_FILE);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Log exactly one file, then call the logger again with nothing to
+ * write: the next file must not be created until there is data for it.
+ * @param spi_param - SPI parameters of the card model.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t sdlog_bench_check_rollover(const struct spi_init_param
+		*spi_param)
+{
+	struct sdlog_bench bench;
+	int32_t ret;
+
+	ret = sdlog_bench_setup(&bench, spi_param, false, SDLOG_BENCH_FILE_SIZE);
+	if (!ret)
+		ret = sdlog_bench_produce(&bench, SDLOG_BENCH_FILE_SIZE -
+					  IIO_SD_LOGGER_HEADER_SIZE);
+	if (!ret)
+		ret = iio_sd_logger_process(bench.logger);
+	if (!ret && (bench.logger->files != 1 || bench.logger->file_open))
+		ret = FAILURE;
+	if (!ret)
+		ret = sdlog_bench_verify(&bench);
+	/* Stopping without pending data must not create a file either */
+	if (!ret)
+		ret = iio_sd_logger_stop(bench.logger);
+	if (!ret)
+		ret = sdlog_bench_verify(&bench);
+	sdlog_bench_cleanup(&bench);
+
+	BENCH_CHECK(ret == SUCCESS);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief A file that does not fit on the volume is rejected with -ENOSPC
+ * and removed.
+ * @param spi_param - SPI parameters of the card model.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t sdlog_bench_check_full(const struct spi_init_param *spi_param)
+{
+	struct linux_sd_model_init_param small = *(struct
+			linux_sd_model_init_param *)spi_param->extra;
+	struct spi_init_param param = *spi_param;
+	struct sdlog_bench bench;
+	FILINFO info;
+	int32_t ret;
+
+	small.size = SDLOG_BENCH_SMALL_CARD;
+	param.extra = &small;
+
+	ret = sdlog_bench_setup(&bench, &param, false, SDLOG_BENCH_FILE_SIZE);
+	if (!ret)
+		ret = sdlog_bench_produce(&bench, SDLOG_BENCH_CHUNK);
+	if (ret == -ENOSPC && f_stat(SDLOG_BENCH_PREFIX "000.BIN",
+				     &info) == FR_NO_FILE)
+		ret = SUCCESS;
+	else if (!ret)
+		ret = FAILURE;
+	sdlog_bench_cleanup(&bench);
+
+	BENCH_CHECK(ret == SUCCESS);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Log a stream, then print the throughput and the card traffic.
+ * @param spi_param - SPI parameters of the card model.
+ * @param bytes - Number of bytes to log.
+ * @param cached - Access the card through sd_cache.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sdlog_bench_run(const struct spi_init_param *spi_param,
+			       uint32_t bytes, bool cached)
+{
+	struct linux_sd_model_stats start, end;
+	struct sdlog_bench bench;
+	uint64_t start_ns, ns;
+	double bus_s;
+	int32_t ret;
+
+	ret = sdlog_bench_setup(&bench, spi_param, cached, SDLOG_BENCH_FILE_SIZE);
+	if (ret)
+		goto out;
+
+	linux_sd_model_get_stats(bench.spi, &start);
+	start_ns = bench_now_ns();
+	ret = sdlog_bench_produce(&bench, bytes);
+	if (!ret)
+		ret = iio_sd_logger_stop(bench.logger);
+	if (!ret && bench.cache)
+		ret = sd_cache_flush(bench.cache);
+	ns = bench_now_ns() - start_ns;
+	linux_sd_model_get_stats(bench.spi, &end);
+	if (ret)
+		goto out;
+
+	bus_s = (end.bus_time_ns - start.bus_time_ns) / 1e9;
+	printf("%-16s %3"PRIu32" files %8"PRIu32" transfers %6"PRIu32
+	       " cmds %7.2f MB/s bus %8.1f ms cpu\n",
+	       cached ? "logger, sd_cache" : "logger",
+	       bench.logger->files, end.transfers - start.transfers,
+	       end.cmds - start.cmds, bytes / bus_s / 1e6, ns / 1e6);
+
+	ret = sdlog_bench_verify(&bench);
+out:
+	sdlog_bench_cleanup(&bench);
+
+	return ret;
+}
+
+/**
+ * @brief IIO SD card logger checks and throughput, on a FatFs volume of the
+ * file backed SD card model.
+ * -f path: backing file of the card
+ * -n bytes: number of bytes logged
+ * -s hz: SPI clock used for the bus time estimate
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sdlog_bench(int argc, char **argv)
+{
+	struct linux_sd_model_init_param model_param = {
+		.path = SDLOG_BENCH_PATH,
+		.size = SDLOG_BENCH_CARD_SIZE,
+	};
+	struct spi_init_param spi_param = {
+		.max_speed_hz = SDLOG_BENCH_HZ,
+		.platform_ops = &linux_sd_model_ops,
+		.extra = &model_param,
+	};
+	uint32_t bytes = SDLOG_BENCH_BYTES;
+	int32_t ret;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "f:n:s:")) != -1) {
+		switch (opt) {
+		case 'f':
+			model_param.path = optarg;
+			break;
+		case 'n':
+			bytes = strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			spi_param.max_speed_hz = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			return -EINVAL;
+		}
+	}
+
+	if (!bytes)
+		return -EINVAL;
+
+	if (sdlog_bench_check_rollover(&spi_param) ||
+	    sdlog_bench_check_full(&spi_param))
+		return FAILURE;
+	printf("sdlog: checks passed\n");
+
+	ret = sdlog_bench_run(&spi_param, bytes, false);
+	if (ret != SUCCESS)
+		return ret;
+
+	return sdlog_bench_run(&spi_param, bytes, true);
+}
@@ -0,0 +1,260 @@
+/***************************************************************************//**
+ *   @file   tls_bench.c
+ *   @brief  TLS handshake time and heap of the secure TCP socket.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <malloc.h>
+#include <unistd.h>
+#include <sys/random.h>
+#include "bench.h"
+#include "tcp_socket.h"
+#include "linux_socket.h"
+#include "no-os/trng.h"
+#include "no-os/error.h"
+#include "no-os/util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define TLS_BENCH_ADDR		"127.0.0.1"
+#define TLS_BENCH_PORT		4433
+#define TLS_BENCH_CONNECTIONS	20
+#define TLS_BENCH_CA_MAX	4096
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct trng_desc
+ * @brief TRNG descriptor. The Linux platform has no TRNG driver, the kernel
+ * pool is used instead.
+ */
+struct trng_desc {
+	uint32_t dev_id;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+int32_t trng_init(struct trng_desc **desc, struct trng_init_param *param)
+{
+	*desc = calloc(1, sizeof(**desc));
+	if (!*desc)
+		return -ENOMEM;
+	(*desc)->dev_id = param->dev_id;
+
+	return SUCCESS;
+}
+
+void trng_remove(struct trng_desc *desc)
+{
+	free(desc);
+}
+
+int32_t trng_fill_buffer(struct trng_desc *desc, uint8_t *buff, uint32_t len)
+{
+	ssize_t n;
+
+	while (len) {
+		n = getrandom(buff, len, 0);
+		if (n < 0)
+			return -EIO;
+		buff += n;
+		len -= n;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Heap in use.
+ * @return Bytes allocated with malloc() and not freed.
+ */
+static size_t tls_bench_heap(void)
+{
+	return mallinfo2().uordblks;
+}
+
+/**
+ * @brief Load a DER certificate.
+ * @param path - Certificate file.
+ * @param buf - Where to store the certificate, TLS_BENCH_CA_MAX bytes.
+ * @param len - Length of the certificate.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t tls_bench_load(const char *path, uint8_t *buf, uint32_t *len)
+{
+	FILE *f;
+
+	f = fopen(path, "rb");
+	if (!f) {
+		printf("tls: can't open %s\n", path);
+		return -ENOENT;
+	}
+
+	*len = fread(buf, 1, TLS_BENCH_CA_MAX, f);
+	fclose(f);
+
+	return *len ? SUCCESS : -EINVAL;
+}
+
+/**
+ * @brief Connect repeatedly to a TLS server and print the handshake time of
+ * the full and resumed handshakes and the heap used by a connection.
+ * -a addr: server address
+ * -p port: server port
+ * -c file: CA certificate (DER) to verify the server, none by default
+ * -n connections: number of connections
+ * -f bytes: maximum fragment length to negotiate
+ * -r: disable session resumption
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t tls_bench(int argc, char **argv)
+{
+	static uint8_t ca[TLS_BENCH_CA_MAX];
+	struct trng_init_param trng_param = { 0 };
+	struct secure_init_param secure_param = {
+		.trng_init_param = &trng_param,
+	};
+	struct tcp_socket_init_param param = {
+		.net = &linux_net,
+		.secure_init_param = &secure_param,
+	};
+	struct socket_address addr = {
+		.addr = TLS_BENCH_ADDR,
+		.port = TLS_BENCH_PORT,
+	};
+	struct secure_socket_stats stats, prev = { 0 };
+	uint64_t full_ns = 0, resumed_ns = 0, start;
+	uint32_t connections = TLS_BENCH_CONNECTIONS;
+	size_t heap_base, heap_init, heap_conn = 0;
+	struct tcp_socket_desc *sock;
+	int32_t ret;
+	uint32_t i;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "a:p:c:n:f:r")) != -1) {
+		switch (opt) {
+		case 'a':
+			addr.addr = optarg;
+			break;
+		case 'p':
+			addr.port = strtoul(optarg, NULL, 0);
+			break;
+		case 'c':
+			ret = tls_bench_load(optarg, ca, &secure_param.ca_cert_len);
+			if (ret)
+				return ret;
+			secure_param.ca_cert = ca;
+			break;
+		case 'n':
+			connections = strtoul(optarg, NULL, 0);
+			break;
+		case 'f':
+			secure_param.max_frag_len = strtoul(optarg, NULL, 0);
+			break;
+		case 'r':
+			secure_param.disable_resumption = true;
+			break;
+		default:
+			return -EINVAL;
+		}
+	}
+
+	if (!connections)
+		return -EINVAL;
+
+	heap_base = tls_bench_heap();
+	ret = socket_init(&sock, &param);
+	if (ret) {
+		printf("tls: socket_init failed (%"PRId32")\n", ret);
+		return ret;
+	}
+	heap_init = tls_bench_heap();
+
+	for (i = 0; i < connections; i++) {
+		start = bench_now_ns();
+		ret = socket_connect(sock, &addr);
+		if (ret) {
+			printf("tls: connection %"PRIu32" to %s:%u failed (%"PRId32")\n",
+			       i, addr.addr, addr.port, ret);
+			goto out;
+		}
+		start = bench_now_ns() - start;
+		heap_conn = max(heap_conn, tls_bench_heap());
+
+		socket_secure_stats(sock, &stats);
+		if (stats.resumed != prev.resumed)
+			resumed_ns += start;
+		else
+			full_ns += start;
+		prev = stats;
+
+		socket_disconnect(sock);
+	}
+
+	printf("%-20s %4"PRIu32" handshakes %10.2f ms each\n", "full",
+	       stats.handshakes - stats.resumed,
+	       stats.handshakes - stats.resumed ?
+	       full_ns / 1e6 / (stats.handshakes - stats.resumed) : 0.0);
+	printf("%-20s %4"PRIu32" handshakes %10.2f ms each\n", "resumed",
+	       stats.resumed,
+	       stats.resumed ? resumed_ns / 1e6 / stats.resumed : 0.0);
+	if (secure_param.max_frag_len)
+		printf("%-20s %4"PRIu32" handshakes accepted %"PRIu16" bytes\n",
+		       "max fragment length", stats.frag_len_accepted,
+		       secure_param.max_frag_len);
+	printf("%-20s %zu bytes after socket_init, %zu bytes connected\n",
+	       "heap", heap_init - heap_base, heap_conn - heap_base);
+
+out:
+	socket_remove(sock);
+
+	return ret;
+}
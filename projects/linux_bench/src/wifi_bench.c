@@ -0,0 +1,681 @@
+/***************************************************************************//**
+ *   @file   wifi_bench.c
+ *   @brief  ESP8266 socket throughput against a simulated module on a pty.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+/* posix_openpt(), ptsname() and memmem() */
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <termios.h>
+#include "bench.h"
+#include "wifi.h"
+#include "linux_uart.h"
+#include "no-os/uart.h"
+#include "no-os/error.h"
+#include "no-os/util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define WIFI_BENCH_BYTES	16384
+#define WIFI_BENCH_CHUNK	64
+#define WIFI_BENCH_LATENCY_MS	3
+#define WIFI_BENCH_IOV		32
+#define WIFI_BENCH_RING		8192
+#define WIFI_BENCH_TIMEOUT_MS	5000
+#define WIFI_BENCH_SIM_BUFF	8192
+#define WIFI_BENCH_BAUD		921600
+/* Bytes the simulator writes at a time, at the pace of the UART */
+#define WIFI_BENCH_SIM_BURST	64
+/* Idle time after which the simulator takes a lone "+++" as the escape */
+#define WIFI_BENCH_GUARD_MS	10
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @enum wifi_bench_sim_state
+ * @brief What the simulated module expects next from the host.
+ */
+enum wifi_bench_sim_state {
+	/** AT commands, ended by "\r\n" */
+	WIFI_BENCH_SIM_CMD,
+	/** The data announced by AT+CIPSEND=<len> */
+	WIFI_BENCH_SIM_DATA,
+	/** Passthrough data, until a lone "+++" */
+	WIFI_BENCH_SIM_PASSTHROUGH
+};
+
+/**
+ * @struct wifi_bench_sim
+ * @brief ESP8266 simulated on the master side of a pty. It answers the AT
+ * commands used by the wifi driver and echoes back the data sent on the
+ * connection, as a module connected to an echo server would. Each command
+ * that starts a transfer waits latency_ms, the radio round trip. The answers
+ * are written at the pace of a WIFI_BENCH_BAUD UART, a pty has no baud rate
+ * and would fill the receive ring faster than any DMA.
+ */
+struct wifi_bench_sim {
+	/** pty master, the module side of the UART */
+	int fd;
+	/** pty slave, kept open so the master doesn't see a hang up */
+	int slave_fd;
+	/** Name of the slave, without "/dev/" */
+	char dev[32];
+	/** Delay of the AT+CIPSEND answers */
+	uint32_t latency_ms;
+	/** Monotonic time (ns) when the UART is done sending the last write */
+	uint64_t tx_done_ns;
+	/** Set to stop the thread */
+	volatile bool stop;
+	enum wifi_bench_sim_state state;
+	/** AT+CIPMUX value */
+	bool mux;
+	/** AT+CIPMODE value */
+	bool cipmode;
+	bool wifi_connected;
+	/** Connection and length of the announced data */
+	uint32_t link_id;
+	uint32_t need;
+	/** AT+CIPSEND commands received */
+	uint32_t cipsend;
+	/** Data bytes received on the connection */
+	uint32_t bytes;
+	/** Received and not yet parsed */
+	uint8_t buff[WIFI_BENCH_SIM_BUFF];
+	uint32_t len;
+	pthread_t thread;
+};
+
+/**
+ * @enum wifi_bench_mode
+ * @brief How the data is handed to the driver.
+ */
+enum wifi_bench_mode {
+	/** socket_send() of every chunk, one AT+CIPSEND each */
+	WIFI_BENCH_SEND,
+	/** socket_send() of every chunk with SOCKET_OPT_CORK set */
+	WIFI_BENCH_CORK,
+	/** socket_sendv() of WIFI_BENCH_IOV chunks at a time */
+	WIFI_BENCH_SENDV,
+	/** socket_send() of every chunk in passthrough mode */
+	WIFI_BENCH_PASSTHROUGH
+};
+
+/**
+ * @struct wifi_bench_case
+ * @brief Send mode measured.
+ */
+struct wifi_bench_case {
+	const char *name;
+	enum wifi_bench_mode mode;
+};
+
+/******************************************************************************/
+/**************************** Global Variables ********************************/
+/******************************************************************************/
+
+static const struct wifi_bench_case wifi_bench_cases[] = {
+	{ "send", WIFI_BENCH_SEND },
+	{ "cork", WIFI_BENCH_CORK },
+	{ "sendv", WIFI_BENCH_SENDV },
+	{ "passthrough", WIFI_BENCH_PASSTHROUGH },
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/*
+ * The Linux UART has no interrupt mode, the parser reads the ring filled by
+ * linux_uart_rx_ring_start() instead.
+ */
+int32_t uart_read_nonblocking(struct uart_desc *desc, uint8_t *data,
+			      uint32_t bytes_number)
+{
+	UNUSED_PARAM(desc);
+	UNUSED_PARAM(data);
+	UNUSED_PARAM(bytes_number);
+
+	return -ENOSYS;
+}
+
+/**
+ * @brief Write to the host, at the pace of the UART.
+ * @param s - Simulator.
+ * @param data - Data.
+ * @param len - Length of the data.
+ */
+static void wifi_bench_sim_out(struct wifi_bench_sim *s, const void *data,
+			       uint32_t len)
+{
+	const uint8_t *p = data;
+	uint64_t now;
+	ssize_t n;
+
+	while (len) {
+		now = bench_now_ns();
+		if (s->tx_done_ns > now)
+			usleep((s->tx_done_ns - now) / 1000);
+		else
+			s->tx_done_ns = now;
+
+		n = write(s->fd, p, min(len, (uint32_t)WIFI_BENCH_SIM_BURST));
+		if (n <= 0)
+			return;
+		/* 10 bits per byte on the line */
+		s->tx_done_ns += n * 10000000000ull / WIFI_BENCH_BAUD;
+		p += n;
+		len -= n;
+	}
+}
+
+/**
+ * @brief Write a string to the host.
+ * @param s - Simulator.
+ * @param str - Null terminated string.
+ */
+static void wifi_bench_sim_puts(struct wifi_bench_sim *s, const char *str)
+{
+	wifi_bench_sim_out(s, str, strlen(str));
+}
+
+/**
+ * @brief Answer an AT command.
+ * @param s - Simulator.
+ * @param cmd - Command, without the "\r\n".
+ */
+static void wifi_bench_sim_cmd(struct wifi_bench_sim *s, const char *cmd)
+{
+	char resp[64];
+	char *end;
+
+	if (!strcmp(cmd, "AT") || !strcmp(cmd, "ATE0") ||
+	    !strncmp(cmd, "AT+CWMODE=", 10) || !strncmp(cmd, "AT+CIPSTO", 9)) {
+		wifi_bench_sim_puts(s, "\r\nOK\r\n");
+	} else if (!strcmp(cmd, "AT+RST")) {
+		wifi_bench_sim_puts(s, "\r\nOK\r\n");
+		usleep(10000);
+		wifi_bench_sim_puts(s, "\r\nready\r\n");
+		s->wifi_connected = false;
+	} else if (!strcmp(cmd, "AT+CWQAP")) {
+		wifi_bench_sim_puts(s, "\r\nOK\r\n");
+		if (s->wifi_connected)
+			wifi_bench_sim_puts(s, "WIFI DISCONNECT\r\n");
+		s->wifi_connected = false;
+	} else if (!strncmp(cmd, "AT+CWJAP=", 9)) {
+		s->wifi_connected = true;
+		wifi_bench_sim_puts(s, "WIFI CONNECTED\r\nWIFI GOT IP\r\n\r\nOK\r\n");
+	} else if (!strcmp(cmd, "AT+CIPMUX?")) {
+		sprintf(resp, "+CIPMUX:%d\r\n\r\nOK\r\n", s->mux);
+		wifi_bench_sim_puts(s, resp);
+	} else if (!strncmp(cmd, "AT+CIPMUX=", 10)) {
+		s->mux = atoi(cmd + 10);
+		wifi_bench_sim_puts(s, "\r\nOK\r\n");
+	} else if (!strncmp(cmd, "AT+CIPMODE=", 11)) {
+		s->cipmode = atoi(cmd + 11);
+		wifi_bench_sim_puts(s, "\r\nOK\r\n");
+	} else if (!strncmp(cmd, "AT+CIPSTART=", 12)) {
+		if (s->mux)
+			sprintf(resp, "%d,CONNECT\r\n\r\nOK\r\n", atoi(cmd + 12));
+		else
+			strcpy(resp, "CONNECT\r\n\r\nOK\r\n");
+		wifi_bench_sim_puts(s, resp);
+	} else if (!strcmp(cmd, "AT+CIPSEND") && s->cipmode) {
+		usleep(s->latency_ms * 1000);
+		wifi_bench_sim_puts(s, "\r\nOK\r\n\r\n>");
+		s->state = WIFI_BENCH_SIM_PASSTHROUGH;
+	} else if (!strncmp(cmd, "AT+CIPSEND=", 11)) {
+		s->link_id = 0;
+		s->need = strtoul(cmd + 11, &end, 10);
+		if (s->mux && *end == ',') {
+			s->link_id = s->need;
+			s->need = strtoul(end + 1, NULL, 10);
+		}
+		s->cipsend++;
+		usleep(s->latency_ms * 1000);
+		wifi_bench_sim_puts(s, "\r\nOK\r\n> ");
+		s->state = WIFI_BENCH_SIM_DATA;
+	} else if (!strncmp(cmd, "AT+CIPCLOSE", 11)) {
+		if (s->mux && cmd[11] == '=')
+			sprintf(resp, "%d,CLOSED\r\n\r\nOK\r\n", atoi(cmd + 12));
+		else
+			strcpy(resp, "CLOSED\r\n\r\nOK\r\n");
+		wifi_bench_sim_puts(s, resp);
+	} else {
+		wifi_bench_sim_puts(s, "\r\nERROR\r\n");
+	}
+}
+
+/**
+ * @brief Check if the received data is the start of the passthrough escape.
+ * @param s - Simulator.
+ * @return true if the data may still become a lone "+++".
+ */
+static bool wifi_bench_sim_escape(struct wifi_bench_sim *s)
+{
+	return s->len && s->len <= 3 && !memcmp(s->buff, "+++", s->len);
+}
+
+/**
+ * @brief Handle the received data.
+ * @param s - Simulator.
+ */
+static void wifi_bench_sim_parse(struct wifi_bench_sim *s)
+{
+	char resp[64];
+	uint8_t *eol;
+	uint32_t n;
+
+	while (s->len) {
+		switch (s->state) {
+		case WIFI_BENCH_SIM_CMD:
+			eol = memmem(s->buff, s->len, "\r\n", 2);
+			if (!eol) {
+				/* A line that long isn't a command */
+				if (s->len == sizeof(s->buff))
+					s->len = 0;
+				return;
+			}
+			*eol = '\0';
+			n = eol - s->buff + 2;
+			wifi_bench_sim_cmd(s, (char *)s->buff);
+			break;
+		case WIFI_BENCH_SIM_DATA:
+			if (s->len < s->need)
+				return;
+			n = s->need;
+			s->bytes += n;
+			usleep(s->latency_ms * 1000);
+			sprintf(resp, "\r\nRecv %"PRIu32" bytes\r\n\r\nSEND OK\r\n",
+				n);
+			wifi_bench_sim_puts(s, resp);
+			if (s->mux)
+				sprintf(resp, "\r\n+IPD,%"PRIu32",%"PRIu32":",
+					s->link_id, n);
+			else
+				sprintf(resp, "\r\n+IPD,%"PRIu32":", n);
+			wifi_bench_sim_puts(s, resp);
+			wifi_bench_sim_out(s, s->buff, n);
+			s->state = WIFI_BENCH_SIM_CMD;
+			break;
+		default:
+			if (wifi_bench_sim_escape(s))
+				return;
+			n = s->len;
+			s->bytes += n;
+			wifi_bench_sim_out(s, s->buff, n);
+			break;
+		}
+		s->len -= n;
+		memmove(s->buff, s->buff + n, s->len);
+	}
+}
+
+/**
+ * @brief Simulator thread, serves the host until stopped.
+ * @param arg - Simulator.
+ * @return NULL.
+ */
+static void *wifi_bench_sim_run(void *arg)
+{
+	struct wifi_bench_sim *s = arg;
+	struct pollfd pfd;
+	ssize_t n;
+	int ret;
+
+	pfd.fd = s->fd;
+	pfd.events = POLLIN;
+	while (!s->stop) {
+		ret = poll(&pfd, 1, WIFI_BENCH_GUARD_MS);
+		if (ret < 0)
+			break;
+		if (!ret) {
+			if (s->state == WIFI_BENCH_SIM_PASSTHROUGH &&
+			    s->len == 3 && wifi_bench_sim_escape(s)) {
+				s->len = 0;
+				s->state = WIFI_BENCH_SIM_CMD;
+			}
+			continue;
+		}
+
+		n = read(s->fd, s->buff + s->len, sizeof(s->buff) - s->len);
+		if (n <= 0)
+			break;
+		s->len += n;
+		wifi_bench_sim_parse(s);
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Open a pty and start the simulator on its master side.
+ * @param s - Simulator, latency_ms set by the caller.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t wifi_bench_sim_start(struct wifi_bench_sim *s)
+{
+	struct termios tio;
+	char *name;
+
+	s->stop = false;
+	s->tx_done_ns = 0;
+	s->state = WIFI_BENCH_SIM_CMD;
+	s->mux = false;
+	s->cipmode = false;
+	s->wifi_connected = false;
+	s->cipsend = 0;
+	s->bytes = 0;
+	s->len = 0;
+
+	s->fd = posix_openpt(O_RDWR | O_NOCTTY);
+	if (s->fd < 0)
+		return -errno;
+	if (grantpt(s->fd) || unlockpt(s->fd))
+		goto error;
+	name = ptsname(s->fd);
+	if (!name || strncmp(name, "/dev/", 5) ||
+	    strlen(name + 5) >= sizeof(s->dev))
+		goto error;
+	strcpy(s->dev, name + 5);
+
+	s->slave_fd = open(name, O_RDWR | O_NOCTTY);
+	if (s->slave_fd < 0)
+		goto error;
+	/* No echo or line discipline on the module side either */
+	if (tcgetattr(s->slave_fd, &tio))
+		goto error_slave;
+	cfmakeraw(&tio);
+	if (tcsetattr(s->slave_fd, TCSANOW, &tio) ||
+	    pthread_create(&s->thread, NULL, wifi_bench_sim_run, s))
+		goto error_slave;
+
+	return SUCCESS;
+
+error_slave:
+	close(s->slave_fd);
+error:
+	close(s->fd);
+
+	return -EIO;
+}
+
+/**
+ * @brief Stop the simulator and close the pty.
+ * @param s - Simulator.
+ */
+static void wifi_bench_sim_stop(struct wifi_bench_sim *s)
+{
+	s->stop = true;
+	pthread_join(s->thread, NULL);
+	close(s->slave_fd);
+	close(s->fd);
+}
+
+/**
+ * @brief Send the data in one mode.
+ * @param c - Send mode.
+ * @param net - Network interface of the module.
+ * @param id - Connected socket.
+ * @param tx - Data.
+ * @param len - Length of the data.
+ * @param chunk - Bytes handed to the driver at a time.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t wifi_bench_send(const struct wifi_bench_case *c,
+			       struct network_interface *net, uint32_t id,
+			       const uint8_t *tx, uint32_t len, uint32_t chunk)
+{
+	struct socket_iovec iov[WIFI_BENCH_IOV];
+	uint32_t i, n = 0;
+	int32_t ret;
+
+	for (i = 0; i < len; i += chunk) {
+		if (c->mode != WIFI_BENCH_SENDV) {
+			ret = net->socket_send(net->net, id, tx + i,
+					       min(chunk, len - i));
+			if (ret < 0)
+				return ret;
+			continue;
+		}
+
+		iov[n].base = tx + i;
+		iov[n++].len = min(chunk, len - i);
+		if (n == WIFI_BENCH_IOV || i + chunk >= len) {
+			ret = net->socket_sendv(net->net, id, iov, n);
+			if (ret < 0)
+				return ret;
+			n = 0;
+		}
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Send the data through the simulated module in one mode, read the
+ * echo back and print the throughput.
+ * @param c - Send mode.
+ * @param s - Simulator, latency_ms set by the caller.
+ * @param tx - Data.
+ * @param rx - Buffer for the echo, as long as the data.
+ * @param len - Length of the data.
+ * @param chunk - Bytes handed to the driver at a time.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t wifi_bench_case_run(const struct wifi_bench_case *c,
+				   struct wifi_bench_sim *s,
+				   const uint8_t *tx, uint8_t *rx,
+				   uint32_t len, uint32_t chunk)
+{
+	static uint8_t ring[WIFI_BENCH_RING];
+	struct linux_uart_init_param linux_param = { 0 };
+	struct uart_init_param uart_param = {
+		.baud_rate = WIFI_BENCH_BAUD,
+		.size = UART_CS_8,
+		.parity = UART_PAR_NO,
+		.stop = UART_STOP_1_BIT,
+		.extra = &linux_param,
+	};
+	struct wifi_init_param wifi_param = {
+		.rx_ring = ring,
+		.rx_ring_size = sizeof(ring),
+		.rx_ring_head = linux_uart_rx_ring_head,
+		.passthrough = c->mode == WIFI_BENCH_PASSTHROUGH,
+	};
+	struct socket_address addr = {
+		.addr = "127.0.0.1",
+		.port = 7,
+	};
+	struct network_interface *net;
+	struct wifi_desc *wifi;
+	struct uart_desc *uart;
+	uint64_t start, timeout;
+	uint32_t id, got = 0;
+	int32_t ret;
+
+	ret = wifi_bench_sim_start(s);
+	if (ret)
+		return ret;
+
+	linux_param.device_id = s->dev;
+	ret = uart_init(&uart, &uart_param);
+	if (ret)
+		goto err_sim;
+	ret = linux_uart_rx_ring_start(uart, ring, sizeof(ring));
+	if (ret)
+		goto err_uart;
+
+	wifi_param.uart_desc = uart;
+	wifi_param.rx_ring_ctx = uart;
+	ret = wifi_init(&wifi, &wifi_param);
+	if (ret)
+		goto err_uart;
+	ret = wifi_connect(wifi, "linux_bench", "linux_bench");
+	if (ret)
+		goto err_wifi;
+	wifi_get_network_interface(wifi, &net);
+
+	/* The whole echo fits in the socket buffer */
+	ret = net->socket_open(net->net, &id, PROTOCOL_TCP, len);
+	if (ret)
+		goto err_wifi;
+	ret = net->socket_connect(net->net, id, &addr);
+	if (ret)
+		goto err_socket;
+
+	start = bench_now_ns();
+	if (c->mode == WIFI_BENCH_CORK)
+		net->socket_setopt(net->net, id, SOCKET_OPT_CORK, 1);
+	ret = wifi_bench_send(c, net, id, tx, len, chunk);
+	if (c->mode == WIFI_BENCH_CORK)
+		net->socket_setopt(net->net, id, SOCKET_OPT_CORK, 0);
+
+	timeout = bench_now_ns() + WIFI_BENCH_TIMEOUT_MS * 1000000ull;
+	while (!ret && got < len && bench_now_ns() < timeout) {
+		ret = net->socket_recv(net->net, id, rx + got, len - got);
+		if (ret >= 0) {
+			got += ret;
+			ret = SUCCESS;
+		} else if (ret == -EAGAIN) {
+			ret = SUCCESS;
+		}
+	}
+	start = bench_now_ns() - start;
+
+	net->socket_disconnect(net->net, id);
+err_socket:
+	net->socket_close(net->net, id);
+err_wifi:
+	wifi_remove(wifi);
+err_uart:
+	uart_remove(uart);
+err_sim:
+	wifi_bench_sim_stop(s);
+	if (ret)
+		return ret;
+
+	printf("%-11s %6"PRIu32" bytes %8.1f ms %8.1f kB/s %5"PRIu32" AT+CIPSEND\n",
+	       c->name, got, start / 1e6, got * 1e6 / start, s->cipsend);
+
+	BENCH_CHECK(s->bytes == len);
+	BENCH_CHECK(got == len);
+	BENCH_CHECK(!memcmp(tx, rx, len));
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Send data through a simulated ESP8266 that echoes it back, with
+ * socket_send(), corked, with socket_sendv() and in passthrough mode, and
+ * print the throughputs.
+ * -n bytes: data sent in each mode
+ * -s bytes: bytes handed to the driver at a time
+ * -l ms: delay of the module answers to AT+CIPSEND, a radio round trip
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t wifi_bench(int argc, char **argv)
+{
+	static struct wifi_bench_sim sim;
+	uint32_t len = WIFI_BENCH_BYTES;
+	uint32_t chunk = WIFI_BENCH_CHUNK;
+	uint8_t *tx, *rx;
+	int32_t ret = SUCCESS;
+	uint32_t i;
+	int opt;
+
+	sim.latency_ms = WIFI_BENCH_LATENCY_MS;
+	while ((opt = getopt(argc, argv, "n:s:l:")) != -1) {
+		switch (opt) {
+		case 'n':
+			len = strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			chunk = strtoul(optarg, NULL, 0);
+			break;
+		case 'l':
+			sim.latency_ms = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			return -EINVAL;
+		}
+	}
+
+	if (!len || !chunk)
+		return -EINVAL;
+
+	tx = malloc(len);
+	rx = malloc(len);
+	if (!tx || !rx) {
+		ret = -ENOMEM;
+		goto out;
+	}
+	for (i = 0; i < len; i++)
+		tx[i] = 'a' + (i * 7 + i / 13) % 26;
+
+	printf("%"PRIu32" byte sends, module latency %"PRIu32" ms\n", chunk,
+	       sim.latency_ms);
+
+	for (i = 0; i < ARRAY_SIZE(wifi_bench_cases); i++) {
+		memset(rx, 0, len);
+		ret = wifi_bench_case_run(&wifi_bench_cases[i], &sim, tx, rx,
+					  len, chunk);
+		if (ret)
+			break;
+	}
+out:
+	free(tx);
+	free(rx);
+
+	return ret;
+}
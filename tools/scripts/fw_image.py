@@ -0,0 +1,178 @@
+#!/bin/python
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+description_help='''Pack a firmware blob into a no-OS fw_image container
+(see include/no-os/fw_image.h). The payload is LZSS compressed (heatshrink
+compatible bit stream) unless -raw is given.
+Examples:\n
+	Compress the Talise ARM firmware into a C array
+	>python fw_image.py drivers/rf-transceiver/talise/firmware/talise_arm_binary.h talise_arm.fwi.h -c talise_arm_fwi
+	Compress a binary file to be stored on the SD card or mmapped on Linux
+	>python fw_image.py Navassa_EvaluationFw.bin Navassa_EvaluationFw.fwi
+'''
+
+FW_IMAGE_MAGIC = 0x4957464E
+FW_IMAGE_VERSION = 1
+CODEC_RAW = 0
+CODEC_LZSS = 1
+
+def parse_input():
+	parser = argparse.ArgumentParser(description=description_help,\
+				formatter_class=argparse.RawTextHelpFormatter)
+	parser.add_argument('input', help='.bin file or C header holding a byte array')
+	parser.add_argument('output', help='Output file')
+	parser.add_argument('-c', dest='c_name', default=None,
+			help='Write a C header defining a const array with this name')
+	parser.add_argument('-w', dest='window', type=int, default=11,
+			help='log2 of the LZSS window (decoder RAM), default 11')
+	parser.add_argument('-l', dest='lookahead', type=int, default=4,
+			help='log2 of the maximum match length, default 4')
+	parser.add_argument('-raw', action='store_true',
+			help='Store the payload without compression')
+	return parser.parse_args()
+
+def read_blob(path):
+	if not path.endswith('.h') and not path.endswith('.c'):
+		with open(path, 'rb') as f:
+			return f.read()
+
+	with open(path, 'r', errors='ignore') as f:
+		text = f.read()
+	body = text[text.index('{', text.index('[]')) + 1:]
+	body = body[:body.index('}')]
+	return bytes(int(v, 0) for v in re.findall(r'0[xX][0-9a-fA-F]+|\d+', body))
+
+class BitWriter:
+	def __init__(self):
+		self.out = bytearray()
+		self.cur = 0
+		self.nbits = 0
+
+	def put(self, val, count):
+		for i in range(count - 1, -1, -1):
+			self.cur = (self.cur << 1) | ((val >> i) & 1)
+			self.nbits += 1
+			if self.nbits == 8:
+				self.out.append(self.cur)
+				self.cur = 0
+				self.nbits = 0
+
+	def flush(self):
+		if self.nbits:
+			self.out.append(self.cur << (8 - self.nbits))
+			self.cur = 0
+			self.nbits = 0
+		return bytes(self.out)
+
+def lzss_compress(data, window_sz2, lookahead_sz2, max_chain=64):
+	max_offset = 1 << window_sz2
+	max_len = 1 << lookahead_sz2
+	# Back-references shorter than this cost more than the literals
+	min_len = (1 + window_sz2 + lookahead_sz2) // 9 + 1
+	heads = {}
+	bw = BitWriter()
+	pos = 0
+	n = len(data)
+
+	def insert(p):
+		if p + 3 <= n:
+			heads.setdefault(data[p:p + 3], []).append(p)
+
+	while pos < n:
+		best_len = 0
+		best_off = 0
+		cands = heads.get(data[pos:pos + 3], [])
+		limit = min(max_len, n - pos)
+		for cand in reversed(cands[-max_chain:]):
+			off = pos - cand
+			if off > max_offset:
+				break
+			l = 0
+			while l < limit and data[cand + l] == data[pos + l]:
+				l += 1
+			if l > best_len:
+				best_len = l
+				best_off = off
+				if l == limit:
+					break
+
+		if best_len >= max(min_len, 3):
+			bw.put(0, 1)
+			bw.put(best_off - 1, window_sz2)
+			bw.put(best_len - 1, lookahead_sz2)
+			for p in range(pos, pos + best_len):
+				insert(p)
+			pos += best_len
+		else:
+			bw.put(1, 1)
+			bw.put(data[pos], 8)
+			insert(pos)
+			pos += 1
+
+	return bw.flush()
+
+def lzss_decompress(payload, size, window_sz2, lookahead_sz2):
+	out = bytearray()
+	bits = ''.join(format(b, '08b') for b in payload)
+	i = 0
+	while len(out) < size:
+		if bits[i] == '1':
+			out.append(int(bits[i + 1:i + 9], 2))
+			i += 9
+		else:
+			off = int(bits[i + 1:i + 1 + window_sz2], 2) + 1
+			i += 1 + window_sz2
+			cnt = int(bits[i:i + lookahead_sz2], 2) + 1
+			i += lookahead_sz2
+			for _ in range(cnt):
+				out.append(out[-off] if off <= len(out) else 0)
+	return bytes(out[:size])
+
+def write_c_header(path, name, image):
+	guard = re.sub(r'[^A-Z0-9]', '_', os.path.basename(path).upper())
+	with open(path, 'w') as f:
+		f.write('/* Generated by tools/scripts/fw_image.py, do not edit. */\n')
+		f.write('#ifndef %s\n#define %s\n\n#include <stdint.h>\n\n' % (guard, guard))
+		f.write('const uint8_t %s[%d] = {\n' % (name, len(image)))
+		for i in range(0, len(image), 12):
+			f.write('\t' + ', '.join('0x%02x' % b for b in image[i:i + 12]) + ',\n')
+		f.write('};\n\n#endif\n')
+
+def main():
+	args = parse_input()
+	data = read_blob(args.input)
+
+	if args.raw:
+		codec = CODEC_RAW
+		payload = data
+	else:
+		if not 0 < args.lookahead < args.window <= 14:
+			sys.exit('invalid window/lookahead sizes')
+		codec = CODEC_LZSS
+		payload = lzss_compress(data, args.window, args.lookahead)
+		if lzss_decompress(payload, len(data), args.window, args.lookahead) != data:
+			sys.exit('internal error: round trip check failed')
+
+	header = struct.pack('<IBBBBII', FW_IMAGE_MAGIC, FW_IMAGE_VERSION, codec,
+			     args.window if codec else 0,
+			     args.lookahead if codec else 0,
+			     len(data), len(payload))
+	image = header + payload
+
+	if args.c_name:
+		write_c_header(args.output, args.c_name, image)
+	else:
+		with open(args.output, 'wb') as f:
+			f.write(image)
+
+	print('%s: %d -> %d bytes (%.1f%%), decoder window %d bytes' %
+	      (os.path.basename(args.input), len(data), len(image),
+	       100.0 * len(image) / max(len(data), 1),
+	       (1 << args.window) if codec else 0))
+
+main()
@@ -229,6 +229,22 @@ ifeq (y,$(strip $(DISABLE_SECURE_SOCKET)))
 CFLAGS += -DDISABLE_SECURE_SOCKET
 endif
 
+ifeq (y,$(strip $(IIO_PERF)))
+CFLAGS += -DIIO_PERF
+endif
+
+# Drivers include trace.h unconditionally, the records are only built with TRACE
+INCS += $(INCLUDE)/no-os/trace.h
+ifeq (y,$(strip $(TRACE)))
+CFLAGS += -DNO_OS_TRACE
+SRCS += $(NO-OS)/util/trace.c
+endif
+
+ifeq (y,$(strip $(DELAY_ACCT)))
+CFLAGS += -DNO_OS_DELAY_ACCT
+SRCS += $(NO-OS)/util/delay_acct.c
+endif
+
 include $(NO-OS)/tools/scripts/libraries.mk
 
 SRC_DIRS := $(patsubst %/,%,$(SRC_DIRS))
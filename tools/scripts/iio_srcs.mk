@@ -8,6 +8,17 @@ INCS += $(NO-OS)/iio/iiod.h
 INCS += $(NO-OS)/iio/iiod_private.h
 INCS += $(INCLUDE)/no-os/circular_buffer.h
 
+ifeq (y,$(strip $(IIO_PERF)))
+SRCS += $(NO-OS)/iio/iio_perf.c
+INCS += $(NO-OS)/iio/iio_perf.h
+INCS += $(INCLUDE)/no-os/timer.h
+# iio_app times the operations with a linux timer
+ifeq (linux,$(strip $(PLATFORM)))
+IIO_PERF_TIMER := $(filter-out $(SRCS),$(DRIVERS)/platform/linux/linux_timer.c)
+SRCS += $(IIO_PERF_TIMER)
+endif
+endif
+
 ifeq (y,$(strip $(ENABLE_IIO_NETWORK)))
 DISABLE_SECURE_SOCKET ?= y
 SRC_DIRS += $(NO-OS)/network
@@ -0,0 +1,380 @@
+#!/bin/python
+
+import argparse
+import json
+import os
+import socket
+import subprocess
+import sys
+import threading
+import time
+import xml.etree.ElementTree as ET
+
+description_help='''Measure how fast an iiod server (iio/iiod.c) serves data, using the
+iiod text protocol (the one libiio uses over the network backend).
+Reported per case: READBUF/WRITEBUF MB/s, attribute READ/WRITE ops/s and
+p50/p99 command latency. Results are printed as a table and written as JSON
+lines (or CSV if the output file ends in .csv).
+With -n more than one, the extra clients run attribute reads concurrently
+with the measured one, so buffer throughput is measured under load.
+Examples:\n
+	Start the Linux build of iio_demo and run the default cases
+	>python iiod_bench.py -run projects/iio_demo/build/iio_demo.out
+	Run against a board and save a baseline
+	>python iiod_bench.py -u 192.168.0.10 -n 1,4 -b 256,4096 -m 1,3 -o base.json
+	Fail (exit code 1) if a case is more than 10% slower than the baseline
+	>python iiod_bench.py -run build/iio_demo.out -cmp base.json -tol 10
+'''
+
+IIOD_PORT = 30431
+
+def parse_input():
+	parser = argparse.ArgumentParser(description=description_help,\
+				formatter_class=argparse.RawTextHelpFormatter)
+	parser.add_argument('-u', dest='host', default='127.0.0.1',
+			help='iiod server address, default 127.0.0.1')
+	parser.add_argument('-p', dest='port', type=int, default=IIOD_PORT,
+			help='iiod server port, default %d' % IIOD_PORT)
+	parser.add_argument('-run', dest='binary', default=None,
+			help='Start this server binary (Linux platform) and stop it at the end')
+	parser.add_argument('-n', dest='clients', default='1,4',
+			help='Comma separated numbers of clients, default 1,4')
+	parser.add_argument('-b', dest='samples', default='256,4096',
+			help='Comma separated buffer sizes in samples, default 256,4096')
+	parser.add_argument('-m', dest='masks', default=None,
+			help='Comma separated hex channel masks, default: first channel and all channels')
+	parser.add_argument('-t', dest='duration', type=float, default=2.0,
+			help='Seconds per case, default 2')
+	parser.add_argument('-o', dest='output', default=None,
+			help='Write the results to this file (.json: JSON lines, .csv: CSV)')
+	parser.add_argument('-cmp', dest='baseline', default=None,
+			help='Compare with results written before with -o (JSON lines)')
+	parser.add_argument('-tol', dest='tolerance', type=float, default=10.0,
+			help='Allowed regression against the baseline in percent, default 10')
+	return parser.parse_args()
+
+class IiodError(Exception):
+	pass
+
+class IiodClient:
+	'''Client for the iiod text protocol'''
+	def __init__(self, host, port, timeout=10):
+		self.sock = socket.create_connection((host, port), timeout)
+		self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+		self.f = self.sock.makefile('rb')
+
+	def close(self):
+		try:
+			self.sock.sendall(b'EXIT\r\n')
+		except OSError:
+			pass
+		self.f.close()
+		self.sock.close()
+
+	def read_int(self):
+		line = self.f.readline()
+		if not line:
+			raise IiodError('connection closed')
+		return int(line)
+
+	def read_exact(self, size):
+		data = self.f.read(size)
+		if len(data) != size:
+			raise IiodError('connection closed')
+		return data
+
+	def cmd(self, line, payload=b''):
+		self.sock.sendall(line.encode() + b'\r\n' + payload)
+		ret = self.read_int()
+		if ret < 0:
+			raise IiodError('%s: %d' % (line, ret))
+		return ret
+
+	def print_xml(self):
+		size = self.cmd('PRINT')
+		# The XML is followed by '\n'
+		return self.read_exact(size + 1)[:size].decode()
+
+	def read_attr(self, path):
+		size = self.cmd('READ ' + path)
+		return self.read_exact(size + 1)[:size]
+
+	def write_attr(self, path, value):
+		return self.cmd('WRITE %s %d' % (path, len(value)), value)
+
+	def open(self, dev, samples, mask):
+		return self.cmd('OPEN %s %d %08x' % (dev, samples, mask))
+
+	def close_dev(self, dev):
+		return self.cmd('CLOSE ' + dev)
+
+	def readbuf(self, dev, size):
+		done = 0
+		while done < size:
+			ret = self.cmd('READBUF %s %d' % (dev, size - done))
+			if ret == 0:
+				break
+			# Mask of the enabled channels
+			self.f.readline()
+			self.read_exact(ret)
+			done += ret
+		return done
+
+	def writebuf(self, dev, data):
+		# The server answers once before reading the data and once after
+		# pushing it
+		self.cmd('WRITEBUF %s %d' % (dev, len(data)))
+		self.sock.sendall(data)
+		ret = self.read_int()
+		if ret < 0:
+			raise IiodError('WRITEBUF %s: %d' % (dev, ret))
+		return ret
+
+class Device:
+	def __init__(self, node):
+		self.id = node.get('id')
+		self.name = node.get('name', self.id)
+		self.attrs = [a.get('name') for a in node.findall('attribute')]
+		# [(index, storage bytes, channel id, is output, attributes)]
+		self.channels = []
+		for ch in node.findall('channel'):
+			scan = ch.find('scan-element')
+			if scan is None:
+				continue
+			fmt = scan.get('format')
+			bits = int(fmt.split('/')[1].split('>')[0].split('X')[0])
+			self.channels.append((int(scan.get('index')), bits // 8,
+					ch.get('id'), ch.get('type') == 'output',
+					[a.get('name') for a in ch.findall('attribute')]))
+		self.channels.sort()
+
+	def is_output(self):
+		return any(ch[3] for ch in self.channels)
+
+	def sample_size(self, mask):
+		return sum(ch[1] for ch in self.channels if mask & (1 << ch[0]))
+
+	def attr_path(self):
+		for idx, size, ch_id, out, attrs in self.channels:
+			if attrs:
+				return '%s %s %s %s' % (self.id,
+					'OUTPUT' if out else 'INPUT', ch_id, attrs[0])
+		if self.attrs:
+			return '%s %s' % (self.id, self.attrs[0])
+		return None
+
+def percentile(values, pct):
+	if not values:
+		return 0.0
+	values = sorted(values)
+	return values[min(len(values) - 1, int(len(values) * pct / 100))]
+
+def summary(case, lat, seconds, nbytes=0):
+	res = dict(case)
+	res['ops'] = len(lat)
+	res['ops_per_s'] = round(len(lat) / seconds, 1)
+	res['p50_us'] = round(percentile(lat, 50) * 1e6, 1)
+	res['p99_us'] = round(percentile(lat, 99) * 1e6, 1)
+	if nbytes:
+		res['mb_per_s'] = round(nbytes / seconds / 1e6, 3)
+	return res
+
+def timed_loop(duration, op):
+	lat = []
+	t0 = time.perf_counter()
+	end = t0 + duration
+	now = t0
+	while now < end:
+		op()
+		t = time.perf_counter()
+		lat.append(t - now)
+		now = t
+	return lat, now - t0
+
+def attr_load(args, path, stop):
+	'''Background client reading an attribute until stopped'''
+	cli = IiodClient(args.host, args.port)
+	while not stop.is_set():
+		cli.read_attr(path)
+	cli.close()
+
+def run_attr_case(args, dev, path, clients, write):
+	'''All clients read (or write back) the same attribute'''
+	results = [None] * clients
+	value = IiodClient(args.host, args.port)
+	val = value.read_attr(path)
+	value.close()
+
+	def worker(i):
+		cli = IiodClient(args.host, args.port)
+		if write:
+			op = lambda: cli.write_attr(path, val)
+		else:
+			op = lambda: cli.read_attr(path)
+		results[i] = timed_loop(args.duration, op)
+		cli.close()
+
+	threads = [threading.Thread(target=worker, args=(i,)) for i in range(clients)]
+	for t in threads:
+		t.start()
+	for t in threads:
+		t.join()
+
+	lat = [l for r in results for l in r[0]]
+	seconds = max(r[1] for r in results)
+	case = {'test': 'attr_write' if write else 'attr_read', 'device': dev.name,
+		'clients': clients, 'samples': 0, 'mask': '0'}
+	return summary(case, lat, seconds)
+
+def run_buf_case(args, dev, load_path, clients, samples, mask):
+	'''One client streams the buffer, the others load the server'''
+	stop = threading.Event()
+	load = []
+	if load_path:
+		load = [threading.Thread(target=attr_load,
+					 args=(args, load_path, stop))
+			for i in range(clients - 1)]
+	for t in load:
+		t.start()
+
+	size = samples * dev.sample_size(mask)
+	cli = IiodClient(args.host, args.port)
+	try:
+		cli.open(dev.id, samples, mask)
+		if dev.is_output():
+			data = os.urandom(size)
+			op = lambda: cli.writebuf(dev.id, data)
+		else:
+			op = lambda: cli.readbuf(dev.id, size)
+		lat, seconds = timed_loop(args.duration, op)
+		cli.close_dev(dev.id)
+	finally:
+		stop.set()
+		for t in load:
+			t.join()
+		cli.close()
+
+	case = {'test': 'writebuf' if dev.is_output() else 'readbuf',
+		'device': dev.name, 'clients': clients if load_path else 1,
+		'samples': samples, 'mask': '%x' % mask}
+	return summary(case, lat, seconds, size * len(lat))
+
+def case_key(res):
+	return '%s/%s/%s/%s/%s' % (res['test'], res['device'], res['clients'],
+				   res['samples'], res['mask'])
+
+def compare(results, path, tolerance):
+	'''Return the cases slower than the baseline by more than tolerance %'''
+	with open(path) as f:
+		base = dict((case_key(r), r) for r in map(json.loads, f) if r)
+	slower = []
+	for res in results:
+		ref = base.get(case_key(res))
+		if not ref:
+			continue
+		metric = 'mb_per_s' if 'mb_per_s' in res else 'ops_per_s'
+		if res[metric] < ref[metric] * (1 - tolerance / 100):
+			slower.append((case_key(res), metric, ref[metric], res[metric]))
+	return slower
+
+def write_results(results, path):
+	with open(path, 'w') as f:
+		if path.endswith('.csv'):
+			keys = ['test', 'device', 'clients', 'samples', 'mask', 'ops',
+				'ops_per_s', 'mb_per_s', 'p50_us', 'p99_us']
+			f.write(','.join(keys) + '\n')
+			for r in results:
+				f.write(','.join(str(r.get(k, '')) for k in keys) + '\n')
+		else:
+			for r in results:
+				f.write(json.dumps(r) + '\n')
+
+def print_result(res):
+	print('%-10s %-12s %3d %6d %4s %10.1f %9s %9.1f %9.1f' % (res['test'],
+		res['device'], res['clients'], res['samples'], res['mask'],
+		res['ops_per_s'], res.get('mb_per_s', '-'), res['p50_us'],
+		res['p99_us']), file=sys.stderr)
+
+def wait_server(args, proc, timeout=10):
+	end = time.time() + timeout
+	while time.time() < end:
+		if proc.poll() is not None:
+			raise IiodError('server exited with code %d' % proc.returncode)
+		try:
+			socket.create_connection((args.host, args.port), 1).close()
+			return
+		except OSError:
+			time.sleep(0.1)
+	raise IiodError('server not reachable on port %d' % args.port)
+
+def run(args):
+	clients = [int(v) for v in args.clients.split(',')]
+	samples = [int(v) for v in args.samples.split(',')]
+
+	cli = IiodClient(args.host, args.port)
+	root = ET.fromstring(cli.print_xml())
+	cli.close()
+	devices = [Device(d) for d in root.findall('device')]
+
+	print('%-10s %-12s %3s %6s %4s %10s %9s %9s %9s' % ('test', 'device',
+		'cli', 'smpl', 'mask', 'ops/s', 'MB/s', 'p50 us', 'p99 us'),
+		file=sys.stderr)
+	results = []
+	for dev in devices:
+		path = dev.attr_path()
+		if path:
+			for n in clients:
+				for write in [False, True]:
+					res = run_attr_case(args, dev, path, n, write)
+					print_result(res)
+					results.append(res)
+
+		if not dev.channels:
+			continue
+		if args.masks:
+			masks = [int(v, 16) for v in args.masks.split(',')]
+		else:
+			all_ch = 0
+			for ch in dev.channels:
+				all_ch |= 1 << ch[0]
+			masks = sorted(set([1 << dev.channels[0][0], all_ch]))
+		for n in clients:
+			for s in samples:
+				for mask in masks:
+					res = run_buf_case(args, dev, path, n, s, mask)
+					print_result(res)
+					results.append(res)
+
+	return results
+
+def main():
+	args = parse_input()
+	proc = None
+	if args.binary:
+		proc = subprocess.Popen([os.path.abspath(args.binary)],
+					stdout=subprocess.DEVNULL)
+	try:
+		if proc:
+			wait_server(args, proc)
+		results = run(args)
+	finally:
+		if proc:
+			proc.terminate()
+			proc.wait()
+
+	if args.output:
+		write_results(results, args.output)
+	else:
+		for r in results:
+			print(json.dumps(r))
+
+	if args.baseline:
+		slower = compare(results, args.baseline, args.tolerance)
+		for key, metric, ref, val in slower:
+			print('REGRESSION %s: %s %s -> %s' % (key, metric, ref, val),
+			      file=sys.stderr)
+		if slower:
+			sys.exit(1)
+
+if __name__ == '__main__':
+	main()
@@ -62,6 +62,14 @@ $(FATFS_LIB):
 # Custom settings
 CFLAGS		+= -I$(NO-OS)/drivers/sd-card -I$(NO-OS)/include
 
+# Sector cache between FatFs and the card, the application sets sd_cache.
+# Rebuild libfatfs (make clean) after changing it.
+ifeq (y,$(strip $(SD_CACHE)))
+CFLAGS		+= -DFATFS_SD_CACHE
+SRCS		+= $(NO-OS)/drivers/sd-card/sd_cache.c
+INCS		+= $(NO-OS)/drivers/sd-card/sd_cache.h
+endif
+
 endif
 
 #	MQTT
@@ -9,6 +9,8 @@ PROJECT_BUILD = $(BUILD_DIR)/app
 CFLAGS +=  -g3 \
 		-DLINUX_PLATFORM \
 
+LIB_FLAGS += -lpthread
+
 $(PROJECT_TARGET):
 	$(MUTE) $(call mk_dir, $(BUILD_DIR)) $(HIDE)
 	$(MUTE) $(call set_one_time_rule,$@)
@@ -21,3 +23,9 @@ $(PLATFORM)_sdkopen:
 
 linux_run: $(BINARY)
 	$(BINARY)
+
+# Run the iiod benchmark against the project binary. Extra arguments can be
+# given with BENCH_ARGS, see tools/scripts/iiod_bench.py -h
+PHONY += bench
+bench: $(BINARY)
+	python3 $(NO-OS)/tools/scripts/iiod_bench.py -run $(BINARY) $(BENCH_ARGS)
@@ -0,0 +1,166 @@
+#!/bin/python
+
+import argparse
+import json
+import os
+import re
+import struct
+import sys
+
+description_help='''Convert a dump of the no-OS trace ring (include/no-os/trace.h)
+to a Chrome trace / Perfetto JSON timeline.
+The dump is either the binary trace_buf memory (trace_dump() or a debugger
+memory save) or a console log containing the output of trace_print().
+Examples:\n
+	Decode a binary dump
+	>python trace_decode.py trace.bin -o trace.json
+	Decode a console log and print the time spent per event
+	>python trace_decode.py console.log -o trace.json -s
+Open the output in https://ui.perfetto.dev or chrome://tracing.
+'''
+
+HEADER = struct.Struct('<IHHIIII')
+RECORD = struct.Struct('<IHBBI')
+MAGIC = 0x52544f4e
+TYPE_BEGIN, TYPE_END, TYPE_INSTANT, TYPE_COUNTER = range(4)
+
+TRACE_H = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+		       '..', '..', 'include', 'no-os', 'trace.h')
+
+def parse_input():
+	parser = argparse.ArgumentParser(description=description_help,\
+				formatter_class=argparse.RawTextHelpFormatter)
+	parser.add_argument('dump', help='Binary dump or console log')
+	parser.add_argument('-o', dest='output', default='trace.json',
+			help='Output JSON file (default trace.json)')
+	parser.add_argument('-t', dest='trace_h', default=TRACE_H,
+			help='trace.h to read the event names from')
+	parser.add_argument('-s', dest='summary', action='store_true',
+			help='Print count, total and max time per event')
+	return parser.parse_args()
+
+def event_names(trace_h):
+	names = {}
+	with open(trace_h) as f:
+		for m in re.finditer(r'TRACE_EV_(\w+)\s*=\s*(0x[0-9a-fA-F]+|\d+)',
+				     f.read()):
+			names[int(m.group(2), 0)] = m.group(1).lower()
+	return names
+
+def read_dump(path):
+	with open(path, 'rb') as f:
+		data = f.read()
+	if len(data) >= 4 and struct.unpack_from('<I', data)[0] == MAGIC:
+		return data
+
+	# Console log: the last block printed by trace_print()
+	text = data.decode('ascii', 'replace')
+	start = text.rfind('TRACE BEGIN')
+	end = text.find('TRACE END', start)
+	if start < 0 or end < 0:
+		sys.exit('%s: no trace found' % path)
+	lines = text[start:end].splitlines()[1:]
+	return bytes.fromhex(''.join(l.strip() for l in lines))
+
+def read_records(data):
+	magic, version, rec_size, freq, size, head, limit = \
+		HEADER.unpack_from(data)
+	if magic != MAGIC or version != 1 or rec_size != RECORD.size:
+		sys.exit('Unsupported dump (magic %x, version %d, record %d)' %
+			 (magic, version, rec_size))
+
+	avail = (len(data) - HEADER.size) // rec_size
+	first = max(0, head - size)
+	recs = []
+	for n in range(first, head):
+		i = n % size
+		if i >= avail:
+			continue
+		recs.append(RECORD.unpack_from(data, HEADER.size + i * rec_size))
+	if first:
+		print('%d records lost to the ring wrapping' % first,
+		      file=sys.stderr)
+
+	return freq, recs
+
+def signed(v):
+	return v - (1 << 32) if v & (1 << 31) else v
+
+def begin_args(name, arg):
+	if name == 'spi':
+		return {'cs': arg >> 16, 'bytes': arg & 0xffff}
+	if name == 'delay':
+		return {'us': arg}
+	if name == 'jesd204_link_state':
+		return {'link': arg >> 8, 'state': arg & 0xff}
+	return {'arg': '0x%x' % arg}
+
+def main():
+	args = parse_input()
+	names = event_names(args.trace_h)
+	freq, recs = read_records(read_dump(args.dump))
+
+	events = []
+	stack = []
+	stats = {}
+	t = 0
+	prev = None
+	for ts, eid, etype, _, arg in recs:
+		# Unwrap the 32 bit time source
+		t += 0 if prev is None else (ts - prev) & 0xffffffff
+		prev = ts
+		us = t * 1e6 / freq if freq else float(t)
+		name = names.get(eid, 'event_%d' % eid)
+		ev = {'name': name, 'ts': us, 'pid': 0, 'tid': 0}
+
+		if etype == TYPE_BEGIN:
+			ev.update(ph='B', args=begin_args(name, arg))
+			stack.append((eid, us))
+		elif etype == TYPE_END:
+			# The begin was overwritten by the ring
+			if not any(e == eid for e, _ in stack):
+				continue
+			# Inner events left open end here, so B/E stay nested
+			while stack:
+				e, start = stack.pop()
+				if e == eid:
+					break
+				events.append({'name': names.get(e, 'event_%d' % e),
+					       'ph': 'E', 'ts': us, 'pid': 0,
+					       'tid': 0,
+					       'args': {'unfinished': True}})
+			ev.update(ph='E', args={'ret': signed(arg)})
+			st = stats.setdefault(name, [0, 0.0, 0.0])
+			st[0] += 1
+			st[1] += us - start
+			st[2] = max(st[2], us - start)
+		elif etype == TYPE_INSTANT:
+			ev.update(ph='i', s='t', args=begin_args(name, arg))
+		elif etype == TYPE_COUNTER:
+			ev.update(ph='C', args={name: signed(arg)})
+		else:
+			continue
+		events.append(ev)
+
+	# Close what was still running when the dump was taken
+	end = events[-1]['ts'] if events else 0
+	while stack:
+		eid, _ = stack.pop()
+		events.append({'name': names.get(eid, 'event_%d' % eid),
+			       'ph': 'E', 'ts': end, 'pid': 0, 'tid': 0,
+			       'args': {'unfinished': True}})
+
+	with open(args.output, 'w') as f:
+		json.dump({'traceEvents': events, 'displayTimeUnit': 'ns'}, f)
+
+	print('%d events written to %s' % (len(events), args.output),
+	      file=sys.stderr)
+	if args.summary:
+		print('%-32s %8s %14s %12s' % ('event', 'count', 'total us',
+						'max us'))
+		for name, (cnt, total, mx) in sorted(stats.items(),
+						     key=lambda s: -s[1][1]):
+			print('%-32s %8d %14.1f %12.1f' % (name, cnt, total, mx))
+
+if __name__ == '__main__':
+	main()
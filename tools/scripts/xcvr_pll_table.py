@@ -0,0 +1,113 @@
+#!/bin/python
+
+import argparse
+import sys
+
+description_help='''Generate the table of precomputed Xilinx transceiver PLL
+solutions used by drivers/axi_core/jesd204/xilinx_transceiver.c.
+The solver below mirrors xilinx_xcvr_calc_cpll_config() and
+xilinx_xcvr_calc_qpll_config(), so a table hit returns exactly what the
+driver would compute at run time. Keep them in sync.
+Examples:\n
+	Regenerate the table shipped with the driver
+	>python xcvr_pll_table.py drivers/axi_core/jesd204/xilinx_transceiver_pll_table.h
+	Add a reference clock and a lane rate (kHz)
+	>python xcvr_pll_table.py out.h -r 184320 -l 7372800
+'''
+
+# Reference clocks and lane rates (kHz) used by the no-OS JESD204 projects
+REFCLKS = [122880, 125000, 153600, 184320, 200000, 245760, 250000, 307200,
+	   368640, 491520, 500000, 616500, 625000, 750000]
+LANE_RATES = [1228800, 2457600, 2500000, 3072000, 4000000, 4915200, 5000000,
+	      6144000, 6250000, 7372800, 9830400, 10000000, 12288000,
+	      12330000, 15000000]
+
+# (name, gtx2 flag, CPLL VCO limits)
+CPLL_VARIANTS = [
+	('GTX2', 1, 1600000, 3300000),
+	('GTH/GTY', 0, 2000000, 6250000),
+	('GTH/GTY low voltage/-1', 0, 2000000, 4250000),
+]
+
+QPLL_N_GTX2 = [16, 20, 32, 40, 64, 66, 80, 100]
+QPLL_N_GTH34 = [16, 20, 32, 40, 64, 66, 75, 80, 100, 112, 120, 125, 150, 160]
+
+# (name, gtx2 flag, N values, vco0 min/max, vco1 min/max)
+QPLL_VARIANTS = [
+	('GTX2', 1, QPLL_N_GTX2, 5930000, 8000000, 9800000, 12500000),
+	('GTH/GTY', 0, QPLL_N_GTH34, 9800000, 16375000, 8000000, 13000000),
+]
+
+def parse_input():
+	parser = argparse.ArgumentParser(description=description_help,\
+				formatter_class=argparse.RawTextHelpFormatter)
+	parser.add_argument('output', help='Output C header')
+	parser.add_argument('-r', dest='refclks', type=int, action='append',
+			default=[], help='Additional reference clock (kHz)')
+	parser.add_argument('-l', dest='lane_rates', type=int, action='append',
+			default=[], help='Additional lane rate (kHz)')
+	return parser.parse_args()
+
+def solve_cpll(refclk, lane_rate, vco_min, vco_max):
+	for m in range(1, 3):
+		for d in [1, 2, 4, 8]:
+			for n1 in [5, 4]:
+				for n2 in [5, 4, 3, 2, 1]:
+					vco = (refclk * n1 * n2) // m
+					if vco > vco_max or vco < vco_min:
+						continue
+					if refclk // m // d == lane_rate // (2 * n1 * n2):
+						return (m, 0, n1, n2, 0, d)
+	return None
+
+def solve_qpll(refclk, lane_rate, N, vco0_min, vco0_max, vco1_min, vco1_max):
+	for m in range(1, 5):
+		for d in [1, 2, 4, 8, 16]:
+			for n in N:
+				vco = (refclk * n) // m
+				if vco >= vco1_min and vco <= vco1_max:
+					band = 1
+				elif vco >= vco0_min and vco <= vco0_max:
+					band = 0
+				else:
+					continue
+				if refclk // m // d == lane_rate // n:
+					return (m, n, 0, 0, band, d)
+	return None
+
+def main():
+	args = parse_input()
+	refclks = sorted(set(REFCLKS + args.refclks))
+	lane_rates = sorted(set(LANE_RATES + args.lane_rates))
+	rows = []
+
+	for refclk in refclks:
+		for lane_rate in lane_rates:
+			for name, gtx2, vco_min, vco_max in CPLL_VARIANTS:
+				sol = solve_cpll(refclk, lane_rate, vco_min, vco_max)
+				if sol:
+					rows.append((refclk, lane_rate, vco_max, gtx2, 0) + sol)
+			for name, gtx2, N, v0min, v0max, v1min, v1max in QPLL_VARIANTS:
+				sol = solve_qpll(refclk, lane_rate, N, v0min, v0max,
+						 v1min, v1max)
+				if sol:
+					rows.append((refclk, lane_rate, 0, gtx2, 1) + sol)
+
+	with open(args.output, 'w') as f:
+		f.write('/* Generated by tools/scripts/xcvr_pll_table.py, do not edit. */\n')
+		f.write('#ifndef XILINX_TRANSCEIVER_PLL_TABLE_H_\n')
+		f.write('#define XILINX_TRANSCEIVER_PLL_TABLE_H_\n\n')
+		f.write('#include "xilinx_transceiver.h"\n\n')
+		f.write('/* refclk_khz, lane_rate_khz, vco_max, gtx2, qpll, refclk_div, '
+			'fb_div, fb_div_N1, fb_div_N2, band, out_div */\n')
+		f.write('static const struct xilinx_xcvr_pll_solution '
+			'xilinx_xcvr_pll_table[] = {\n')
+		for r in rows:
+			f.write('\t{%s},\n' % ', '.join(str(v) for v in r))
+		f.write('};\n\n#endif\n')
+
+	print('%d solutions written to %s' % (len(rows), args.output),
+	      file=sys.stderr)
+
+if __name__ == '__main__':
+	main()
@@ -186,6 +186,7 @@ static int32_t cb_prepare_async_operation(struct circular_buffer *desc,
 	if (is_read) {
 		ret = cb_size(desc, &available_size);
 		if (ret == -EOVERRUN) {
+			desc->overruns++;
 			/* Update read index */
 			desc->read.spin_count = desc->write.spin_count - 1;
 			desc->read.idx = desc->write.idx;
@@ -40,41 +40,130 @@
 /******************************************************************************/
 /***************************** Include Files **********************************/
 /******************************************************************************/
+#include <stddef.h>
 #include "no-os/error.h"
 #include "no-os/clk.h"
+#include "no-os/util.h"
 
 /******************************************************************************/
 /************************** Functions Implementation **************************/
 /******************************************************************************/
 
 /**
- * Start the clock.
+ * Reset the framework state of the clock and attach it to a parent.
+ * Parents must be registered before their children.
+ * @param clk - The clock structure, hw, hw_ch_num and name already set.
+ * @param parent - The clock this one is derived from, NULL for a root clock.
+ * @param flags - CLK_* flags.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t clk_register(struct clk *clk,
+		     struct clk *parent,
+		     uint32_t flags)
+{
+	if (!clk)
+		return -EINVAL;
+
+	clk->flags = flags & (CLK_CACHE_RATE | CLK_SET_RATE_PARENT |
+			      CLK_ENABLE_REFCOUNT);
+	clk->parent = parent;
+	clk->child = NULL;
+	clk->sibling = NULL;
+	clk->rate = 0;
+	clk->req_rate = 0;
+	clk->enable_count = 0;
+
+	if (parent) {
+		clk->sibling = parent->child;
+		parent->child = clk;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * Start the clock. With CLK_ENABLE_REFCOUNT the parent is started first and
+ * only the first call reaches the provider, a clock without an enable op is
+ * then considered always on.
  * @param clk - The clock structure.
  * @return SUCCESS in case of success, negative error code otherwise.
  */
 int32_t clk_enable(struct clk * clk)
 {
-	if (clk->hw->dev_clk_enable)
-		return clk->hw->dev_clk_enable(clk->hw->dev);
-	else
+	int32_t ret;
+
+	if (!(clk->flags & CLK_ENABLE_REFCOUNT)) {
+		if (clk->hw && clk->hw->dev_clk_enable)
+			return clk->hw->dev_clk_enable(clk->hw->dev);
+
 		return FAILURE;
+	}
+
+	if (clk->enable_count++)
+		return SUCCESS;
+
+	if (clk->parent) {
+		ret = clk_enable(clk->parent);
+		if (ret)
+			goto error;
+	}
+
+	if (clk->hw && clk->hw->dev_clk_enable) {
+		ret = clk->hw->dev_clk_enable(clk->hw->dev);
+		if (ret) {
+			if (clk->parent)
+				clk_disable(clk->parent);
+			goto error;
+		}
+	}
+
+	return SUCCESS;
+
+error:
+	clk->enable_count--;
+
+	return ret;
 }
 
 /**
- * Stop the clock.
+ * Stop the clock. With CLK_ENABLE_REFCOUNT the provider is reached when the
+ * last user is gone and the parent is stopped afterwards. An unbalanced call
+ * is still forwarded to the provider.
  * @param clk - The clock structure.
  * @return SUCCESS in case of success, negative error code otherwise.
  */
 int32_t clk_disable(struct clk * clk)
 {
-	if (clk->hw->dev_clk_disable)
-		return clk->hw->dev_clk_disable(clk->hw->dev);
-	else
+	int32_t ret = SUCCESS;
+
+	if (!(clk->flags & CLK_ENABLE_REFCOUNT)) {
+		if (clk->hw && clk->hw->dev_clk_disable)
+			return clk->hw->dev_clk_disable(clk->hw->dev);
+
 		return FAILURE;
+	}
+
+	if (clk->enable_count > 1) {
+		clk->enable_count--;
+		return SUCCESS;
+	}
+
+	if (clk->hw && clk->hw->dev_clk_disable)
+		ret = clk->hw->dev_clk_disable(clk->hw->dev);
+
+	if (clk->enable_count) {
+		clk->enable_count = 0;
+		if (clk->parent)
+			clk_disable(clk->parent);
+	}
+
+	return ret;
 }
 
 /**
- * Get the current frequency of the clock.
+ * Get the current frequency of the clock. With CLK_CACHE_RATE the rate is
+ * cached until the clock or one of its parents is reprogrammed. A clock
+ * without a recalc_rate op runs at the rate of its parent.
  * @param clk - The clock structure.
  * @param rate - The current frequency.
  * @return SUCCESS in case of success, negative error code otherwise.
@@ -82,12 +171,29 @@ int32_t clk_disable(struct clk * clk)
 int32_t clk_recalc_rate(struct clk *clk,
 			uint64_t *rate)
 {
-	if (clk->hw->dev_clk_recalc_rate)
-		return clk->hw->dev_clk_recalc_rate(clk->hw->dev,
-						    clk->hw_ch_num,
-						    rate);
+	uint64_t new_rate;
+	int32_t ret;
+
+	if (clk->rate && (clk->flags & CLK_CACHE_RATE)) {
+		*rate = clk->rate;
+		return SUCCESS;
+	}
+
+	if (clk->hw && clk->hw->dev_clk_recalc_rate)
+		ret = clk->hw->dev_clk_recalc_rate(clk->hw->dev,
+						   clk->hw_ch_num,
+						   &new_rate);
+	else if (clk->parent)
+		ret = clk_recalc_rate(clk->parent, &new_rate);
 	else
 		return FAILURE;
+	if (ret)
+		return ret;
+
+	clk->rate = new_rate;
+	*rate = new_rate;
+
+	return SUCCESS;
 }
 
 /**
@@ -101,15 +207,185 @@ int32_t clk_round_rate(struct clk *clk,
 		       uint64_t rate,
 		       uint64_t *rounded_rate)
 {
-	if (clk->hw->dev_clk_round_rate)
+	if (clk->hw && clk->hw->dev_clk_round_rate)
 		return clk->hw->dev_clk_round_rate(clk->hw->dev,
 						   clk->hw_ch_num,
 						   rate,
 						   rounded_rate);
+	else if (clk->parent && (clk->flags & CLK_SET_RATE_PARENT))
+		return clk_round_rate(clk->parent, rate, rounded_rate);
 	else
 		return FAILURE;
 }
 
+/**
+ * Drop the cached rate of the clock and of everything derived from it.
+ * @param clk - The clock structure.
+ */
+void clk_invalidate_rate(struct clk *clk)
+{
+	struct clk *child;
+
+	clk->rate = 0;
+	clk->flags &= ~CLK_RATE_APPLIED;
+
+	for (child = clk->child; child; child = child->sibling)
+		clk_invalidate_rate(child);
+}
+
+/**
+ * Clock that actually handles a rate change requested on clk.
+ * @param clk - The clock structure.
+ * @return The clock or NULL if no clock in the chain can change its rate.
+ */
+static struct clk *clk_rate_target(struct clk *clk)
+{
+	while (clk) {
+		if (clk->hw && clk->hw->dev_clk_set_rate)
+			return clk;
+		if (!(clk->flags & CLK_SET_RATE_PARENT))
+			return NULL;
+		clk = clk->parent;
+	}
+
+	return NULL;
+}
+
+static int32_t clk_apply_rate(struct clk *clk);
+
+/**
+ * The parent of clk changed: drop cached rates and reprogram the clocks below
+ * it that have a requested rate.
+ * @param clk - The clock structure.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t clk_propagate_rate(struct clk *clk)
+{
+	struct clk *child;
+	int32_t ret;
+
+	clk->rate = 0;
+	clk->flags &= ~CLK_RATE_APPLIED;
+
+	if (clk->req_rate && clk->hw && clk->hw->dev_clk_set_rate)
+		return clk_apply_rate(clk);
+
+	for (child = clk->child; child; child = child->sibling) {
+		ret = clk_propagate_rate(child);
+		if (ret)
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * Program the requested rate of the clock, then propagate the change down.
+ * The provider is skipped only for a CLK_CACHE_RATE clock that already runs
+ * at the requested rate.
+ * @param clk - The clock structure.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t clk_apply_rate(struct clk *clk)
+{
+	struct clk *child;
+	int32_t ret;
+
+	clk->flags &= ~CLK_RATE_PENDING;
+
+	if ((clk->flags & CLK_CACHE_RATE) && (clk->flags & CLK_RATE_APPLIED))
+		return SUCCESS;
+
+	ret = clk->hw->dev_clk_set_rate(clk->hw->dev,
+					clk->hw_ch_num,
+					clk->req_rate);
+	if (ret)
+		return ret;
+
+	clk->rate = 0;
+	clk->flags |= CLK_RATE_APPLIED;
+
+	for (child = clk->child; child; child = child->sibling) {
+		ret = clk_propagate_rate(child);
+		if (ret)
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * Depth of the clock in the tree, 0 for a root clock.
+ * @param clk - The clock structure.
+ * @return The depth.
+ */
+static uint32_t clk_depth(struct clk *clk)
+{
+	uint32_t depth = 0;
+
+	while (clk->parent) {
+		clk = clk->parent;
+		depth++;
+	}
+
+	return depth;
+}
+
+/**
+ * Change the frequency of several clocks at once. The providers are
+ * reprogrammed top-down, each one at most once, and clocks derived from a
+ * reprogrammed clock get their requested rate re-applied. A request for the
+ * rate already programmed is a no-op for CLK_CACHE_RATE clocks only.
+ * @param req - The rate requests.
+ * @param count - Number of requests.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t clk_set_rates(struct clk_rate_request *req,
+		      uint32_t count)
+{
+	struct clk *target;
+	uint32_t depth, max_depth = 0;
+	uint32_t i;
+	int32_t ret;
+
+	for (i = 0; i < count; i++) {
+		if (!req[i].clk)
+			return -EINVAL;
+
+		target = clk_rate_target(req[i].clk);
+		if (!target)
+			return FAILURE;
+
+		if (target->req_rate != req[i].rate)
+			target->flags &= ~CLK_RATE_APPLIED;
+		target->req_rate = req[i].rate;
+		target->flags |= CLK_RATE_PENDING;
+
+		max_depth = max(max_depth, clk_depth(target));
+	}
+
+	for (depth = 0; depth <= max_depth; depth++) {
+		for (i = 0; i < count; i++) {
+			target = clk_rate_target(req[i].clk);
+			if (!(target->flags & CLK_RATE_PENDING) ||
+			    clk_depth(target) != depth)
+				continue;
+
+			ret = clk_apply_rate(target);
+			if (ret)
+				goto error;
+		}
+	}
+
+	return SUCCESS;
+
+error:
+	for (i = 0; i < count; i++)
+		clk_rate_target(req[i].clk)->flags &= ~CLK_RATE_PENDING;
+
+	return ret;
+}
+
 /**
  * Change the frequency of the clock.
  * @param clk - The clock structure.
@@ -119,10 +395,10 @@ int32_t clk_round_rate(struct clk *clk,
 int32_t clk_set_rate(struct clk *clk,
 		     uint64_t rate)
 {
-	if (clk->hw->dev_clk_set_rate)
-		return clk->hw->dev_clk_set_rate(clk->hw->dev,
-						 clk->hw_ch_num,
-						 rate);
-	else
-		return FAILURE;
+	struct clk_rate_request req = {
+		.clk = clk,
+		.rate = rate,
+	};
+
+	return clk_set_rates(&req, 1);
 }
@@ -0,0 +1,177 @@
+/***************************************************************************//**
+ *   @file   delay_acct.c
+ *   @brief  Accounting of the delays requested per call site.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "no-os/delay.h"
+
+/* The accounting calls the platform delays */
+#undef udelay
+#undef mdelay
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+
+static struct delay_acct acct;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Add a delay to the total and to its call site.
+ * @param usecs - Requested delay in microseconds.
+ * @param func - Calling function.
+ * @param line - Line of the call.
+ */
+static void delay_acct_add(uint64_t usecs, const char *func, uint32_t line)
+{
+	struct delay_acct_site *site;
+	uint32_t i;
+
+	acct.total_us += usecs;
+	acct.count++;
+
+	for (i = 0; i < acct.nb_sites; i++) {
+		site = &acct.sites[i];
+		if (site->line == line && site->func == func)
+			break;
+	}
+
+	if (i == acct.nb_sites) {
+		if (i == DELAY_ACCT_SITES) {
+			acct.untracked++;
+			return;
+		}
+		site = &acct.sites[i];
+		site->func = func;
+		site->line = line;
+		acct.nb_sites++;
+	}
+
+	site->count++;
+	site->total_us += usecs;
+}
+
+/**
+ * @brief Account and generate microseconds delay.
+ * @param usecs - Delay in microseconds.
+ * @param func - Calling function.
+ * @param line - Line of the call.
+ */
+void delay_acct_udelay(uint32_t usecs, const char *func, uint32_t line)
+{
+	delay_acct_add(usecs, func, line);
+	udelay(usecs);
+}
+
+/**
+ * @brief Account and generate miliseconds delay.
+ * @param msecs - Delay in miliseconds.
+ * @param func - Calling function.
+ * @param line - Line of the call.
+ */
+void delay_acct_mdelay(uint32_t msecs, const char *func, uint32_t line)
+{
+	delay_acct_add((uint64_t)msecs * 1000, func, line);
+	mdelay(msecs);
+}
+
+/**
+ * @brief Get the delay accounting state. The call sites are in the order of
+ * their first delay, or sorted by delay_acct_print().
+ * @return The delay accounting state.
+ */
+const struct delay_acct *delay_acct_get(void)
+{
+	return &acct;
+}
+
+/**
+ * @brief Clear the totals and the call sites.
+ */
+void delay_acct_reset(void)
+{
+	memset(&acct, 0, sizeof(acct));
+}
+
+/**
+ * @brief Order the call sites by decreasing total delay.
+ */
+static int delay_acct_cmp(const void *a, const void *b)
+{
+	const struct delay_acct_site *sa = a;
+	const struct delay_acct_site *sb = b;
+
+	if (sa->total_us == sb->total_us)
+		return 0;
+
+	return sa->total_us < sb->total_us ? 1 : -1;
+}
+
+/**
+ * @brief Print the total delay and the delay of each call site, longest
+ * first.
+ */
+void delay_acct_print(void)
+{
+	struct delay_acct_site *site;
+	uint32_t i;
+
+	qsort(acct.sites, acct.nb_sites, sizeof(*site),
+	      delay_acct_cmp);
+
+	printf("delay: %"PRIu64" us in %"PRIu32" calls\n", acct.total_us,
+	       acct.count);
+	for (i = 0; i < acct.nb_sites; i++) {
+		site = &acct.sites[i];
+		printf("%12"PRIu64" us %8"PRIu32" calls  %s:%"PRIu32"\n",
+		       site->total_us, site->count, site->func, site->line);
+	}
+	if (acct.untracked)
+		printf("%"PRIu32" calls from untracked call sites\n",
+		       acct.untracked);
+}
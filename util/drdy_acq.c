@@ -0,0 +1,312 @@
+/***************************************************************************//**
+ *   @file   drdy_acq.c
+ *   @brief  Data-ready driven acquisition helper.
+ *           Samples are read on the DRDY/BUSY edge instead of polling the pin.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include "no-os/drdy_acq.h"
+#include "no-os/error.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Read one sample from the device and push it in the ring.
+ * @param desc - The acquisition descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t drdy_acq_fetch(struct drdy_acq_desc *desc)
+{
+	uint32_t size;
+	int32_t ret;
+
+	ret = desc->read_sample(desc->dev, desc->sample);
+	if (IS_ERR_VALUE(ret)) {
+		desc->errors++;
+		return ret;
+	}
+
+	if (desc->trigger && desc->running) {
+		ret = desc->trigger(desc->dev);
+		if (IS_ERR_VALUE(ret))
+			desc->errors++;
+	}
+
+	/* Drop the newest sample instead of overwriting unread data */
+	ret = cb_size(desc->ring, &size);
+	if (ret == -EOVERRUN || size + desc->sample_size > desc->ring->size) {
+		desc->overruns++;
+		return -EOVERRUN;
+	}
+
+	return cb_write(desc->ring, desc->sample, desc->sample_size);
+}
+
+/**
+ * @brief DRDY/BUSY interrupt handler.
+ * @param ctx - The acquisition descriptor.
+ * @param event - Unused.
+ * @param extra - Unused.
+ */
+static void drdy_acq_irq_handler(void *ctx, uint32_t event, void *extra)
+{
+	struct drdy_acq_desc *desc = ctx;
+
+	if (!desc->running)
+		return;
+
+	if (!desc->deferred) {
+		drdy_acq_fetch(desc);
+		return;
+	}
+
+	if (desc->pending)
+		desc->overruns++;
+	else
+		desc->pending = 1;
+}
+
+/**
+ * @brief Initialize the acquisition.
+ * @param desc - The acquisition descriptor.
+ * @param param - The structure that contains the acquisition parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t drdy_acq_init(struct drdy_acq_desc **desc,
+		      const struct drdy_acq_init_param *param)
+{
+	struct drdy_acq_desc *ldesc;
+	int32_t ret;
+
+	if (!desc || !param || !param->irq_ctrl || !param->read_sample ||
+	    !param->sample_size || !param->nb_samples)
+		return -EINVAL;
+
+	ldesc = calloc(1, sizeof(*ldesc));
+	if (!ldesc)
+		return -ENOMEM;
+
+	ldesc->sample = calloc(1, param->sample_size);
+	if (!ldesc->sample) {
+		ret = -ENOMEM;
+		goto error_desc;
+	}
+
+	ret = cb_init(&ldesc->ring, param->sample_size * param->nb_samples);
+	if (IS_ERR_VALUE(ret))
+		goto error_sample;
+
+	ldesc->irq_ctrl = param->irq_ctrl;
+	ldesc->irq_id = param->irq_id;
+	ldesc->trig = param->trig;
+	ldesc->sample_size = param->sample_size;
+	ldesc->deferred = param->deferred;
+	ldesc->dev = param->dev;
+	ldesc->read_sample = param->read_sample;
+	ldesc->trigger = param->trigger;
+
+	*desc = ldesc;
+
+	return SUCCESS;
+
+error_sample:
+	free(ldesc->sample);
+error_desc:
+	free(ldesc);
+
+	return ret;
+}
+
+/**
+ * @brief Free the resources allocated by drdy_acq_init().
+ * @param desc - The acquisition descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t drdy_acq_remove(struct drdy_acq_desc *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	if (desc->running)
+		drdy_acq_stop(desc);
+
+	cb_remove(desc->ring);
+	free(desc->sample);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Enable the DRDY interrupt and start the acquisition.
+ * @param desc - The acquisition descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t drdy_acq_start(struct drdy_acq_desc *desc)
+{
+	struct callback_desc callback;
+	int32_t ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	callback.callback = drdy_acq_irq_handler;
+	callback.ctx = desc;
+	callback.config = NULL;
+
+	ret = irq_register_callback(desc->irq_ctrl, desc->irq_id, &callback);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	ret = irq_trigger_level_set(desc->irq_ctrl, desc->irq_id, desc->trig);
+	if (IS_ERR_VALUE(ret))
+		goto error_unregister;
+
+	desc->pending = 0;
+	desc->running = true;
+
+	ret = irq_enable(desc->irq_ctrl, desc->irq_id);
+	if (IS_ERR_VALUE(ret))
+		goto error_running;
+
+	if (desc->trigger) {
+		ret = desc->trigger(desc->dev);
+		if (IS_ERR_VALUE(ret))
+			goto error_disable;
+	}
+
+	return SUCCESS;
+
+error_disable:
+	irq_disable(desc->irq_ctrl, desc->irq_id);
+error_running:
+	desc->running = false;
+error_unregister:
+	irq_unregister(desc->irq_ctrl, desc->irq_id);
+
+	return ret;
+}
+
+/**
+ * @brief Disable the DRDY interrupt.
+ * @param desc - The acquisition descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t drdy_acq_stop(struct drdy_acq_desc *desc)
+{
+	int32_t ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	desc->running = false;
+
+	ret = irq_disable(desc->irq_ctrl, desc->irq_id);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	return irq_unregister(desc->irq_ctrl, desc->irq_id);
+}
+
+/**
+ * @brief Read the pending sample in deferred mode. Must be called from the
+ * main loop often enough to keep up with the data rate.
+ * @param desc - The acquisition descriptor.
+ * @return SUCCESS if a sample was read, -EAGAIN if no sample is pending,
+ *         negative error code otherwise.
+ */
+int32_t drdy_acq_process(struct drdy_acq_desc *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	if (!desc->pending)
+		return -EAGAIN;
+
+	desc->pending = 0;
+
+	return drdy_acq_fetch(desc);
+}
+
+/**
+ * @brief Get the number of samples available in the ring.
+ * @param desc - The acquisition descriptor.
+ * @param nb_samples - Number of complete samples available.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t drdy_acq_available(struct drdy_acq_desc *desc, uint32_t *nb_samples)
+{
+	uint32_t size;
+	int32_t ret;
+
+	if (!desc || !nb_samples)
+		return -EINVAL;
+
+	ret = cb_size(desc->ring, &size);
+	*nb_samples = size / desc->sample_size;
+
+	return ret;
+}
+
+/**
+ * @brief Copy samples from the ring.
+ * @param desc - The acquisition descriptor.
+ * @param data - Destination buffer, nb_samples * sample_size bytes.
+ * @param nb_samples - Number of samples to be copied.
+ * @return SUCCESS in case of success, -EAGAIN if not enough samples are
+ *         available, negative error code otherwise.
+ */
+int32_t drdy_acq_read(struct drdy_acq_desc *desc, void *data,
+		      uint32_t nb_samples)
+{
+	uint32_t available;
+	int32_t ret;
+
+	ret = drdy_acq_available(desc, &available);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	if (available < nb_samples)
+		return -EAGAIN;
+
+	return cb_read(desc->ring, data, nb_samples * desc->sample_size);
+}
@@ -0,0 +1,407 @@
+/***************************************************************************//**
+ *   @file   fw_image.c
+ *   @brief  Firmware image container and streaming decoder.
+ *           Images are decoded chunk by chunk so they can be uploaded without
+ *           holding the whole decoded blob in RAM.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "no-os/fw_image.h"
+#include "no-os/error.h"
+#include "no-os/util.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Get the next byte of the container.
+ * @param img - The image descriptor.
+ * @param byte - The byte.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t fw_image_get_byte(struct fw_image *img, uint8_t *byte)
+{
+	int32_t ret;
+
+	if (img->mem) {
+		if (img->mem_pos >= img->mem_size)
+			return -EIO;
+		*byte = img->mem[img->mem_pos++];
+
+		return SUCCESS;
+	}
+
+	if (img->in_pos == img->in_len) {
+		ret = img->reader.read(img->reader.ctx, img->in_buff,
+				       FW_IMAGE_READ_BUFF_SIZE);
+		if (ret <= 0)
+			return ret ? ret : -EIO;
+		img->in_len = ret;
+		img->in_pos = 0;
+	}
+	*byte = img->in_buff[img->in_pos++];
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the next bits of the LZSS stream, MSB first.
+ * @param img - The image descriptor.
+ * @param count - Number of bits, at most 16.
+ * @param val - The value.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t fw_image_get_bits(struct fw_image *img, uint8_t count,
+				 uint16_t *val)
+{
+	int32_t ret;
+
+	*val = 0;
+	while (count--) {
+		if (!img->bit_mask) {
+			ret = fw_image_get_byte(img, &img->bit_buff);
+			if (IS_ERR_VALUE(ret))
+				return ret;
+			img->bit_mask = 0x80;
+		}
+		*val <<= 1;
+		if (img->bit_buff & img->bit_mask)
+			*val |= 1;
+		img->bit_mask >>= 1;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Parse the container header.
+ * @param img - The image descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t fw_image_parse_header(struct fw_image *img)
+{
+	uint8_t hdr[FW_IMAGE_HEADER_SIZE];
+	uint32_t i;
+	int32_t ret;
+
+	for (i = 0; i < FW_IMAGE_HEADER_SIZE; i++) {
+		ret = fw_image_get_byte(img, &hdr[i]);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	if (get_unaligned_le32(&hdr[0]) != FW_IMAGE_MAGIC ||
+	    hdr[4] != FW_IMAGE_VERSION)
+		return -EINVAL;
+
+	img->codec = hdr[5];
+	img->window_sz2 = hdr[6];
+	img->lookahead_sz2 = hdr[7];
+	img->size = get_unaligned_le32(&hdr[8]);
+
+	switch (img->codec) {
+	case FW_IMAGE_CODEC_RAW:
+		return SUCCESS;
+	case FW_IMAGE_CODEC_LZSS:
+		if (!img->window_sz2 || img->window_sz2 > FW_IMAGE_MAX_WINDOW_SZ2 ||
+		    !img->lookahead_sz2 || img->lookahead_sz2 >= img->window_sz2)
+			return -EINVAL;
+
+		img->window = calloc(1, 1 << img->window_sz2);
+		if (!img->window)
+			return -ENOMEM;
+
+		return SUCCESS;
+	default:
+		return -ENOTSUP;
+	}
+}
+
+/**
+ * @brief Open an image stored in memory. data may be a container produced by
+ * tools/scripts/fw_image.py or a plain, headerless blob.
+ * @param img - The image descriptor.
+ * @param data - Start of the image (e.g. a const array or an mmapped file).
+ * @param size - Number of bytes available at data.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t fw_image_init_mem(struct fw_image **img, const uint8_t *data,
+			  uint32_t size)
+{
+	struct fw_image *image;
+	int32_t ret;
+
+	if (!img || !data)
+		return -EINVAL;
+
+	image = calloc(1, sizeof(*image));
+	if (!image)
+		return -ENOMEM;
+
+	image->mem = data;
+	image->mem_size = size;
+
+	if (size >= FW_IMAGE_HEADER_SIZE &&
+	    get_unaligned_le32((uint8_t *)data) == FW_IMAGE_MAGIC) {
+		ret = fw_image_parse_header(image);
+		if (IS_ERR_VALUE(ret)) {
+			free(image);
+			return ret;
+		}
+	} else {
+		image->codec = FW_IMAGE_CODEC_RAW;
+		image->size = size;
+	}
+
+	image->mem_start = image->mem_pos;
+	*img = image;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Open an image fetched through reader callbacks. The data must be a
+ * container produced by tools/scripts/fw_image.py.
+ * @param img - The image descriptor.
+ * @param reader - The reader callbacks.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t fw_image_init_reader(struct fw_image **img,
+			     const struct fw_image_reader *reader)
+{
+	struct fw_image *image;
+	int32_t ret;
+
+	if (!img || !reader || !reader->read)
+		return -EINVAL;
+
+	image = calloc(1, sizeof(*image));
+	if (!image)
+		return -ENOMEM;
+
+	image->in_buff = malloc(FW_IMAGE_READ_BUFF_SIZE);
+	if (!image->in_buff) {
+		ret = -ENOMEM;
+		goto error_image;
+	}
+
+	image->reader = *reader;
+
+	ret = fw_image_parse_header(image);
+	if (IS_ERR_VALUE(ret))
+		goto error_buff;
+
+	*img = image;
+
+	return SUCCESS;
+
+error_buff:
+	free(image->in_buff);
+error_image:
+	free(image);
+
+	return ret;
+}
+
+/**
+ * @brief Free the resources allocated by fw_image_init_*().
+ * @param img - The image descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t fw_image_remove(struct fw_image *img)
+{
+	if (!img)
+		return -EINVAL;
+
+	free(img->window);
+	free(img->in_buff);
+	free(img);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Decode the LZSS payload.
+ * @param img - The image descriptor.
+ * @param buf - Destination buffer.
+ * @param len - Number of bytes to decode.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t fw_image_lzss_read(struct fw_image *img, uint8_t *buf,
+				  uint32_t len)
+{
+	uint32_t mask = (1 << img->window_sz2) - 1;
+	uint16_t val;
+	uint8_t byte;
+	int32_t ret;
+
+	while (len) {
+		if (img->br_count) {
+			byte = img->window[(img->window_pos - img->br_offset) & mask];
+			img->br_count--;
+		} else {
+			ret = fw_image_get_bits(img, 1, &val);
+			if (IS_ERR_VALUE(ret))
+				return ret;
+
+			if (!val) {
+				ret = fw_image_get_bits(img, img->window_sz2, &val);
+				if (IS_ERR_VALUE(ret))
+					return ret;
+				img->br_offset = val + 1;
+
+				ret = fw_image_get_bits(img, img->lookahead_sz2, &val);
+				if (IS_ERR_VALUE(ret))
+					return ret;
+				img->br_count = val + 1;
+
+				continue;
+			}
+
+			ret = fw_image_get_bits(img, 8, &val);
+			if (IS_ERR_VALUE(ret))
+				return ret;
+			byte = val;
+		}
+
+		img->window[img->window_pos++ & mask] = byte;
+		*buf++ = byte;
+		len--;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Decode the next bytes of the image.
+ * @param img - The image descriptor.
+ * @param buf - Destination buffer.
+ * @param len - Maximum number of bytes to decode.
+ * @return Number of bytes decoded (0 at the end of the image), negative error
+ *         code otherwise.
+ */
+int32_t fw_image_read(struct fw_image *img, uint8_t *buf, uint32_t len)
+{
+	uint32_t i;
+	int32_t ret;
+
+	if (!img || !buf)
+		return -EINVAL;
+
+	len = min(len, img->size - img->pos);
+	if (!len)
+		return 0;
+
+	if (img->codec == FW_IMAGE_CODEC_LZSS) {
+		ret = fw_image_lzss_read(img, buf, len);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	} else if (img->mem) {
+		if (img->mem_pos + len > img->mem_size)
+			return -EIO;
+		memcpy(buf, img->mem + img->mem_pos, len);
+		img->mem_pos += len;
+	} else {
+		for (i = 0; i < len; i++) {
+			ret = fw_image_get_byte(img, &buf[i]);
+			if (IS_ERR_VALUE(ret))
+				return ret;
+		}
+	}
+
+	img->pos += len;
+
+	return len;
+}
+
+/**
+ * @brief Restart decoding from the beginning of the image.
+ * @param img - The image descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t fw_image_rewind(struct fw_image *img)
+{
+	uint32_t i;
+	uint8_t byte;
+	int32_t ret;
+
+	if (!img)
+		return -EINVAL;
+
+	img->pos = 0;
+	img->window_pos = 0;
+	img->bit_mask = 0;
+	img->br_count = 0;
+
+	if (img->mem) {
+		img->mem_pos = img->mem_start;
+
+		return SUCCESS;
+	}
+
+	if (!img->reader.rewind)
+		return -ENOTSUP;
+
+	ret = img->reader.rewind(img->reader.ctx);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	img->in_len = 0;
+	img->in_pos = 0;
+	for (i = 0; i < FW_IMAGE_HEADER_SIZE; i++) {
+		ret = fw_image_get_byte(img, &byte);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Decoded image size.
+ * @param img - The image descriptor.
+ * @return Size in bytes.
+ */
+uint32_t fw_image_size(struct fw_image *img)
+{
+	return img ? img->size : 0;
+}
@@ -0,0 +1,557 @@
+/***************************************************************************//**
+ *   @file   interleave.c
+ *   @brief  Channel interleave and sample format conversion kernels.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <string.h>
+#include "no-os/interleave.h"
+#include "no-os/error.h"
+#include "no-os/util.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/* Generic kernels, for any number of channels */
+static void interleave16_n(void *dst, const void * const *src, uint32_t nb_ch,
+			   uint32_t samples)
+{
+	const uint16_t * const *s = (const uint16_t * const *)src;
+	uint16_t *d = dst;
+	uint32_t i, j;
+
+	for (i = 0; i < samples; i++)
+		for (j = 0; j < nb_ch; j++)
+			*d++ = s[j][i];
+}
+
+static void deinterleave16_n(void * const *dst, const void *src,
+			     uint32_t nb_ch, uint32_t samples)
+{
+	uint16_t * const *d = (uint16_t * const *)dst;
+	const uint16_t *s = src;
+	uint32_t i, j;
+
+	for (i = 0; i < samples; i++)
+		for (j = 0; j < nb_ch; j++)
+			d[j][i] = *s++;
+}
+
+static void interleave32_n(void *dst, const void * const *src, uint32_t nb_ch,
+			   uint32_t samples)
+{
+	const uint32_t * const *s = (const uint32_t * const *)src;
+	uint32_t *d = dst;
+	uint32_t i, j;
+
+	for (i = 0; i < samples; i++)
+		for (j = 0; j < nb_ch; j++)
+			*d++ = s[j][i];
+}
+
+static void deinterleave32_n(void * const *dst, const void *src,
+			     uint32_t nb_ch, uint32_t samples)
+{
+	uint32_t * const *d = (uint32_t * const *)dst;
+	const uint32_t *s = src;
+	uint32_t i, j;
+
+	for (i = 0; i < samples; i++)
+		for (j = 0; j < nb_ch; j++)
+			d[j][i] = *s++;
+}
+
+/* A single channel is a plain copy */
+static void interleave16_1(void *dst, const void * const *src, uint32_t nb_ch,
+			   uint32_t samples)
+{
+	memcpy(dst, src[0], samples * 2);
+}
+
+static void deinterleave16_1(void * const *dst, const void *src,
+			     uint32_t nb_ch, uint32_t samples)
+{
+	memcpy(dst[0], src, samples * 2);
+}
+
+static void interleave32_1(void *dst, const void * const *src, uint32_t nb_ch,
+			   uint32_t samples)
+{
+	memcpy(dst, src[0], samples * 4);
+}
+
+static void deinterleave32_1(void * const *dst, const void *src,
+			     uint32_t nb_ch, uint32_t samples)
+{
+	memcpy(dst[0], src, samples * 4);
+}
+
+/* Two and four channel kernels, vectorized where available */
+static void interleave16_2(void *dst, const void * const *src, uint32_t nb_ch,
+			   uint32_t samples)
+{
+	const uint16_t *a = src[0], *b = src[1];
+	uint16_t *d = dst;
+	uint32_t i = 0;
+
+#if defined(__SSE2__)
+	for (; i + 8 <= samples; i += 8, d += 16) {
+		__m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+		__m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+		_mm_storeu_si128((__m128i *)d, _mm_unpacklo_epi16(va, vb));
+		_mm_storeu_si128((__m128i *)(d + 8), _mm_unpackhi_epi16(va, vb));
+	}
+#elif defined(__ARM_NEON)
+	for (; i + 8 <= samples; i += 8, d += 16) {
+		uint16x8x2_t v = {{ vld1q_u16(a + i), vld1q_u16(b + i) }};
+		vst2q_u16(d, v);
+	}
+#endif
+	for (; i < samples; i++) {
+		*d++ = a[i];
+		*d++ = b[i];
+	}
+}
+
+static void deinterleave16_2(void * const *dst, const void *src,
+			     uint32_t nb_ch, uint32_t samples)
+{
+	uint16_t *a = dst[0], *b = dst[1];
+	const uint16_t *s = src;
+	uint32_t i = 0;
+
+#if defined(__SSE2__)
+	for (; i + 8 <= samples; i += 8, s += 16) {
+		__m128i v0 = _mm_loadu_si128((const __m128i *)s);
+		__m128i v1 = _mm_loadu_si128((const __m128i *)(s + 8));
+		/* Three rounds of unpacking transpose the 2 x 8 block */
+		__m128i t0 = _mm_unpacklo_epi16(v0, v1);
+		__m128i t1 = _mm_unpackhi_epi16(v0, v1);
+		v0 = _mm_unpacklo_epi16(t0, t1);
+		v1 = _mm_unpackhi_epi16(t0, t1);
+		_mm_storeu_si128((__m128i *)(a + i), _mm_unpacklo_epi16(v0, v1));
+		_mm_storeu_si128((__m128i *)(b + i), _mm_unpackhi_epi16(v0, v1));
+	}
+#elif defined(__ARM_NEON)
+	for (; i + 8 <= samples; i += 8, s += 16) {
+		uint16x8x2_t v = vld2q_u16(s);
+		vst1q_u16(a + i, v.val[0]);
+		vst1q_u16(b + i, v.val[1]);
+	}
+#endif
+	for (; i < samples; i++) {
+		a[i] = *s++;
+		b[i] = *s++;
+	}
+}
+
+static void interleave16_4(void *dst, const void * const *src, uint32_t nb_ch,
+			   uint32_t samples)
+{
+	const uint16_t *a = src[0], *b = src[1], *c = src[2], *e = src[3];
+	uint16_t *d = dst;
+	uint32_t i = 0;
+
+#if defined(__SSE2__)
+	for (; i + 8 <= samples; i += 8, d += 32) {
+		__m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+		__m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+		__m128i vc = _mm_loadu_si128((const __m128i *)(c + i));
+		__m128i ve = _mm_loadu_si128((const __m128i *)(e + i));
+		__m128i ab0 = _mm_unpacklo_epi16(va, vb);
+		__m128i ab1 = _mm_unpackhi_epi16(va, vb);
+		__m128i ce0 = _mm_unpacklo_epi16(vc, ve);
+		__m128i ce1 = _mm_unpackhi_epi16(vc, ve);
+		_mm_storeu_si128((__m128i *)d, _mm_unpacklo_epi32(ab0, ce0));
+		_mm_storeu_si128((__m128i *)(d + 8), _mm_unpackhi_epi32(ab0, ce0));
+		_mm_storeu_si128((__m128i *)(d + 16), _mm_unpacklo_epi32(ab1, ce1));
+		_mm_storeu_si128((__m128i *)(d + 24), _mm_unpackhi_epi32(ab1, ce1));
+	}
+#elif defined(__ARM_NEON)
+	for (; i + 8 <= samples; i += 8, d += 32) {
+		uint16x8x4_t v = {{
+				vld1q_u16(a + i), vld1q_u16(b + i),
+				vld1q_u16(c + i), vld1q_u16(e + i)
+			}
+		};
+		vst4q_u16(d, v);
+	}
+#endif
+	for (; i < samples; i++) {
+		*d++ = a[i];
+		*d++ = b[i];
+		*d++ = c[i];
+		*d++ = e[i];
+	}
+}
+
+static void deinterleave16_4(void * const *dst, const void *src,
+			     uint32_t nb_ch, uint32_t samples)
+{
+	uint16_t *a = dst[0], *b = dst[1], *c = dst[2], *e = dst[3];
+	const uint16_t *s = src;
+	uint32_t i = 0;
+
+#if defined(__SSE2__)
+	for (; i + 8 <= samples; i += 8, s += 32) {
+		__m128i v0 = _mm_loadu_si128((const __m128i *)s);
+		__m128i v1 = _mm_loadu_si128((const __m128i *)(s + 8));
+		__m128i v2 = _mm_loadu_si128((const __m128i *)(s + 16));
+		__m128i v3 = _mm_loadu_si128((const __m128i *)(s + 24));
+		__m128i t0 = _mm_unpacklo_epi16(v0, v1);
+		__m128i t1 = _mm_unpackhi_epi16(v0, v1);
+		__m128i t2 = _mm_unpacklo_epi16(v2, v3);
+		__m128i t3 = _mm_unpackhi_epi16(v2, v3);
+		/* u0 = a0..a3 b0..b3, u1 = c0..c3 e0..e3, u2/u3 samples 4..7 */
+		__m128i u0 = _mm_unpacklo_epi16(t0, t1);
+		__m128i u1 = _mm_unpackhi_epi16(t0, t1);
+		__m128i u2 = _mm_unpacklo_epi16(t2, t3);
+		__m128i u3 = _mm_unpackhi_epi16(t2, t3);
+		_mm_storeu_si128((__m128i *)(a + i), _mm_unpacklo_epi64(u0, u2));
+		_mm_storeu_si128((__m128i *)(b + i), _mm_unpackhi_epi64(u0, u2));
+		_mm_storeu_si128((__m128i *)(c + i), _mm_unpacklo_epi64(u1, u3));
+		_mm_storeu_si128((__m128i *)(e + i), _mm_unpackhi_epi64(u1, u3));
+	}
+#elif defined(__ARM_NEON)
+	for (; i + 8 <= samples; i += 8, s += 32) {
+		uint16x8x4_t v = vld4q_u16(s);
+		vst1q_u16(a + i, v.val[0]);
+		vst1q_u16(b + i, v.val[1]);
+		vst1q_u16(c + i, v.val[2]);
+		vst1q_u16(e + i, v.val[3]);
+	}
+#endif
+	for (; i < samples; i++) {
+		a[i] = *s++;
+		b[i] = *s++;
+		c[i] = *s++;
+		e[i] = *s++;
+	}
+}
+
+static void interleave32_2(void *dst, const void * const *src, uint32_t nb_ch,
+			   uint32_t samples)
+{
+	const uint32_t *a = src[0], *b = src[1];
+	uint32_t *d = dst;
+	uint32_t i = 0;
+
+#if defined(__SSE2__)
+	for (; i + 4 <= samples; i += 4, d += 8) {
+		__m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+		__m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+		_mm_storeu_si128((__m128i *)d, _mm_unpacklo_epi32(va, vb));
+		_mm_storeu_si128((__m128i *)(d + 4), _mm_unpackhi_epi32(va, vb));
+	}
+#elif defined(__ARM_NEON)
+	for (; i + 4 <= samples; i += 4, d += 8) {
+		uint32x4x2_t v = {{ vld1q_u32(a + i), vld1q_u32(b + i) }};
+		vst2q_u32(d, v);
+	}
+#endif
+	for (; i < samples; i++) {
+		*d++ = a[i];
+		*d++ = b[i];
+	}
+}
+
+static void deinterleave32_2(void * const *dst, const void *src,
+			     uint32_t nb_ch, uint32_t samples)
+{
+	uint32_t *a = dst[0], *b = dst[1];
+	const uint32_t *s = src;
+	uint32_t i = 0;
+
+#if defined(__SSE2__)
+	for (; i + 4 <= samples; i += 4, s += 8) {
+		__m128i v0 = _mm_loadu_si128((const __m128i *)s);
+		__m128i v1 = _mm_loadu_si128((const __m128i *)(s + 4));
+		__m128i t0 = _mm_unpacklo_epi32(v0, v1);
+		__m128i t1 = _mm_unpackhi_epi32(v0, v1);
+		_mm_storeu_si128((__m128i *)(a + i), _mm_unpacklo_epi32(t0, t1));
+		_mm_storeu_si128((__m128i *)(b + i), _mm_unpackhi_epi32(t0, t1));
+	}
+#elif defined(__ARM_NEON)
+	for (; i + 4 <= samples; i += 4, s += 8) {
+		uint32x4x2_t v = vld2q_u32(s);
+		vst1q_u32(a + i, v.val[0]);
+		vst1q_u32(b + i, v.val[1]);
+	}
+#endif
+	for (; i < samples; i++) {
+		a[i] = *s++;
+		b[i] = *s++;
+	}
+}
+
+#if defined(__SSE2__)
+/* 4 x 4 transpose of 32-bit elements, its own inverse */
+static inline void transpose32_4x4(__m128i *v)
+{
+	__m128i t0 = _mm_unpacklo_epi32(v[0], v[1]);
+	__m128i t1 = _mm_unpackhi_epi32(v[0], v[1]);
+	__m128i t2 = _mm_unpacklo_epi32(v[2], v[3]);
+	__m128i t3 = _mm_unpackhi_epi32(v[2], v[3]);
+
+	v[0] = _mm_unpacklo_epi64(t0, t2);
+	v[1] = _mm_unpackhi_epi64(t0, t2);
+	v[2] = _mm_unpacklo_epi64(t1, t3);
+	v[3] = _mm_unpackhi_epi64(t1, t3);
+}
+#endif
+
+static void interleave32_4(void *dst, const void * const *src, uint32_t nb_ch,
+			   uint32_t samples)
+{
+	const uint32_t *a = src[0], *b = src[1], *c = src[2], *e = src[3];
+	uint32_t *d = dst;
+	uint32_t i = 0;
+
+#if defined(__SSE2__)
+	__m128i v[4];
+
+	for (; i + 4 <= samples; i += 4, d += 16) {
+		v[0] = _mm_loadu_si128((const __m128i *)(a + i));
+		v[1] = _mm_loadu_si128((const __m128i *)(b + i));
+		v[2] = _mm_loadu_si128((const __m128i *)(c + i));
+		v[3] = _mm_loadu_si128((const __m128i *)(e + i));
+		transpose32_4x4(v);
+		_mm_storeu_si128((__m128i *)d, v[0]);
+		_mm_storeu_si128((__m128i *)(d + 4), v[1]);
+		_mm_storeu_si128((__m128i *)(d + 8), v[2]);
+		_mm_storeu_si128((__m128i *)(d + 12), v[3]);
+	}
+#elif defined(__ARM_NEON)
+	for (; i + 4 <= samples; i += 4, d += 16) {
+		uint32x4x4_t v = {{
+				vld1q_u32(a + i), vld1q_u32(b + i),
+				vld1q_u32(c + i), vld1q_u32(e + i)
+			}
+		};
+		vst4q_u32(d, v);
+	}
+#endif
+	for (; i < samples; i++) {
+		*d++ = a[i];
+		*d++ = b[i];
+		*d++ = c[i];
+		*d++ = e[i];
+	}
+}
+
+static void deinterleave32_4(void * const *dst, const void *src,
+			     uint32_t nb_ch, uint32_t samples)
+{
+	uint32_t *a = dst[0], *b = dst[1], *c = dst[2], *e = dst[3];
+	const uint32_t *s = src;
+	uint32_t i = 0;
+
+#if defined(__SSE2__)
+	__m128i v[4];
+
+	for (; i + 4 <= samples; i += 4, s += 16) {
+		v[0] = _mm_loadu_si128((const __m128i *)s);
+		v[1] = _mm_loadu_si128((const __m128i *)(s + 4));
+		v[2] = _mm_loadu_si128((const __m128i *)(s + 8));
+		v[3] = _mm_loadu_si128((const __m128i *)(s + 12));
+		transpose32_4x4(v);
+		_mm_storeu_si128((__m128i *)(a + i), v[0]);
+		_mm_storeu_si128((__m128i *)(b + i), v[1]);
+		_mm_storeu_si128((__m128i *)(c + i), v[2]);
+		_mm_storeu_si128((__m128i *)(e + i), v[3]);
+	}
+#elif defined(__ARM_NEON)
+	for (; i + 4 <= samples; i += 4, s += 16) {
+		uint32x4x4_t v = vld4q_u32(s);
+		vst1q_u32(a + i, v.val[0]);
+		vst1q_u32(b + i, v.val[1]);
+		vst1q_u32(c + i, v.val[2]);
+		vst1q_u32(e + i, v.val[3]);
+	}
+#endif
+	for (; i < samples; i++) {
+		a[i] = *s++;
+		b[i] = *s++;
+		c[i] = *s++;
+		e[i] = *s++;
+	}
+}
+
+/***************************************************************************//**
+ * @brief Select the interleave kernels for a channel mask.
+ *
+ * Called when the channel mask changes (buffer pre enable), so the per sample
+ * path does no channel mask walking and no kernel selection.
+ *
+ * @param plan - Plan to fill.
+ * @param mask - Mask of the active channels.
+ * @param size - Size of a sample in bytes, 2 or 4.
+ *
+ * @return SUCCESS in case of success, -EINVAL otherwise.
+*******************************************************************************/
+int32_t interleave_plan_init(struct interleave_plan *plan, uint32_t mask,
+			     uint32_t size)
+{
+	uint32_t ch;
+
+	if (!plan || (size != 2 && size != 4))
+		return -EINVAL;
+
+	plan->nb_ch = 0;
+	plan->size = size;
+	for (ch = 0; ch < INTERLEAVE_MAX_CH; ch++)
+		if (mask & (1u << ch))
+			plan->ch[plan->nb_ch++] = ch;
+
+	switch (plan->nb_ch) {
+	case 1:
+		plan->interleave = size == 2 ? interleave16_1 : interleave32_1;
+		plan->deinterleave = size == 2 ? deinterleave16_1 :
+				     deinterleave32_1;
+		break;
+	case 2:
+		plan->interleave = size == 2 ? interleave16_2 : interleave32_2;
+		plan->deinterleave = size == 2 ? deinterleave16_2 :
+				     deinterleave32_2;
+		break;
+	case 4:
+		plan->interleave = size == 2 ? interleave16_4 : interleave32_4;
+		plan->deinterleave = size == 2 ? deinterleave16_4 :
+				     deinterleave32_4;
+		break;
+	default:
+		plan->interleave = size == 2 ? interleave16_n : interleave32_n;
+		plan->deinterleave = size == 2 ? deinterleave16_n :
+				     deinterleave32_n;
+		break;
+	}
+
+	return SUCCESS;
+}
+
+/***************************************************************************//**
+ * @brief Sign extend samples in place.
+ * @param buf - Buffer of samples.
+ * @param samples - Number of samples.
+ * @param bits - Number of valid bits of a sample, 1 to 32. The bits above
+ *               are replaced by copies of the sign bit.
+*******************************************************************************/
+void sample_sign_extend32(int32_t *buf, uint32_t samples, uint32_t bits)
+{
+	uint32_t shift, i = 0;
+
+	if (!bits || bits >= 32)
+		return;
+
+	shift = 32 - bits;
+#if defined(__SSE2__)
+	const __m128i cnt = _mm_cvtsi32_si128(shift);
+
+	for (; i + 4 <= samples; i += 4) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(buf + i));
+		v = _mm_sra_epi32(_mm_sll_epi32(v, cnt), cnt);
+		_mm_storeu_si128((__m128i *)(buf + i), v);
+	}
+#elif defined(__ARM_NEON)
+	const int32x4_t l = vdupq_n_s32(shift);
+	const int32x4_t r = vdupq_n_s32(-(int32_t)shift);
+
+	for (; i + 4 <= samples; i += 4)
+		vst1q_s32(buf + i, vshlq_s32(vshlq_s32(vld1q_s32(buf + i), l), r));
+#endif
+	for (; i < samples; i++)
+		buf[i] = (int32_t)((uint32_t)buf[i] << shift) >> shift;
+}
+
+/***************************************************************************//**
+ * @brief Swap the bytes of 16-bit samples in place.
+ * @param buf - Buffer of samples.
+ * @param samples - Number of samples.
+*******************************************************************************/
+void sample_swab16(uint16_t *buf, uint32_t samples)
+{
+	uint32_t i = 0;
+
+#if defined(__SSE2__)
+	for (; i + 8 <= samples; i += 8) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(buf + i));
+		v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+		_mm_storeu_si128((__m128i *)(buf + i), v);
+	}
+#elif defined(__ARM_NEON)
+	for (; i + 8 <= samples; i += 8)
+		vst1q_u8((uint8_t *)(buf + i),
+			 vrev16q_u8(vld1q_u8((const uint8_t *)(buf + i))));
+#endif
+	for (; i < samples; i++)
+		buf[i] = bswap_constant_16(buf[i]);
+}
+
+/***************************************************************************//**
+ * @brief Swap the bytes of 32-bit samples in place.
+ * @param buf - Buffer of samples.
+ * @param samples - Number of samples.
+*******************************************************************************/
+void sample_swab32(uint32_t *buf, uint32_t samples)
+{
+	uint32_t i = 0;
+
+#if defined(__SSE2__)
+	for (; i + 4 <= samples; i += 4) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(buf + i));
+		v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+		v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+		v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+		_mm_storeu_si128((__m128i *)(buf + i), v);
+	}
+#elif defined(__ARM_NEON)
+	for (; i + 4 <= samples; i += 4)
+		vst1q_u8((uint8_t *)(buf + i),
+			 vrev32q_u8(vld1q_u8((const uint8_t *)(buf + i))));
+#endif
+	for (; i < samples; i++)
+		buf[i] = bswap_constant_32(buf[i]);
+}
@@ -0,0 +1,125 @@
+/***************************************************************************//**
+ *   @file   trace.c
+ *   @brief  Binary event trace ring.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include "no-os/trace.h"
+#include "no-os/error.h"
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+
+struct trace_buffer trace_buf = {
+	.magic = TRACE_MAGIC,
+	.version = TRACE_VERSION,
+	.record_size = sizeof(struct trace_record),
+	.size = TRACE_RING_SIZE,
+};
+
+uint32_t (*trace_timestamp)(void);
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Clear the ring and start recording.
+ * @param param - Time source and mode.
+ * @return SUCCESS in case of success, -EINVAL without a time source.
+ */
+int32_t trace_start(const struct trace_init_param *param)
+{
+	if (!param || !param->timestamp)
+		return -EINVAL;
+
+	trace_buf.limit = 0;
+	trace_timestamp = param->timestamp;
+	trace_buf.freq_hz = param->freq_hz;
+	memset(trace_buf.records, 0, sizeof(trace_buf.records));
+	trace_buf.head = 0;
+	trace_buf.limit = param->mode == TRACE_MODE_ONESHOT ?
+			  TRACE_RING_SIZE : UINT32_MAX;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Stop recording. The records are kept until the next trace_start().
+ */
+void trace_stop(void)
+{
+	trace_buf.limit = trace_buf.head;
+}
+
+/**
+ * @brief Get the binary dump of the ring, to be saved as is.
+ * @param buf - Where to store the address of the dump.
+ * @param len - Where to store the size of the dump in bytes.
+ */
+void trace_dump(const void **buf, uint32_t *len)
+{
+	*buf = &trace_buf;
+	*len = sizeof(trace_buf);
+}
+
+/**
+ * @brief Print the dump as lines of hex bytes between "TRACE BEGIN" and
+ * "TRACE END", which the decoder finds in a console log. Only the records
+ * written are printed.
+ */
+void trace_print(void)
+{
+	const uint8_t *buf = (const uint8_t *)&trace_buf;
+	uint32_t len, i;
+
+	len = offsetof(struct trace_buffer, records) +
+	      (trace_buf.head < TRACE_RING_SIZE ? trace_buf.head :
+	       TRACE_RING_SIZE) * sizeof(struct trace_record);
+
+	printf("TRACE BEGIN\n");
+	for (i = 0; i < len; i++)
+		printf("%02x%s", buf[i], (i % 32 == 31 || i == len - 1) ?
+		       "\n" : "");
+	printf("TRACE END\n");
+}